@@ -27,6 +27,7 @@
 #endif
 
 #include "command/IAmCommandSend.h"
+#include "TAmPluginTemplate.h"
 
 namespace am
 {
@@ -41,9 +42,21 @@ class CAmCommandReceiver;
 class CAmCommandSender
 {
 public:
-    CAmCommandSender(const std::vector<std::string>& listOfPluginDirectories);
+    /**
+     * delivery information of one command plugin
+     */
+    struct deliveryStatistic_s
+    {
+        std::string plugin; //!< the library name of the plugin
+        uint32_t calls; //!< number of callbacks delivered to the plugin
+        uint64_t timeNs; //!< time spent in the callbacks of the plugin, in nanoseconds
+        uint64_t maxTimeNs; //!< longest single callback, in nanoseconds
+    };
+
+    CAmCommandSender(const std::vector<std::string>& listOfPluginDirectories, const unsigned int loadThreads = 1, const std::vector<std::string>& listDeferredPlugins = std::vector<std::string>());
     ~CAmCommandSender();
     am_Error_e startupInterfaces(CAmCommandReceiver* iCommandReceiver);
+    am_Error_e startupDeferredInterfaces();
     void setCommandReady();
     void setCommandRundown();
     void cbNewMainConnection(const am_MainConnectionType_s mainConnection);
@@ -65,14 +78,23 @@ public:
     void cbTimingInformationChanged(const am_mainConnectionID_t mainConnectionID, const am_timeSync_t time);
     void getInterfaceVersion(std::string& version) const;
     am_Error_e getListPlugins(std::vector<std::string>& interfaces) const;
+    void getPluginStartupTimes(std::vector<pluginStartup_s>& listStartup) const;
+    void getDeliveryStatistics(std::vector<deliveryStatistic_s>& listStatistics) const;
+    void resetDeliveryStatistics();
 #ifdef UNIT_TEST
     friend class IAmCommandBackdoor; //this is to get access to the loaded plugins and be able to exchange the interfaces
 #endif
 private:
     void unloadLibraries(void); //!< unload the shared libraries
+    void loadInterfaces(const std::vector<std::string>& listLibraries, const bool deferred); //!< loads plugins and appends them to mListInterfaces
     std::vector<IAmCommandSend*> mListInterfaces; //!< list of all interfaces
     std::vector<void*> mListLibraryHandles; //!< list of all library handles. This information is used to unload the plugins correctly.
     std::vector<std::string> mListLibraryNames; //!< list of all library names. This information is used for getListPlugins.
+    std::vector<deliveryStatistic_s> mListDeliveryStatistics; //!< delivery information, same order as mListInterfaces
+    std::vector<pluginStartup_s> mListPluginStartup; //!< startup timeline, same order as mListInterfaces
+    std::vector<std::string> mListDeferredLibraries; //!< libraries that are loaded after the first main connection
+    unsigned int mLoadThreads; //!< number of threads that load the plugins
+    bool mCommandReady; //!< true after setCommandReady, deferred plugins get their ready right after their startup
 
     CAmCommandReceiver *mCommandReceiver;
 };
@@ -28,7 +28,7 @@ namespace am
 {
 
 class CAmSocketHandler;
-class CAmDatabaseHandler;
+class IAmDatabaseHandler;
 class CAmRoutingSender;
 class CAmCommandSender;
 class CAmRouter;
@@ -39,7 +39,7 @@ class CAmRouter;
 class CAmControlReceiver: public IAmControlReceive
 {
 public:
-    CAmControlReceiver(CAmDatabaseHandler *iDatabaseHandler, CAmRoutingSender *iRoutingSender, CAmCommandSender *iCommandSender, CAmSocketHandler *iSocketHandler, CAmRouter* iRouter);
+    CAmControlReceiver(IAmDatabaseHandler *iDatabaseHandler, CAmRoutingSender *iRoutingSender, CAmCommandSender *iCommandSender, CAmSocketHandler *iSocketHandler, CAmRouter* iRouter);
     ~CAmControlReceiver();
     am_Error_e getRoute(const bool onlyfree, const am_sourceID_t sourceID, const am_sinkID_t sinkID, std::vector<am_Route_s>& returnList);
     am_Error_e connect(am_Handle_s& handle, am_connectionID_t& connectionID, const am_ConnectionFormat_e format, const am_sourceID_t sourceID, const am_sinkID_t sinkID);
@@ -115,7 +115,7 @@ public:
     void getInterfaceVersion(std::string& version) const;
 
 private:
-    CAmDatabaseHandler* mDatabaseHandler; //!< pointer tto the databasehandler
+    IAmDatabaseHandler* mDatabaseHandler; //!< pointer tto the databasehandler
     CAmRoutingSender* mRoutingSender; //!< pointer to the routing send interface.
     CAmCommandSender* mCommandSender; //!< pointer to the command send interface
     CAmSocketHandler* mSocketHandler; //!< pointer to the socketHandler
@@ -22,7 +22,8 @@
 #ifndef DATABASEHANDLER_H_
 #define DATABASEHANDLER_H_
 
-#include "audiomanagertypes.h"
+#include "IAmDatabaseHandler.h"
+#include "CAmDatabaseStatementCache.h"
 #include <map>
 #include <vector>
 #include <string>
@@ -31,11 +32,6 @@
 namespace am
 {
 
-class CAmDatabaseObserver;
-class CAmRoutingTree;
-class CAmRoutingTreeItem;
-
-#define DYNAMIC_ID_BOUNDARY 100 //!< the value below is reserved for staticIDs, the value above will be assigned to dynamically registered items
 //todo: check the enum values before entering & changing in the database.
 //todo: change asserts for dynamic boundary checks into failure answers.#
 //todo: check autoincrement boundary and set to 16bit limits
@@ -45,13 +41,38 @@ class CAmRoutingTreeItem;
 //todo: enforce the uniqueness of names
 
 /**
- * This class handles and abstracts the database
+ * This class handles and abstracts the database, it is the sqlite backend of IAmDatabaseHandler
  */
-class CAmDatabaseHandler
+class CAmDatabaseHandler: public IAmDatabaseHandler
 {
 public:
+    /**
+     * the sqlite settings that are applied when the database is opened. Empty strings and zero values keep the sqlite default.
+     * The database holds volatile routing state, so durability can be traded for speed, e.g. with WAL and synchronous OFF.
+     */
+    struct databaseSettings_s
+    {
+        databaseSettings_s();
+        std::string journalMode; //!< PRAGMA journal_mode: DELETE, TRUNCATE, PERSIST, MEMORY, WAL or OFF
+        std::string synchronous; //!< PRAGMA synchronous: OFF, NORMAL, FULL or EXTRA
+        int32_t cacheSize; //!< PRAGMA cache_size: pages if positive, KiB if negative
+        int64_t mmapSize; //!< PRAGMA mmap_size in bytes
+        bool set(const std::string& key, const std::string& value); //!< sets a value by its pragma name, returns false for unknown keys or values
+    };
+
+    /**
+     * usage information of one list snapshot
+     */
+    struct snapshotStatistic_s
+    {
+        std::string name; //!< the list
+        uint32_t builds; //!< number of times the list was read from the database
+        uint32_t hits; //!< number of calls that were served from the snapshot
+    };
+
     CAmDatabaseHandler(std::string databasePath);
-    ~CAmDatabaseHandler();
+    CAmDatabaseHandler(std::string databasePath, const databaseSettings_s& settings);
+    virtual ~CAmDatabaseHandler();
     am_Error_e enterDomainDB(const am_Domain_s& domainData, am_domainID_t& domainID);
     am_Error_e enterMainConnectionDB(const am_MainConnection_s& mainConnectionData, am_mainConnectionID_t& connectionID);
     am_Error_e enterSinkDB(const am_Sink_s& sinkData, am_sinkID_t& sinkID);
@@ -152,16 +173,52 @@ public:
     bool existSinkClass(const am_sinkClass_t sinkClassID) const;
     bool existSourceClass(const am_sourceClass_t sourceClassID) const;
     void registerObserver(CAmDatabaseObserver *iObserver);
+    am_Error_e beginTransaction();
+    am_Error_e commitTransaction();
+    const CAmDatabaseStatementCache& getStatementCache() const; //!< gives access to the statistics of the statement cache
+    const databaseSettings_s& getSettings() const; //!< returns the settings sqlite reported back after opening
+    void getSnapshotStatistics(std::vector<snapshotStatistic_s>& listStatistics) const;
     bool sourceVisible(const am_sourceID_t sourceID) const;
     bool sinkVisible(const am_sinkID_t sinkID) const;
+    void getStatementStatistics(std::vector<statementClassStatistic_s>& listStatistics) const;
+    void resetStatementStatistics();
 
 private:
+    /**
+     * a list that is read from the database once and handed out until one of the tables it is read from changes
+     */
+    template<class T> struct snapshot_s
+    {
+        snapshot_s(const char* iName) :
+                name(iName), list(), valid(false), builds(0), hits(0)
+        {
+        }
+        const char* name; //!< the name of the list, for the statistics
+        std::vector<T> list; //!< the list as it was read last
+        bool valid; //!< false if the tables changed since the list was read
+        uint32_t builds; //!< number of times the list was read, this is the version of the snapshot
+        uint32_t hits; //!< number of calls that were served from the snapshot
+    };
+
+    template<class T> am_Error_e getSnapshot(snapshot_s<T>& snapshot, am_Error_e (CAmDatabaseHandler::*buildList)(std::vector<T>&) const, std::vector<T>& list) const;
+    template<class T> void addSnapshotStatistic(const snapshot_s<T>& snapshot, std::vector<snapshotStatistic_s>& listStatistics) const;
+    am_Error_e buildListMainConnections(std::vector<am_MainConnection_s>& listMainConnections) const;
+    am_Error_e buildListSinks(std::vector<am_Sink_s>& listSinks) const;
+    am_Error_e buildListSources(std::vector<am_Source_s>& listSources) const;
+    am_Error_e buildListVisibleMainConnections(std::vector<am_MainConnectionType_s>& listConnections) const;
+    am_Error_e buildListMainSinks(std::vector<am_SinkType_s>& listMainSinks) const;
+    am_Error_e buildListMainSources(std::vector<am_SourceType_s>& listMainSources) const;
+    static void updateHook(void* userData, int operation, const char* database, const char* table, sqlite3_int64 rowID); //!< called by sqlite for every changed row
+    void tableChanged(const char* table); //!< invalidates the snapshots that are read from the table
     am_timeSync_t calculateMainConnectionDelay(const am_mainConnectionID_t mainConnectionID) const; //!< calculates a new main connection delay
     bool sqQuery(const std::string& query); //!< queries the database
     bool openDatabase(); //!< opens the database
     void createTables(); //!< creates all tables from the static table
+    void applySettings(); //!< issues the pragmas of mSettings and reads back what sqlite uses
+    void init(); //!< opens the database and creates the tables
     sqlite3 *mpDatabase; //!< pointer to the database
     std::string mPath; //!< path to the database
+    databaseSettings_s mSettings; //!< the sqlite settings
     CAmDatabaseObserver *mpDatabaseObserver; //!< pointer to the Observer
     bool mFirstStaticSink; //!< bool for dynamic range handling
     bool mFirstStaticSource; //!< bool for dynamic range handling
@@ -171,6 +228,14 @@ private:
     bool mFirstStaticCrossfader; //!< bool for dynamic range handling
     typedef std::map<am_gatewayID_t, std::vector<bool> > ListConnectionFormat; //!< type for list of connection formats
     ListConnectionFormat mListConnectionFormat; //!< list of connection formats
+    mutable CAmDatabaseStatementCache mStatementCache; //!< keeps the compiled statements between calls
+    uint16_t mTransactionDepth; //!< number of open beginTransaction calls
+    mutable snapshot_s<am_MainConnection_s> mSnapshotMainConnections; //!< snapshot of getListMainConnections
+    mutable snapshot_s<am_Sink_s> mSnapshotSinks; //!< snapshot of getListSinks
+    mutable snapshot_s<am_Source_s> mSnapshotSources; //!< snapshot of getListSources
+    mutable snapshot_s<am_MainConnectionType_s> mSnapshotVisibleMainConnections; //!< snapshot of getListVisibleMainConnections
+    mutable snapshot_s<am_SinkType_s> mSnapshotMainSinks; //!< snapshot of getListMainSinks
+    mutable snapshot_s<am_SourceType_s> mSnapshotMainSources; //!< snapshot of getListMainSources
 };
 
 }
@@ -0,0 +1,249 @@
+/**
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \author Christian Mueller, christian.ei.mueller@bmw.de BMW 2011,2012
+ *
+ * \file CAmDatabaseHandlerMap.h
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#ifndef DATABASEHANDLERMAP_H_
+#define DATABASEHANDLERMAP_H_
+
+#include "IAmDatabaseHandler.h"
+#include <map>
+#include <vector>
+#include <string>
+
+namespace am
+{
+
+/**
+ * This class is the in-memory backend of IAmDatabaseHandler.
+ * All objects are kept in std::maps indexed by their ID, sinks, sources and domains are additionally indexed by name.
+ * The behaviour (ID assignment, reservation, observer calls and return values) is the same as in CAmDatabaseHandler.
+ */
+class CAmDatabaseHandlerMap: public IAmDatabaseHandler
+{
+public:
+    CAmDatabaseHandlerMap();
+    virtual ~CAmDatabaseHandlerMap();
+    am_Error_e enterDomainDB(const am_Domain_s& domainData, am_domainID_t& domainID);
+    am_Error_e enterMainConnectionDB(const am_MainConnection_s& mainConnectionData, am_mainConnectionID_t& connectionID);
+    am_Error_e enterSinkDB(const am_Sink_s& sinkData, am_sinkID_t& sinkID);
+    am_Error_e enterCrossfaderDB(const am_Crossfader_s& crossfaderData, am_crossfaderID_t& crossfaderID);
+    am_Error_e enterGatewayDB(const am_Gateway_s& gatewayData, am_gatewayID_t& gatewayID);
+    am_Error_e enterSourceDB(const am_Source_s& sourceData, am_sourceID_t& sourceID);
+    am_Error_e enterConnectionDB(const am_Connection_s& connection, am_connectionID_t& connectionID);
+    am_Error_e enterSinkClassDB(const am_SinkClass_s& sinkClass, am_sinkClass_t& sinkClassID);
+    am_Error_e enterSourceClassDB(am_sourceClass_t& sourceClassID, const am_SourceClass_s& sourceClass);
+    am_Error_e enterSystemProperties(const std::vector<am_SystemProperty_s>& listSystemProperties);
+    am_Error_e changeMainConnectionRouteDB(const am_mainConnectionID_t mainconnectionID, const std::vector<am_connectionID_t>& listConnectionID);
+    am_Error_e changeMainConnectionStateDB(const am_mainConnectionID_t mainconnectionID, const am_ConnectionState_e connectionState);
+    am_Error_e changeSinkMainVolumeDB(const am_mainVolume_t mainVolume, const am_sinkID_t sinkID);
+    am_Error_e changeSinkAvailabilityDB(const am_Availability_s& availability, const am_sinkID_t sinkID);
+    am_Error_e changDomainStateDB(const am_DomainState_e domainState, const am_domainID_t domainID);
+    am_Error_e changeSinkMuteStateDB(const am_MuteState_e muteState, const am_sinkID_t sinkID);
+    am_Error_e changeMainSinkSoundPropertyDB(const am_MainSoundProperty_s& soundProperty, const am_sinkID_t sinkID);
+    am_Error_e changeMainSourceSoundPropertyDB(const am_MainSoundProperty_s& soundProperty, const am_sourceID_t sourceID);
+    am_Error_e changeSourceSoundPropertyDB(const am_SoundProperty_s& soundProperty, const am_sourceID_t sourceID);
+    am_Error_e changeSinkSoundPropertyDB(const am_SoundProperty_s& soundProperty, const am_sinkID_t sinkID);
+    am_Error_e changeSourceAvailabilityDB(const am_Availability_s& availability, const am_sourceID_t sourceID);
+    am_Error_e changeSystemPropertyDB(const am_SystemProperty_s& property);
+    am_Error_e changeDelayMainConnection(const am_timeSync_t & delay, const am_mainConnectionID_t & connectionID);
+    am_Error_e changeSinkClassInfoDB(const am_SinkClass_s& sinkClass);
+    am_Error_e changeSourceClassInfoDB(const am_SourceClass_s& sourceClass);
+    am_Error_e changeConnectionTimingInformation(const am_connectionID_t connectionID, const am_timeSync_t delay);
+    am_Error_e changeConnectionFinal(const am_connectionID_t connectionID);
+    am_Error_e changeSourceState(const am_sourceID_t sourceID, const am_SourceState_e sourceState);
+    am_Error_e changeSinkVolume(const am_sinkID_t sinkID, const am_volume_t volume);
+    am_Error_e changeSourceVolume(const am_sourceID_t sourceID, const am_volume_t volume);
+    am_Error_e changeCrossFaderHotSink(const am_crossfaderID_t crossfaderID, const am_HotSink_e hotsink);
+    am_Error_e removeMainConnectionDB(const am_mainConnectionID_t mainConnectionID);
+    am_Error_e removeSinkDB(const am_sinkID_t sinkID);
+    am_Error_e removeSourceDB(const am_sourceID_t sourceID);
+    am_Error_e removeGatewayDB(const am_gatewayID_t gatewayID);
+    am_Error_e removeCrossfaderDB(const am_crossfaderID_t crossfaderID);
+    am_Error_e removeDomainDB(const am_domainID_t domainID);
+    am_Error_e removeSinkClassDB(const am_sinkClass_t sinkClassID);
+    am_Error_e removeSourceClassDB(const am_sourceClass_t sourceClassID);
+    am_Error_e removeConnection(const am_connectionID_t connectionID);
+    am_Error_e getSourceClassInfoDB(const am_sourceID_t sourceID, am_SourceClass_s& classInfo) const;
+    am_Error_e getSinkClassInfoDB(const am_sinkID_t sinkID, am_SinkClass_s& sinkClass) const;
+    am_Error_e getGatewayInfoDB(const am_gatewayID_t gatewayID, am_Gateway_s& gatewayData) const;
+    am_Error_e getSinkInfoDB(const am_sinkID_t sinkID, am_Sink_s& sinkData) const;
+    am_Error_e getSourceInfoDB(const am_sourceID_t sourceID, am_Source_s& sourceData) const;
+    am_Error_e getCrossfaderInfoDB(const am_crossfaderID_t crossfaderID, am_Crossfader_s& crossfaderData) const;
+    am_Error_e getMainConnectionInfoDB(const am_mainConnectionID_t mainConnectionID, am_MainConnection_s& mainConnectionData) const;
+    am_Error_e getSinkVolume(const am_sinkID_t sinkID, am_volume_t& volume) const;
+    am_Error_e getSourceVolume(const am_sourceID_t sourceID, am_volume_t& volume) const;
+    am_Error_e getSinkSoundPropertyValue(const am_sinkID_t sinkID, const am_SoundPropertyType_e propertyType, int16_t& value) const;
+    am_Error_e getSourceSoundPropertyValue(const am_sourceID_t sourceID, const am_SoundPropertyType_e propertyType, int16_t& value) const;
+    am_Error_e getListSinksOfDomain(const am_domainID_t domainID, std::vector<am_sinkID_t>& listSinkID) const;
+    am_Error_e getListSourcesOfDomain(const am_domainID_t domainID, std::vector<am_sourceID_t>& listSourceID) const;
+    am_Error_e getListCrossfadersOfDomain(const am_domainID_t domainID, std::vector<am_crossfaderID_t>& listGatewaysID) const;
+    am_Error_e getListGatewaysOfDomain(const am_domainID_t domainID, std::vector<am_gatewayID_t>& listGatewaysID) const;
+    am_Error_e getListMainConnections(std::vector<am_MainConnection_s>& listMainConnections) const;
+    am_Error_e getListDomains(std::vector<am_Domain_s>& listDomains) const;
+    am_Error_e getListConnections(std::vector<am_Connection_s>& listConnections) const;
+    am_Error_e getListSinks(std::vector<am_Sink_s>& listSinks) const;
+    am_Error_e getListSources(std::vector<am_Source_s>& lisSources) const;
+    am_Error_e getListSourceClasses(std::vector<am_SourceClass_s>& listSourceClasses) const;
+    am_Error_e getListCrossfaders(std::vector<am_Crossfader_s>& listCrossfaders) const;
+    am_Error_e getListGateways(std::vector<am_Gateway_s>& listGateways) const;
+    am_Error_e getListSinkClasses(std::vector<am_SinkClass_s>& listSinkClasses) const;
+    am_Error_e getListVisibleMainConnections(std::vector<am_MainConnectionType_s>& listConnections) const;
+    am_Error_e getListMainSinks(std::vector<am_SinkType_s>& listMainSinks) const;
+    am_Error_e getListMainSources(std::vector<am_SourceType_s>& listMainSources) const;
+    am_Error_e getListMainSinkSoundProperties(const am_sinkID_t sinkID, std::vector<am_MainSoundProperty_s>& listSoundProperties) const;
+    am_Error_e getListMainSourceSoundProperties(const am_sourceID_t sourceID, std::vector<am_MainSoundProperty_s>& listSourceProperties) const;
+    am_Error_e getListSystemProperties(std::vector<am_SystemProperty_s>& listSystemProperties) const;
+    am_Error_e getListSinkConnectionFormats(const am_sinkID_t sinkID, std::vector<am_ConnectionFormat_e> & listConnectionFormats) const;
+    am_Error_e getListSourceConnectionFormats(const am_sourceID_t sourceID, std::vector<am_ConnectionFormat_e> & listConnectionFormats) const;
+    am_Error_e getListGatewayConnectionFormats(const am_gatewayID_t gatewayID, std::vector<bool> & listConnectionFormat) const;
+    am_Error_e getTimingInformation(const am_mainConnectionID_t mainConnectionID, am_timeSync_t& delay) const;
+    am_Error_e getDomainOfSource(const am_sourceID_t sourceID, am_domainID_t& domainID) const;
+    am_Error_e getDomainOfSink(const am_sinkID_t sinkID, am_domainID_t& domainID) const;
+    am_Error_e getSoureState(const am_sourceID_t sourceID, am_SourceState_e& sourceState) const;
+    am_Error_e getDomainState(const am_domainID_t domainID, am_DomainState_e& state) const;
+    am_Error_e getRoutingTree(bool onlyfree, CAmRoutingTree& tree, std::vector<CAmRoutingTreeItem*>& flatTree);
+    am_Error_e peekDomain(const std::string& name, am_domainID_t& domainID);
+    am_Error_e peekSink(const std::string& name, am_sinkID_t& sinkID);
+    am_Error_e peekSource(const std::string& name, am_sourceID_t& sourceID);
+    am_Error_e peekSinkClassID(const std::string& name, am_sinkClass_t& sinkClassID);
+    am_Error_e peekSourceClassID(const std::string& name, am_sourceClass_t& sourceClassID);
+
+    bool existMainConnection(const am_mainConnectionID_t mainConnectionID) const;
+    bool existcrossFader(const am_crossfaderID_t crossfaderID) const;
+    bool existConnection(const am_Connection_s connection);
+    bool existConnectionID(const am_connectionID_t connectionID);
+    bool existSource(const am_sourceID_t sourceID) const;
+    bool existSourceNameOrID(const am_sourceID_t sourceID, const std::string& name) const;
+    bool existSourceName(const std::string& name) const;
+    bool existSink(const am_sinkID_t sinkID) const;
+    bool existSinkNameOrID(const am_sinkID_t sinkID, const std::string& name) const;
+    bool existSinkName(const std::string& name) const;
+    bool existDomain(const am_domainID_t domainID) const;
+    bool existGateway(const am_gatewayID_t gatewayID) const;
+    bool existSinkClass(const am_sinkClass_t sinkClassID) const;
+    bool existSourceClass(const am_sourceClass_t sourceClassID) const;
+    void registerObserver(CAmDatabaseObserver *iObserver);
+    am_Error_e beginTransaction();
+    am_Error_e commitTransaction();
+    bool sourceVisible(const am_sourceID_t sourceID) const;
+    bool sinkVisible(const am_sinkID_t sinkID) const;
+    void getStatementStatistics(std::vector<statementClassStatistic_s>& listStatistics) const;
+    void resetStatementStatistics();
+
+private:
+    /**
+     * a domain together with its reservation flag
+     */
+    struct am_Domain_Database_s: public am_Domain_s
+    {
+        bool reserved; //!< true if the domain was only peeked
+        am_Domain_Database_s() :
+                am_Domain_s(), reserved(false)
+        {
+        }
+    };
+
+    /**
+     * a sink together with its reservation flag
+     */
+    struct am_Sink_Database_s: public am_Sink_s
+    {
+        bool reserved; //!< true if the sink was only peeked
+        am_Sink_Database_s() :
+                am_Sink_s(), reserved(false)
+        {
+        }
+    };
+
+    /**
+     * a source together with its reservation flag
+     */
+    struct am_Source_Database_s: public am_Source_s
+    {
+        bool reserved; //!< true if the source was only peeked
+        am_Source_Database_s() :
+                am_Source_s(), reserved(false)
+        {
+        }
+    };
+
+    /**
+     * a connection together with its reservation flag
+     */
+    struct am_Connection_Database_s: public am_Connection_s
+    {
+        bool reserved; //!< true until changeConnectionFinal was called
+        am_Connection_Database_s() :
+                am_Connection_s(), reserved(true)
+        {
+        }
+    };
+
+    typedef std::map<am_domainID_t, am_Domain_Database_s> DomainMap; //!< domains indexed by ID
+    typedef std::map<am_sinkID_t, am_Sink_Database_s> SinkMap; //!< sinks indexed by ID
+    typedef std::map<am_sourceID_t, am_Source_Database_s> SourceMap; //!< sources indexed by ID
+    typedef std::map<am_gatewayID_t, am_Gateway_s> GatewayMap; //!< gateways indexed by ID
+    typedef std::map<am_crossfaderID_t, am_Crossfader_s> CrossfaderMap; //!< crossfaders indexed by ID
+    typedef std::map<am_connectionID_t, am_Connection_Database_s> ConnectionMap; //!< connections indexed by ID
+    typedef std::map<am_mainConnectionID_t, am_MainConnection_s> MainConnectionMap; //!< main connections indexed by ID
+    typedef std::map<am_sinkClass_t, am_SinkClass_s> SinkClassMap; //!< sink classes indexed by ID
+    typedef std::map<am_sourceClass_t, am_SourceClass_s> SourceClassMap; //!< source classes indexed by ID
+    typedef std::map<std::string, uint16_t> NameMap; //!< name to ID index
+
+    am_timeSync_t calculateMainConnectionDelay(const am_mainConnectionID_t mainConnectionID) const; //!< calculates a new main connection delay
+    bool calculateRouteDelay(const std::vector<am_connectionID_t>& listConnectionID, am_timeSync_t& delay) const; //!< calculates the delay of a route, false if a connection is missing
+    uint16_t nextID(uint16_t& currentID); //!< returns the next free ID of a table, like sqlite autoincrement does
+    void useID(uint16_t& currentID, const uint16_t id); //!< makes sure that an explicitely given ID is not handed out again
+
+    CAmDatabaseObserver *mpDatabaseObserver; //!< pointer to the Observer
+    bool mFirstStaticSink; //!< bool for dynamic range handling
+    bool mFirstStaticSource; //!< bool for dynamic range handling
+    bool mFirstStaticGateway; //!< bool for dynamic range handling
+    bool mFirstStaticSinkClass; //!< bool for dynamic range handling
+    bool mFirstStaticSourceClass; //!< bool for dynamic range handling
+    bool mFirstStaticCrossfader; //!< bool for dynamic range handling
+    DomainMap mDomainMap; //!< all domains
+    SinkMap mSinkMap; //!< all sinks
+    SourceMap mSourceMap; //!< all sources
+    GatewayMap mGatewayMap; //!< all gateways
+    CrossfaderMap mCrossfaderMap; //!< all crossfaders
+    ConnectionMap mConnectionMap; //!< all connections
+    MainConnectionMap mMainConnectionMap; //!< all main connections
+    SinkClassMap mSinkClassMap; //!< all sink classes
+    SourceClassMap mSourceClassMap; //!< all source classes
+    std::vector<am_SystemProperty_s> mSystemProperties; //!< the system properties
+    NameMap mDomainNames; //!< index domain name -> domainID
+    NameMap mSinkNames; //!< index sink name -> sinkID
+    NameMap mSourceNames; //!< index source name -> sourceID
+    uint16_t mCurrentDomainID; //!< highest domainID handed out so far
+    uint16_t mCurrentSinkID; //!< highest sinkID handed out so far
+    uint16_t mCurrentSourceID; //!< highest sourceID handed out so far
+    uint16_t mCurrentGatewayID; //!< highest gatewayID handed out so far
+    uint16_t mCurrentCrossfaderID; //!< highest crossfaderID handed out so far
+    uint16_t mCurrentConnectionID; //!< highest connectionID handed out so far
+    uint16_t mCurrentMainConnectionID; //!< highest mainConnectionID handed out so far
+    uint16_t mCurrentSinkClassID; //!< highest sinkClassID handed out so far
+    uint16_t mCurrentSourceClassID; //!< highest sourceClassID handed out so far
+    uint16_t mTransactionDepth; //!< number of open beginTransaction calls
+};
+
+}
+
+#endif /* DATABASEHANDLERMAP_H_ */
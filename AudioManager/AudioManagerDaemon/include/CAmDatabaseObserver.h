@@ -23,7 +23,10 @@
 #define DATABASEOBSERVER_H_
 
 #include "audiomanagertypes.h"
-#include <queue>
+#include <deque>
+#include <map>
+#include <vector>
+#include <time.h>
 #include "shared/CAmSerializer.h"
 
 namespace am
@@ -32,16 +35,25 @@ namespace am
 class CAmTelnetServer;
 class CAmCommandSender;
 class CAmRoutingSender;
+class CAmRouter;
 class CAmSocketHandler;
 
 /**
  * This class observes the Database and notifies other classes about important events, mainly the CommandSender.
+ * While the database is in a transaction, the notifications to the CommandSender are collected and sent when the
+ * transaction is committed. Sinks and sources that are added and removed again within one transaction are not reported.
+ * The value changes and main connection notifications of the transaction are held in their order and sent after the new
+ * sinks and sources, so the CommandSender never hears about a sink or source before it is announced.
+ * The RoutingSender and the Router are always updated right away, because they are needed to complete the transaction.
+ * Value changes (volumes, mute states, availabilities, sound and system properties, timing information) are collected
+ * until the mainloop dispatches them, and only the last value per sink, source or property is sent. Before any other
+ * notification is sent the collected values are closed, so the CommandSender gets the changes in the order they happened.
  */
 class CAmDatabaseObserver
 {
 public:
-    CAmDatabaseObserver(CAmCommandSender *iCommandSender, CAmRoutingSender *iRoutingSender, CAmSocketHandler *iSocketHandler);
-    CAmDatabaseObserver(CAmCommandSender *iCommandSender, CAmRoutingSender *iRoutingSender, CAmSocketHandler *iSocketHandler, CAmTelnetServer *iTelnetServer);
+    CAmDatabaseObserver(CAmCommandSender *iCommandSender, CAmRoutingSender *iRoutingSender, CAmRouter *iRouter, CAmSocketHandler *iSocketHandler);
+    CAmDatabaseObserver(CAmCommandSender *iCommandSender, CAmRoutingSender *iRoutingSender, CAmRouter *iRouter, CAmSocketHandler *iSocketHandler, CAmTelnetServer *iTelnetServer);
     ~CAmDatabaseObserver();
     void numberOfSinkClassesChanged();
     void numberOfSourceClassesChanged();
@@ -57,6 +69,8 @@ public:
     void removeDomain(const am_domainID_t domainID);
     void removeGateway(const am_gatewayID_t gatewayID);
     void removeCrossfader(const am_crossfaderID_t crossfaderID);
+    void newConnection(const am_Connection_s& connection);
+    void removedConnection(const am_connectionID_t connectionID);
     void mainConnectionStateChanged(const am_mainConnectionID_t connectionID, const am_ConnectionState_e connectionState);
     void mainSinkSoundPropertyChanged(const am_sinkID_t sinkID, const am_MainSoundProperty_s& SoundProperty);
     void mainSourceSoundPropertyChanged(const am_sourceID_t sourceID, const am_MainSoundProperty_s& SoundProperty);
@@ -66,12 +80,82 @@ public:
     void sinkMuteStateChanged(const am_sinkID_t sinkID, const am_MuteState_e muteState);
     void systemPropertyChanged(const am_SystemProperty_s& SystemProperty);
     void timingInformationChanged(const am_mainConnectionID_t mainConnection, const am_timeSync_t time);
+    void beginBatch();
+    void commitBatch();
+    void getChangeStatistics(uint32_t& delivered, uint32_t& dropped, uint64_t& maxDelayNs) const;
+    void getQueueStatistics(uint32_t& depth, uint32_t& maxDepth, uint32_t& calls) const;
+    void resetStatistics();
 
 private:
+    /**
+     * the kinds of notifications that are held back while the database is in a transaction
+     */
+    enum batchCall_e
+    {
+        BC_DELIVER_CHANGES, //!< dispatch of one entry of collected value changes
+        BC_NEW_MAIN_CONNECTION, //!< cbNewMainConnection
+        BC_REMOVED_MAIN_CONNECTION, //!< cbRemovedMainConnection
+        BC_MAIN_CONNECTION_STATE //!< cbMainConnectionStateChanged
+    };
+
+    /**
+     * one notification to the CommandSender that is sent when the transaction is committed
+     */
+    struct batchCall_s
+    {
+        batchCall_e type; //!< the kind of notification
+        am_MainConnectionType_s mainConnection; //!< the main connection, for BC_NEW_MAIN_CONNECTION
+        am_mainConnectionID_t mainConnectionID; //!< the main connection, for BC_REMOVED_MAIN_CONNECTION and BC_MAIN_CONNECTION_STATE
+        am_ConnectionState_e connectionState; //!< the new state, for BC_MAIN_CONNECTION_STATE
+    };
+
+    /**
+     * the value changes that are delivered with one mainloop dispatch, for each key only the last value is kept
+     */
+    struct pendingChanges_s
+    {
+        timespec created; //!< time of the first change, used to measure the delay
+        std::map<am_sinkID_t, am_mainVolume_t> mapVolumes; //!< main volumes by sink
+        std::map<am_sinkID_t, am_MuteState_e> mapMuteStates; //!< mute states by sink
+        std::map<am_sinkID_t, am_Availability_s> mapSinkAvailabilities; //!< availabilities by sink
+        std::map<am_sourceID_t, am_Availability_s> mapSourceAvailabilities; //!< availabilities by source
+        std::map<std::pair<am_sinkID_t, am_MainSoundPropertyType_e>, int16_t> mapSinkSoundProperties; //!< main sound property values by sink and type
+        std::map<std::pair<am_sourceID_t, am_MainSoundPropertyType_e>, int16_t> mapSourceSoundProperties; //!< main sound property values by source and type
+        std::map<am_SystemPropertyType_e, int16_t> mapSystemProperties; //!< system property values by type
+        std::map<am_mainConnectionID_t, am_timeSync_t> mapTimingInformation; //!< delays by main connection
+    };
+
+    pendingChanges_s& openChanges();
+    void closeChanges();
+    void queueCall(const batchCall_s& call);
+    void sendCall(const batchCall_s& call);
+    void deliverChanges();
+    template<class TKey, class TValue> void storeChange(std::map<TKey, TValue>& mapChanges, const TKey& key, const TValue& value);
+
+    am_SinkType_s* findBatchSink(const am_sinkID_t sinkID);
+    am_SourceType_s* findBatchSource(const am_sourceID_t sourceID);
+    void scheduleDeferredPlugins(const am_ConnectionState_e connectionState);
+    void startupDeferredPlugins();
+
     CAmCommandSender *mCommandSender; //!< pointer to the comandSender
     CAmRoutingSender* mRoutingSender; //!< pointer to the routingSender
+    CAmRouter* mRouter; //!< pointer to the router, it keeps its routing graph up to date with the changes
     CAmTelnetServer* mTelnetServer; //!< pointer to the telnetserver
     CAmSerializer mSerializer; //!< serializer to handle the CommandInterface via the mainloop
+    bool mBatch; //!< true while the database is in a transaction
+    bool mBatchSinkClassesChanged; //!< the number of sink classes changed during the transaction
+    bool mBatchSourceClassesChanged; //!< the number of source classes changed during the transaction
+    std::vector<am_SinkType_s> mBatchNewSinks; //!< visible sinks that were added during the transaction
+    std::vector<am_sinkID_t> mBatchRemovedSinks; //!< visible sinks that were removed during the transaction
+    std::vector<am_SourceType_s> mBatchNewSources; //!< visible sources that were added during the transaction
+    std::vector<am_sourceID_t> mBatchRemovedSources; //!< visible sources that were removed during the transaction
+    std::vector<batchCall_s> mListBatchCalls; //!< value change dispatches and main connection notifications of the transaction, in their order
+    std::deque<pendingChanges_s> mListPendingChanges; //!< collected value changes, one entry per scheduled dispatch
+    bool mChangesOpen; //!< true if the last entry of mListPendingChanges still takes changes
+    uint32_t mDeliveredChanges; //!< number of value changes sent to the CommandSender
+    uint32_t mDroppedChanges; //!< number of value changes that were replaced by a newer value before they were sent
+    uint64_t mMaxChangeDelayNs; //!< longest time between a change and its dispatch, in nanoseconds
+    bool mDeferredPluginsStarted; //!< true once the first main connection was connected and the deferred plugins were scheduled
 };
 
 }
@@ -0,0 +1,99 @@
+/**
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \author Christian Mueller, christian.ei.mueller@bmw.de BMW 2011,2012
+ *
+ * \file CAmDatabaseStatementCache.h
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#ifndef DATABASESTATEMENTCACHE_H_
+#define DATABASESTATEMENTCACHE_H_
+
+#include <map>
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include <time.h>
+#include <sqlite3.h>
+
+namespace am
+{
+
+/**
+ * Keeps compiled sqlite statements alive between calls of the CAmDatabaseHandler.
+ * A statement is looked up by its sql text, handed out and given back after use. On return it is reset and its bindings
+ * are cleared, so the next caller only needs to bind and step. If the same command is requested while it is still in use
+ * (nested queries), a temporary statement is prepared and finalized on return.
+ * The number of cached statements is limited, the least recently used one is dropped first.
+ */
+class CAmDatabaseStatementCache
+{
+public:
+    /**
+     * usage information of one sql command
+     */
+    struct statementStatistic_s
+    {
+        std::string command; //!< the sql text
+        uint32_t hits; //!< number of uses that found a compiled statement
+        uint32_t misses; //!< number of uses that had to compile the statement
+        uint64_t timeNs; //!< time spent between handing out and returning the statement, in nanoseconds
+    };
+
+    CAmDatabaseStatementCache(const size_t maxStatements);
+    ~CAmDatabaseStatementCache();
+    int prepare(sqlite3* database, const char* command, sqlite3_stmt** statement);
+    int release(sqlite3_stmt* statement);
+    void clear();
+    void getStatistics(std::vector<statementStatistic_s>& listStatistics) const;
+    void getTotals(uint32_t& hits, uint32_t& misses, uint32_t& evictions) const;
+    void resetStatistics();
+
+private:
+    struct statementEntry_s
+    {
+        sqlite3_stmt* statement; //!< the compiled statement
+        bool inUse; //!< true while the statement is handed out
+        uint64_t lastUse; //!< value of mUseCounter at the last use, used for eviction
+        uint32_t hits; //!< number of uses that found a compiled statement
+        uint32_t misses; //!< number of uses that had to compile the statement
+        uint64_t timeNs; //!< accumulated time of use in nanoseconds
+    };
+
+    struct activeStatement_s
+    {
+        std::string command; //!< the sql text the statement belongs to
+        timespec start; //!< time when the statement was handed out
+        bool cached; //!< false for temporary statements that are finalized on release
+    };
+
+    typedef std::map<std::string, statementEntry_s> StatementMap; //!< cached statements by sql text
+    typedef std::map<sqlite3_stmt*, activeStatement_s> ActiveMap; //!< statements that are handed out
+
+    void evict();
+
+    size_t mMaxStatements; //!< maximum number of cached statements
+    uint64_t mUseCounter; //!< counts all uses, gives the order of use for eviction
+    uint32_t mHits; //!< total number of hits
+    uint32_t mMisses; //!< total number of misses
+    uint32_t mEvictions; //!< total number of statements dropped because the cache was full
+    StatementMap mStatements; //!< the cached statements
+    ActiveMap mActive; //!< the statements that are in use
+};
+
+}
+
+#endif /* DATABASESTATEMENTCACHE_H_ */
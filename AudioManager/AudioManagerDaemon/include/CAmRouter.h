@@ -22,30 +22,132 @@
 #ifndef ROUTER_H_
 #define ROUTER_H_
 
+#include <bitset>
+#include <map>
+#include <vector>
 #include "audiomanagertypes.h"
 
 namespace am
 {
 
-class CAmDatabaseHandler;
+class IAmDatabaseHandler;
 class CAmControlSender;
 
 /**
  * Implements an autorouting algorithm for connecting sinks and sources via different audio domains.
+ * The router keeps its own graph of the domains and the gateways between them. The graph is read from the database once
+ * and then kept up to date by the CAmDatabaseObserver, so searching a route does not need to query the gateways.
+ * Connection formats are handled as bitsets: the formats of sinks and sources are cached and the conversion matrix of every
+ * gateway is turned into one set of output formats per input format when the gateway is added.
+ * Found routes are cached per onlyfree, source and sink. The cache is invalidated when gateways, domains, connections or the
+ * sink or source themselves change. The connection format choice of the controller is only asked when a route is calculated,
+ * a controller that changes its choice must call invalidateRoutes.
+ * By default all routes are returned in the order they are found. With setMaxRoutes the router searches only the cheapest
+ * routes instead, the cost of a route is made of its hops, the costs set per gateway and the format conversions it needs.
  */
 class CAmRouter
 {
 public:
-    CAmRouter(CAmDatabaseHandler* iDatabaseHandler, CAmControlSender* iSender);
+    CAmRouter(IAmDatabaseHandler* iDatabaseHandler, CAmControlSender* iSender);
     ~CAmRouter();
     am_Error_e getRoute(const bool onlyfree, const am_sourceID_t sourceID, const am_sinkID_t sinkID, std::vector<am_Route_s>& returnList);
+    void addGateway(const am_Gateway_s& gateway);
+    void removeGateway(const am_gatewayID_t gatewayID);
+    void addConnection(const am_Connection_s& connection);
+    void removeConnection(const am_connectionID_t connectionID);
+    void invalidateRoutes();
+    void invalidateRoutesOfSink(const am_sinkID_t sinkID);
+    void invalidateRoutesOfSource(const am_sourceID_t sourceID);
+    void getRouteCacheStatistics(uint32_t& hits, uint32_t& misses, uint32_t& invalidations, size_t& entries) const;
+    uint64_t getRouteCalculationTime() const;
+    void resetRouteCacheStatistics();
+    void setMaxRoutes(const uint16_t maxRoutes);
+    void setRouteCost(const uint16_t hopCost, const uint16_t conversionCost);
+    void setGatewayCost(const am_gatewayID_t gatewayID, const uint16_t latencyCost);
 
 private:
-    am_Error_e findBestWay(am_sinkID_t sinkID, am_sourceID_t sourceID, std::vector<am_RoutingElement_s>& listRoute, std::vector<am_RoutingElement_s>::iterator routeIterator, std::vector<am_gatewayID_t>::iterator gatewayIterator);
-    void listPossibleConnectionFormats(const am_sourceID_t sourceID, const am_sinkID_t sinkID, std::vector<am_ConnectionFormat_e>& listFormats) const;
-    void listRestrictedOutputFormatsGateways(const am_gatewayID_t gatewayID, const am_ConnectionFormat_e sinkConnectionFormat, std::vector<am_ConnectionFormat_e>& listFormats) const;
-    CAmDatabaseHandler* mpDatabaseHandler; //!< pointer to database handler
+    typedef std::bitset<CF_MAX> connectionFormatSet; //!< one bit per am_ConnectionFormat_e
+
+    /**
+     * the key of the route cache
+     */
+    struct routeCacheKey_s
+    {
+        bool onlyfree; //!< the onlyfree parameter of getRoute
+        am_sourceID_t sourceID; //!< the source of the route
+        am_sinkID_t sinkID; //!< the sink of the route
+        bool operator<(const routeCacheKey_s& other) const
+        {
+            if (onlyfree != other.onlyfree)
+                return (onlyfree < other.onlyfree);
+            if (sourceID != other.sourceID)
+                return (sourceID < other.sourceID);
+            return (sinkID < other.sinkID);
+        }
+    };
+
+    /**
+     * a gateway as an edge of the routing graph
+     */
+    struct routingGateway_s
+    {
+        am_gatewayID_t gatewayID; //!< the gatewayID
+        am_sinkID_t sinkID; //!< the sink of the gateway
+        am_sourceID_t sourceID; //!< the source of the gateway
+        am_domainID_t domainSinkID; //!< the domain the gateway sink is in
+        am_domainID_t domainSourceID; //!< the domain the gateway source is in
+        std::vector<connectionFormatSet> listConversion; //!< the source formats that can be reached, indexed by the sink format
+    };
+
+    /**
+     * a node of the routing tree that is searched for one getRoute call
+     */
+    struct routingNode_s
+    {
+        am_domainID_t domainID; //!< the domain that is reached with this node
+        am_gatewayID_t gatewayID; //!< the gateway that leads into the domain, 0 for the root
+        size_t parent; //!< the index of the parent node
+        uint32_t cost; //!< the cost of the way from the root to this node
+    };
+
+    typedef std::map<am_gatewayID_t, routingGateway_s> GatewayMap; //!< all gateways by ID
+    typedef std::map<am_domainID_t, std::vector<am_gatewayID_t> > DomainGatewayMap; //!< the gateways that lead out of a domain, sorted by ID
+    typedef std::map<routeCacheKey_s, std::vector<am_Route_s> > RouteCacheMap; //!< the found routes
+
+    am_Error_e calculateRoute(const bool onlyfree, const am_sourceID_t sourceID, const am_sinkID_t sinkID, std::vector<am_Route_s>& returnList);
+    am_Error_e calculateBestRoutes(const bool onlyfree, const am_sourceID_t sourceID, const am_sinkID_t sinkID, const am_domainID_t sourceDomainID, const am_domainID_t sinkDomainID, std::vector<am_Route_s>& returnList);
+    am_Error_e buildRoute(const am_sourceID_t sourceID, const am_sinkID_t sinkID, const am_domainID_t sourceDomainID, const am_domainID_t sinkDomainID, std::vector<am_gatewayID_t>& listGatewayID, am_Route_s& route);
+    static bool compareRouteCost(const std::pair<uint32_t, am_Route_s>& a, const std::pair<uint32_t, am_Route_s>& b);
+    void invalidateRoutesOnlyFree();
+    void buildRoutingTree(const bool onlyfree, const am_domainID_t rootDomainID, std::vector<routingNode_s>& listNodes) const;
+    bool isInRoutingTree(const std::vector<routingNode_s>& listNodes, size_t nodeIndex, const am_domainID_t domainID) const;
+    bool updateGatewaysInUse(const am_sinkID_t sinkID, const am_sourceID_t sourceID);
+    bool updateGatewayInUse(const routingGateway_s& gateway);
+    am_Error_e findBestWay(am_sinkID_t sinkID, am_sourceID_t sourceID, std::vector<am_RoutingElement_s>& listRoute, std::vector<am_RoutingElement_s>::iterator routeIterator, std::vector<am_gatewayID_t>::iterator gatewayIterator, const std::vector<connectionFormatSet>& listUsableFormats);
+    bool calculateUsableFormats(const std::vector<am_RoutingElement_s>& listRoute, const std::vector<am_gatewayID_t>& listGatewayID, std::vector<connectionFormatSet>& listUsableFormats);
+    connectionFormatSet possibleConnectionFormats(const am_sourceID_t sourceID, const am_sinkID_t sinkID);
+    connectionFormatSet convertedConnectionFormats(const am_gatewayID_t gatewayID, const am_ConnectionFormat_e sinkConnectionFormat) const;
+    static connectionFormatSet toFormatSet(const std::vector<am_ConnectionFormat_e>& listFormats);
+    static void toFormatList(const connectionFormatSet& formats, std::vector<am_ConnectionFormat_e>& listFormats);
+    IAmDatabaseHandler* mpDatabaseHandler; //!< pointer to database handler
     CAmControlSender* mpControlSender; //!< pointer the controlsender - is used to retrieve information for the optimal route
+    GatewayMap mGateways; //!< the edges of the routing graph
+    DomainGatewayMap mDomainGateways; //!< the adjacency list of the routing graph, keyed by the domain of the gateway sink
+    std::map<am_connectionID_t, std::pair<am_sinkID_t, am_sourceID_t> > mConnections; //!< sink and source of every connection
+    std::map<am_sinkID_t, uint16_t> mSinkConnectionCount; //!< number of connections per sink
+    std::map<am_sourceID_t, uint16_t> mSourceConnectionCount; //!< number of connections per source
+    std::vector<bool> mGatewayInUse; //!< one bit per gatewayID, set if the sink or the source of the gateway is connected
+    std::map<am_sinkID_t, connectionFormatSet> mSinkFormats; //!< cached connection formats of the sinks
+    std::map<am_sourceID_t, connectionFormatSet> mSourceFormats; //!< cached connection formats of the sources
+    RouteCacheMap mRouteCache; //!< routes that were already calculated
+    uint32_t mRouteCacheHits; //!< number of getRoute calls answered from the cache
+    uint32_t mRouteCacheMisses; //!< number of getRoute calls that had to calculate the routes
+    uint32_t mRouteCacheInvalidations; //!< number of cache entries that were dropped because of changes
+    uint64_t mRouteCalculationNs; //!< time spent calculating the routes of the cache misses
+    uint16_t mMaxRoutes; //!< the number of cheapest routes that are searched, 0 returns all routes
+    uint16_t mHopCost; //!< the cost of passing one gateway
+    uint16_t mConversionCost; //!< the cost of changing the connection format in a gateway
+    std::map<am_gatewayID_t, uint16_t> mGatewayCost; //!< additional cost per gateway, e.g. its latency
 };
 
 /**
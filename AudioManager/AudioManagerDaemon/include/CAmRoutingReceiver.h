@@ -23,13 +23,14 @@
 #define ROUTINGRECEIVER_H_
 
 #include "routing/IAmRoutingReceive.h"
+#include "shared/CAmSocketHandler.h"
 
 namespace am
 {
 
 class CAmSocketHandler;
 class CAmDbusWrapper;
-class CAmDatabaseHandler;
+class IAmDatabaseHandler;
 class CAmRoutingSender;
 class CAmControlSender;
 
@@ -39,8 +40,8 @@ class CAmControlSender;
 class CAmRoutingReceiver: public IAmRoutingReceive
 {
 public:
-    CAmRoutingReceiver(CAmDatabaseHandler *iDatabaseHandler, CAmRoutingSender *iRoutingSender, CAmControlSender *iControlSender, CAmSocketHandler *iSocketHandler);
-    CAmRoutingReceiver(CAmDatabaseHandler *iDatabaseHandler, CAmRoutingSender *iRoutingSender, CAmControlSender *iControlSender, CAmSocketHandler *iSocketHandler, CAmDbusWrapper *iDBusWrapper);
+    CAmRoutingReceiver(IAmDatabaseHandler *iDatabaseHandler, CAmRoutingSender *iRoutingSender, CAmControlSender *iControlSender, CAmSocketHandler *iSocketHandler);
+    CAmRoutingReceiver(IAmDatabaseHandler *iDatabaseHandler, CAmRoutingSender *iRoutingSender, CAmControlSender *iControlSender, CAmSocketHandler *iSocketHandler, CAmDbusWrapper *iDBusWrapper);
     ~CAmRoutingReceiver();
     void ackConnect(const am_Handle_s handle, const am_connectionID_t connectionID, const am_Error_e error);
     void ackDisconnect(const am_Handle_s handle, const am_connectionID_t connectionID, const am_Error_e error);
@@ -89,7 +90,10 @@ public:
     void waitOnRundown(bool rundown); //!< tells the RoutingReceiver to start waiting for all handles to be confirmed
 
 private:
-    CAmDatabaseHandler *mpDatabaseHandler; //!< pointer to the databaseHandler
+    void commitDomainRegistration();
+    void registrationTimerCallback(sh_timerHandle_t handle, void* userData);
+
+    IAmDatabaseHandler *mpDatabaseHandler; //!< pointer to the databaseHandler
     CAmRoutingSender *mpRoutingSender; //!< pointer to the routingSender
     CAmControlSender *mpControlSender; //!< pointer to the controlSender
     CAmSocketHandler *mpSocketHandler; //!< pointer to sockethandler
@@ -100,6 +104,9 @@ private:
     uint16_t handleCount; //!< counts all handles
     bool mWaitStartup; //!< if true confirmation will be sent if list of handles = 0
     bool mWaitRundown; //!< if true confirmation will be sent if list of handles = 0
+    bool mRegistrationOpen; //!< true while the transaction of a domain registration is open
+    sh_timerHandle_t mRegistrationTimer; //!< commits the transaction of a domain registration on the next mainloop iteration
+    TAmShTimerCallBack<CAmRoutingReceiver> mRegistrationTimerCallback; //!< callback of mRegistrationTimer
 
 };
 
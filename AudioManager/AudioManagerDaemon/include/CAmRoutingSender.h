@@ -24,6 +24,34 @@
 
 #include "routing/IAmRoutingSend.h"
 #include <map>
+#include <deque>
+#include "TAmPluginTemplate.h"
+
+/**
+ * number of buckets of the handle latency histograms. Bucket i counts the handles that took less than 2^i ms, the last
+ * bucket all slower ones.
+ */
+#define HANDLE_LATENCY_BUCKETS 12
+
+/**
+ * handles that need longer than this time in ms from their creation to their removal are logged
+ */
+#ifndef HANDLE_LATENCY_WARN_TIME
+#define HANDLE_LATENCY_WARN_TIME 500
+#endif
+
+/**
+ * handles are 12 bit wide and 0 is no valid handle, so this is the maximum number of handles in flight
+ */
+#define HANDLE_MAX_SLOTS 4095
+
+/**
+ * a released handle is only reused when at least this number of other handles was released after it, so a stale
+ * handle does not hit a new one of the same type right away
+ */
+#ifndef HANDLE_REUSE_DISTANCE
+#define HANDLE_REUSE_DISTANCE 64
+#endif
 
 #ifdef UNIT_TEST //this is needed to test RoutingSender
 #include "../test/IAmRoutingBackdoor.h"
@@ -40,10 +68,11 @@ class CAmRoutingReceiver;
 class CAmRoutingSender
 {
 public:
-    CAmRoutingSender(const std::vector<std::string>& listOfPluginDirectories);
+    CAmRoutingSender(const std::vector<std::string>& listOfPluginDirectories, const unsigned int loadThreads = 1, const std::vector<std::string>& listDeferredPlugins = std::vector<std::string>());
     ~CAmRoutingSender();
 
     am_Error_e removeHandle(const am_Handle_s& handle);
+    void traceHandleAck(const am_Handle_s& handle);
     am_Error_e addDomainLookup(const am_Domain_s& domainData);
     am_Error_e addSourceLookup(const am_Source_s& sourceData);
     am_Error_e addSinkLookup(const am_Sink_s& sinkData);
@@ -54,6 +83,7 @@ public:
     am_Error_e removeCrossfaderLookup(const am_crossfaderID_t crossfaderID);
 
     am_Error_e startupInterfaces(CAmRoutingReceiver* iRoutingReceiver);
+    am_Error_e startupDeferredInterfaces();
     void setRoutingReady();
     void setRoutingRundown();
     am_Error_e asyncAbort(const am_Handle_s& handle);
@@ -70,6 +100,8 @@ public:
     am_Error_e setDomainState(const am_domainID_t domainID, const am_DomainState_e domainState);
     am_Error_e getListHandles(std::vector<am_Handle_s> & listHandles) const;
     am_Error_e getListPlugins(std::vector<std::string>& interfaces) const;
+    void getPluginStartupTimes(std::vector<pluginStartup_s>& listStartup) const;
+    void traceReadyConfirm(const uint16_t handle);
     void getInterfaceVersion(std::string& version) const;
 
     struct InterfaceNamePairs //!< is used to pair interfaces with busnames
@@ -102,40 +134,68 @@ public:
 
     am_handleData_c returnHandleData(const am_Handle_s handle) const; //!< returns the handle data associated with a handle
 
+    struct handleStatistic_s //!< latencies of all finished handles of one type on one routing plugin
+    {
+        am_Handle_e handleType; //!< the type of the handles
+        std::string busName; //!< the busname of the plugin
+        uint32_t count; //!< number of finished handles
+        uint64_t dispatchNs; //!< sum of the time spent in the async call of the plugin
+        uint64_t pluginNs; //!< sum of the time from the return of the async call to the ack
+        uint64_t storeNs; //!< sum of the time from the ack to the removal of the handle, mostly the database update
+        uint64_t maxNs; //!< longest time from creation to removal
+        uint32_t histogram[HANDLE_LATENCY_BUCKETS]; //!< time from creation to removal, see HANDLE_LATENCY_BUCKETS
+    };
+
+    void getHandleStatistics(std::vector<handleStatistic_s>& listStatistics) const;
+    void getOutstandingHandles(std::vector<uint16_t>& listCounts) const;
+    void getOutstandingHandlesOfPlugins(std::map<std::string, uint16_t>& mapCounts) const;
+    void resetHandleStatistics();
+
 #ifdef UNIT_TEST //this is needed to test RoutingSender
     friend class IAmRoutingBackdoor;
 #endif
 
 private:
-    struct comparator //!< is needed to sort the handles in the map
+    struct handleSlot_s //!< one entry of the handle table, the handle is the index + 1
     {
-        bool operator()(const am_Handle_s& a, const am_Handle_s& b) const
-        {
-            return (a.handle < b.handle);
-        }
+        am_Handle_e handleType; //!< the type of the handle, H_UNKNOWN if the slot is free
+        am_handleData_c handleData; //!< the data of the handle
+        IAmRoutingSend* routingInterface; //!< the plugin that handles the handle
+        uint64_t created; //!< creation of the handle
+        uint64_t dispatched; //!< return of the async call of the plugin, 0 if not yet returned
+        uint64_t acked; //!< arrival of the ack, 0 if not yet acked
     };
 
-    am_Handle_s createHandle(const am_handleData_c& handleData, const am_Handle_e type); //!< creates a handle
+    am_Handle_s createHandle(const am_handleData_c& handleData, const am_Handle_e type, IAmRoutingSend* routingInterface); //!< creates a handle
+    handleSlot_s* findHandle(const am_Handle_s& handle); //!< returns the slot of an active handle or NULL
+    void releaseSlot(const am_Handle_s& handle, handleSlot_s& slot); //!< frees the slot of a handle
+    am_Error_e handleDispatched(const am_Handle_s& handle, const am_Error_e error); //!< stamps the return of the async call
+    void finishTrace(const am_Handle_s& handle, const handleSlot_s& slot); //!< adds the trace of a removed handle to the statistics
     void unloadLibraries(void); //!< unloads all loaded plugins
+    void loadInterfaces(const std::vector<std::string>& listLibraries, const bool deferred); //!< loads plugins and appends them to mListInterfaces
 
     typedef std::map<am_domainID_t, IAmRoutingSend*> DomainInterfaceMap; //!< maps domains to interfaces
     typedef std::map<am_sinkID_t, IAmRoutingSend*> SinkInterfaceMap; //!< maps sinks to interfaces
     typedef std::map<am_sourceID_t, IAmRoutingSend*> SourceInterfaceMap; //!< maps sources to interfaces
     typedef std::map<am_crossfaderID_t, IAmRoutingSend*> CrossfaderInterfaceMap; //!< maps crossfaders to interfaces
     typedef std::map<am_connectionID_t, IAmRoutingSend*> ConnectionInterfaceMap; //!< maps connections to interfaces
-    typedef std::map<uint16_t, IAmRoutingSend*> HandleInterfaceMap; //!< maps handles to interfaces
-    typedef std::map<am_Handle_s, am_handleData_c, comparator> HandlesMap; //!< maps handleData to handles
+    typedef std::map<std::pair<IAmRoutingSend*, am_Handle_e>, handleStatistic_s> HandleStatisticMap; //!< maps plugin and handle type to statistics
 
-    int16_t mHandleCount; //!< is used to create handles
-    HandlesMap mlistActiveHandles; //!< list of all currently "running" handles.
+    std::vector<handleSlot_s> mListHandleSlots; //!< the handle table, grows up to HANDLE_MAX_SLOTS
+    std::deque<uint16_t> mListFreeSlots; //!< indices of the free slots, oldest first
+    std::vector<uint16_t> mListOutstandingHandles; //!< number of active handles per am_Handle_e
     std::vector<void*> mListLibraryHandles; //!< list of all loaded pluginInterfaces
     std::vector<InterfaceNamePairs> mListInterfaces; //!< list of busname/interface relation
+    std::vector<pluginStartup_s> mListPluginStartup; //!< startup timeline, same order as mListInterfaces
+    std::vector<std::string> mListDeferredLibraries; //!< libraries that are loaded after the first main connection
+    unsigned int mLoadThreads; //!< number of threads that load the plugins
+    bool mRoutingReady; //!< true after setRoutingReady, deferred plugins get their ready right after their startup
     ConnectionInterfaceMap mMapConnectionInterface; //!< map of connection to interfaces
     CrossfaderInterfaceMap mMapCrossfaderInterface; //!< map of crossfaders to interface
     DomainInterfaceMap mMapDomainInterface; //!< map of domains to interfaces
     SinkInterfaceMap mMapSinkInterface; //!< map of sinks to interfaces
     SourceInterfaceMap mMapSourceInterface; //!< map of sources to interfaces
-    HandleInterfaceMap mMapHandleInterface; //!< map of handles to interfaces
+    HandleStatisticMap mMapHandleStatistics; //!< latencies of the finished handles
     CAmRoutingReceiver *mpRoutingReceiver; //!< pointer to routing receiver
 };
 
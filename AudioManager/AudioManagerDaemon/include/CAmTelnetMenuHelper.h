@@ -32,13 +32,15 @@
 #include <sstream>
 #include <vector>
 #include <sys/socket.h>
+#include <time.h>
 #include "audiomanagertypes.h"
+#include "shared/CAmSocketHandler.h"
 
 namespace am
 {
 
 class CAmTelnetServer;
-class CAmDatabaseHandler;
+class IAmDatabaseHandler;
 class CAmCommandSender;
 class CAmRoutingSender;
 class CAmControlSender;
@@ -47,7 +49,7 @@ class CAmRoutingReceiver;
 class CAmControlReceiver;
 
 class CAmRouter;
-class CAmSocketHandler;
+class CAmDatabaseObserver;
 
 /**
  * helper class for CAmTelnetServer
@@ -58,10 +60,10 @@ public:
 
     enum EMainState
     {
-        eRootState = 0, eListState, eInfoState, eGetState, eSetState
+        eRootState = 0, eListState, eInfoState, eGetState, eSetState, ePerfState
     };
 
-    CAmTelnetMenuHelper(CAmSocketHandler *iSocketHandler, CAmCommandSender *iCommandSender, CAmCommandReceiver *iCommandReceiver, CAmRoutingSender *iRoutingSender, CAmRoutingReceiver *iRoutingReceiver, CAmControlSender *iControlSender, CAmControlReceiver *iControlReceiver, CAmDatabaseHandler *iDatabasehandler, CAmRouter *iRouter, CAmTelnetServer *iTelnetServer);
+    CAmTelnetMenuHelper(CAmSocketHandler *iSocketHandler, CAmCommandSender *iCommandSender, CAmCommandReceiver *iCommandReceiver, CAmRoutingSender *iRoutingSender, CAmRoutingReceiver *iRoutingReceiver, CAmControlSender *iControlSender, CAmControlReceiver *iControlReceiver, IAmDatabaseHandler *iDatabasehandler, CAmRouter *iRouter, CAmTelnetServer *iTelnetServer);
 
     ~CAmTelnetMenuHelper();
 
@@ -71,6 +73,11 @@ public:
 
     void enterCmdQueue(std::queue<std::string> &CmdQueue, int &filedescriptor);
 
+    void setDatabaseObserver(CAmDatabaseObserver *iDatabaseObserver);
+
+    void perfTimerCallback(sh_timerHandle_t handle, void* userData);
+    TAmShTimerCallBack<CAmTelnetMenuHelper> perfTimerCB;
+
 private:
 
     void createCommandMaps();
@@ -95,6 +102,8 @@ private:
     void rootListCommandExec(std::queue<std::string> & CmdQueue, int & filedescriptor);
     static void rootInfoCommand(std::queue<std::string> & CmdQueue, int & filedescriptor);
     void rootInfoCommandExec(std::queue<std::string> & CmdQueue, int & filedescriptor);
+    static void rootPerfCommand(std::queue<std::string> & CmdQueue, int & filedescriptor);
+    void rootPerfCommandExec(std::queue<std::string> & CmdQueue, int & filedescriptor);
 
     // LIST commands
     static void listConnectionsCommand(std::queue<std::string> & CmdQueue, int & filedescriptor);
@@ -149,9 +158,42 @@ private:
     // INFO commands
     static void infoSystempropertiesCommand(std::queue<std::string> & CmdQueue, int & filedescriptor);
     void infoSystempropertiesCommandExec(std::queue<std::string> & CmdQueue, int & filedescriptor);
+    static void infoRouteCacheCommand(std::queue<std::string> & CmdQueue, int & filedescriptor);
+    void infoRouteCacheCommandExec(std::queue<std::string> & CmdQueue, int & filedescriptor);
+    static void infoHandlesCommand(std::queue<std::string> & CmdQueue, int & filedescriptor);
+    void infoHandlesCommandExec(std::queue<std::string> & CmdQueue, int & filedescriptor);
+
+    // PERF commands
+    static void perfShowCommand(std::queue<std::string> & CmdQueue, int & filedescriptor);
+    void perfShowCommandExec(std::queue<std::string> & CmdQueue, int & filedescriptor);
+    static void perfResetCommand(std::queue<std::string> & CmdQueue, int & filedescriptor);
+    void perfResetCommandExec(std::queue<std::string> & CmdQueue, int & filedescriptor);
+    static void perfStreamCommand(std::queue<std::string> & CmdQueue, int & filedescriptor);
+    void perfStreamCommandExec(std::queue<std::string> & CmdQueue, int & filedescriptor);
 
 private:
 
+    struct perfCounters_s //!< totals of the counters that are shown as rates
+    {
+        timespec time; //!< when the counters were taken
+        uint32_t statements; //!< executed database statements
+        uint32_t routeCalculations; //!< calculated routes
+        uint32_t wakeups; //!< wakeups of the mainloop
+        uint64_t busyNs; //!< time the mainloop spent in callbacks, in nanoseconds
+        uint32_t serializerCalls; //!< calls executed by the serializer of the database observer
+        uint32_t finishedHandles; //!< handles that were acknowledged and removed
+    };
+
+    struct perfSession_s //!< perf state of one telnet session
+    {
+        perfCounters_s counters; //!< counters of the last output, the rates are calculated against them
+        sh_timerHandle_t timer; //!< timer of the periodic output, 0 if the session is not streaming
+    };
+
+    void collectPerfCounters(perfCounters_s& counters) const;
+    void writePerfCounters(const int filedescriptor, std::stringstream& output);
+    void stopPerfStream(const int filedescriptor);
+
     typedef void (*pCommandPrototype)(std::queue<std::string>& msg, int & filedescriptor);
 
     struct sCommandPrototypeInfo
@@ -184,14 +226,17 @@ private:
     CAmRoutingReceiver *mpRoutingReceiver;
     CAmControlSender *mpControlSender;
     CAmControlReceiver *mpControlReceiver;
-    CAmDatabaseHandler *mpDatabasehandler;
+    IAmDatabaseHandler *mpDatabasehandler;
     CAmRouter *mpRouter;
+    CAmDatabaseObserver *mpDatabaseObserver;
+    std::map<int, perfSession_s> mMapPerfSessions; //!< int filedescriptor of socket connection; perf state of the telnet session
 
     tCommandMap mRootCommands;
     tCommandMap mListCommands;
     tCommandMap mGetCommands;
     tCommandMap mSetCommands;
     tCommandMap mInfoCommands;
+    tCommandMap mPerfCommands;
 
 };
 // class CAmTelnetMenuHelper
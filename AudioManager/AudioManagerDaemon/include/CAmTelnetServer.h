@@ -31,7 +31,7 @@
 namespace am
 {
 
-class CAmDatabaseHandler;
+class IAmDatabaseHandler;
 class CAmCommandSender;
 class CAmRoutingSender;
 class CAmControlSender;
@@ -39,6 +39,7 @@ class CAmCommandReceiver;
 class CAmRoutingReceiver;
 class CAmControlReceiver;
 class CAmRouter;
+class CAmDatabaseObserver;
 class CAmTelnetMenuHelper;
 
 /**
@@ -50,10 +51,11 @@ class CAmTelnetMenuHelper;
 class CAmTelnetServer
 {
 public:
-    CAmTelnetServer(CAmSocketHandler *iSocketHandler, CAmCommandSender *iCommandSender, CAmCommandReceiver *iCommandReceiver, CAmRoutingSender *iRoutingSender, CAmRoutingReceiver *iRoutingReceiver, CAmControlSender *iControlSender, CAmControlReceiver *iControlReceiver, CAmDatabaseHandler *iDatabasehandler, CAmRouter *iRouter, unsigned int servPort, unsigned int maxConnections);
+    CAmTelnetServer(CAmSocketHandler *iSocketHandler, CAmCommandSender *iCommandSender, CAmCommandReceiver *iCommandReceiver, CAmRoutingSender *iRoutingSender, CAmRoutingReceiver *iRoutingReceiver, CAmControlSender *iControlSender, CAmControlReceiver *iControlReceiver, IAmDatabaseHandler *iDatabasehandler, CAmRouter *iRouter, unsigned int servPort, unsigned int maxConnections);
     ~CAmTelnetServer();
     void connectSocket(const pollfd pfd, const sh_pollHandle_t handle, void* userData);
     void disconnectClient(int filedescriptor);
+    void setDatabaseObserver(CAmDatabaseObserver *iDatabaseObserver);
     void receiveData(const pollfd pfd, const sh_pollHandle_t handle, void* userData);
     bool dispatchData(const sh_pollHandle_t handle, void* userData);
     bool check(const sh_pollHandle_t handle, void* userData);
@@ -82,7 +84,7 @@ private:
     CAmRoutingReceiver *mpRoutingReceiver;
     CAmControlSender *mpControlSender;
     CAmControlReceiver *mpControlReceiver;
-    CAmDatabaseHandler *mpDatabasehandler;
+    IAmDatabaseHandler *mpDatabasehandler;
     CAmRouter *mpRouter;
     sh_pollHandle_t mConnecthandle;
     std::queue<std::string> mListMessages;
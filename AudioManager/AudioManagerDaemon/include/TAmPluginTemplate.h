@@ -24,6 +24,10 @@
 
 #include <dlfcn.h>
 #include <libgen.h>
+#include <pthread.h>
+#include <time.h>
+#include <string>
+#include <vector>
 #include "shared/CAmDltWrapper.h"
 
 namespace am
@@ -85,6 +89,132 @@ template<class T> T* getCreateFunction(const std::string& libname, void*& librar
     return (createFunction);
 }
 
+/**
+ * the startup timeline of one plugin. All times are CLOCK_MONOTONIC in nanoseconds, so they count from the boot of the
+ * system.
+ */
+struct pluginStartup_s
+{
+    std::string name; //!< the library of the plugin
+    bool deferred; //!< true if the plugin was loaded after the first main connection was connected
+    uint64_t loadNs; //!< when the library was opened
+    uint64_t createdNs; //!< when the factory of the plugin returned
+    uint64_t startupNs; //!< when startupInterface returned, 0 if not yet started
+    uint64_t readyNs; //!< when the plugin confirmed ready, 0 if not yet confirmed or not tracked
+    uint16_t readyHandle; //!< the startup handle the plugin confirms, 0 if ready was not yet set
+};
+
+/**
+ * returns the current CLOCK_MONOTONIC time in nanoseconds
+ */
+inline uint64_t pluginClockNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec);
+}
+
+/**
+ * loads a list of plugins with a number of threads. Opening the libraries and calling the factories of independent
+ * plugins does not touch the daemon, so it can run in parallel. Everything that calls back into the daemon, like
+ * startupInterface, has to be done afterwards on the mainloop thread.
+ */
+template<class T> class TAmPluginLoader
+{
+public:
+    /**
+     * the result of loading one library
+     */
+    struct load_s
+    {
+        std::string libname; //!< full path of the library
+        void* libraryHandle; //!< the handle of dlopen, NULL if loading failed
+        T* plugin; //!< the instance the factory created, NULL if loading failed
+        uint64_t loadNs; //!< when loading started
+        uint64_t createdNs; //!< when the factory returned
+    };
+
+    /**
+     * loads the libraries, the results keep the order of the list
+     * @param listLibraries full paths of the libraries
+     * @param threads number of loader threads, 0 and 1 load on the calling thread
+     * @param listLoaded the results
+     */
+    static void load(const std::vector<std::string>& listLibraries, const unsigned int threads, std::vector<load_s>& listLoaded)
+    {
+        listLoaded.resize(listLibraries.size());
+        for (size_t i = 0; i < listLibraries.size(); i++)
+        {
+            listLoaded[i].libname = listLibraries[i];
+            listLoaded[i].libraryHandle = NULL;
+            listLoaded[i].plugin = NULL;
+            listLoaded[i].loadNs = 0;
+            listLoaded[i].createdNs = 0;
+        }
+
+        TAmPluginLoader loader(listLoaded);
+        std::vector<pthread_t> listThreads;
+        for (unsigned int i = 1; i < threads && i < listLoaded.size(); i++)
+        {
+            pthread_t thread;
+            if (pthread_create(&thread, NULL, &TAmPluginLoader::loaderThread, &loader) != 0)
+            {
+                logError("TAmPluginLoader::load could not create loader thread, loading with", listThreads.size() + 1, "threads");
+                break;
+            }
+            listThreads.push_back(thread);
+        }
+
+        //the calling thread loads as well
+        loader.run();
+        for (size_t i = 0; i < listThreads.size(); i++)
+            pthread_join(listThreads[i], NULL);
+    }
+
+private:
+    TAmPluginLoader(std::vector<load_s>& listLoaded) :
+            mListLoaded(listLoaded), //
+            mNext(0)
+    {
+    }
+
+    static void* loaderThread(void* data)
+    {
+        static_cast<TAmPluginLoader*>(data)->run();
+        return (NULL);
+    }
+
+    void run()
+    {
+        size_t index;
+        while ((index = __sync_fetch_and_add(&mNext, 1)) < mListLoaded.size())
+        {
+            load_s& loaded = mListLoaded[index];
+            loaded.loadNs = pluginClockNs();
+            T* (*createFunc)() = getCreateFunction<T*()>(loaded.libname, loaded.libraryHandle);
+            if (!createFunc && loaded.libraryHandle)
+            {
+                dlclose(loaded.libraryHandle);
+                loaded.libraryHandle = NULL;
+            }
+            else if (createFunc)
+            {
+                loaded.plugin = createFunc();
+                if (!loaded.plugin)
+                {
+                    logError("TAmPluginLoader::run factory of plugin failed", loaded.libname);
+                    dlclose(loaded.libraryHandle);
+                    loaded.libraryHandle = NULL;
+                }
+            }
+            loaded.createdNs = pluginClockNs();
+        }
+    }
+
+    std::vector<load_s>& mListLoaded; //!< the libraries and their results
+    volatile size_t mNext; //!< the next library to load
+};
+
 }
 
 #endif /* PLUGINTEMPLATE_H_ */
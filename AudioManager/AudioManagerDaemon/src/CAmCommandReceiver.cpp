@@ -22,7 +22,7 @@
 #include "CAmCommandReceiver.h"
 #include <cassert>
 #include <algorithm>
-#include "CAmDatabaseHandler.h"
+#include "IAmDatabaseHandler.h"
 #include "CAmControlSender.h"
 #include "shared/CAmDltWrapper.h"
 #include "shared/CAmSocketHandler.h"
@@ -30,7 +30,7 @@
 namespace am
 {
 
-CAmCommandReceiver::CAmCommandReceiver(CAmDatabaseHandler *iDatabaseHandler, CAmControlSender *iControlSender, CAmSocketHandler *iSocketHandler) :
+CAmCommandReceiver::CAmCommandReceiver(IAmDatabaseHandler *iDatabaseHandler, CAmControlSender *iControlSender, CAmSocketHandler *iSocketHandler) :
         mDatabaseHandler(iDatabaseHandler), //
         mControlSender(iControlSender), //
         mDBusWrapper(NULL), //
@@ -47,7 +47,7 @@ CAmCommandReceiver::CAmCommandReceiver(CAmDatabaseHandler *iDatabaseHandler, CAm
     assert(mControlSender!=NULL);
 }
 
-CAmCommandReceiver::CAmCommandReceiver(CAmDatabaseHandler *iDatabaseHandler, CAmControlSender *iControlSender, CAmSocketHandler *iSocketHandler, CAmDbusWrapper *iDBusWrapper) :
+CAmCommandReceiver::CAmCommandReceiver(IAmDatabaseHandler *iDatabaseHandler, CAmControlSender *iControlSender, CAmSocketHandler *iSocketHandler, CAmDbusWrapper *iDBusWrapper) :
         mDatabaseHandler(iDatabaseHandler), //
         mControlSender(iControlSender), //
         mDBusWrapper(iDBusWrapper), //
@@ -188,7 +188,11 @@ void CAmCommandReceiver::confirmCommandReady(const uint16_t handle)
 {
     mListStartupHandles.erase(std::remove(mListStartupHandles.begin(), mListStartupHandles.end(), handle), mListStartupHandles.end());
     if (mWaitStartup && mListStartupHandles.empty())
+    {
+        //the controller is told only once, deferred plugins that confirm later do not start the commands again
+        mWaitStartup = false;
         mControlSender->confirmCommandReady();
+    }
 }
 
 void CAmCommandReceiver::confirmCommandRundown(const uint16_t handle)
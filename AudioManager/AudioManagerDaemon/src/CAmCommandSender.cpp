@@ -21,8 +21,11 @@
 
 #include "CAmCommandSender.h"
 #include <dirent.h>
+#include <algorithm>
+#include <cassert>
 #include <sstream>
 #include <string>
+#include <time.h>
 #include "CAmCommandReceiver.h"
 #include "TAmPluginTemplate.h"
 #include "shared/CAmDltWrapper.h"
@@ -33,20 +36,40 @@ namespace am
 #define REQUIRED_INTERFACE_VERSION_MAJOR 1  //!< major interface version. All versions smaller than this will be rejected
 #define REQUIRED_INTERFACE_VERSION_MINOR 0 //!< minor interface version. All versions smaller than this will be rejected
 /**
- *  macro to call all interfaces
+ *  macro to call all interfaces, the time spent in each plugin is added to its delivery statistic
  */
 #define CALL_ALL_INTERFACES(...) 														 \
-		std::vector<IAmCommandSend*>::iterator iter = mListInterfaces.begin();	         \
-		std::vector<IAmCommandSend*>::iterator iterEnd = mListInterfaces.end();	         \
-		for (; iter<iterEnd;++iter)													 	 \
+		mListDeliveryStatistics.resize(mListInterfaces.size());						 	 \
+		timespec start, end;														 	 \
+		for (size_t i = 0; i < mListInterfaces.size(); ++i)							 	 \
 		{																				 \
-			(*iter)->__VA_ARGS__;													 	 \
+			clock_gettime(CLOCK_MONOTONIC, &start);									 	 \
+			mListInterfaces[i]->__VA_ARGS__;										 	 \
+			clock_gettime(CLOCK_MONOTONIC, &end);									 	 \
+			addDelivery(mListDeliveryStatistics[i], start, end);					 	 \
 		}
 
-CAmCommandSender::CAmCommandSender(const std::vector<std::string>& listOfPluginDirectories) :
+/**
+ * adds one callback to a delivery statistic
+ */
+static void addDelivery(CAmCommandSender::deliveryStatistic_s& statistic, const timespec& start, const timespec& end)
+{
+    uint64_t timeNs((end.tv_sec - start.tv_sec) * 1000000000ULL + end.tv_nsec - start.tv_nsec);
+    statistic.calls++;
+    statistic.timeNs += timeNs;
+    if (timeNs > statistic.maxTimeNs)
+        statistic.maxTimeNs = timeNs;
+}
+
+CAmCommandSender::CAmCommandSender(const std::vector<std::string>& listOfPluginDirectories, const unsigned int loadThreads, const std::vector<std::string>& listDeferredPlugins) :
         mListInterfaces(), //
         mListLibraryHandles(), //
         mListLibraryNames(), //
+        mListDeliveryStatistics(), //
+        mListPluginStartup(), //
+        mListDeferredLibraries(), //
+        mLoadThreads(loadThreads), //
+        mCommandReady(false), //
         mCommandReceiver()
 {
     std::vector<std::string> sharedLibraryNameList;
@@ -79,35 +102,39 @@ CAmCommandSender::CAmCommandSender(const std::vector<std::string>& listOfPluginD
             if (regularFile && sharedLibExtension)
             {
                 std::string name(directoryName);
-                sharedLibraryNameList.push_back(name + "/" + entryName);
+                if (std::find(listDeferredPlugins.begin(), listDeferredPlugins.end(), entryName) != listDeferredPlugins.end())
+                {
+                    logInfo("Deferring CommandSender plugin", entryName);
+                    mListDeferredLibraries.push_back(name + "/" + entryName);
+                }
+                else
+                    sharedLibraryNameList.push_back(name + "/" + entryName);
             }
         }
         closedir(directory);
     }
 
-    // iterate all communicator plugins and start them
-    std::vector<std::string>::iterator iter = sharedLibraryNameList.begin();
-    std::vector<std::string>::iterator iterEnd = sharedLibraryNameList.end();
-
-    for (; iter < iterEnd; ++iter)
-    {
-        logInfo("Loading CommandSender plugin", *iter);
-        IAmCommandSend* (*createFunc)();
-        void* tempLibHandle = NULL;
-        createFunc = getCreateFunction<IAmCommandSend*()>(*iter, tempLibHandle);
-
-        if (!createFunc)
-        {
-            logInfo("Entry point of CommandPlugin not found", *iter);
-            continue;
-        }
+    loadInterfaces(sharedLibraryNameList, false);
+}
 
-        IAmCommandSend* commander = createFunc();
+/**
+ * loads plugins with mLoadThreads threads and appends the ones that are usable to mListInterfaces
+ * @param listLibraries full paths of the libraries
+ * @param deferred true if the plugins are loaded after the first main connection
+ */
+void CAmCommandSender::loadInterfaces(const std::vector<std::string>& listLibraries, const bool deferred)
+{
+    std::vector<TAmPluginLoader<IAmCommandSend>::load_s> listLoaded;
+    TAmPluginLoader<IAmCommandSend>::load(listLibraries, mLoadThreads, listLoaded);
 
+    //the checks are done in the order of the list, so the order of the interfaces does not depend on the threads
+    std::vector<TAmPluginLoader<IAmCommandSend>::load_s>::iterator iter = listLoaded.begin();
+    for (; iter != listLoaded.end(); ++iter)
+    {
+        IAmCommandSend* commander = iter->plugin;
         if (!commander)
         {
-            logInfo("CommandPlugin initialization failed. Entry Function not callable");
-            dlclose(tempLibHandle);
+            logInfo("CommandPlugin could not be loaded", iter->libname);
             continue;
         }
 
@@ -121,13 +148,24 @@ CAmCommandSender::CAmCommandSender(const std::vector<std::string>& listOfPluginD
         if (majorVersion < REQUIRED_INTERFACE_VERSION_MAJOR || ((majorVersion == REQUIRED_INTERFACE_VERSION_MAJOR) && (minorVersion > REQUIRED_INTERFACE_VERSION_MINOR)))
         {
             logInfo("CommandInterface initialization failed. Version of Interface to old");
-            dlclose(tempLibHandle);
+            dlclose(iter->libraryHandle);
             continue;
         }
 
         mListInterfaces.push_back(commander);
-        mListLibraryHandles.push_back(tempLibHandle);
-        mListLibraryNames.push_back(iter->c_str());
+        mListLibraryHandles.push_back(iter->libraryHandle);
+        mListLibraryNames.push_back(iter->libname);
+
+        pluginStartup_s startup;
+        startup.name = iter->libname;
+        startup.deferred = deferred;
+        startup.loadNs = iter->loadNs;
+        startup.createdNs = iter->createdNs;
+        startup.startupNs = 0;
+        startup.readyNs = 0;
+        startup.readyHandle = 0;
+        mListPluginStartup.push_back(startup);
+        logInfo("Loaded CommandSender plugin", iter->libname, "in", (iter->createdNs - iter->loadNs) / 1000, "us");
     }
 }
 
@@ -141,15 +179,49 @@ am_Error_e CAmCommandSender::startupInterfaces(CAmCommandReceiver *iCommandRecei
     mCommandReceiver = iCommandReceiver;
     am_Error_e returnError = E_OK;
 
-    std::vector<IAmCommandSend*>::iterator iter = mListInterfaces.begin();
-    std::vector<IAmCommandSend*>::iterator iterEnd = mListInterfaces.end();
-    for (; iter < iterEnd; ++iter)
+    for (size_t i = 0; i < mListInterfaces.size(); i++)
+    {
+        am_Error_e error = mListInterfaces[i]->startupInterface(iCommandReceiver);
+        if (error != E_OK)
+        {
+            returnError = error;
+        }
+        if (i < mListPluginStartup.size())
+            mListPluginStartup[i].startupNs = pluginClockNs();
+    }
+    return (returnError);
+}
+
+/**
+ * loads and starts the plugins that were deferred to the first main connection. If the commands are already ready, the
+ * new plugins get their setCommandReady right after their startup.
+ * @return E_OK or the last error of startupInterface
+ */
+am_Error_e CAmCommandSender::startupDeferredInterfaces()
+{
+    if (mListDeferredLibraries.empty())
+        return (E_OK);
+    assert(mCommandReceiver!=NULL);
+
+    logInfo("CommandSender::startupDeferredInterfaces loading", mListDeferredLibraries.size(), "deferred plugins");
+    size_t first = mListInterfaces.size();
+    loadInterfaces(mListDeferredLibraries, true);
+    mListDeferredLibraries.clear();
+
+    am_Error_e returnError = E_OK;
+    for (size_t i = first; i < mListInterfaces.size(); i++)
     {
-        am_Error_e error = (*iter)->startupInterface(iCommandReceiver);
+        am_Error_e error = mListInterfaces[i]->startupInterface(mCommandReceiver);
         if (error != E_OK)
         {
             returnError = error;
         }
+        mListPluginStartup[i].startupNs = pluginClockNs();
+        if (mCommandReady)
+        {
+            mListPluginStartup[i].readyHandle = mCommandReceiver->getStartupHandle();
+            mListInterfaces[i]->setCommandReady(mListPluginStartup[i].readyHandle);
+        }
     }
     return (returnError);
 }
@@ -254,17 +326,18 @@ void CAmCommandSender::setCommandReady()
     mCommandReceiver->waitOnStartup(true);
 
     //now do the calls
-    std::vector<IAmCommandSend*>::iterator iter = mListInterfaces.begin();
-    std::vector<IAmCommandSend*>::iterator iterEnd = mListInterfaces.end();
-    std::vector<uint16_t>::const_iterator handleIter(listStartupHandles.begin());
-    for (; iter < iterEnd; ++iter)
+    mCommandReady = true;
+    for (size_t i = 0; i < mListInterfaces.size(); i++)
     {
-        (*iter)->setCommandReady(*(handleIter++));
+        if (i < mListPluginStartup.size())
+            mListPluginStartup[i].readyHandle = listStartupHandles[i];
+        mListInterfaces[i]->setCommandReady(listStartupHandles[i]);
     }
 }
 
 void CAmCommandSender::setCommandRundown()
 {
+    mCommandReady = false;
     mCommandReceiver->waitOnRundown(false);
     //create a list of handles
     std::vector<uint16_t> listStartupHandles;
@@ -297,6 +370,33 @@ am_Error_e am::CAmCommandSender::getListPlugins(std::vector<std::string> & inter
     return (E_OK);
 }
 
+/**
+ * returns the startup timeline of the loaded plugins, see pluginStartup_s. The ready time is not tracked for command
+ * plugins.
+ * @param listStartup the timeline, in the order of getListPlugins
+ */
+void CAmCommandSender::getPluginStartupTimes(std::vector<pluginStartup_s>& listStartup) const
+{
+    listStartup = mListPluginStartup;
+}
+
+/**
+ * returns how many callbacks each plugin got and how long they took
+ * @param listStatistics one entry per plugin, in the order of getListPlugins
+ */
+void CAmCommandSender::getDeliveryStatistics(std::vector<deliveryStatistic_s>& listStatistics) const
+{
+    listStatistics = mListDeliveryStatistics;
+    listStatistics.resize(mListInterfaces.size());
+    for (size_t i = 0; i < listStatistics.size() && i < mListLibraryNames.size(); i++)
+        listStatistics[i].plugin = mListLibraryNames[i];
+}
+
+void CAmCommandSender::resetDeliveryStatistics()
+{
+    mListDeliveryStatistics.clear();
+}
+
 void CAmCommandSender::unloadLibraries(void)
 {
     std::vector<void*>::iterator iterator = mListLibraryHandles.begin();
@@ -21,6 +21,10 @@
 
 #include "CAmDatabaseHandler.h"
 #include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
 #include <stdexcept>
 #include <vector>
 #include <fstream>
@@ -34,64 +38,75 @@ namespace am
 {
 
 /**
- * Macro to handle SQLITE errors on prepare
+ * Macro to handle SQLITE errors on prepare, the statement is taken from the statement cache
  */
 #define MY_SQLITE_PREPARE_V2(db,zSql,nByte,ppStmt,pzTail)                                                               \
-        if ((eCode = sqlite3_prepare_v2(db, zSql, nByte, ppStmt, pzTail)))                                              \
+        if ((eCode = mStatementCache.prepare(db, zSql, ppStmt)))                                                   \
         {                                                                                                               \
             logError("CAmDatabaseHandler::my_sqlite_prepare_v2 on Command",zSql,"failed with errorCode:", eCode);       \
             return (E_DATABASE_ERROR);                                                                                  \
         }
 
 #define MY_SQLITE_PREPARE_V2_BOOL(db,zSql,nByte,ppStmt,pzTail)                                                          \
-        if ((eCode = sqlite3_prepare_v2(db, zSql, nByte, ppStmt, pzTail)))                                              \
+        if ((eCode = mStatementCache.prepare(db, zSql, ppStmt)))                                                   \
         {                                                                                                               \
             logError("CAmDatabaseHandler::my_sqlite_prepare_v2_bool on Command",zSql,"failed with errorCode:", eCode);       \
             return (false);                                                                                             \
         }
 
 /**
- * Macro to handle SQLITE errors bind text
+ * Macro to handle SQLITE errors bind text, on error the statement goes back into the statement cache
  */
 #define MY_SQLITE_BIND_TEXT(query,index,text,size,static_)                                                              \
         if ((eCode = sqlite3_bind_text(query, index, text, size, static_)))                                             \
         {                                                                                                               \
             logError("CAmDatabaseHandler::sqlite3_bind_text failed with errorCode:", eCode);                            \
+            mStatementCache.release(query);                                                                             \
             return (E_DATABASE_ERROR);                                                                                  \
         }
 
 /**
- * Macro to handle SQLITE errors on bind int
+ * Macro to handle SQLITE errors on bind int, on error the statement goes back into the statement cache
  */
 #define MY_SQLITE_BIND_INT(query, index, data)                                                                          \
         if((eCode = sqlite3_bind_int(query, index, data)))                                                              \
         {                                                                                                               \
             logError("CAmDatabaseHandler::sqlite3_bind_int failed with errorCode:", eCode);                             \
+            mStatementCache.release(query);                                                                             \
             return (E_DATABASE_ERROR);                                                                                  \
         }
 
+#define MY_SQLITE_BIND_INT_BOOL(query, index, data)                                                                     \
+        if((eCode = sqlite3_bind_int(query, index, data)))                                                              \
+        {                                                                                                               \
+            logError("CAmDatabaseHandler::sqlite3_bind_int failed with errorCode:", eCode);                             \
+            mStatementCache.release(query);                                                                             \
+            return (false);                                                                                             \
+        }
+
 /**
- * Macro to handle SQLITE errors on reset
+ * Macro to handle SQLITE errors on reset, on error the statement goes back into the statement cache
  */
 #define MY_SQLITE_RESET(query)                                                                                          \
         if((eCode = sqlite3_reset(query)))                                                                              \
         {                                                                                                               \
             logError("CAmDatabaseHandler::sqlite3_reset failed with errorCode:", eCode);                                \
+            mStatementCache.release(query);                                                                             \
             return (E_DATABASE_ERROR);                                                                                  \
         }
 
 /**
- * Macro to handle SQLITE finalize
+ * Macro to handle SQLITE finalize, the statement goes back into the statement cache
  */
 #define MY_SQLITE_FINALIZE(query)                                                                                       \
-        if((eCode = sqlite3_finalize(query)))                                                                           \
+        if((eCode = mStatementCache.release(query)))                                                                       \
         {                                                                                                               \
             logError("CAmDatabaseHandler::sqlite3_finalize failed with errorCode:", eCode);                             \
             return (E_DATABASE_ERROR);                                                                                  \
         }
 
 #define MY_SQLITE_FINALIZE_BOOL(query)                                                                                  \
-        if((eCode = sqlite3_finalize(query)))                                                                           \
+        if((eCode = mStatementCache.release(query)))                                                                       \
         {                                                                                                               \
             logError("CAmDatabaseHandler::sqlite3_finalize failed with errorCode:", eCode);                             \
             return (true);                                                                                              \
@@ -107,6 +122,18 @@ namespace am
 #define CONNECTION_TABLE "Connections" //!< connection table
 #define MAINCONNECTION_TABLE "MainConnections" //!< main connection table
 #define SYSTEM_TABLE "SystemProperties" //!< system properties table
+#define MAINCONNECTIONROUTE_TABLE "MainConnectionRoutes" //!< connections of the routes of the main connections
+#define SINKCONNECTIONFORMAT_TABLE "SinkConnectionFormats" //!< connection formats of the sinks
+#define SINKSOUNDPROPERTY_TABLE "SinkSoundProperties" //!< sound properties of the sinks
+#define SINKMAINSOUNDPROPERTY_TABLE "SinkMainSoundProperties" //!< main sound properties of the visible sinks
+#define SOURCECONNECTIONFORMAT_TABLE "SourceConnectionFormats" //!< connection formats of the sources
+#define SOURCESOUNDPROPERTY_TABLE "SourceSoundProperties" //!< sound properties of the sources
+#define SOURCEMAINSOUNDPROPERTY_TABLE "SourceMainSoundProperties" //!< main sound properties of the visible sources
+#define GATEWAYSOURCEFORMAT_TABLE "GatewaySourceFormats" //!< source formats of the gateways
+#define GATEWAYSINKFORMAT_TABLE "GatewaySinkFormats" //!< sink formats of the gateways
+#define SINKCLASSPROPERTY_TABLE "SinkClassProperties" //!< class properties of the sink classes
+#define SOURCECLASSPROPERTY_TABLE "SourceClassProperties" //!< class properties of the source classes
+#define STATEMENT_CACHE_SIZE 256 //!< maximum number of compiled statements that are kept
 /**
  * table that holds table informations
  */
@@ -120,7 +147,35 @@ const std::string databaseTables[] =
         " Crossfaders (crossfaderID INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT, name VARCHAR(50), sinkID_A INTEGER, sinkID_B INTEGER, sourceID INTEGER, hotSink INTEGER);", //
         " Connections (connectionID INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT, sourceID INTEGER, sinkID INTEGER, delay INTEGER, connectionFormat INTEGER, reserved BOOL);", //
         " MainConnections (mainConnectionID INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT, sourceID INTEGER, sinkID INTEGER, connectionState INTEGER, delay INTEGER);", //
-        " SystemProperties (type INTEGER PRIMARY KEY, value INTEGER);" };
+        " SystemProperties (type INTEGER PRIMARY KEY, value INTEGER);", //
+        " MainConnectionRoutes (mainConnectionID INTEGER, connectionID INTEGER);", //
+        " SinkConnectionFormats (sinkID INTEGER, soundFormat INTEGER);", //
+        " SinkSoundProperties (sinkID INTEGER, soundPropertyType INTEGER, value INTEGER);", //
+        " SinkMainSoundProperties (sinkID INTEGER, soundPropertyType INTEGER, value INTEGER);", //
+        " SourceConnectionFormats (sourceID INTEGER, soundFormat INTEGER);", //
+        " SourceSoundProperties (sourceID INTEGER, soundPropertyType INTEGER, value INTEGER);", //
+        " SourceMainSoundProperties (sourceID INTEGER, soundPropertyType INTEGER, value INTEGER);", //
+        " GatewaySourceFormats (gatewayID INTEGER, soundFormat INTEGER);", //
+        " GatewaySinkFormats (gatewayID INTEGER, soundFormat INTEGER);", //
+        " SinkClassProperties (sinkClassID INTEGER, classProperty INTEGER, value INTEGER);", //
+        " SourceClassProperties (sourceClassID INTEGER, classProperty INTEGER, value INTEGER);" };
+
+/**
+ * indexes on the owner IDs of the relation tables, the rows of one owner keep their order of insertion
+ */
+const std::string databaseIndexes[] =
+{ " MainConnectionRoutesIndex ON MainConnectionRoutes (mainConnectionID);", //
+        " MainConnectionRoutesConnectionIndex ON MainConnectionRoutes (connectionID);", //
+        " SinkConnectionFormatsIndex ON SinkConnectionFormats (sinkID);", //
+        " SinkSoundPropertiesIndex ON SinkSoundProperties (sinkID);", //
+        " SinkMainSoundPropertiesIndex ON SinkMainSoundProperties (sinkID);", //
+        " SourceConnectionFormatsIndex ON SourceConnectionFormats (sourceID);", //
+        " SourceSoundPropertiesIndex ON SourceSoundProperties (sourceID);", //
+        " SourceMainSoundPropertiesIndex ON SourceMainSoundProperties (sourceID);", //
+        " GatewaySourceFormatsIndex ON GatewaySourceFormats (gatewayID);", //
+        " GatewaySinkFormatsIndex ON GatewaySinkFormats (gatewayID);", //
+        " SinkClassPropertiesIndex ON SinkClassProperties (sinkClassID);", //
+        " SourceClassPropertiesIndex ON SourceClassProperties (sourceClassID);" };
 
 /**
  * template to converts T to std::string
@@ -135,9 +190,121 @@ inline std::string i2s(T const& x)
     return (o.str());
 }
 
+static const char* const journalModes[] = { "DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF" }; //!< the values of PRAGMA journal_mode
+static const char* const synchronousLevels[] = { "OFF", "NORMAL", "FULL", "EXTRA" }; //!< the values of PRAGMA synchronous, in the order of their numbers
+
+/**
+ * converts a string to upper case, pragma values are compared in upper case
+ */
+static std::string toUpper(std::string value)
+{
+    std::transform(value.begin(), value.end(), value.begin(), ::toupper);
+    return (value);
+}
+
+/**
+ * looks up a value in a list of names
+ * @return the index of the value, -1 if it is not in the list
+ */
+static int findName(const char* const listNames[], const size_t size, const std::string& value)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        if (value == listNames[i])
+            return (i);
+    }
+    return (-1);
+}
+
+/**
+ * reads the value of a pragma
+ * @return the value as text, empty if the pragma could not be read
+ */
+static std::string readPragma(sqlite3* database, const std::string& pragma)
+{
+    sqlite3_stmt* query = NULL;
+    std::string value;
+    std::string command = "PRAGMA " + pragma;
+    if (sqlite3_prepare_v2(database, command.c_str(), -1, &query, NULL) != SQLITE_OK)
+        return (value);
+    if (sqlite3_step(query) == SQLITE_ROW && sqlite3_column_text(query, 0) != NULL)
+        value = std::string((const char*) sqlite3_column_text(query, 0));
+    sqlite3_finalize(query);
+    return (value);
+}
+
+CAmDatabaseHandler::databaseSettings_s::databaseSettings_s() :
+        journalMode(), //
+        synchronous(), //
+        cacheSize(0), //
+        mmapSize(0)
+{
+}
+
+/**
+ * sets a value by the name of its pragma, used for the commandline and the configuration file
+ * @param key journal_mode, synchronous, cache_size or mmap_size
+ * @param value the value
+ * @return false if the key or the value is not valid
+ */
+bool CAmDatabaseHandler::databaseSettings_s::set(const std::string& key, const std::string& value)
+{
+    std::istringstream stream(value);
+    if (key == "journal_mode")
+    {
+        if (findName(journalModes, sizeof(journalModes) / sizeof(journalModes[0]), toUpper(value)) < 0)
+            return (false);
+        journalMode = toUpper(value);
+    }
+    else if (key == "synchronous")
+    {
+        if (findName(synchronousLevels, sizeof(synchronousLevels) / sizeof(synchronousLevels[0]), toUpper(value)) < 0)
+            return (false);
+        synchronous = toUpper(value);
+    }
+    else if (key == "cache_size")
+    {
+        if (!(stream >> cacheSize) || !stream.eof())
+            return (false);
+    }
+    else if (key == "mmap_size")
+    {
+        if (!(stream >> mmapSize) || !stream.eof() || mmapSize < 0)
+            return (false);
+    }
+    else
+        return (false);
+    return (true);
+}
+
 CAmDatabaseHandler::CAmDatabaseHandler(std::string databasePath) :
         mpDatabase(NULL), //
         mPath(databasePath), //
+        mSettings(), //
+        mpDatabaseObserver(NULL), //
+        mFirstStaticSink(true), //
+        mFirstStaticSource(true), //
+        mFirstStaticGateway(true), //
+        mFirstStaticSinkClass(true), //
+        mFirstStaticSourceClass(true), //
+        mFirstStaticCrossfader(true), //
+        mListConnectionFormat(), //
+        mStatementCache(STATEMENT_CACHE_SIZE), //
+        mTransactionDepth(0), //
+        mSnapshotMainConnections("MainConnections"), //
+        mSnapshotSinks("Sinks"), //
+        mSnapshotSources("Sources"), //
+        mSnapshotVisibleMainConnections("VisibleMainConnections"), //
+        mSnapshotMainSinks("MainSinks"), //
+        mSnapshotMainSources("MainSources")
+{
+    init();
+}
+
+CAmDatabaseHandler::CAmDatabaseHandler(std::string databasePath, const databaseSettings_s& settings) :
+        mpDatabase(NULL), //
+        mPath(databasePath), //
+        mSettings(settings), //
         mpDatabaseObserver(NULL), //
         mFirstStaticSink(true), //
         mFirstStaticSource(true), //
@@ -145,14 +312,29 @@ CAmDatabaseHandler::CAmDatabaseHandler(std::string databasePath) :
         mFirstStaticSinkClass(true), //
         mFirstStaticSourceClass(true), //
         mFirstStaticCrossfader(true), //
-        mListConnectionFormat()
+        mListConnectionFormat(), //
+        mStatementCache(STATEMENT_CACHE_SIZE), //
+        mTransactionDepth(0), //
+        mSnapshotMainConnections("MainConnections"), //
+        mSnapshotSinks("Sinks"), //
+        mSnapshotSources("Sources"), //
+        mSnapshotVisibleMainConnections("VisibleMainConnections"), //
+        mSnapshotMainSinks("MainSinks"), //
+        mSnapshotMainSources("MainSources")
 {
+    init();
+}
 
+void CAmDatabaseHandler::init()
+{
     std::ifstream infile(mPath.c_str());
 
     if (infile)
     {
         remove(mPath.c_str());
+        //a write ahead log of the old database must not be replayed into the new one
+        remove((mPath + "-wal").c_str());
+        remove((mPath + "-shm").c_str());
         logInfo("DatabaseHandler::DatabaseHandler Knocked down database");
     }
 
@@ -162,12 +344,141 @@ CAmDatabaseHandler::CAmDatabaseHandler(std::string databasePath) :
         logInfo("DatabaseHandler::DatabaseHandler problems opening the database!");
     }
 
+    applySettings();
     createTables();
+    sqlite3_update_hook(mpDatabase, &CAmDatabaseHandler::updateHook, this);
+}
+
+/**
+ * issues the pragmas that were configured and logs what sqlite really uses. An in-memory database for example always
+ * reports the journal mode MEMORY. mSettings holds the values that sqlite reported afterwards.
+ */
+void CAmDatabaseHandler::applySettings()
+{
+    if (!mSettings.journalMode.empty())
+        sqQuery("PRAGMA journal_mode=" + mSettings.journalMode);
+    if (!mSettings.synchronous.empty())
+        sqQuery("PRAGMA synchronous=" + mSettings.synchronous);
+    if (mSettings.cacheSize != 0)
+        sqQuery("PRAGMA cache_size=" + i2s(mSettings.cacheSize));
+    if (mSettings.mmapSize != 0)
+        sqQuery("PRAGMA mmap_size=" + i2s(mSettings.mmapSize));
+
+    mSettings.journalMode = toUpper(readPragma(mpDatabase, "journal_mode"));
+    int synchronous = atoi(readPragma(mpDatabase, "synchronous").c_str());
+    if (synchronous >= 0 && synchronous < (int) (sizeof(synchronousLevels) / sizeof(synchronousLevels[0])))
+        mSettings.synchronous = synchronousLevels[synchronous];
+    mSettings.cacheSize = atoi(readPragma(mpDatabase, "cache_size").c_str());
+    mSettings.mmapSize = atoll(readPragma(mpDatabase, "mmap_size").c_str());
+
+    logInfo("DatabaseHandler::applySettings path:", mPath, "journal_mode:", mSettings.journalMode, "synchronous:", mSettings.synchronous, "cache_size:", mSettings.cacheSize, "mmap_size:", mSettings.mmapSize);
+}
+
+/**
+ * hands out a list from its snapshot. If the snapshot is not valid, the list is read from the database first.
+ * @param snapshot the snapshot of the list
+ * @param buildList the function that reads the list from the database
+ * @param list the list
+ * @return E_OK on success, the error of buildList otherwise
+ */
+template<class T> am_Error_e CAmDatabaseHandler::getSnapshot(snapshot_s<T>& snapshot, am_Error_e (CAmDatabaseHandler::*buildList)(std::vector<T>&) const, std::vector<T>& list) const
+{
+    if (snapshot.valid)
+    {
+        snapshot.hits++;
+        list = snapshot.list;
+        return (E_OK);
+    }
+
+    am_Error_e error = (this->*buildList)(snapshot.list);
+    if (error != E_OK)
+    {
+        snapshot.list.clear();
+        list.clear();
+        return (error);
+    }
+    snapshot.valid = true;
+    snapshot.builds++;
+    list = snapshot.list;
+    return (E_OK);
+}
+
+template<class T> void CAmDatabaseHandler::addSnapshotStatistic(const snapshot_s<T>& snapshot, std::vector<snapshotStatistic_s>& listStatistics) const
+{
+    snapshotStatistic_s statistic;
+    statistic.name = snapshot.name;
+    statistic.builds = snapshot.builds;
+    statistic.hits = snapshot.hits;
+    listStatistics.push_back(statistic);
+}
+
+/**
+ * returns how often the list snapshots were read from the database and how often they were used
+ * @param listStatistics the statistics, one entry per list
+ */
+void CAmDatabaseHandler::getSnapshotStatistics(std::vector<snapshotStatistic_s>& listStatistics) const
+{
+    listStatistics.clear();
+    addSnapshotStatistic(mSnapshotMainConnections, listStatistics);
+    addSnapshotStatistic(mSnapshotSinks, listStatistics);
+    addSnapshotStatistic(mSnapshotSources, listStatistics);
+    addSnapshotStatistic(mSnapshotVisibleMainConnections, listStatistics);
+    addSnapshotStatistic(mSnapshotMainSinks, listStatistics);
+    addSnapshotStatistic(mSnapshotMainSources, listStatistics);
+}
+
+/**
+ * sqlite calls this for every row that is inserted, updated or deleted. This catches every change, no matter which
+ * function made it, so the snapshots cannot miss one.
+ */
+void CAmDatabaseHandler::updateHook(void* userData, int operation, const char* database, const char* table, sqlite3_int64 rowID)
+{
+    (void) operation;
+    (void) database;
+    (void) rowID;
+    static_cast<CAmDatabaseHandler*>(userData)->tableChanged(table);
+}
+
+void CAmDatabaseHandler::tableChanged(const char* table)
+{
+    if (strcmp(table, SINK_TABLE) == 0)
+    {
+        mSnapshotSinks.valid = false;
+        mSnapshotMainSinks.valid = false;
+    }
+    else if (strcmp(table, SOURCE_TABLE) == 0)
+    {
+        mSnapshotSources.valid = false;
+        mSnapshotMainSources.valid = false;
+    }
+    else if (strcmp(table, MAINCONNECTION_TABLE) == 0)
+    {
+        mSnapshotMainConnections.valid = false;
+        mSnapshotVisibleMainConnections.valid = false;
+    }
+    else if (strcmp(table, MAINCONNECTIONROUTE_TABLE) == 0)
+        mSnapshotMainConnections.valid = false;
+    else if (strcmp(table, SINKCONNECTIONFORMAT_TABLE) == 0 || strcmp(table, SINKSOUNDPROPERTY_TABLE) == 0 || strcmp(table, SINKMAINSOUNDPROPERTY_TABLE) == 0)
+        mSnapshotSinks.valid = false;
+    else if (strcmp(table, SOURCECONNECTIONFORMAT_TABLE) == 0 || strcmp(table, SOURCESOUNDPROPERTY_TABLE) == 0 || strcmp(table, SOURCEMAINSOUNDPROPERTY_TABLE) == 0)
+        mSnapshotSources.valid = false;
+}
+
+/**
+ * returns the settings that sqlite uses, as they were read back after opening the database
+ * @return the settings
+ */
+const CAmDatabaseHandler::databaseSettings_s& CAmDatabaseHandler::getSettings() const
+{
+    return (mSettings);
 }
 
 CAmDatabaseHandler::~CAmDatabaseHandler()
 {
     logInfo("Closed Database");
+    if (mTransactionDepth != 0)
+        sqQuery("COMMIT");
+    mStatementCache.clear();
     sqlite3_close(mpDatabase);
 }
 
@@ -282,17 +593,14 @@ am_Error_e CAmDatabaseHandler::enterMainConnectionDB(const am_MainConnection_s &
     }
     MY_SQLITE_FINALIZE(query)
 
-    //now we create a table with references to the connections;
-    command = "CREATE TABLE MainConnectionRoute" + i2s(connectionID) + std::string("(connectionID INTEGER)");
-    if (!this->sqQuery(command))
-        return (E_DATABASE_ERROR);
-
-    command = "INSERT INTO MainConnectionRoute" + i2s(connectionID) + "(connectionID) VALUES (?)";
+    //now we enter the references to the connections;
+    command = "INSERT INTO " + std::string(MAINCONNECTIONROUTE_TABLE) + "(mainConnectionID, connectionID) VALUES (?,?)";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
     std::vector<am_connectionID_t>::const_iterator listConnectionIterator(mainConnectionData.listConnectionID.begin());
     for (; listConnectionIterator < mainConnectionData.listConnectionID.end(); ++listConnectionIterator)
     {
-        MY_SQLITE_BIND_INT(query, 1, *listConnectionIterator)
+        MY_SQLITE_BIND_INT(query, 1, connectionID)
+        MY_SQLITE_BIND_INT(query, 2, *listConnectionIterator)
         if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
         {
             logError("DatabaseHandler::enterMainConnectionDB SQLITE Step error code:", eCode);
@@ -423,20 +731,15 @@ am_Error_e CAmDatabaseHandler::enterSinkDB(const am_Sink_s & sinkData, am_sinkID
     MY_SQLITE_FINALIZE(query)
 
     //now we need to create the additional tables:
-    command = "CREATE TABLE SinkConnectionFormat" + i2s(sinkID) + std::string("(soundFormat INTEGER)");
-    if (!this->sqQuery(command))
-        return (E_DATABASE_ERROR);
-    command = "CREATE TABLE SinkSoundProperty" + i2s(sinkID) + std::string("(soundPropertyType INTEGER, value INTEGER)");
-    if (!this->sqQuery(command))
-        return (E_DATABASE_ERROR);
 
     //fill ConnectionFormats
-    command = "INSERT INTO SinkConnectionFormat" + i2s(sinkID) + std::string("(soundFormat) VALUES (?)");
+    command = "INSERT INTO " + std::string(SINKCONNECTIONFORMAT_TABLE) + "(sinkID, soundFormat) VALUES (?,?)";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
     std::vector<am_ConnectionFormat_e>::const_iterator connectionFormatIterator = sinkData.listConnectionFormats.begin();
     for (; connectionFormatIterator < sinkData.listConnectionFormats.end(); ++connectionFormatIterator)
     {
-        MY_SQLITE_BIND_INT(query, 1, *connectionFormatIterator)
+        MY_SQLITE_BIND_INT(query, 1, sinkID)
+        MY_SQLITE_BIND_INT(query, 2, *connectionFormatIterator)
         if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
         {
             logError("DatabaseHandler::enterSinkDB SQLITE Step error code:", eCode);
@@ -445,15 +748,17 @@ am_Error_e CAmDatabaseHandler::enterSinkDB(const am_Sink_s & sinkData, am_sinkID
         }
         MY_SQLITE_RESET(query)
     }
+    MY_SQLITE_FINALIZE(query)
 
     //Fill SinkSoundProperties
-    command = "INSERT INTO SinkSoundProperty" + i2s(sinkID) + std::string("(soundPropertyType,value) VALUES (?,?)");
+    command = "INSERT INTO " + std::string(SINKSOUNDPROPERTY_TABLE) + "(sinkID, soundPropertyType, value) VALUES (?,?,?)";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
     std::vector<am_SoundProperty_s>::const_iterator SoundPropertyIterator = sinkData.listSoundProperties.begin();
     for (; SoundPropertyIterator < sinkData.listSoundProperties.end(); ++SoundPropertyIterator)
     {
-        MY_SQLITE_BIND_INT(query, 1, SoundPropertyIterator->type)
-        MY_SQLITE_BIND_INT(query, 2, SoundPropertyIterator->value)
+        MY_SQLITE_BIND_INT(query, 1, sinkID)
+        MY_SQLITE_BIND_INT(query, 2, SoundPropertyIterator->type)
+        MY_SQLITE_BIND_INT(query, 3, SoundPropertyIterator->value)
         if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
         {
             logError("DatabaseHandler::enterSinkDB SQLITE Step error code:", eCode);
@@ -462,21 +767,19 @@ am_Error_e CAmDatabaseHandler::enterSinkDB(const am_Sink_s & sinkData, am_sinkID
         }
         MY_SQLITE_RESET(query)
     }
+    MY_SQLITE_FINALIZE(query)
 
     if (sinkData.visible == true)
     {
-        command = "CREATE TABLE SinkMainSoundProperty" + i2s(sinkID) + std::string("(soundPropertyType INTEGER, value INTEGER)");
-        if (!this->sqQuery(command))
-            return (E_DATABASE_ERROR);
-
         //Fill MainSinkSoundProperties
-        command = "INSERT INTO SinkMainSoundProperty" + i2s(sinkID) + std::string("(soundPropertyType,value) VALUES (?,?)");
+        command = "INSERT INTO " + std::string(SINKMAINSOUNDPROPERTY_TABLE) + "(sinkID, soundPropertyType, value) VALUES (?,?,?)";
         MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
         std::vector<am_MainSoundProperty_s>::const_iterator mainSoundPropertyIterator = sinkData.listMainSoundProperties.begin();
         for (; mainSoundPropertyIterator < sinkData.listMainSoundProperties.end(); ++mainSoundPropertyIterator)
         {
-            MY_SQLITE_BIND_INT(query, 1, mainSoundPropertyIterator->type)
-            MY_SQLITE_BIND_INT(query, 2, mainSoundPropertyIterator->value)
+            MY_SQLITE_BIND_INT(query, 1, sinkID)
+            MY_SQLITE_BIND_INT(query, 2, mainSoundPropertyIterator->type)
+            MY_SQLITE_BIND_INT(query, 3, mainSoundPropertyIterator->value)
             if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
             {
                 logError("DatabaseHandler::enterSinkDB SQLITE Step error code:", eCode);
@@ -645,20 +948,14 @@ am_Error_e CAmDatabaseHandler::enterGatewayDB(const am_Gateway_s & gatewayData,
     //now the convertion matrix todo: change the map implementation sometimes to blob in sqlite
     mListConnectionFormat.insert(std::make_pair(gatewayID, gatewayData.convertionMatrix));
 
-    command = "CREATE TABLE GatewaySourceFormat" + i2s(gatewayID) + std::string("(soundFormat INTEGER)");
-    if (!this->sqQuery(command))
-        return (E_DATABASE_ERROR);
-    command = "CREATE TABLE GatewaySinkFormat" + i2s(gatewayID) + std::string("(soundFormat INTEGER)");
-    if (!this->sqQuery(command))
-        return (E_DATABASE_ERROR);
-
     //fill ConnectionFormats
-    command = "INSERT INTO GatewaySourceFormat" + i2s(gatewayID) + std::string("(soundFormat) VALUES (?)");
+    command = "INSERT INTO " + std::string(GATEWAYSOURCEFORMAT_TABLE) + "(gatewayID, soundFormat) VALUES (?,?)";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
     std::vector<am_ConnectionFormat_e>::const_iterator connectionFormatIterator = gatewayData.listSourceFormats.begin();
     for (; connectionFormatIterator < gatewayData.listSourceFormats.end(); ++connectionFormatIterator)
     {
-        MY_SQLITE_BIND_INT(query, 1, *connectionFormatIterator)
+        MY_SQLITE_BIND_INT(query, 1, gatewayID)
+        MY_SQLITE_BIND_INT(query, 2, *connectionFormatIterator)
         if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
         {
             logError("DatabaseHandler::enterGatewayDB SQLITE Step error code:", eCode);
@@ -669,12 +966,13 @@ am_Error_e CAmDatabaseHandler::enterGatewayDB(const am_Gateway_s & gatewayData,
     }
     MY_SQLITE_FINALIZE(query)
 
-    command = "INSERT INTO GatewaySinkFormat" + i2s(gatewayID) + std::string("(soundFormat) VALUES (?)");
+    command = "INSERT INTO " + std::string(GATEWAYSINKFORMAT_TABLE) + "(gatewayID, soundFormat) VALUES (?,?)";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
     connectionFormatIterator = gatewayData.listSinkFormats.begin();
     for (; connectionFormatIterator < gatewayData.listSinkFormats.end(); ++connectionFormatIterator)
     {
-        MY_SQLITE_BIND_INT(query, 1, *connectionFormatIterator)
+        MY_SQLITE_BIND_INT(query, 1, gatewayID)
+        MY_SQLITE_BIND_INT(query, 2, *connectionFormatIterator)
         if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
         {
             logError("DatabaseHandler::enterGatewayDB SQLITE Step error code:", eCode);
@@ -794,20 +1092,15 @@ am_Error_e CAmDatabaseHandler::enterSourceDB(const am_Source_s & sourceData, am_
     MY_SQLITE_FINALIZE(query)
 
     //now we need to create the additional tables:
-    command = "CREATE TABLE SourceConnectionFormat" + i2s(sourceID) + std::string("(soundFormat INTEGER)");
-    if (!this->sqQuery(command))
-        return (E_DATABASE_ERROR);
-    command = "CREATE TABLE SourceSoundProperty" + i2s(sourceID) + std::string("(soundPropertyType INTEGER, value INTEGER)");
-    if (!this->sqQuery(command))
-        return (E_DATABASE_ERROR);
 
     //fill ConnectionFormats
-    command = "INSERT INTO SourceConnectionFormat" + i2s(sourceID) + std::string("(soundFormat) VALUES (?)");
+    command = "INSERT INTO " + std::string(SOURCECONNECTIONFORMAT_TABLE) + "(sourceID, soundFormat) VALUES (?,?)";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
     std::vector<am_ConnectionFormat_e>::const_iterator connectionFormatIterator = sourceData.listConnectionFormats.begin();
     for (; connectionFormatIterator < sourceData.listConnectionFormats.end(); ++connectionFormatIterator)
     {
-        MY_SQLITE_BIND_INT(query, 1, *connectionFormatIterator)
+        MY_SQLITE_BIND_INT(query, 1, sourceID)
+        MY_SQLITE_BIND_INT(query, 2, *connectionFormatIterator)
         if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
         {
             logError("DatabaseHandler::enterSourceDB SQLITE Step error code:", eCode);
@@ -819,13 +1112,14 @@ am_Error_e CAmDatabaseHandler::enterSourceDB(const am_Source_s & sourceData, am_
     MY_SQLITE_FINALIZE(query)
 
     //Fill SinkSoundProperties
-    command = "INSERT INTO SourceSoundProperty" + i2s(sourceID) + std::string("(soundPropertyType,value) VALUES (?,?)");
+    command = "INSERT INTO " + std::string(SOURCESOUNDPROPERTY_TABLE) + "(sourceID, soundPropertyType, value) VALUES (?,?,?)";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
     std::vector<am_SoundProperty_s>::const_iterator SoundPropertyIterator = sourceData.listSoundProperties.begin();
     for (; SoundPropertyIterator < sourceData.listSoundProperties.end(); ++SoundPropertyIterator)
     {
-        MY_SQLITE_BIND_INT(query, 1, SoundPropertyIterator->type)
-        MY_SQLITE_BIND_INT(query, 2, SoundPropertyIterator->value)
+        MY_SQLITE_BIND_INT(query, 1, sourceID)
+        MY_SQLITE_BIND_INT(query, 2, SoundPropertyIterator->type)
+        MY_SQLITE_BIND_INT(query, 3, SoundPropertyIterator->value)
         if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
         {
             logError("DatabaseHandler::enterSinkDB SQLITE Step error code:", eCode);
@@ -839,18 +1133,15 @@ am_Error_e CAmDatabaseHandler::enterSourceDB(const am_Source_s & sourceData, am_
 
     if (sourceData.visible == true)
     {
-        command = "CREATE TABLE SourceMainSoundProperty" + i2s(sourceID) + std::string("(soundPropertyType INTEGER, value INTEGER)");
-        if (!this->sqQuery(command))
-            return (E_DATABASE_ERROR);
-
         //Fill MainSinkSoundProperties
-        command = "INSERT INTO SourceMainSoundProperty" + i2s(sourceID) + std::string("(soundPropertyType,value) VALUES (?,?)");
+        command = "INSERT INTO " + std::string(SOURCEMAINSOUNDPROPERTY_TABLE) + "(sourceID, soundPropertyType, value) VALUES (?,?,?)";
         MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
         std::vector<am_MainSoundProperty_s>::const_iterator mainSoundPropertyIterator = sourceData.listMainSoundProperties.begin();
         for (; mainSoundPropertyIterator < sourceData.listMainSoundProperties.end(); ++mainSoundPropertyIterator)
         {
-            MY_SQLITE_BIND_INT(query, 1, mainSoundPropertyIterator->type)
-            MY_SQLITE_BIND_INT(query, 2, mainSoundPropertyIterator->value)
+            MY_SQLITE_BIND_INT(query, 1, sourceID)
+            MY_SQLITE_BIND_INT(query, 2, mainSoundPropertyIterator->type)
+            MY_SQLITE_BIND_INT(query, 3, mainSoundPropertyIterator->value)
             if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
             {
                 logError("DatabaseHandler::enterSourceDB SQLITE Step error code:", eCode);
@@ -909,17 +1200,25 @@ am_Error_e CAmDatabaseHandler::changeMainConnectionRouteDB(const am_mainConnecti
 
     MY_SQLITE_FINALIZE(query)
 
-    //now we delete the data in the table
-    command = "DELETE from MainConnectionRoute" + i2s(mainconnectionID);
-    if (!this->sqQuery(command))
+    //now we delete the old route
+    command = "DELETE from " + std::string(MAINCONNECTIONROUTE_TABLE) + " WHERE mainConnectionID=?";
+    MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, mainconnectionID)
+    if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
+    {
+        logError("DatabaseHandler::changeMainConnectionRouteDB SQLITE Step error code:", eCode);
+        MY_SQLITE_FINALIZE(query)
         return (E_DATABASE_ERROR);
+    }
+    MY_SQLITE_FINALIZE(query)
 
-    command = "INSERT INTO MainConnectionRoute" + i2s(mainconnectionID) + "(connectionID) VALUES (?)";
+    command = "INSERT INTO " + std::string(MAINCONNECTIONROUTE_TABLE) + "(mainConnectionID, connectionID) VALUES (?,?)";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
     std::vector<am_connectionID_t>::const_iterator listConnectionIterator(listConnectionID.begin());
     for (; listConnectionIterator != listConnectionID.end(); ++listConnectionIterator)
     {
-        MY_SQLITE_BIND_INT(query, 1, *listConnectionIterator)
+        MY_SQLITE_BIND_INT(query, 1, mainconnectionID)
+        MY_SQLITE_BIND_INT(query, 2, *listConnectionIterator)
         if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
         {
             logError("DatabaseHandler::changeMainConnectionRouteDB SQLITE Step error code:", eCode);
@@ -947,8 +1246,9 @@ am_Error_e CAmDatabaseHandler::changeMainConnectionStateDB(const am_mainConnecti
     {
         return (E_NON_EXISTENT);
     }
-    command = "UPDATE " + std::string(MAINCONNECTION_TABLE) + " SET connectionState=? WHERE mainConnectionID=" + i2s(mainconnectionID);
+    command = "UPDATE " + std::string(MAINCONNECTION_TABLE) + " SET connectionState=? WHERE mainConnectionID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 2, mainconnectionID)
     MY_SQLITE_BIND_INT(query, 1, connectionState)
     if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
     {
@@ -976,8 +1276,9 @@ am_Error_e CAmDatabaseHandler::changeSinkMainVolumeDB(const am_mainVolume_t main
     {
         return (E_NON_EXISTENT);
     }
-    command = "UPDATE " + std::string(SINK_TABLE) + " SET mainVolume=? WHERE sinkID=" + i2s(sinkID);
+    command = "UPDATE " + std::string(SINK_TABLE) + " SET mainVolume=? WHERE sinkID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 2, sinkID)
     MY_SQLITE_BIND_INT(query, 1, mainVolume)
     if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
     {
@@ -1009,8 +1310,9 @@ am_Error_e CAmDatabaseHandler::changeSinkAvailabilityDB(const am_Availability_s
     {
         return (E_NON_EXISTENT);
     }
-    command = "UPDATE " + std::string(SINK_TABLE) + " SET availability=?, availabilityReason=? WHERE sinkID=" + i2s(sinkID);
+    command = "UPDATE " + std::string(SINK_TABLE) + " SET availability=?, availabilityReason=? WHERE sinkID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 3, sinkID)
     MY_SQLITE_BIND_INT(query, 1, availability.availability)
     MY_SQLITE_BIND_INT(query, 2, availability.availabilityReason)
     if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
@@ -1041,8 +1343,9 @@ am_Error_e CAmDatabaseHandler::changDomainStateDB(const am_DomainState_e domainS
     {
         return (E_NON_EXISTENT);
     }
-    command = "UPDATE " + std::string(DOMAIN_TABLE) + " SET state=? WHERE domainID=" + i2s(domainID);
+    command = "UPDATE " + std::string(DOMAIN_TABLE) + " SET state=? WHERE domainID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 2, domainID)
     MY_SQLITE_BIND_INT(query, 1, domainState)
     if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
     {
@@ -1070,8 +1373,9 @@ am_Error_e CAmDatabaseHandler::changeSinkMuteStateDB(const am_MuteState_e muteSt
     {
         return (E_NON_EXISTENT);
     }
-    command = "UPDATE " + std::string(SINK_TABLE) + " SET muteState=? WHERE sinkID=" + i2s(sinkID);
+    command = "UPDATE " + std::string(SINK_TABLE) + " SET muteState=? WHERE sinkID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 2, sinkID)
     MY_SQLITE_BIND_INT(query, 1, muteState)
     if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
     {
@@ -1102,8 +1406,10 @@ am_Error_e CAmDatabaseHandler::changeMainSinkSoundPropertyDB(const am_MainSoundP
     {
         return (E_NON_EXISTENT);
     }
-    command = "UPDATE SinkMainSoundProperty" + i2s(sinkID) + " SET value=? WHERE soundPropertyType=" + i2s(soundProperty.type);
+    command = "UPDATE " + std::string(SINKMAINSOUNDPROPERTY_TABLE) + " SET value=? WHERE soundPropertyType=? AND sinkID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 3, sinkID)
+    MY_SQLITE_BIND_INT(query, 2, soundProperty.type)
     MY_SQLITE_BIND_INT(query, 1, soundProperty.value)
     if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
     {
@@ -1132,8 +1438,10 @@ am_Error_e CAmDatabaseHandler::changeMainSourceSoundPropertyDB(const am_MainSoun
     {
         return (E_NON_EXISTENT);
     }
-    command = "UPDATE SourceMainSoundProperty" + i2s(sourceID) + " SET value=? WHERE soundPropertyType=" + i2s(soundProperty.type);
+    command = "UPDATE " + std::string(SOURCEMAINSOUNDPROPERTY_TABLE) + " SET value=? WHERE soundPropertyType=? AND sourceID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 3, sourceID)
+    MY_SQLITE_BIND_INT(query, 2, soundProperty.type)
     MY_SQLITE_BIND_INT(query, 1, soundProperty.value)
     if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
     {
@@ -1164,8 +1472,9 @@ am_Error_e CAmDatabaseHandler::changeSourceAvailabilityDB(const am_Availability_
     {
         return (E_NON_EXISTENT);
     }
-    command = "UPDATE " + std::string(SOURCE_TABLE) + " SET availability=?, availabilityReason=? WHERE sourceID=" + i2s(sourceID);
+    command = "UPDATE " + std::string(SOURCE_TABLE) + " SET availability=?, availabilityReason=? WHERE sourceID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 3, sourceID)
     MY_SQLITE_BIND_INT(query, 1, availability.availability)
     MY_SQLITE_BIND_INT(query, 2, availability.availabilityReason)
     if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
@@ -1221,7 +1530,7 @@ am_Error_e CAmDatabaseHandler::removeMainConnectionDB(const am_mainConnectionID_
         return (E_NON_EXISTENT);
     }
     std::string command = "DELETE from " + std::string(MAINCONNECTION_TABLE) + " WHERE mainConnectionID=" + i2s(mainConnectionID);
-    std::string command1 = "DROP table MainConnectionRoute" + i2s(mainConnectionID);
+    std::string command1 = "DELETE from " + std::string(MAINCONNECTIONROUTE_TABLE) + " WHERE mainConnectionID=" + i2s(mainConnectionID);
     if (!sqQuery(command))
         return (E_DATABASE_ERROR);
     if (!sqQuery(command1))
@@ -1247,20 +1556,17 @@ am_Error_e CAmDatabaseHandler::removeSinkDB(const am_sinkID_t sinkID)
     bool visible = sinkVisible(sinkID);
 
     std::string command = "DELETE from " + std::string(SINK_TABLE) + " WHERE sinkID=" + i2s(sinkID);
-    std::string command1 = "DROP table SinkConnectionFormat" + i2s(sinkID);
-    std::string command2 = "DROP table SinkSoundProperty" + i2s(sinkID);
-    std::string command3 = "DROP table SinkMainSoundProperty" + i2s(sinkID);
+    std::string command1 = "DELETE from " + std::string(SINKCONNECTIONFORMAT_TABLE) + " WHERE sinkID=" + i2s(sinkID);
+    std::string command2 = "DELETE from " + std::string(SINKSOUNDPROPERTY_TABLE) + " WHERE sinkID=" + i2s(sinkID);
+    std::string command3 = "DELETE from " + std::string(SINKMAINSOUNDPROPERTY_TABLE) + " WHERE sinkID=" + i2s(sinkID);
     if (!sqQuery(command))
         return (E_DATABASE_ERROR);
     if (!sqQuery(command1))
         return (E_DATABASE_ERROR);
     if (!sqQuery(command2))
         return (E_DATABASE_ERROR);
-    if (visible) //only drop table if it ever existed
-    {
-        if (!sqQuery(command3))
-            return (E_DATABASE_ERROR);
-    }
+    if (!sqQuery(command3))
+        return (E_DATABASE_ERROR);
     logInfo("DatabaseHandler::removeSinkDB removed:", sinkID);
 
     if (mpDatabaseObserver != NULL)
@@ -1281,21 +1587,17 @@ am_Error_e CAmDatabaseHandler::removeSourceDB(const am_sourceID_t sourceID)
     bool visible = sourceVisible(sourceID);
 
     std::string command = "DELETE from " + std::string(SOURCE_TABLE) + " WHERE sourceID=" + i2s(sourceID);
-    std::string command1 = "DROP table SourceConnectionFormat" + i2s(sourceID);
-    std::string command2 = "DROP table SourceMainSoundProperty" + i2s(sourceID);
-    std::string command3 = "DROP table SourceSoundProperty" + i2s(sourceID);
+    std::string command1 = "DELETE from " + std::string(SOURCECONNECTIONFORMAT_TABLE) + " WHERE sourceID=" + i2s(sourceID);
+    std::string command2 = "DELETE from " + std::string(SOURCEMAINSOUNDPROPERTY_TABLE) + " WHERE sourceID=" + i2s(sourceID);
+    std::string command3 = "DELETE from " + std::string(SOURCESOUNDPROPERTY_TABLE) + " WHERE sourceID=" + i2s(sourceID);
     if (!sqQuery(command))
         return (E_DATABASE_ERROR);
     if (!sqQuery(command1))
         return (E_DATABASE_ERROR);
+    if (!sqQuery(command2))
+        return (E_DATABASE_ERROR);
     if (!sqQuery(command3))
         return (E_DATABASE_ERROR);
-
-    if(visible)
-    {
-        if (!sqQuery(command2))
-            return (E_DATABASE_ERROR);
-    }
     logInfo("DatabaseHandler::removeSourceDB removed:", sourceID);
     if (mpDatabaseObserver)
         mpDatabaseObserver->removedSource(sourceID, visible);
@@ -1311,8 +1613,14 @@ am_Error_e CAmDatabaseHandler::removeGatewayDB(const am_gatewayID_t gatewayID)
         return (E_NON_EXISTENT);
     }
     std::string command = "DELETE from " + std::string(GATEWAY_TABLE) + " WHERE gatewayID=" + i2s(gatewayID);
+    std::string command1 = "DELETE from " + std::string(GATEWAYSOURCEFORMAT_TABLE) + " WHERE gatewayID=" + i2s(gatewayID);
+    std::string command2 = "DELETE from " + std::string(GATEWAYSINKFORMAT_TABLE) + " WHERE gatewayID=" + i2s(gatewayID);
     if (!sqQuery(command))
         return (E_DATABASE_ERROR);
+    if (!sqQuery(command1))
+        return (E_DATABASE_ERROR);
+    if (!sqQuery(command2))
+        return (E_DATABASE_ERROR);
     logInfo("DatabaseHandler::removeGatewayDB removed:", gatewayID);
     if (mpDatabaseObserver)
         mpDatabaseObserver->removeGateway(gatewayID);
@@ -1362,7 +1670,7 @@ am_Error_e CAmDatabaseHandler::removeSinkClassDB(const am_sinkClass_t sinkClassI
         return (E_NON_EXISTENT);
     }
     std::string command = "DELETE from " + std::string(SINK_CLASS_TABLE) + " WHERE sinkClassID=" + i2s(sinkClassID);
-    std::string command1 = "DROP table SinkClassProperties" + i2s(sinkClassID);
+    std::string command1 = "DELETE from " + std::string(SINKCLASSPROPERTY_TABLE) + " WHERE sinkClassID=" + i2s(sinkClassID);
     if (!sqQuery(command))
         return (E_DATABASE_ERROR);
     if (!sqQuery(command1))
@@ -1384,7 +1692,7 @@ am_Error_e CAmDatabaseHandler::removeSourceClassDB(const am_sourceClass_t source
         return (E_NON_EXISTENT);
     }
     std::string command = "DELETE from " + std::string(SOURCE_CLASS_TABLE) + " WHERE sourceClassID=" + i2s(sourceClassID);
-    std::string command1 = "DROP table SourceClassProperties" + i2s(sourceClassID);
+    std::string command1 = "DELETE from " + std::string(SOURCECLASSPROPERTY_TABLE) + " WHERE sourceClassID=" + i2s(sourceClassID);
     if (!sqQuery(command))
         return (E_DATABASE_ERROR);
     if (!sqQuery(command1))
@@ -1403,6 +1711,8 @@ am_Error_e CAmDatabaseHandler::removeConnection(const am_connectionID_t connecti
     if (!sqQuery(command))
         return (E_DATABASE_ERROR);
     logInfo("DatabaseHandler::removeConnection removed:", connectionID);
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->removedConnection(connectionID);
     return (E_OK);
 }
 
@@ -1417,8 +1727,9 @@ am_Error_e CAmDatabaseHandler::getSourceClassInfoDB(const am_sourceID_t sourceID
     sqlite3_stmt* query = NULL;
     int eCode = 0;
     am_ClassProperty_s propertyTemp;
-    std::string command = "SELECT sourceClassID FROM " + std::string(SOURCE_TABLE) + " WHERE sourceID=" + (i2s(sourceID));
+    std::string command = "SELECT sourceClassID FROM " + std::string(SOURCE_TABLE) + " WHERE sourceID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, sourceID)
 
     if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -1434,8 +1745,9 @@ am_Error_e CAmDatabaseHandler::getSourceClassInfoDB(const am_sourceID_t sourceID
 
     MY_SQLITE_FINALIZE(query)
 
-    command = "SELECT name FROM " + std::string(SOURCE_CLASS_TABLE) + " WHERE sourceClassID=" + (i2s(classInfo.sourceClassID));
+    command = "SELECT name FROM " + std::string(SOURCE_CLASS_TABLE) + " WHERE sourceClassID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, classInfo.sourceClassID)
 
     if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -1452,8 +1764,9 @@ am_Error_e CAmDatabaseHandler::getSourceClassInfoDB(const am_sourceID_t sourceID
     MY_SQLITE_FINALIZE(query)
 
     //read out Properties
-    command = "SELECT classProperty, value FROM SourceClassProperties" + i2s(classInfo.sourceClassID);
+    command = "SELECT classProperty, value FROM " + std::string(SOURCECLASSPROPERTY_TABLE) + " WHERE sourceClassID=? ORDER BY rowid";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, classInfo.sourceClassID)
     while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
         propertyTemp.classProperty = (am_ClassProperty_e) sqlite3_column_int(query, 0);
@@ -1487,8 +1800,9 @@ am_Error_e CAmDatabaseHandler::getSinkInfoDB(const am_sinkID_t sinkID, am_Sink_s
     am_ConnectionFormat_e tempConnectionFormat;
     am_SoundProperty_s tempSoundProperty;
     am_MainSoundProperty_s tempMainSoundProperty;
-    std::string command = "SELECT name, domainID, sinkClassID, volume, visible, availability, availabilityReason, muteState, mainVolume, sinkID FROM " + std::string(SINK_TABLE) + " WHERE reserved=0 and sinkID=" + i2s(sinkID);
+    std::string command = "SELECT name, domainID, sinkClassID, volume, visible, availability, availabilityReason, muteState, mainVolume, sinkID FROM " + std::string(SINK_TABLE) + " WHERE reserved=0 and sinkID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, sinkID)
 
     if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -1504,8 +1818,9 @@ am_Error_e CAmDatabaseHandler::getSinkInfoDB(const am_sinkID_t sinkID, am_Sink_s
         sinkData.sinkID = sqlite3_column_int(query, 9);
 
         //read out the connectionFormats
-        std::string commandConnectionFormat = "SELECT soundFormat FROM SinkConnectionFormat" + i2s(sinkID);
+        std::string commandConnectionFormat = "SELECT soundFormat FROM " + std::string(SINKCONNECTIONFORMAT_TABLE) + " WHERE sinkID=? ORDER BY rowid";
         MY_SQLITE_PREPARE_V2(mpDatabase, commandConnectionFormat.c_str(), -1, &qConnectionFormat, NULL)
+        MY_SQLITE_BIND_INT(qConnectionFormat, 1, sinkID)
         while ((eCode = sqlite3_step(qConnectionFormat)) == SQLITE_ROW)
         {
             tempConnectionFormat = (am_ConnectionFormat_e) sqlite3_column_int(qConnectionFormat, 0);
@@ -1515,8 +1830,9 @@ am_Error_e CAmDatabaseHandler::getSinkInfoDB(const am_sinkID_t sinkID, am_Sink_s
         MY_SQLITE_FINALIZE(qConnectionFormat)
 
         //read out sound properties
-        std::string commandSoundProperty = "SELECT soundPropertyType, value FROM SinkSoundProperty" + i2s(sinkID);
+        std::string commandSoundProperty = "SELECT soundPropertyType, value FROM " + std::string(SINKSOUNDPROPERTY_TABLE) + " WHERE sinkID=? ORDER BY rowid";
         MY_SQLITE_PREPARE_V2(mpDatabase, commandSoundProperty.c_str(), -1, &qSoundProperty, NULL)
+        MY_SQLITE_BIND_INT(qSoundProperty, 1, sinkID)
         while ((eCode = sqlite3_step(qSoundProperty)) == SQLITE_ROW)
         {
             tempSoundProperty.type = (am_SoundPropertyType_e) sqlite3_column_int(qSoundProperty, 0);
@@ -1527,8 +1843,9 @@ am_Error_e CAmDatabaseHandler::getSinkInfoDB(const am_sinkID_t sinkID, am_Sink_s
         MY_SQLITE_FINALIZE(qSoundProperty)
 
         //read out MainSoundProperties
-        std::string commandMainSoundProperty = "SELECT soundPropertyType, value FROM SinkMainSoundProperty" + i2s(sinkID);
+        std::string commandMainSoundProperty = "SELECT soundPropertyType, value FROM " + std::string(SINKMAINSOUNDPROPERTY_TABLE) + " WHERE sinkID=? ORDER BY rowid";
         MY_SQLITE_PREPARE_V2(mpDatabase, commandMainSoundProperty.c_str(), -1, &qMAinSoundProperty, NULL)
+        MY_SQLITE_BIND_INT(qMAinSoundProperty, 1, sinkID)
         while ((eCode = sqlite3_step(qMAinSoundProperty)) == SQLITE_ROW)
         {
             tempMainSoundProperty.type = (am_MainSoundPropertyType_e) sqlite3_column_int(qMAinSoundProperty, 0);
@@ -1565,8 +1882,9 @@ am_Error_e CAmDatabaseHandler::getSourceInfoDB(const am_sourceID_t sourceID, am_
     am_ConnectionFormat_e tempConnectionFormat;
     am_SoundProperty_s tempSoundProperty;
     am_MainSoundProperty_s tempMainSoundProperty;
-    std::string command = "SELECT name, domainID, sourceClassID, sourceState, volume, visible, availability, availabilityReason, interruptState, sourceID FROM " + std::string(SOURCE_TABLE) + " WHERE reserved=0 AND sourceID=" + i2s(sourceID);
+    std::string command = "SELECT name, domainID, sourceClassID, sourceState, volume, visible, availability, availabilityReason, interruptState, sourceID FROM " + std::string(SOURCE_TABLE) + " WHERE reserved=0 AND sourceID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, sourceID)
 
     if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -1582,8 +1900,9 @@ am_Error_e CAmDatabaseHandler::getSourceInfoDB(const am_sourceID_t sourceID, am_
         sourceData.sourceID = sqlite3_column_int(query, 9);
 
         //read out the connectionFormats
-        std::string commandConnectionFormat = "SELECT soundFormat FROM SourceConnectionFormat" + i2s(sourceID);
+        std::string commandConnectionFormat = "SELECT soundFormat FROM " + std::string(SOURCECONNECTIONFORMAT_TABLE) + " WHERE sourceID=? ORDER BY rowid";
         MY_SQLITE_PREPARE_V2(mpDatabase, commandConnectionFormat.c_str(), -1, &qConnectionFormat, NULL)
+        MY_SQLITE_BIND_INT(qConnectionFormat, 1, sourceID)
         while ((eCode = sqlite3_step(qConnectionFormat)) == SQLITE_ROW)
         {
             tempConnectionFormat = (am_ConnectionFormat_e) sqlite3_column_int(qConnectionFormat, 0);
@@ -1593,8 +1912,9 @@ am_Error_e CAmDatabaseHandler::getSourceInfoDB(const am_sourceID_t sourceID, am_
         MY_SQLITE_FINALIZE(qConnectionFormat)
 
         //read out sound properties
-        std::string commandSoundProperty = "SELECT soundPropertyType, value FROM SourceSoundProperty" + i2s(sourceID);
+        std::string commandSoundProperty = "SELECT soundPropertyType, value FROM " + std::string(SOURCESOUNDPROPERTY_TABLE) + " WHERE sourceID=? ORDER BY rowid";
         MY_SQLITE_PREPARE_V2(mpDatabase, commandSoundProperty.c_str(), -1, &qSoundProperty, NULL);
+        MY_SQLITE_BIND_INT(qSoundProperty, 1, sourceID)
         while ((eCode = sqlite3_step(qSoundProperty)) == SQLITE_ROW)
         {
             tempSoundProperty.type = (am_SoundPropertyType_e) sqlite3_column_int(qSoundProperty, 0);
@@ -1605,8 +1925,9 @@ am_Error_e CAmDatabaseHandler::getSourceInfoDB(const am_sourceID_t sourceID, am_
         MY_SQLITE_FINALIZE(qSoundProperty)
 
         //read out MainSoundProperties
-        std::string commandMainSoundProperty = "SELECT soundPropertyType, value FROM SourceMainSoundProperty" + i2s(sourceID);
+        std::string commandMainSoundProperty = "SELECT soundPropertyType, value FROM " + std::string(SOURCEMAINSOUNDPROPERTY_TABLE) + " WHERE sourceID=? ORDER BY rowid";
         MY_SQLITE_PREPARE_V2(mpDatabase, commandMainSoundProperty.c_str(), -1, &qMAinSoundProperty, NULL)
+        MY_SQLITE_BIND_INT(qMAinSoundProperty, 1, sourceID)
         while ((eCode = sqlite3_step(qMAinSoundProperty)) == SQLITE_ROW)
         {
             tempMainSoundProperty.type = (am_MainSoundPropertyType_e) sqlite3_column_int(qMAinSoundProperty, 0);
@@ -1638,9 +1959,10 @@ am_Error_e am::CAmDatabaseHandler::getMainConnectionInfoDB(const am_mainConnecti
     sqlite3_stmt *query = NULL, *query1 = NULL;
     int eCode = 0;
     am_MainConnection_s temp;
-    std::string command = "SELECT mainConnectionID, sourceID, sinkID, connectionState, delay FROM " + std::string(MAINCONNECTION_TABLE) + " WHERE mainConnectionID=" + i2s(mainConnectionID);
-    std::string command1 = "SELECT connectionID FROM MainConnectionRoute";
+    std::string command = "SELECT mainConnectionID, sourceID, sinkID, connectionState, delay FROM " + std::string(MAINCONNECTION_TABLE) + " WHERE mainConnectionID=?";
+    std::string command1 = "SELECT connectionID FROM " + std::string(MAINCONNECTIONROUTE_TABLE) + " WHERE mainConnectionID=? ORDER BY rowid";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, mainConnectionID)
 
     while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -1649,8 +1971,8 @@ am_Error_e am::CAmDatabaseHandler::getMainConnectionInfoDB(const am_mainConnecti
         mainConnectionData.sinkID = sqlite3_column_int(query, 2);
         mainConnectionData.connectionState = (am_ConnectionState_e) sqlite3_column_int(query, 3);
         mainConnectionData.delay = sqlite3_column_int(query, 4);
-        std::string statement = command1 + i2s(mainConnectionID);
-        MY_SQLITE_PREPARE_V2(mpDatabase, statement.c_str(), -1, &query1, NULL)
+        MY_SQLITE_PREPARE_V2(mpDatabase, command1.c_str(), -1, &query1, NULL)
+        MY_SQLITE_BIND_INT(query1, 1, mainConnectionID)
         while ((eCode = sqlite3_step(query1)) == SQLITE_ROW)
         {
             mainConnectionData.listConnectionID.push_back(sqlite3_column_int(query1, 0));
@@ -1683,13 +2005,14 @@ am_Error_e CAmDatabaseHandler::changeSinkClassInfoDB(const am_SinkClass_s& sinkC
         return (E_NON_EXISTENT);
 
     //fill ConnectionFormats
-    std::string command = "UPDATE SinkClassProperties" + i2s(sinkClass.sinkClassID) + " set value=? WHERE classProperty=?;";
+    std::string command = "UPDATE " + std::string(SINKCLASSPROPERTY_TABLE) + " set value=? WHERE classProperty=? AND sinkClassID=?;";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
     std::vector<am_ClassProperty_s>::const_iterator Iterator = sinkClass.listClassProperties.begin();
     for (; Iterator < sinkClass.listClassProperties.end(); ++Iterator)
     {
         MY_SQLITE_BIND_INT(query, 1, Iterator->value)
         MY_SQLITE_BIND_INT(query, 2, Iterator->classProperty)
+        MY_SQLITE_BIND_INT(query, 3, sinkClass.sinkClassID)
         if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
         {
             logError("DatabaseHandler::setSinkClassInfoDB SQLITE Step error code:", eCode);
@@ -1718,13 +2041,14 @@ am_Error_e CAmDatabaseHandler::changeSourceClassInfoDB(const am_SourceClass_s& s
         return (E_NON_EXISTENT);
 
     //fill ConnectionFormats
-    std::string command = "UPDATE SourceClassProperties" + i2s(sourceClass.sourceClassID) + " set value=? WHERE classProperty=?;";
+    std::string command = "UPDATE " + std::string(SOURCECLASSPROPERTY_TABLE) + " set value=? WHERE classProperty=? AND sourceClassID=?;";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
     std::vector<am_ClassProperty_s>::const_iterator Iterator = sourceClass.listClassProperties.begin();
     for (; Iterator < sourceClass.listClassProperties.end(); ++Iterator)
     {
         MY_SQLITE_BIND_INT(query, 1, Iterator->value)
         MY_SQLITE_BIND_INT(query, 2, Iterator->classProperty)
+        MY_SQLITE_BIND_INT(query, 3, sourceClass.sourceClassID)
         if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
         {
             logError("DatabaseHandler::setSinkClassInfoDB SQLITE Step error code:", eCode);
@@ -1751,8 +2075,9 @@ am_Error_e CAmDatabaseHandler::getSinkClassInfoDB(const am_sinkID_t sinkID, am_S
     sqlite3_stmt* query = NULL;
     int eCode = 0;
     am_ClassProperty_s propertyTemp;
-    std::string command = "SELECT sinkClassID FROM " + std::string(SINK_TABLE) + " WHERE sinkID=" + (i2s(sinkID));
+    std::string command = "SELECT sinkClassID FROM " + std::string(SINK_TABLE) + " WHERE sinkID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, sinkID)
 
     if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -1768,8 +2093,9 @@ am_Error_e CAmDatabaseHandler::getSinkClassInfoDB(const am_sinkID_t sinkID, am_S
 
     MY_SQLITE_FINALIZE(query)
 
-    command = "SELECT name FROM " + std::string(SINK_CLASS_TABLE) + " WHERE sinkClassID=" + (i2s(sinkClass.sinkClassID));
+    command = "SELECT name FROM " + std::string(SINK_CLASS_TABLE) + " WHERE sinkClassID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, sinkClass.sinkClassID)
 
     if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -1786,8 +2112,9 @@ am_Error_e CAmDatabaseHandler::getSinkClassInfoDB(const am_sinkID_t sinkID, am_S
     MY_SQLITE_FINALIZE(query)
 
     //read out Properties
-    command = "SELECT classProperty, value FROM SinkClassProperties" + i2s(sinkClass.sinkClassID);
+    command = "SELECT classProperty, value FROM " + std::string(SINKCLASSPROPERTY_TABLE) + " WHERE sinkClassID=? ORDER BY rowid";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, sinkClass.sinkClassID)
     while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
         propertyTemp.classProperty = (am_ClassProperty_e) sqlite3_column_int(query, 0);
@@ -1816,8 +2143,9 @@ am_Error_e CAmDatabaseHandler::getGatewayInfoDB(const am_gatewayID_t gatewayID,
     sqlite3_stmt* query = NULL, *qSinkConnectionFormat = NULL, *qSourceConnectionFormat = NULL;
     int eCode = 0;
     am_ConnectionFormat_e tempConnectionFormat;
-    std::string command = "SELECT name, sinkID, sourceID, domainSinkID, domainSourceID, controlDomainID, gatewayID FROM " + std::string(GATEWAY_TABLE) + " WHERE gatewayID=" + i2s(gatewayID);
+    std::string command = "SELECT name, sinkID, sourceID, domainSinkID, domainSourceID, controlDomainID, gatewayID FROM " + std::string(GATEWAY_TABLE) + " WHERE gatewayID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, gatewayID)
 
     while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -1841,8 +2169,9 @@ am_Error_e CAmDatabaseHandler::getGatewayInfoDB(const am_gatewayID_t gatewayID,
         gatewayData.convertionMatrix = iter->second;
 
         //read out the connectionFormats
-        std::string commandConnectionFormat = "SELECT soundFormat FROM GatewaySourceFormat" + i2s(gatewayData.gatewayID);
+        std::string commandConnectionFormat = "SELECT soundFormat FROM " + std::string(GATEWAYSOURCEFORMAT_TABLE) + " WHERE gatewayID=? ORDER BY rowid";
         MY_SQLITE_PREPARE_V2(mpDatabase, commandConnectionFormat.c_str(), -1, &qSourceConnectionFormat, NULL)
+        MY_SQLITE_BIND_INT(qSourceConnectionFormat, 1, gatewayData.gatewayID)
         while ((eCode = sqlite3_step(qSourceConnectionFormat)) == SQLITE_ROW)
         {
             tempConnectionFormat = (am_ConnectionFormat_e) sqlite3_column_int(qSourceConnectionFormat, 0);
@@ -1852,8 +2181,9 @@ am_Error_e CAmDatabaseHandler::getGatewayInfoDB(const am_gatewayID_t gatewayID,
         MY_SQLITE_FINALIZE(qSourceConnectionFormat)
 
         //read out sound properties
-        commandConnectionFormat = "SELECT soundFormat FROM GatewaySinkFormat" + i2s(gatewayData.gatewayID);
+        commandConnectionFormat = "SELECT soundFormat FROM " + std::string(GATEWAYSINKFORMAT_TABLE) + " WHERE gatewayID=? ORDER BY rowid";
         MY_SQLITE_PREPARE_V2(mpDatabase, commandConnectionFormat.c_str(), -1, &qSinkConnectionFormat, NULL)
+        MY_SQLITE_BIND_INT(qSinkConnectionFormat, 1, gatewayData.gatewayID)
         while ((eCode = sqlite3_step(qSinkConnectionFormat)) == SQLITE_ROW)
         {
             tempConnectionFormat = (am_ConnectionFormat_e) sqlite3_column_int(qSinkConnectionFormat, 0);
@@ -1886,8 +2216,9 @@ am_Error_e CAmDatabaseHandler::getCrossfaderInfoDB(const am_crossfaderID_t cross
     }
     sqlite3_stmt* query = NULL;
     int eCode = 0;
-    std::string command = "SELECT name, sinkID_A, sinkID_B, sourceID, hotSink,crossfaderID FROM " + std::string(CROSSFADER_TABLE) + " WHERE crossfaderID=" + i2s(crossfaderID);
+    std::string command = "SELECT name, sinkID_A, sinkID_B, sourceID, hotSink,crossfaderID FROM " + std::string(CROSSFADER_TABLE) + " WHERE crossfaderID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, crossfaderID)
 
     while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -1922,8 +2253,9 @@ am_Error_e CAmDatabaseHandler::getListSinksOfDomain(const am_domainID_t domainID
     sqlite3_stmt* query = NULL;
     int eCode = 0;
     am_sinkID_t temp;
-    std::string command = "SELECT sinkID FROM " + std::string(SINK_TABLE) + " WHERE reserved=0 AND domainID=" + (i2s(domainID));
+    std::string command = "SELECT sinkID FROM " + std::string(SINK_TABLE) + " WHERE reserved=0 AND domainID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, domainID)
 
     while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -1953,9 +2285,10 @@ am_Error_e CAmDatabaseHandler::getListSourcesOfDomain(const am_domainID_t domain
     sqlite3_stmt* query = NULL;
     int eCode = 0;
     am_sourceID_t temp;
-    std::string command = "SELECT sourceID FROM " + std::string(SOURCE_TABLE) + " WHERE reserved=0 AND domainID=" + i2s(domainID);
+    std::string command = "SELECT sourceID FROM " + std::string(SOURCE_TABLE) + " WHERE reserved=0 AND domainID=?";
 
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, domainID)
 
     while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -1987,8 +2320,9 @@ am_Error_e CAmDatabaseHandler::getListCrossfadersOfDomain(const am_domainID_t do
     int eCode = 0;
     am_crossfaderID_t temp;
 
-    std::string command = "SELECT c.crossfaderID FROM " + std::string(CROSSFADER_TABLE) + " c," + std::string(SOURCE_TABLE) + " s WHERE c.sourceID=s.sourceID AND s.domainID=" + i2s(domainID);
+    std::string command = "SELECT c.crossfaderID FROM " + std::string(CROSSFADER_TABLE) + " c," + std::string(SOURCE_TABLE) + " s WHERE c.sourceID=s.sourceID AND s.domainID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, domainID)
 
     while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -2021,8 +2355,9 @@ am_Error_e CAmDatabaseHandler::getListGatewaysOfDomain(const am_domainID_t domai
     int eCode = 0;
     am_gatewayID_t temp;
 
-    std::string command = "SELECT gatewayID FROM " + std::string(GATEWAY_TABLE) + " WHERE controlDomainID=" + i2s(domainID);
+    std::string command = "SELECT gatewayID FROM " + std::string(GATEWAY_TABLE) + " WHERE controlDomainID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, domainID)
 
     while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -2042,14 +2377,23 @@ am_Error_e CAmDatabaseHandler::getListGatewaysOfDomain(const am_domainID_t domai
     return (E_OK);
 }
 
+/**
+ * returns the main connections from the snapshot, they are read from the database only if they changed since the last call
+ */
 am_Error_e CAmDatabaseHandler::getListMainConnections(std::vector<am_MainConnection_s> & listMainConnections) const
+{
+    return (getSnapshot(mSnapshotMainConnections, &CAmDatabaseHandler::buildListMainConnections, listMainConnections));
+}
+
+am_Error_e CAmDatabaseHandler::buildListMainConnections(std::vector<am_MainConnection_s> & listMainConnections) const
 {
     listMainConnections.clear();
-    sqlite3_stmt *query = NULL, *query1 = NULL;
+    sqlite3_stmt *query = NULL;
     int eCode = 0;
     am_MainConnection_s temp;
+    std::map<am_mainConnectionID_t, size_t> mapIndex;
+    std::map<am_mainConnectionID_t, size_t>::const_iterator indexIterator;
     std::string command = "SELECT mainConnectionID, sourceID, sinkID, connectionState, delay FROM " + std::string(MAINCONNECTION_TABLE);
-    std::string command1 = "SELECT connectionID FROM MainConnectionRoute";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
 
     while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
@@ -2059,14 +2403,28 @@ am_Error_e CAmDatabaseHandler::getListMainConnections(std::vector<am_MainConnect
         temp.sinkID = sqlite3_column_int(query, 2);
         temp.connectionState = (am_ConnectionState_e) sqlite3_column_int(query, 3);
         temp.delay = sqlite3_column_int(query, 4);
-        std::string statement = command1 + i2s(temp.mainConnectionID);
-        MY_SQLITE_PREPARE_V2(mpDatabase, statement.c_str(), -1, &query1, NULL)
-        while ((eCode = sqlite3_step(query1)) == SQLITE_ROW)
-        {
-            temp.listConnectionID.push_back(sqlite3_column_int(query1, 0));
-        }
+        mapIndex[temp.mainConnectionID] = listMainConnections.size();
         listMainConnections.push_back(temp);
-        MY_SQLITE_FINALIZE(query1)
+    }
+
+    if (eCode != SQLITE_DONE)
+    {
+        logError("DatabaseHandler::getListMainConnections SQLITE error code:", eCode);
+        MY_SQLITE_FINALIZE(query)
+        return (E_DATABASE_ERROR);
+    }
+
+    MY_SQLITE_FINALIZE(query)
+
+    //all routes are read in one go and sorted to their main connections
+    command = "SELECT mainConnectionID, connectionID FROM " + std::string(MAINCONNECTIONROUTE_TABLE) + " ORDER BY rowid";
+    MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+
+    while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
+    {
+        indexIterator = mapIndex.find(sqlite3_column_int(query, 0));
+        if (indexIterator != mapIndex.end())
+            listMainConnections[indexIterator->second].listConnectionID.push_back(sqlite3_column_int(query, 1));
     }
 
     if (eCode != SQLITE_DONE)
@@ -2145,15 +2503,24 @@ am_Error_e CAmDatabaseHandler::getListConnections(std::vector<am_Connection_s> &
     return (E_OK);
 }
 
+/**
+ * returns the sinks from the snapshot, they are read from the database only if they changed since the last call
+ */
 am_Error_e CAmDatabaseHandler::getListSinks(std::vector<am_Sink_s> & listSinks) const
+{
+    return (getSnapshot(mSnapshotSinks, &CAmDatabaseHandler::buildListSinks, listSinks));
+}
+
+am_Error_e CAmDatabaseHandler::buildListSinks(std::vector<am_Sink_s> & listSinks) const
 {
     listSinks.clear();
-    sqlite3_stmt* query = NULL, *qConnectionFormat = NULL, *qSoundProperty = NULL, *qMAinSoundProperty = NULL;
+    sqlite3_stmt* query = NULL;
     int eCode = 0;
     am_Sink_s temp;
-    am_ConnectionFormat_e tempConnectionFormat;
     am_SoundProperty_s tempSoundProperty;
     am_MainSoundProperty_s tempMainSoundProperty;
+    std::map<am_sinkID_t, size_t> mapIndex;
+    std::map<am_sinkID_t, size_t>::const_iterator indexIterator;
     std::string command = "SELECT name, domainID, sinkClassID, volume, visible, availability, availabilityReason, muteState, mainVolume, sinkID FROM " + std::string(SINK_TABLE) + " WHERE reserved=0";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
 
@@ -2169,49 +2536,75 @@ am_Error_e CAmDatabaseHandler::getListSinks(std::vector<am_Sink_s> & listSinks)
         temp.muteState = (am_MuteState_e) sqlite3_column_int(query, 7);
         temp.mainVolume = sqlite3_column_int(query, 8);
         temp.sinkID = sqlite3_column_int(query, 9);
+        mapIndex[temp.sinkID] = listSinks.size();
+        listSinks.push_back(temp);
+    }
 
-        //read out the connectionFormats
-        std::string commandConnectionFormat = "SELECT soundFormat FROM SinkConnectionFormat" + i2s(temp.sinkID);
-        MY_SQLITE_PREPARE_V2(mpDatabase, commandConnectionFormat.c_str(), -1, &qConnectionFormat, NULL)
-        while ((eCode = sqlite3_step(qConnectionFormat)) == SQLITE_ROW)
-        {
-            tempConnectionFormat = (am_ConnectionFormat_e) sqlite3_column_int(qConnectionFormat, 0);
-            temp.listConnectionFormats.push_back(tempConnectionFormat);
-        }
+    if (eCode != SQLITE_DONE)
+    {
+        logError("DatabaseHandler::getListSinks SQLITE error code:", eCode);
+        MY_SQLITE_FINALIZE(query)
+        return (E_DATABASE_ERROR);
+    }
 
-        MY_SQLITE_FINALIZE(qConnectionFormat)
+    MY_SQLITE_FINALIZE(query)
 
-        //read out sound properties
-        std::string commandSoundProperty = "SELECT soundPropertyType, value FROM SinkSoundProperty" + i2s(temp.sinkID);
-        MY_SQLITE_PREPARE_V2(mpDatabase, commandSoundProperty.c_str(), -1, &qSoundProperty, NULL)
-        while ((eCode = sqlite3_step(qSoundProperty)) == SQLITE_ROW)
+    //the lists are read with one query per table and sorted to their sinks, rows of reserved sinks are skipped
+    command = "SELECT sinkID, soundFormat FROM " + std::string(SINKCONNECTIONFORMAT_TABLE) + " ORDER BY rowid";
+    MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+
+    while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
+    {
+        indexIterator = mapIndex.find(sqlite3_column_int(query, 0));
+        if (indexIterator != mapIndex.end())
+            listSinks[indexIterator->second].listConnectionFormats.push_back((am_ConnectionFormat_e) sqlite3_column_int(query, 1));
+    }
+
+    if (eCode != SQLITE_DONE)
+    {
+        logError("DatabaseHandler::getListSinks SQLITE error code:", eCode);
+        MY_SQLITE_FINALIZE(query)
+        return (E_DATABASE_ERROR);
+    }
+
+    MY_SQLITE_FINALIZE(query)
+
+    command = "SELECT sinkID, soundPropertyType, value FROM " + std::string(SINKSOUNDPROPERTY_TABLE) + " ORDER BY rowid";
+    MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+
+    while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
+    {
+        indexIterator = mapIndex.find(sqlite3_column_int(query, 0));
+        if (indexIterator != mapIndex.end())
         {
-            tempSoundProperty.type = (am_SoundPropertyType_e) sqlite3_column_int(qSoundProperty, 0);
-            tempSoundProperty.value = sqlite3_column_int(qSoundProperty, 1);
-            temp.listSoundProperties.push_back(tempSoundProperty);
+            tempSoundProperty.type = (am_SoundPropertyType_e) sqlite3_column_int(query, 1);
+            tempSoundProperty.value = sqlite3_column_int(query, 2);
+            listSinks[indexIterator->second].listSoundProperties.push_back(tempSoundProperty);
         }
+    }
 
-        MY_SQLITE_FINALIZE(qSoundProperty)
+    if (eCode != SQLITE_DONE)
+    {
+        logError("DatabaseHandler::getListSinks SQLITE error code:", eCode);
+        MY_SQLITE_FINALIZE(query)
+        return (E_DATABASE_ERROR);
+    }
 
-        //read out MainSoundProperties if sink is visible
-        if(temp.visible)
-        {
-            std::string commandMainSoundProperty = "SELECT soundPropertyType, value FROM SinkMainSoundProperty" + i2s(temp.sinkID);
-            MY_SQLITE_PREPARE_V2(mpDatabase, commandMainSoundProperty.c_str(), -1, &qMAinSoundProperty, NULL)
-            while ((eCode = sqlite3_step(qMAinSoundProperty)) == SQLITE_ROW)
-            {
-                tempMainSoundProperty.type = (am_MainSoundPropertyType_e) sqlite3_column_int(qMAinSoundProperty, 0);
-                tempMainSoundProperty.value = sqlite3_column_int(qMAinSoundProperty, 1);
-                temp.listMainSoundProperties.push_back(tempMainSoundProperty);
-            }
+    MY_SQLITE_FINALIZE(query)
 
-            MY_SQLITE_FINALIZE(qMAinSoundProperty)
-        }
+    //MainSoundProperties are only reported for visible sinks
+    command = "SELECT sinkID, soundPropertyType, value FROM " + std::string(SINKMAINSOUNDPROPERTY_TABLE) + " ORDER BY rowid";
+    MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
 
-        listSinks.push_back(temp);
-        temp.listConnectionFormats.clear();
-        temp.listMainSoundProperties.clear();
-        temp.listSoundProperties.clear();
+    while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
+    {
+        indexIterator = mapIndex.find(sqlite3_column_int(query, 0));
+        if (indexIterator != mapIndex.end() && listSinks[indexIterator->second].visible)
+        {
+            tempMainSoundProperty.type = (am_MainSoundPropertyType_e) sqlite3_column_int(query, 1);
+            tempMainSoundProperty.value = sqlite3_column_int(query, 2);
+            listSinks[indexIterator->second].listMainSoundProperties.push_back(tempMainSoundProperty);
+        }
     }
 
     if (eCode != SQLITE_DONE)
@@ -2226,15 +2619,24 @@ am_Error_e CAmDatabaseHandler::getListSinks(std::vector<am_Sink_s> & listSinks)
     return (E_OK);
 }
 
+/**
+ * returns the sources from the snapshot, they are read from the database only if they changed since the last call
+ */
 am_Error_e CAmDatabaseHandler::getListSources(std::vector<am_Source_s> & listSources) const
+{
+    return (getSnapshot(mSnapshotSources, &CAmDatabaseHandler::buildListSources, listSources));
+}
+
+am_Error_e CAmDatabaseHandler::buildListSources(std::vector<am_Source_s> & listSources) const
 {
     listSources.clear();
-    sqlite3_stmt* query = NULL, *qConnectionFormat = NULL, *qSoundProperty = NULL, *qMAinSoundProperty = NULL;
+    sqlite3_stmt* query = NULL;
     int eCode = 0;
     am_Source_s temp;
-    am_ConnectionFormat_e tempConnectionFormat;
     am_SoundProperty_s tempSoundProperty;
     am_MainSoundProperty_s tempMainSoundProperty;
+    std::map<am_sourceID_t, size_t> mapIndex;
+    std::map<am_sourceID_t, size_t>::const_iterator indexIterator;
     std::string command = "SELECT name, domainID, sourceClassID, sourceState, volume, visible, availability, availabilityReason, interruptState, sourceID FROM " + std::string(SOURCE_TABLE) + " WHERE reserved=0";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
 
@@ -2250,50 +2652,75 @@ am_Error_e CAmDatabaseHandler::getListSources(std::vector<am_Source_s> & listSou
         temp.available.availabilityReason = (am_AvailabilityReason_e) sqlite3_column_int(query, 7);
         temp.interruptState = (am_InterruptState_e) sqlite3_column_int(query, 8);
         temp.sourceID = sqlite3_column_int(query, 9);
+        mapIndex[temp.sourceID] = listSources.size();
+        listSources.push_back(temp);
+    }
 
-        //read out the connectionFormats
-        std::string commandConnectionFormat = "SELECT soundFormat FROM SourceConnectionFormat" + i2s(temp.sourceID);
-        MY_SQLITE_PREPARE_V2(mpDatabase, commandConnectionFormat.c_str(), -1, &qConnectionFormat, NULL)
-        while ((eCode = sqlite3_step(qConnectionFormat)) == SQLITE_ROW)
-        {
-            tempConnectionFormat = (am_ConnectionFormat_e) sqlite3_column_int(qConnectionFormat, 0);
-            temp.listConnectionFormats.push_back(tempConnectionFormat);
-        }
+    if (eCode != SQLITE_DONE)
+    {
+        logError("DatabaseHandler::getListSources SQLITE error code:", eCode);
+        MY_SQLITE_FINALIZE(query)
+        return (E_DATABASE_ERROR);
+    }
 
-        MY_SQLITE_FINALIZE(qConnectionFormat)
+    MY_SQLITE_FINALIZE(query)
 
-        //read out sound properties
-        std::string commandSoundProperty = "SELECT soundPropertyType, value FROM SourceSoundProperty" + i2s(temp.sourceID);
-        MY_SQLITE_PREPARE_V2(mpDatabase, commandSoundProperty.c_str(), -1, &qSoundProperty, NULL)
-        while ((eCode = sqlite3_step(qSoundProperty)) == SQLITE_ROW)
-        {
-            tempSoundProperty.type = (am_SoundPropertyType_e) sqlite3_column_int(qSoundProperty, 0);
-            tempSoundProperty.value = sqlite3_column_int(qSoundProperty, 1);
-            temp.listSoundProperties.push_back(tempSoundProperty);
-        }
+    //the lists are read with one query per table and sorted to their sources, rows of reserved sources are skipped
+    command = "SELECT sourceID, soundFormat FROM " + std::string(SOURCECONNECTIONFORMAT_TABLE) + " ORDER BY rowid";
+    MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
 
-        MY_SQLITE_FINALIZE(qSoundProperty)
+    while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
+    {
+        indexIterator = mapIndex.find(sqlite3_column_int(query, 0));
+        if (indexIterator != mapIndex.end())
+            listSources[indexIterator->second].listConnectionFormats.push_back((am_ConnectionFormat_e) sqlite3_column_int(query, 1));
+    }
 
-        //read out MainSoundProperties if source is visible
-        if(temp.visible)
-        {
-            std::string commandMainSoundProperty = "SELECT soundPropertyType, value FROM SourceMainSoundProperty" + i2s(temp.sourceID);
-            MY_SQLITE_PREPARE_V2(mpDatabase, commandMainSoundProperty.c_str(), -1, &qMAinSoundProperty, NULL)
-            while ((eCode = sqlite3_step(qMAinSoundProperty)) == SQLITE_ROW)
-            {
-                tempMainSoundProperty.type = (am_MainSoundPropertyType_e) sqlite3_column_int(qMAinSoundProperty, 0);
-                tempMainSoundProperty.value = sqlite3_column_int(qMAinSoundProperty, 1);
-                temp.listMainSoundProperties.push_back(tempMainSoundProperty);
-            }
+    if (eCode != SQLITE_DONE)
+    {
+        logError("DatabaseHandler::getListSources SQLITE error code:", eCode);
+        MY_SQLITE_FINALIZE(query)
+        return (E_DATABASE_ERROR);
+    }
 
-            MY_SQLITE_FINALIZE(qMAinSoundProperty)
+    MY_SQLITE_FINALIZE(query)
+
+    command = "SELECT sourceID, soundPropertyType, value FROM " + std::string(SOURCESOUNDPROPERTY_TABLE) + " ORDER BY rowid";
+    MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+
+    while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
+    {
+        indexIterator = mapIndex.find(sqlite3_column_int(query, 0));
+        if (indexIterator != mapIndex.end())
+        {
+            tempSoundProperty.type = (am_SoundPropertyType_e) sqlite3_column_int(query, 1);
+            tempSoundProperty.value = sqlite3_column_int(query, 2);
+            listSources[indexIterator->second].listSoundProperties.push_back(tempSoundProperty);
         }
+    }
 
+    if (eCode != SQLITE_DONE)
+    {
+        logError("DatabaseHandler::getListSources SQLITE error code:", eCode);
+        MY_SQLITE_FINALIZE(query)
+        return (E_DATABASE_ERROR);
+    }
 
-        listSources.push_back(temp);
-        temp.listConnectionFormats.clear();
-        temp.listMainSoundProperties.clear();
-        temp.listSoundProperties.clear();
+    MY_SQLITE_FINALIZE(query)
+
+    //MainSoundProperties are only reported for visible sources
+    command = "SELECT sourceID, soundPropertyType, value FROM " + std::string(SOURCEMAINSOUNDPROPERTY_TABLE) + " ORDER BY rowid";
+    MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+
+    while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
+    {
+        indexIterator = mapIndex.find(sqlite3_column_int(query, 0));
+        if (indexIterator != mapIndex.end() && listSources[indexIterator->second].visible)
+        {
+            tempMainSoundProperty.type = (am_MainSoundPropertyType_e) sqlite3_column_int(query, 1);
+            tempMainSoundProperty.value = sqlite3_column_int(query, 2);
+            listSources[indexIterator->second].listMainSoundProperties.push_back(tempMainSoundProperty);
+        }
     }
 
     if (eCode != SQLITE_DONE)
@@ -2327,8 +2754,9 @@ am_Error_e CAmDatabaseHandler::getListSourceClasses(std::vector<am_SourceClass_s
         classTemp.name = std::string((const char*) sqlite3_column_text(query, 1));
 
         //read out Properties
-        command2 = "SELECT classProperty, value FROM SourceClassProperties" + i2s(classTemp.sourceClassID);
+        command2 = "SELECT classProperty, value FROM " + std::string(SOURCECLASSPROPERTY_TABLE) + " WHERE sourceClassID=? ORDER BY rowid";
         MY_SQLITE_PREPARE_V2(mpDatabase, command2.c_str(), -1, &subQuery, NULL)
+        MY_SQLITE_BIND_INT(subQuery, 1, classTemp.sourceClassID)
 
         while ((eCode1 = sqlite3_step(subQuery)) == SQLITE_ROW)
         {
@@ -2427,8 +2855,9 @@ am_Error_e CAmDatabaseHandler::getListGateways(std::vector<am_Gateway_s> & listG
         temp.convertionMatrix = iter->second;
 
         //read out the connectionFormats
-        std::string commandConnectionFormat = "SELECT soundFormat FROM GatewaySourceFormat" + i2s(temp.gatewayID);
+        std::string commandConnectionFormat = "SELECT soundFormat FROM " + std::string(GATEWAYSOURCEFORMAT_TABLE) + " WHERE gatewayID=? ORDER BY rowid";
         MY_SQLITE_PREPARE_V2(mpDatabase, commandConnectionFormat.c_str(), -1, &qSourceConnectionFormat, NULL)
+        MY_SQLITE_BIND_INT(qSourceConnectionFormat, 1, temp.gatewayID)
         while ((eCode = sqlite3_step(qSourceConnectionFormat)) == SQLITE_ROW)
         {
             tempConnectionFormat = (am_ConnectionFormat_e) sqlite3_column_int(qSourceConnectionFormat, 0);
@@ -2438,8 +2867,9 @@ am_Error_e CAmDatabaseHandler::getListGateways(std::vector<am_Gateway_s> & listG
         MY_SQLITE_FINALIZE(qSourceConnectionFormat)
 
         //read out sound properties
-        commandConnectionFormat = "SELECT soundFormat FROM GatewaySinkFormat" + i2s(temp.gatewayID);
+        commandConnectionFormat = "SELECT soundFormat FROM " + std::string(GATEWAYSINKFORMAT_TABLE) + " WHERE gatewayID=? ORDER BY rowid";
         MY_SQLITE_PREPARE_V2(mpDatabase, commandConnectionFormat.c_str(), -1, &qSinkConnectionFormat, NULL)
+        MY_SQLITE_BIND_INT(qSinkConnectionFormat, 1, temp.gatewayID)
         while ((eCode = sqlite3_step(qSinkConnectionFormat)) == SQLITE_ROW)
         {
             tempConnectionFormat = (am_ConnectionFormat_e) sqlite3_column_int(qSinkConnectionFormat, 0);
@@ -2484,8 +2914,9 @@ am_Error_e CAmDatabaseHandler::getListSinkClasses(std::vector<am_SinkClass_s> &
         classTemp.name = std::string((const char*) sqlite3_column_text(query, 1));
 
         //read out Properties
-        command2 = "SELECT classProperty, value FROM SinkClassProperties" + i2s(classTemp.sinkClassID);
+        command2 = "SELECT classProperty, value FROM " + std::string(SINKCLASSPROPERTY_TABLE) + " WHERE sinkClassID=? ORDER BY rowid";
         MY_SQLITE_PREPARE_V2(mpDatabase, command2.c_str(), -1, &subQuery, NULL)
+        MY_SQLITE_BIND_INT(subQuery, 1, classTemp.sinkClassID)
 
         while ((eCode = sqlite3_step(subQuery)) == SQLITE_ROW)
         {
@@ -2518,7 +2949,15 @@ am_Error_e CAmDatabaseHandler::getListSinkClasses(std::vector<am_SinkClass_s> &
     return (E_OK);
 }
 
+/**
+ * returns the visible main connections from the snapshot, they are read from the database only if they changed since the last call
+ */
 am_Error_e CAmDatabaseHandler::getListVisibleMainConnections(std::vector<am_MainConnectionType_s> & listConnections) const
+{
+    return (getSnapshot(mSnapshotVisibleMainConnections, &CAmDatabaseHandler::buildListVisibleMainConnections, listConnections));
+}
+
+am_Error_e CAmDatabaseHandler::buildListVisibleMainConnections(std::vector<am_MainConnectionType_s> & listConnections) const
 {
     listConnections.clear();
     sqlite3_stmt *query = NULL;
@@ -2550,7 +2989,15 @@ am_Error_e CAmDatabaseHandler::getListVisibleMainConnections(std::vector<am_Main
     return (E_OK);
 }
 
+/**
+ * returns the main sinks from the snapshot, they are read from the database only if they changed since the last call
+ */
 am_Error_e CAmDatabaseHandler::getListMainSinks(std::vector<am_SinkType_s> & listMainSinks) const
+{
+    return (getSnapshot(mSnapshotMainSinks, &CAmDatabaseHandler::buildListMainSinks, listMainSinks));
+}
+
+am_Error_e CAmDatabaseHandler::buildListMainSinks(std::vector<am_SinkType_s> & listMainSinks) const
 {
     listMainSinks.clear();
     sqlite3_stmt* query = NULL;
@@ -2584,7 +3031,15 @@ am_Error_e CAmDatabaseHandler::getListMainSinks(std::vector<am_SinkType_s> & lis
     return (E_OK);
 }
 
+/**
+ * returns the main sources from the snapshot, they are read from the database only if they changed since the last call
+ */
 am_Error_e CAmDatabaseHandler::getListMainSources(std::vector<am_SourceType_s> & listMainSources) const
+{
+    return (getSnapshot(mSnapshotMainSources, &CAmDatabaseHandler::buildListMainSources, listMainSources));
+}
+
+am_Error_e CAmDatabaseHandler::buildListMainSources(std::vector<am_SourceType_s> & listMainSources) const
 {
     listMainSources.clear();
     sqlite3_stmt* query = NULL;
@@ -2626,8 +3081,9 @@ am_Error_e CAmDatabaseHandler::getListMainSinkSoundProperties(const am_sinkID_t
     sqlite3_stmt* query = NULL;
     int eCode = 0;
     am_MainSoundProperty_s temp;
-    std::string command = "SELECT soundPropertyType, value FROM SinkMainSoundProperty" + i2s(sinkID);
+    std::string command = "SELECT soundPropertyType, value FROM " + std::string(SINKMAINSOUNDPROPERTY_TABLE) + " WHERE sinkID=? ORDER BY rowid";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, sinkID)
 
     while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -2658,8 +3114,9 @@ am_Error_e CAmDatabaseHandler::getListMainSourceSoundProperties(const am_sourceI
     sqlite3_stmt* query = NULL;
     int eCode = 0;
     am_MainSoundProperty_s temp;
-    std::string command = "SELECT soundPropertyType, value FROM SourceMainSoundProperty" + i2s(sourceID);
+    std::string command = "SELECT soundPropertyType, value FROM " + std::string(SOURCEMAINSOUNDPROPERTY_TABLE) + " WHERE sourceID=? ORDER BY rowid";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, sourceID)
 
     while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -2715,8 +3172,9 @@ am_Error_e am::CAmDatabaseHandler::getListSinkConnectionFormats(const am_sinkID_
     sqlite3_stmt *qConnectionFormat = NULL;
     int eCode = 0;
     am_ConnectionFormat_e tempConnectionFormat;
-    std::string commandConnectionFormat = "SELECT soundFormat FROM SinkConnectionFormat" + i2s(sinkID);
+    std::string commandConnectionFormat = "SELECT soundFormat FROM " + std::string(SINKCONNECTIONFORMAT_TABLE) + " WHERE sinkID=? ORDER BY rowid";
     MY_SQLITE_PREPARE_V2(mpDatabase, commandConnectionFormat.c_str(), -1, &qConnectionFormat, NULL)
+    MY_SQLITE_BIND_INT(qConnectionFormat, 1, sinkID)
     while ((eCode = sqlite3_step(qConnectionFormat)) == SQLITE_ROW)
     {
         tempConnectionFormat = (am_ConnectionFormat_e) sqlite3_column_int(qConnectionFormat, 0);
@@ -2736,8 +3194,9 @@ am_Error_e am::CAmDatabaseHandler::getListSourceConnectionFormats(const am_sourc
     am_ConnectionFormat_e tempConnectionFormat;
 
     //read out the connectionFormats
-    std::string commandConnectionFormat = "SELECT soundFormat FROM SourceConnectionFormat" + i2s(sourceID);
+    std::string commandConnectionFormat = "SELECT soundFormat FROM " + std::string(SOURCECONNECTIONFORMAT_TABLE) + " WHERE sourceID=? ORDER BY rowid";
     MY_SQLITE_PREPARE_V2(mpDatabase, commandConnectionFormat.c_str(), -1, &qConnectionFormat, NULL)
+    MY_SQLITE_BIND_INT(qConnectionFormat, 1, sourceID)
     while ((eCode = sqlite3_step(qConnectionFormat)) == SQLITE_ROW)
     {
         tempConnectionFormat = (am_ConnectionFormat_e) sqlite3_column_int(qConnectionFormat, 0);
@@ -2771,8 +3230,9 @@ am_Error_e CAmDatabaseHandler::getTimingInformation(const am_mainConnectionID_t
     sqlite3_stmt *query = NULL;
     int eCode = 0;
 
-    std::string command = "SELECT delay FROM " + std::string(MAINCONNECTION_TABLE) + " WHERE mainConnectionID=" + i2s(mainConnectionID);
+    std::string command = "SELECT delay FROM " + std::string(MAINCONNECTION_TABLE) + " WHERE mainConnectionID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, mainConnectionID)
 
     while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -2832,6 +3292,7 @@ am_Error_e CAmDatabaseHandler::changeDelayMainConnection(const am_timeSync_t & d
         MY_SQLITE_FINALIZE(query)
         return (E_OK);
     }
+    MY_SQLITE_FINALIZE(query)
     command = "UPDATE " + std::string(MAINCONNECTION_TABLE) + " SET delay=? WHERE mainConnectionID=?;";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
     MY_SQLITE_BIND_INT(query, 1, delay)
@@ -2882,6 +3343,10 @@ am_Error_e CAmDatabaseHandler::enterConnectionDB(const am_Connection_s& connecti
     connectionID = sqlite3_last_insert_rowid(mpDatabase);
 
     logInfo("DatabaseHandler::enterConnectionDB entered new connection sourceID=", connection.sourceID, "sinkID=", connection.sinkID, "sourceID=", connection.sourceID, "connectionFormat=", connection.connectionFormat, "assigned ID=", connectionID);
+    am_Connection_s newConnection = connection;
+    newConnection.connectionID = connectionID;
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->newConnection(newConnection);
     return (E_OK);
 }
 
@@ -2934,19 +3399,15 @@ am_Error_e CAmDatabaseHandler::enterSinkClassDB(const am_SinkClass_s & sinkClass
 
     sinkClassID = sqlite3_last_insert_rowid(mpDatabase); //todo:change last_insert implementations for mulithread usage...
 
-    //now we need to create the additional tables:
-    command = "CREATE TABLE SinkClassProperties" + i2s(sinkClassID) + std::string("(classProperty INTEGER, value INTEGER)");
-    if (!this->sqQuery(command))
-        return (E_DATABASE_ERROR);
-
-    //fill ConnectionFormats
-    command = "INSERT INTO SinkClassProperties" + i2s(sinkClassID) + std::string("(classProperty,value) VALUES (?,?)");
+    //fill ClassProperties
+    command = "INSERT INTO " + std::string(SINKCLASSPROPERTY_TABLE) + "(sinkClassID, classProperty, value) VALUES (?,?,?)";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
     std::vector<am_ClassProperty_s>::const_iterator Iterator = sinkClass.listClassProperties.begin();
     for (; Iterator < sinkClass.listClassProperties.end(); ++Iterator)
     {
-        MY_SQLITE_BIND_INT(query, 1, Iterator->classProperty)
-        MY_SQLITE_BIND_INT(query, 2, Iterator->value)
+        MY_SQLITE_BIND_INT(query, 1, sinkClassID)
+        MY_SQLITE_BIND_INT(query, 2, Iterator->classProperty)
+        MY_SQLITE_BIND_INT(query, 3, Iterator->value)
         if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
         {
             logError("DatabaseHandler::enterSinkClassDB SQLITE Step error code:", eCode);
@@ -3013,18 +3474,15 @@ am_Error_e CAmDatabaseHandler::enterSourceClassDB(am_sourceClass_t & sourceClass
 
     sourceClassID = sqlite3_last_insert_rowid(mpDatabase); //todo:change last_insert implementations for mulithread usage...
 
-    //now we need to create the additional tables:
-    command = "CREATE TABLE SourceClassProperties" + i2s(sourceClassID) + std::string("(classProperty INTEGER, value INTEGER)");
-    assert(sqQuery(command));
-
-    //fill ConnectionFormats
-    command = "INSERT INTO SourceClassProperties" + i2s(sourceClassID) + std::string("(classProperty,value) VALUES (?,?)");
+    //fill ClassProperties
+    command = "INSERT INTO " + std::string(SOURCECLASSPROPERTY_TABLE) + "(sourceClassID, classProperty, value) VALUES (?,?,?)";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
     std::vector<am_ClassProperty_s>::const_iterator Iterator = sourceClass.listClassProperties.begin();
     for (; Iterator < sourceClass.listClassProperties.end(); ++Iterator)
     {
-        MY_SQLITE_BIND_INT(query, 1, Iterator->classProperty)
-        MY_SQLITE_BIND_INT(query, 2, Iterator->value)
+        MY_SQLITE_BIND_INT(query, 1, sourceClassID)
+        MY_SQLITE_BIND_INT(query, 2, Iterator->classProperty)
+        MY_SQLITE_BIND_INT(query, 3, Iterator->value)
         if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
         {
             logError("DatabaseHandler::enterSourceClassDB SQLITE Step error code:", eCode);
@@ -3085,10 +3543,11 @@ am_Error_e CAmDatabaseHandler::enterSystemProperties(const std::vector<am_System
 bool CAmDatabaseHandler::existMainConnection(const am_mainConnectionID_t mainConnectionID) const
 {
     sqlite3_stmt* query = NULL;
-    std::string command = "SELECT mainConnectionID FROM " + std::string(MAINCONNECTION_TABLE) + " WHERE mainConnectionID=" + i2s(mainConnectionID);
+    std::string command = "SELECT mainConnectionID FROM " + std::string(MAINCONNECTION_TABLE) + " WHERE mainConnectionID=?";
     int eCode = 0;
     bool returnVal = true;
     MY_SQLITE_PREPARE_V2_BOOL(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT_BOOL(query, 1, mainConnectionID)
     if ((eCode = sqlite3_step(query)) == SQLITE_DONE)
         returnVal = false;
     else if (eCode != SQLITE_ROW)
@@ -3109,10 +3568,11 @@ bool CAmDatabaseHandler::existMainConnection(const am_mainConnectionID_t mainCon
 bool CAmDatabaseHandler::existSource(const am_sourceID_t sourceID) const
 {
     sqlite3_stmt* query = NULL;
-    std::string command = "SELECT sourceID FROM " + std::string(SOURCE_TABLE) + " WHERE reserved=0 AND sourceID=" + i2s(sourceID);
+    std::string command = "SELECT sourceID FROM " + std::string(SOURCE_TABLE) + " WHERE reserved=0 AND sourceID=?";
     int eCode = 0;
     bool returnVal = true;
     MY_SQLITE_PREPARE_V2_BOOL(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT_BOOL(query, 1, sourceID)
     if ((eCode = sqlite3_step(query)) == SQLITE_DONE)
         returnVal = false;
     else if (eCode != SQLITE_ROW)
@@ -3200,10 +3660,11 @@ bool CAmDatabaseHandler::existSourceName(const std::string & name) const
 bool CAmDatabaseHandler::existSink(const am_sinkID_t sinkID) const
 {
     sqlite3_stmt* query = NULL;
-    std::string command = "SELECT sinkID FROM " + std::string(SINK_TABLE) + " WHERE reserved=0 AND sinkID=" + i2s(sinkID);
+    std::string command = "SELECT sinkID FROM " + std::string(SINK_TABLE) + " WHERE reserved=0 AND sinkID=?";
     int eCode = 0;
     bool returnVal = true;
     MY_SQLITE_PREPARE_V2_BOOL(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT_BOOL(query, 1, sinkID)
 
     if ((eCode = sqlite3_step(query)) == SQLITE_DONE)
         returnVal = false;
@@ -3293,10 +3754,11 @@ bool CAmDatabaseHandler::existSinkName(const std::string & name) const
 bool CAmDatabaseHandler::existDomain(const am_domainID_t domainID) const
 {
     sqlite3_stmt* query = NULL;
-    std::string command = "SELECT domainID FROM " + std::string(DOMAIN_TABLE) + " WHERE reserved=0 AND domainID=" + i2s(domainID);
+    std::string command = "SELECT domainID FROM " + std::string(DOMAIN_TABLE) + " WHERE reserved=0 AND domainID=?";
     int eCode = 0;
     bool returnVal = true;
     MY_SQLITE_PREPARE_V2_BOOL(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT_BOOL(query, 1, domainID)
 
     if ((eCode = sqlite3_step(query)) == SQLITE_DONE)
         returnVal = false;
@@ -3318,10 +3780,11 @@ bool CAmDatabaseHandler::existDomain(const am_domainID_t domainID) const
 bool CAmDatabaseHandler::existGateway(const am_gatewayID_t gatewayID) const
 {
     sqlite3_stmt* query = NULL;
-    std::string command = "SELECT gatewayID FROM " + std::string(GATEWAY_TABLE) + " WHERE gatewayID=" + i2s(gatewayID);
+    std::string command = "SELECT gatewayID FROM " + std::string(GATEWAY_TABLE) + " WHERE gatewayID=?";
     int eCode = 0;
     bool returnVal = true;
     MY_SQLITE_PREPARE_V2_BOOL(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT_BOOL(query, 1, gatewayID)
 
     if ((eCode = sqlite3_step(query)) == SQLITE_DONE)
         returnVal = false;
@@ -3340,10 +3803,11 @@ am_Error_e CAmDatabaseHandler::getDomainOfSource(const am_sourceID_t sourceID, a
     assert(sourceID!=0);
 
     sqlite3_stmt* query = NULL;
-    std::string command = "SELECT domainID FROM " + std::string(SOURCE_TABLE) + " WHERE sourceID=" + i2s(sourceID);
+    std::string command = "SELECT domainID FROM " + std::string(SOURCE_TABLE) + " WHERE sourceID=?";
     int eCode = 0;
     am_Error_e returnVal = E_DATABASE_ERROR;
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, sourceID)
     if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
         domainID = sqlite3_column_int(query, 0);
@@ -3363,10 +3827,11 @@ am_Error_e am::CAmDatabaseHandler::getDomainOfSink(const am_sinkID_t sinkID, am_
     assert(sinkID!=0);
 
     sqlite3_stmt* query = NULL;
-    std::string command = "SELECT domainID FROM " + std::string(SINK_TABLE) + " WHERE sinkID=" + i2s(sinkID);
+    std::string command = "SELECT domainID FROM " + std::string(SINK_TABLE) + " WHERE sinkID=?";
     int eCode = 0;
     am_Error_e returnVal = E_DATABASE_ERROR;
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, sinkID)
 
     if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -3390,10 +3855,11 @@ am_Error_e am::CAmDatabaseHandler::getDomainOfSink(const am_sinkID_t sinkID, am_
 bool CAmDatabaseHandler::existSinkClass(const am_sinkClass_t sinkClassID) const
 {
     sqlite3_stmt* query = NULL;
-    std::string command = "SELECT sinkClassID FROM " + std::string(SINK_CLASS_TABLE) + " WHERE sinkClassID=" + i2s(sinkClassID);
+    std::string command = "SELECT sinkClassID FROM " + std::string(SINK_CLASS_TABLE) + " WHERE sinkClassID=?";
     int eCode = 0;
     bool returnVal = true;
     MY_SQLITE_PREPARE_V2_BOOL(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT_BOOL(query, 1, sinkClassID)
     if ((eCode = sqlite3_step(query)) == SQLITE_DONE)
         returnVal = false;
     else if (eCode != SQLITE_ROW)
@@ -3414,10 +3880,11 @@ bool CAmDatabaseHandler::existSinkClass(const am_sinkClass_t sinkClassID) const
 bool CAmDatabaseHandler::existSourceClass(const am_sourceClass_t sourceClassID) const
 {
     sqlite3_stmt* query = NULL;
-    std::string command = "SELECT sourceClassID FROM " + std::string(SOURCE_CLASS_TABLE) + " WHERE sourceClassID=" + i2s(sourceClassID);
+    std::string command = "SELECT sourceClassID FROM " + std::string(SOURCE_CLASS_TABLE) + " WHERE sourceClassID=?";
     int eCode = 0;
     bool returnVal = true;
     MY_SQLITE_PREPARE_V2_BOOL(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT_BOOL(query, 1, sourceClassID)
 
     if ((eCode = sqlite3_step(query)) == SQLITE_DONE)
         returnVal = false;
@@ -3435,8 +3902,8 @@ am_Error_e CAmDatabaseHandler::changeConnectionTimingInformation(const am_connec
 {
     assert(connectionID!=0);
 
-    sqlite3_stmt *query = NULL, *queryMainConnectionSubIDs = NULL;
-    int eCode = 0, eCode1 = 0;
+    sqlite3_stmt *query = NULL;
+    int eCode = 0;
     std::string command = "UPDATE " + std::string(CONNECTION_TABLE) + " set delay=? WHERE connectionID=?";
 
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
@@ -3454,30 +3921,15 @@ am_Error_e CAmDatabaseHandler::changeConnectionTimingInformation(const am_connec
 
     //now we need to find all mainConnections that use the changed connection and update their timing
 
-    int tempMainConnectionID;
-    //first get all route tables for all mainconnections
-    command = "SELECT name FROM sqlite_master WHERE type ='table' and name LIKE 'MainConnectionRoute%'";
+    //collect the mainconnections that use the connection first, their delay is changed after the query is done
+    std::vector<am_mainConnectionID_t> listMainConnectionID;
+    command = "SELECT DISTINCT mainConnectionID FROM " + std::string(MAINCONNECTIONROUTE_TABLE) + " WHERE connectionID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, connectionID)
 
     while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
-        //now check if the connection ID is in this table
-        std::string tablename = std::string((const char*) sqlite3_column_text(query, 0));
-        std::string command2 = "SELECT connectionID FROM " + tablename + " WHERE connectionID=" + i2s(connectionID);
-        MY_SQLITE_PREPARE_V2(mpDatabase, command2.c_str(), -1, &queryMainConnectionSubIDs, NULL)
-        if ((eCode1 = sqlite3_step(queryMainConnectionSubIDs)) == SQLITE_ROW)
-        {
-            //if the connection ID is in, recalculate the mainconnection delay
-            std::stringstream(tablename.substr(tablename.find_first_not_of("MainConnectionRoute"))) >> tempMainConnectionID;
-            changeDelayMainConnection(calculateMainConnectionDelay(tempMainConnectionID), tempMainConnectionID);
-        }
-        else if (eCode1 != SQLITE_DONE)
-        {
-            logError("DatabaseHandler::changeConnectionTimingInformation SQLITE error code:", eCode1);
-
-            return (E_DATABASE_ERROR);
-        }
-        MY_SQLITE_FINALIZE(queryMainConnectionSubIDs)
+        listMainConnectionID.push_back(sqlite3_column_int(query, 0));
     }
 
     if (eCode != SQLITE_DONE)
@@ -3489,6 +3941,13 @@ am_Error_e CAmDatabaseHandler::changeConnectionTimingInformation(const am_connec
 
     MY_SQLITE_FINALIZE(query)
 
+    //recalculate the delay of every mainconnection that uses the connection
+    std::vector<am_mainConnectionID_t>::const_iterator iter = listMainConnectionID.begin();
+    for (; iter != listMainConnectionID.end(); ++iter)
+    {
+        changeDelayMainConnection(calculateMainConnectionDelay(*iter), *iter);
+    }
+
     return (E_OK);
 }
 
@@ -3518,11 +3977,12 @@ am_timeSync_t CAmDatabaseHandler::calculateMainConnectionDelay(const am_mainConn
 {
     assert(mainConnectionID!=0);
     sqlite3_stmt* query = NULL;
-    std::string command = "SELECT sum(Connections.delay),min(Connections.delay) FROM " + std::string(CONNECTION_TABLE) + ",MainConnectionRoute" + i2s(mainConnectionID) + " WHERE MainConnectionRoute" + i2s(mainConnectionID) + ".connectionID = Connections.connectionID";
+    std::string command = "SELECT sum(Connections.delay),min(Connections.delay) FROM " + std::string(CONNECTION_TABLE) + "," + std::string(MAINCONNECTIONROUTE_TABLE) + " WHERE " + std::string(MAINCONNECTIONROUTE_TABLE) + ".mainConnectionID=? AND " + std::string(MAINCONNECTIONROUTE_TABLE) + ".connectionID = Connections.connectionID";
     int eCode = 0;
     am_timeSync_t delay = 0;
     am_timeSync_t min = 0;
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, mainConnectionID)
     if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
         delay = sqlite3_column_int(query, 0);
@@ -3535,10 +3995,9 @@ am_timeSync_t CAmDatabaseHandler::calculateMainConnectionDelay(const am_mainConn
         return (E_DATABASE_ERROR);
     }
 
-    if ((eCode = sqlite3_finalize(query)) != SQLITE_OK)
+    if ((eCode = mStatementCache.release(query)) != SQLITE_OK)
     {
         logError("DatabaseHandler::calculateMainConnectionDelay SQLITE Finalize error code:", eCode);
-        MY_SQLITE_FINALIZE(query)
         return (E_DATABASE_ERROR);
     }
     if (min < 0)
@@ -3557,6 +4016,92 @@ void CAmDatabaseHandler::registerObserver(CAmDatabaseObserver *iObserver)
     mpDatabaseObserver = iObserver;
 }
 
+/**
+ * starts a transaction. All changes until the matching commitTransaction are written in one sqlite transaction and the
+ * observer holds back its notifications until then. Transactions can be nested, only the outermost one is committed.
+ * @return E_OK on success, E_DATABASE_ERROR if the transaction could not be started
+ */
+am_Error_e CAmDatabaseHandler::beginTransaction()
+{
+    if (mTransactionDepth == 0)
+    {
+        if (!sqQuery("BEGIN TRANSACTION"))
+            return (E_DATABASE_ERROR);
+        if (mpDatabaseObserver)
+            mpDatabaseObserver->beginBatch();
+    }
+    mTransactionDepth++;
+    return (E_OK);
+}
+
+/**
+ * ends a transaction that was started with beginTransaction. The outermost commit writes the changes and lets the observer
+ * send the notifications it held back.
+ * @return E_OK on success, E_NOT_POSSIBLE if there is no open transaction, E_DATABASE_ERROR if the commit failed
+ */
+am_Error_e CAmDatabaseHandler::commitTransaction()
+{
+    if (mTransactionDepth == 0)
+    {
+        logError("DatabaseHandler::commitTransaction no transaction open");
+        return (E_NOT_POSSIBLE);
+    }
+
+    if (--mTransactionDepth != 0)
+        return (E_OK);
+
+    am_Error_e error = E_OK;
+    if (!sqQuery("COMMIT"))
+        error = E_DATABASE_ERROR;
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->commitBatch();
+    return (error);
+}
+
+/**
+ * returns the statement cache, so that hits, misses and times of the queries can be read out
+ * @return reference to the statement cache
+ */
+const CAmDatabaseStatementCache& CAmDatabaseHandler::getStatementCache() const
+{
+    return (mStatementCache);
+}
+
+/**
+ * sums up the statistics of the statement cache by the first keyword of the sql commands
+ * @param listStatistics one entry per keyword, for example SELECT or UPDATE
+ */
+void CAmDatabaseHandler::getStatementStatistics(std::vector<statementClassStatistic_s>& listStatistics) const
+{
+    listStatistics.clear();
+    std::vector<CAmDatabaseStatementCache::statementStatistic_s> listStatements;
+    mStatementCache.getStatistics(listStatements);
+    std::map<std::string, statementClassStatistic_s> mapClasses;
+    std::vector<CAmDatabaseStatementCache::statementStatistic_s>::const_iterator iter = listStatements.begin();
+    for (; iter != listStatements.end(); ++iter)
+    {
+        std::string name(iter->command.substr(0, iter->command.find(' ')));
+        std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+        statementClassStatistic_s& statistic(mapClasses[name]);
+        if (statistic.name.empty())
+        {
+            statistic.name = name;
+            statistic.count = 0;
+            statistic.timeNs = 0;
+        }
+        statistic.count += iter->hits + iter->misses;
+        statistic.timeNs += iter->timeNs;
+    }
+    std::map<std::string, statementClassStatistic_s>::const_iterator classIter = mapClasses.begin();
+    for (; classIter != mapClasses.end(); ++classIter)
+        listStatistics.push_back(classIter->second);
+}
+
+void CAmDatabaseHandler::resetStatementStatistics()
+{
+    mStatementCache.resetStatistics();
+}
+
 /**
  * gives information about the visibility of a source
  * @param sourceID the sourceID
@@ -3566,16 +4111,17 @@ bool CAmDatabaseHandler::sourceVisible(const am_sourceID_t sourceID) const
 {
     assert(sourceID!=0);
     sqlite3_stmt* query = NULL;
-    std::string command = "SELECT visible FROM " + std::string(SOURCE_TABLE) + " WHERE sourceID=" + i2s(sourceID);
+    std::string command = "SELECT visible FROM " + std::string(SOURCE_TABLE) + " WHERE sourceID=?";
     int eCode = 0;
     bool returnVal = false;
     MY_SQLITE_PREPARE_V2_BOOL(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT_BOOL(query, 1, sourceID)
 
-    if ((eCode = sqlite3_step(query)) == SQLITE_DONE)
+    if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
         returnVal = (bool) sqlite3_column_int(query, 0);
     }
-    else if (eCode != SQLITE_ROW)
+    else if (eCode != SQLITE_DONE)
     {
         returnVal = false;
         logError("DatabaseHandler::sourceVisible database error!:", eCode);
@@ -3593,15 +4139,16 @@ bool CAmDatabaseHandler::sourceVisible(const am_sourceID_t sourceID) const
 bool CAmDatabaseHandler::sinkVisible(const am_sinkID_t sinkID) const
 {
     sqlite3_stmt* query = NULL;
-    std::string command = "SELECT visible FROM " + std::string(SINK_TABLE) + " WHERE reserved=0 AND sinkID=" + i2s(sinkID);
+    std::string command = "SELECT visible FROM " + std::string(SINK_TABLE) + " WHERE reserved=0 AND sinkID=?";
     int eCode = 0;
     bool returnVal = false;
     MY_SQLITE_PREPARE_V2_BOOL(mpDatabase, command.c_str(), -1, &query, NULL)
-    if ((eCode = sqlite3_step(query)) == SQLITE_DONE)
+    MY_SQLITE_BIND_INT_BOOL(query, 1, sinkID)
+    if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
         returnVal = sqlite3_column_int(query, 0);
     }
-    else if (eCode != SQLITE_ROW)
+    else if (eCode != SQLITE_DONE)
     {
         returnVal = false;
         logError("DatabaseHandler::sinkVisible database error!:", eCode);
@@ -3722,9 +4269,10 @@ am_Error_e CAmDatabaseHandler::getSoureState(const am_sourceID_t sourceID, am_So
     assert(sourceID!=0);
     sqlite3_stmt* query = NULL;
     sourceState = SS_UNKNNOWN;
-    std::string command = "SELECT sourceState FROM " + std::string(SOURCE_TABLE) + " WHERE sourceID=" + i2s(sourceID);
+    std::string command = "SELECT sourceState FROM " + std::string(SOURCE_TABLE) + " WHERE sourceID=?";
     int eCode = 0;
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, sourceID)
     if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
         sourceState = (am_SourceState_e) sqlite3_column_int(query, 0);
@@ -3742,9 +4290,10 @@ am_Error_e CAmDatabaseHandler::changeSourceState(const am_sourceID_t sourceID, c
     assert(sourceID!=0);
     assert(sourceState>=SS_UNKNNOWN && sourceState<=SS_MAX);
     sqlite3_stmt* query = NULL;
-    std::string command = "UPDATE " + std::string(SOURCE_TABLE) + " SET sourceState=? WHERE sourceID=" + i2s(sourceID);
+    std::string command = "UPDATE " + std::string(SOURCE_TABLE) + " SET sourceState=? WHERE sourceID=?";
     int eCode = 0;
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 2, sourceID)
     MY_SQLITE_BIND_INT(query, 1, sourceState)
     if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
     {
@@ -3762,9 +4311,10 @@ am_Error_e CAmDatabaseHandler::getSinkVolume(const am_sinkID_t sinkID, am_volume
     assert(sinkID!=0);
     sqlite3_stmt* query = NULL;
     volume = -1;
-    std::string command = "SELECT volume FROM " + std::string(SINK_TABLE) + " WHERE sinkID=" + i2s(sinkID);
+    std::string command = "SELECT volume FROM " + std::string(SINK_TABLE) + " WHERE sinkID=?";
     int eCode = 0;
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, sinkID)
     if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
         volume = sqlite3_column_int(query, 0);
@@ -3782,9 +4332,10 @@ am_Error_e CAmDatabaseHandler::getSourceVolume(const am_sourceID_t sourceID, am_
     assert(sourceID!=0);
     sqlite3_stmt* query = NULL;
     volume = -1;
-    std::string command = "SELECT volume FROM " + std::string(SOURCE_TABLE) + " WHERE sourceID=" + i2s(sourceID);
+    std::string command = "SELECT volume FROM " + std::string(SOURCE_TABLE) + " WHERE sourceID=?";
     int eCode = 0;
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, sourceID)
     if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
         volume = sqlite3_column_int(query, 0);
@@ -3805,8 +4356,10 @@ am_Error_e CAmDatabaseHandler::getSinkSoundPropertyValue(const am_sinkID_t sinkI
 
     sqlite3_stmt* query = NULL;
     int eCode = 0;
-    std::string command = "SELECT value FROM SinkSoundProperty" + i2s(sinkID) + " WHERE soundPropertyType=" + i2s(propertyType);
+    std::string command = "SELECT value FROM " + std::string(SINKSOUNDPROPERTY_TABLE) + " WHERE soundPropertyType=? AND sinkID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 2, sinkID)
+    MY_SQLITE_BIND_INT(query, 1, propertyType)
 
     if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -3832,8 +4385,10 @@ am_Error_e CAmDatabaseHandler::getSourceSoundPropertyValue(const am_sourceID_t s
 
     sqlite3_stmt* query = NULL;
     int eCode = 0;
-    std::string command = "SELECT value FROM SourceSoundProperty" + i2s(sourceID) + " WHERE soundPropertyType=" + i2s(propertyType);
+    std::string command = "SELECT value FROM " + std::string(SOURCESOUNDPROPERTY_TABLE) + " WHERE soundPropertyType=? AND sourceID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 2, sourceID)
+    MY_SQLITE_BIND_INT(query, 1, propertyType)
 
     while ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
@@ -3857,9 +4412,10 @@ am_Error_e CAmDatabaseHandler::getDomainState(const am_domainID_t domainID, am_D
     assert(domainID!=0);
     sqlite3_stmt* query = NULL;
     state = DS_UNKNOWN;
-    std::string command = "SELECT domainState FROM " + std::string(DOMAIN_TABLE) + " WHERE domainID=" + i2s(domainID);
+    std::string command = "SELECT domainState FROM " + std::string(DOMAIN_TABLE) + " WHERE domainID=?";
     int eCode = 0;
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 1, domainID)
     if ((eCode = sqlite3_step(query)) == SQLITE_ROW)
     {
         state = (am_DomainState_e) sqlite3_column_int(query, 0);
@@ -4022,8 +4578,9 @@ am_Error_e CAmDatabaseHandler::changeSinkVolume(const am_sinkID_t sinkID, const
     {
         return (E_NON_EXISTENT);
     }
-    command = "UPDATE " + std::string(SINK_TABLE) + " SET volume=? WHERE sinkID=" + i2s(sinkID);
+    command = "UPDATE " + std::string(SINK_TABLE) + " SET volume=? WHERE sinkID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 2, sinkID)
     MY_SQLITE_BIND_INT(query, 1, volume)
     if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
     {
@@ -4049,8 +4606,9 @@ am_Error_e CAmDatabaseHandler::changeSourceVolume(const am_sourceID_t sourceID,
     {
         return (E_NON_EXISTENT);
     }
-    command = "UPDATE " + std::string(SOURCE_TABLE) + " SET volume=? WHERE sourceID=" + i2s(sourceID);
+    command = "UPDATE " + std::string(SOURCE_TABLE) + " SET volume=? WHERE sourceID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 2, sourceID)
     MY_SQLITE_BIND_INT(query, 1, volume)
     if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
     {
@@ -4078,8 +4636,10 @@ am_Error_e CAmDatabaseHandler::changeSourceSoundPropertyDB(const am_SoundPropert
     {
         return (E_NON_EXISTENT);
     }
-    command = "UPDATE SourceSoundProperty" + i2s(sourceID) + " SET value=? WHERE soundPropertyType=" + i2s(soundProperty.type);
+    command = "UPDATE " + std::string(SOURCESOUNDPROPERTY_TABLE) + " SET value=? WHERE soundPropertyType=? AND sourceID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 3, sourceID)
+    MY_SQLITE_BIND_INT(query, 2, soundProperty.type)
     MY_SQLITE_BIND_INT(query, 1, soundProperty.value)
     if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
     {
@@ -4106,8 +4666,10 @@ am_Error_e CAmDatabaseHandler::changeSinkSoundPropertyDB(const am_SoundProperty_
     {
         return (E_NON_EXISTENT);
     }
-    command = "UPDATE SinkSoundProperty" + i2s(sinkID) + " SET value=? WHERE soundPropertyType=" + i2s(soundProperty.type);
+    command = "UPDATE " + std::string(SINKSOUNDPROPERTY_TABLE) + " SET value=? WHERE soundPropertyType=? AND sinkID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 3, sinkID)
+    MY_SQLITE_BIND_INT(query, 2, soundProperty.type)
     MY_SQLITE_BIND_INT(query, 1, soundProperty.value)
     if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
     {
@@ -4135,8 +4697,9 @@ am_Error_e CAmDatabaseHandler::changeCrossFaderHotSink(const am_crossfaderID_t c
     {
         return (E_NON_EXISTENT);
     }
-    command = "UPDATE " + std::string(CROSSFADER_TABLE) + " SET hotsink=? WHERE crossfaderID=" + i2s(crossfaderID);
+    command = "UPDATE " + std::string(CROSSFADER_TABLE) + " SET hotsink=? WHERE crossfaderID=?";
     MY_SQLITE_PREPARE_V2(mpDatabase, command.c_str(), -1, &query, NULL)
+    MY_SQLITE_BIND_INT(query, 2, crossfaderID)
     MY_SQLITE_BIND_INT(query, 1, hotsink)
     if ((eCode = sqlite3_step(query)) != SQLITE_DONE)
     {
@@ -4261,5 +4824,10 @@ void CAmDatabaseHandler::createTables()
         if (!sqQuery("CREATE TABLE " + databaseTables[i]))
             throw std::runtime_error("CAmDatabaseHandler Could not create tables!");
     }
+    for (uint16_t i = 0; i < sizeof(databaseIndexes) / sizeof(databaseIndexes[0]); i++)
+    {
+        if (!sqQuery("CREATE INDEX " + databaseIndexes[i]))
+            throw std::runtime_error("CAmDatabaseHandler Could not create indexes!");
+    }
 }
 }
@@ -0,0 +1,1923 @@
+/**
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \author Christian Mueller, christian.ei.mueller@bmw.de BMW 2011,2012
+ *
+ * \file CAmDatabaseHandlerMap.cpp
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#include "CAmDatabaseHandlerMap.h"
+#include <cassert>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "CAmDatabaseObserver.h"
+#include "CAmRouter.h"
+#include "shared/CAmDltWrapper.h"
+
+namespace am
+{
+
+CAmDatabaseHandlerMap::CAmDatabaseHandlerMap() :
+        mpDatabaseObserver(NULL), //
+        mFirstStaticSink(true), //
+        mFirstStaticSource(true), //
+        mFirstStaticGateway(true), //
+        mFirstStaticSinkClass(true), //
+        mFirstStaticSourceClass(true), //
+        mFirstStaticCrossfader(true), //
+        mDomainMap(), //
+        mSinkMap(), //
+        mSourceMap(), //
+        mGatewayMap(), //
+        mCrossfaderMap(), //
+        mConnectionMap(), //
+        mMainConnectionMap(), //
+        mSinkClassMap(), //
+        mSourceClassMap(), //
+        mSystemProperties(), //
+        mDomainNames(), //
+        mSinkNames(), //
+        mSourceNames(), //
+        mCurrentDomainID(0), //
+        mCurrentSinkID(0), //
+        mCurrentSourceID(0), //
+        mCurrentGatewayID(0), //
+        mCurrentCrossfaderID(0), //
+        mCurrentConnectionID(0), //
+        mCurrentMainConnectionID(0), //
+        mCurrentSinkClassID(0), //
+        mCurrentSourceClassID(0), //
+        mTransactionDepth(0)
+{
+    logInfo("DatabaseHandlerMap::DatabaseHandlerMap using in-memory map storage");
+}
+
+CAmDatabaseHandlerMap::~CAmDatabaseHandlerMap()
+{
+    logInfo("Closed Database");
+}
+
+/**
+ * hands out the next ID of a table. Like sqlite AUTOINCREMENT, an ID is never handed out twice.
+ * @param currentID the highest ID used so far in the table
+ * @return the new ID
+ */
+uint16_t CAmDatabaseHandlerMap::nextID(uint16_t& currentID)
+{
+    return (++currentID);
+}
+
+/**
+ * registers an ID that was given from outside, so that the automatic numbering continues above it.
+ * @param currentID the highest ID used so far in the table
+ * @param id the ID that is used now
+ */
+void CAmDatabaseHandlerMap::useID(uint16_t& currentID, const uint16_t id)
+{
+    if (id > currentID)
+        currentID = id;
+}
+
+am_Error_e CAmDatabaseHandlerMap::enterDomainDB(const am_Domain_s & domainData, am_domainID_t & domainID)
+{
+    assert(domainData.domainID==0);
+    assert(!domainData.name.empty());
+    assert(!domainData.busname.empty());
+    assert(domainData.state>=DS_UNKNOWN && domainData.state<=DS_MAX);
+
+    //first check for a reserved domain
+    NameMap::const_iterator nameIterator = mDomainNames.find(domainData.name);
+    if (nameIterator != mDomainNames.end())
+    {
+        domainID = nameIterator->second;
+    }
+    else
+    {
+        domainID = nextID(mCurrentDomainID);
+        mDomainNames[domainData.name] = domainID;
+    }
+
+    am_Domain_Database_s& domain = mDomainMap[domainID];
+    static_cast<am_Domain_s&>(domain) = domainData;
+    domain.domainID = domainID;
+    domain.reserved = false;
+
+    logInfo("DatabaseHandlerMap::enterDomainDB entered new domain with name=", domainData.name, "busname=", domainData.busname, "nodename=", domainData.nodename, "assigned ID:", domainID);
+
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->newDomain(domain);
+
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::enterMainConnectionDB(const am_MainConnection_s & mainConnectionData, am_mainConnectionID_t & connectionID)
+{
+    assert(mainConnectionData.mainConnectionID==0);
+    assert(mainConnectionData.connectionState>=CS_UNKNOWN && mainConnectionData.connectionState<=CS_MAX);
+    assert(mainConnectionData.sinkID!=0);
+    assert(mainConnectionData.sourceID!=0);
+
+    am_timeSync_t delay = 0;
+    if (!calculateRouteDelay(mainConnectionData.listConnectionID, delay))
+    {
+        logError("DatabaseHandlerMap::enterMainConnectionDB did not find route for MainConnection");
+        return (E_DATABASE_ERROR);
+    }
+
+    connectionID = nextID(mCurrentMainConnectionID);
+    am_MainConnection_s& mainConnection = mMainConnectionMap[connectionID];
+    mainConnection = mainConnectionData;
+    mainConnection.mainConnectionID = connectionID;
+    mainConnection.delay = -1;
+
+    logInfo("DatabaseHandlerMap::enterMainConnectionDB entered new mainConnection with sourceID", mainConnectionData.sourceID, "sinkID:", mainConnectionData.sinkID, "delay:", delay, "assigned ID:", connectionID);
+
+    if (mpDatabaseObserver)
+    {
+        am_MainConnectionType_s mainConnectionType;
+        mainConnectionType.mainConnectionID = connectionID;
+        mainConnectionType.connectionState = mainConnectionData.connectionState;
+        mainConnectionType.delay = delay;
+        mainConnectionType.sinkID = mainConnectionData.sinkID;
+        mainConnectionType.sourceID = mainConnectionData.sourceID;
+        mpDatabaseObserver->newMainConnection(mainConnectionType);
+        mpDatabaseObserver->mainConnectionStateChanged(connectionID, mainConnectionData.connectionState);
+    }
+
+    //finally, we update the delay value for the maintable
+    if (delay == 0)
+        delay = -1;
+    return (changeDelayMainConnection(delay, connectionID));
+}
+
+am_Error_e CAmDatabaseHandlerMap::enterSinkDB(const am_Sink_s & sinkData, am_sinkID_t & sinkID)
+{
+    assert(sinkData.sinkID<DYNAMIC_ID_BOUNDARY);
+    assert(sinkData.domainID!=0);
+    assert(!sinkData.name.empty());
+    assert(sinkData.sinkClassID!=0);
+    //todo: need to check if class exists?
+    assert(!sinkData.listConnectionFormats.empty());
+    assert(sinkData.muteState>=MS_UNKNOWN && sinkData.muteState<=MS_MAX);
+
+    NameMap::const_iterator nameIterator = mSinkNames.find(sinkData.name);
+    if (nameIterator != mSinkNames.end() && mSinkMap[nameIterator->second].reserved)
+    {
+        //a reserved sink with this name exists, we take it over
+        sinkID = nameIterator->second;
+    }
+    //if sinkID is zero and the first Static Sink was already entered, the ID is created
+    else if (sinkData.sinkID == 0 && !mFirstStaticSink && !existSinkName(sinkData.name))
+    {
+        sinkID = nextID(mCurrentSinkID);
+    }
+    else
+    {
+        //check if the ID already exists
+        if (existSinkNameOrID(sinkData.sinkID, sinkData.name))
+            return (E_ALREADY_EXISTS);
+
+        if (sinkData.sinkID != 0)
+        {
+            sinkID = sinkData.sinkID;
+        }
+        //if the first static sink is entered, we need to set it onto the boundary
+        else
+        {
+            sinkID = DYNAMIC_ID_BOUNDARY;
+            mFirstStaticSink = false;
+        }
+        useID(mCurrentSinkID, sinkID);
+    }
+
+    am_Sink_Database_s& sink = mSinkMap[sinkID];
+    static_cast<am_Sink_s&>(sink) = sinkData;
+    sink.sinkID = sinkID;
+    sink.reserved = false;
+
+    //main sound properties are only kept for visible sinks
+    if (!sink.visible)
+        sink.listMainSoundProperties.clear();
+    mSinkNames[sinkData.name] = sinkID;
+
+    logInfo("DatabaseHandlerMap::enterSinkDB entered new sink with name", sinkData.name, "domainID:", sinkData.domainID, "classID:", sinkData.sinkClassID, "volume:", sinkData.volume, "assigned ID:", sinkID);
+
+    if (mpDatabaseObserver != NULL)
+        mpDatabaseObserver->newSink(sink);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::enterCrossfaderDB(const am_Crossfader_s & crossfaderData, am_crossfaderID_t & crossfaderID)
+{
+    assert(crossfaderData.crossfaderID<DYNAMIC_ID_BOUNDARY);
+    assert(crossfaderData.hotSink>=HS_UNKNOWN && crossfaderData.hotSink<=HS_MAX);
+    assert(!crossfaderData.name.empty());
+    assert(existSink(crossfaderData.sinkID_A));
+    assert(existSink(crossfaderData.sinkID_B));
+    assert(existSource(crossfaderData.sourceID));
+
+    //if crossfaderID is zero and the first Static crossfader was already entered, the ID is created
+    if (crossfaderData.crossfaderID == 0 && !mFirstStaticCrossfader)
+    {
+        crossfaderID = nextID(mCurrentCrossfaderID);
+    }
+    else
+    {
+        //check if the ID already exists
+        if (existcrossFader(crossfaderData.crossfaderID))
+            return (E_ALREADY_EXISTS);
+
+        if (crossfaderData.crossfaderID != 0)
+        {
+            crossfaderID = crossfaderData.crossfaderID;
+        }
+        //if the first static crossfader is entered, we need to set it onto the boundary
+        else
+        {
+            crossfaderID = DYNAMIC_ID_BOUNDARY;
+            mFirstStaticCrossfader = false;
+        }
+        useID(mCurrentCrossfaderID, crossfaderID);
+    }
+
+    am_Crossfader_s& crossfader = mCrossfaderMap[crossfaderID];
+    crossfader = crossfaderData;
+    crossfader.crossfaderID = crossfaderID;
+
+    logInfo("DatabaseHandlerMap::enterCrossfaderDB entered new crossfader with name=", crossfaderData.name, "sinkA= ", crossfaderData.sinkID_A, "sinkB=", crossfaderData.sinkID_B, "source=", crossfaderData.sourceID, "assigned ID:", crossfaderID);
+
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->newCrossfader(crossfader);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::enterGatewayDB(const am_Gateway_s & gatewayData, am_gatewayID_t & gatewayID)
+{
+    assert(gatewayData.gatewayID<DYNAMIC_ID_BOUNDARY);
+    assert(gatewayData.sinkID!=0);
+    assert(gatewayData.sourceID!=0);
+    assert(gatewayData.controlDomainID!=0);
+    assert(gatewayData.domainSinkID!=0);
+    assert(gatewayData.domainSourceID!=0);
+    assert(!gatewayData.name.empty());
+    assert(!gatewayData.convertionMatrix.empty());
+    assert(!gatewayData.listSinkFormats.empty());
+    assert(!gatewayData.listSourceFormats.empty());
+    assert(existSink(gatewayData.sinkID));
+    assert(existSource(gatewayData.sourceID));
+
+    //if gatewayID is zero and the first Static gateway was already entered, the ID is created
+    if (gatewayData.gatewayID == 0 && !mFirstStaticGateway)
+    {
+        gatewayID = nextID(mCurrentGatewayID);
+    }
+    else
+    {
+        //check if the ID already exists
+        if (existGateway(gatewayData.gatewayID))
+            return (E_ALREADY_EXISTS);
+
+        if (gatewayData.gatewayID != 0)
+        {
+            gatewayID = gatewayData.gatewayID;
+        }
+        //if the first static gateway is entered, we need to set it onto the boundary
+        else
+        {
+            gatewayID = DYNAMIC_ID_BOUNDARY;
+            mFirstStaticGateway = false;
+        }
+        useID(mCurrentGatewayID, gatewayID);
+    }
+
+    am_Gateway_s& gateway = mGatewayMap[gatewayID];
+    gateway = gatewayData;
+    gateway.gatewayID = gatewayID;
+
+    logInfo("DatabaseHandlerMap::enterGatewayDB entered new gateway with name", gatewayData.name, "sourceID:", gatewayData.sourceID, "sinkID:", gatewayData.sinkID, "assigned ID:", gatewayID);
+
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->newGateway(gateway);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::enterSourceDB(const am_Source_s & sourceData, am_sourceID_t & sourceID)
+{
+    assert(sourceData.sourceID<DYNAMIC_ID_BOUNDARY);
+    assert(sourceData.domainID!=0);
+    assert(!sourceData.name.empty());
+    assert(sourceData.sourceClassID!=0);
+    assert(!sourceData.listConnectionFormats.empty());
+    assert(sourceData.sourceState>=SS_UNKNNOWN && sourceData.sourceState<=SS_MAX);
+
+    NameMap::const_iterator nameIterator = mSourceNames.find(sourceData.name);
+    if (nameIterator != mSourceNames.end() && mSourceMap[nameIterator->second].reserved)
+    {
+        //a reserved source with this name exists, we take it over
+        sourceID = nameIterator->second;
+    }
+    //if sourceID is zero and the first Static Source was already entered, the ID is created
+    else if (sourceData.sourceID == 0 && !mFirstStaticSource && !existSourceName(sourceData.name))
+    {
+        sourceID = nextID(mCurrentSourceID);
+    }
+    else
+    {
+        //check if the ID already exists
+        if (existSourceNameOrID(sourceData.sourceID, sourceData.name))
+            return (E_ALREADY_EXISTS);
+
+        if (sourceData.sourceID != 0)
+        {
+            sourceID = sourceData.sourceID;
+        }
+        //if the first static source is entered, we need to set it onto the boundary
+        else
+        {
+            sourceID = DYNAMIC_ID_BOUNDARY;
+            mFirstStaticSource = false;
+        }
+        useID(mCurrentSourceID, sourceID);
+    }
+
+    am_Source_Database_s& source = mSourceMap[sourceID];
+    static_cast<am_Source_s&>(source) = sourceData;
+    source.sourceID = sourceID;
+    source.reserved = false;
+
+    //main sound properties are only kept for visible sources
+    if (!source.visible)
+        source.listMainSoundProperties.clear();
+    mSourceNames[sourceData.name] = sourceID;
+
+    logInfo("DatabaseHandlerMap::enterSourceDB entered new source with name", sourceData.name, "domainID:", sourceData.domainID, "classID:", sourceData.sourceClassID, "visible:", sourceData.visible, "assigned ID:", sourceID);
+
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->newSource(source);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeMainConnectionRouteDB(const am_mainConnectionID_t mainconnectionID, const std::vector<am_connectionID_t>& listConnectionID)
+{
+    assert(mainconnectionID!=0);
+    MainConnectionMap::iterator iter = mMainConnectionMap.find(mainconnectionID);
+    if (iter == mMainConnectionMap.end())
+    {
+        return (E_NON_EXISTENT);
+    }
+
+    am_timeSync_t delay = 0;
+    if (!calculateRouteDelay(listConnectionID, delay))
+    {
+        logError("DatabaseHandlerMap::changeMainConnectionRouteDB did not find route for MainConnection");
+        return (E_DATABASE_ERROR);
+    }
+
+    iter->second.listConnectionID = listConnectionID;
+    logInfo("DatabaseHandlerMap::changeMainConnectionRouteDB entered new route:", mainconnectionID);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeMainConnectionStateDB(const am_mainConnectionID_t mainconnectionID, const am_ConnectionState_e connectionState)
+{
+    assert(mainconnectionID!=0);
+    assert(connectionState>=CS_UNKNOWN && connectionState<=CS_MAX);
+
+    MainConnectionMap::iterator iter = mMainConnectionMap.find(mainconnectionID);
+    if (iter == mMainConnectionMap.end())
+    {
+        return (E_NON_EXISTENT);
+    }
+    iter->second.connectionState = connectionState;
+    logInfo("DatabaseHandlerMap::changeMainConnectionStateDB changed mainConnectionState of MainConnection:", mainconnectionID, "to:", connectionState);
+
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->mainConnectionStateChanged(mainconnectionID, connectionState);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeSinkMainVolumeDB(const am_mainVolume_t mainVolume, const am_sinkID_t sinkID)
+{
+    assert(sinkID!=0);
+
+    if (!existSink(sinkID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    mSinkMap[sinkID].mainVolume = mainVolume;
+    logInfo("DatabaseHandlerMap::changeSinkMainVolumeDB changed mainVolume of sink:", sinkID, "to:", mainVolume);
+
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->volumeChanged(sinkID, mainVolume);
+
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeSinkAvailabilityDB(const am_Availability_s & availability, const am_sinkID_t sinkID)
+{
+    assert(sinkID!=0);
+    assert(availability.availability>=A_UNKNOWN && availability.availability<=A_MAX);
+    assert(availability.availabilityReason>=AR_UNKNOWN && availability.availabilityReason<=AR_MAX);
+
+    if (!existSink(sinkID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    mSinkMap[sinkID].available = availability;
+    logInfo("DatabaseHandlerMap::changeSinkAvailabilityDB changed sinkAvailability of sink:", sinkID, "to:", availability.availability, "Reason:", availability.availabilityReason);
+
+    if (mpDatabaseObserver && sinkVisible(sinkID))
+        mpDatabaseObserver->sinkAvailabilityChanged(sinkID, availability);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changDomainStateDB(const am_DomainState_e domainState, const am_domainID_t domainID)
+{
+    assert(domainID!=0);
+    assert(domainState>=DS_UNKNOWN && domainState<=DS_MAX);
+
+    if (!existDomain(domainID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    mDomainMap[domainID].state = domainState;
+    logInfo("DatabaseHandlerMap::changDomainStateDB changed domainState of domain:", domainID, "to:", domainState);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeSinkMuteStateDB(const am_MuteState_e muteState, const am_sinkID_t sinkID)
+{
+    assert(sinkID!=0);
+    assert(muteState>=MS_UNKNOWN && muteState<=MS_MAX);
+
+    if (!existSink(sinkID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    mSinkMap[sinkID].muteState = muteState;
+    logInfo("DatabaseHandlerMap::changeSinkMuteStateDB changed sinkMuteState of sink:", sinkID, "to:", muteState);
+
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->sinkMuteStateChanged(sinkID, muteState);
+
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeMainSinkSoundPropertyDB(const am_MainSoundProperty_s & soundProperty, const am_sinkID_t sinkID)
+{
+    assert(soundProperty.type>=MSP_UNKNOWN && soundProperty.type<=MSP_MAX);
+    assert(sinkID!=0);
+
+    if (!existSink(sinkID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    std::vector<am_MainSoundProperty_s>& listProperties = mSinkMap[sinkID].listMainSoundProperties;
+    std::vector<am_MainSoundProperty_s>::iterator propertyIterator = listProperties.begin();
+    for (; propertyIterator != listProperties.end(); ++propertyIterator)
+    {
+        if (propertyIterator->type == soundProperty.type)
+            propertyIterator->value = soundProperty.value;
+    }
+    logInfo("DatabaseHandlerMap::changeMainSinkSoundPropertyDB changed MainSinkSoundProperty of sink:", sinkID, "type:", soundProperty.type, "to:", soundProperty.value);
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->mainSinkSoundPropertyChanged(sinkID, soundProperty);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeMainSourceSoundPropertyDB(const am_MainSoundProperty_s & soundProperty, const am_sourceID_t sourceID)
+{
+    assert(soundProperty.type>=MSP_UNKNOWN && soundProperty.type<=MSP_MAX);
+    assert(sourceID!=0);
+
+    if (!existSource(sourceID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    std::vector<am_MainSoundProperty_s>& listProperties = mSourceMap[sourceID].listMainSoundProperties;
+    std::vector<am_MainSoundProperty_s>::iterator propertyIterator = listProperties.begin();
+    for (; propertyIterator != listProperties.end(); ++propertyIterator)
+    {
+        if (propertyIterator->type == soundProperty.type)
+            propertyIterator->value = soundProperty.value;
+    }
+    logInfo("DatabaseHandlerMap::changeMainSourceSoundPropertyDB changed MainSinkSoundProperty of source:", sourceID, "type:", soundProperty.type, "to:", soundProperty.value);
+
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->mainSourceSoundPropertyChanged(sourceID, soundProperty);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeSourceAvailabilityDB(const am_Availability_s & availability, const am_sourceID_t sourceID)
+{
+    assert(sourceID!=0);
+    assert(availability.availability>=A_UNKNOWN && availability.availability<=A_MAX);
+    assert(availability.availabilityReason>=AR_UNKNOWN && availability.availabilityReason<=AR_MAX);
+
+    if (!existSource(sourceID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    mSourceMap[sourceID].available = availability;
+    logInfo("DatabaseHandlerMap::changeSourceAvailabilityDB changed changeSourceAvailabilityDB of source:", sourceID, "to:", availability.availability, "Reason:", availability.availabilityReason);
+
+    if (mpDatabaseObserver && sourceVisible(sourceID))
+        mpDatabaseObserver->sourceAvailabilityChanged(sourceID, availability);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeSystemPropertyDB(const am_SystemProperty_s & property)
+{
+    assert(property.type>=SYP_UNKNOWN && property.type<=SYP_MAX);
+
+    std::vector<am_SystemProperty_s>::iterator propertyIterator = mSystemProperties.begin();
+    for (; propertyIterator != mSystemProperties.end(); ++propertyIterator)
+    {
+        if (propertyIterator->type == property.type)
+            propertyIterator->value = property.value;
+    }
+    logInfo("DatabaseHandlerMap::changeSystemPropertyDB changed system property");
+
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->systemPropertyChanged(property);
+
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::removeMainConnectionDB(const am_mainConnectionID_t mainConnectionID)
+{
+    assert(mainConnectionID!=0);
+
+    if (mMainConnectionMap.erase(mainConnectionID) == 0)
+    {
+        return (E_NON_EXISTENT);
+    }
+    logInfo("DatabaseHandlerMap::removeMainConnectionDB removed:", mainConnectionID);
+    if (mpDatabaseObserver)
+    {
+        mpDatabaseObserver->mainConnectionStateChanged(mainConnectionID, CS_DISCONNECTED);
+        mpDatabaseObserver->removedMainConnection(mainConnectionID);
+    }
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::removeSinkDB(const am_sinkID_t sinkID)
+{
+    assert(sinkID!=0);
+
+    if (!existSink(sinkID))
+    {
+        return (E_NON_EXISTENT);
+    }
+
+    bool visible = sinkVisible(sinkID);
+    mSinkNames.erase(mSinkMap[sinkID].name);
+    mSinkMap.erase(sinkID);
+    logInfo("DatabaseHandlerMap::removeSinkDB removed:", sinkID);
+
+    if (mpDatabaseObserver != NULL)
+        mpDatabaseObserver->removedSink(sinkID, visible);
+
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::removeSourceDB(const am_sourceID_t sourceID)
+{
+    assert(sourceID!=0);
+
+    if (!existSource(sourceID))
+    {
+        return (E_NON_EXISTENT);
+    }
+
+    bool visible = sourceVisible(sourceID);
+    mSourceNames.erase(mSourceMap[sourceID].name);
+    mSourceMap.erase(sourceID);
+    logInfo("DatabaseHandlerMap::removeSourceDB removed:", sourceID);
+
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->removedSource(sourceID, visible);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::removeGatewayDB(const am_gatewayID_t gatewayID)
+{
+    assert(gatewayID!=0);
+
+    if (mGatewayMap.erase(gatewayID) == 0)
+    {
+        return (E_NON_EXISTENT);
+    }
+    logInfo("DatabaseHandlerMap::removeGatewayDB removed:", gatewayID);
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->removeGateway(gatewayID);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::removeCrossfaderDB(const am_crossfaderID_t crossfaderID)
+{
+    assert(crossfaderID!=0);
+
+    if (mCrossfaderMap.erase(crossfaderID) == 0)
+    {
+        return (E_NON_EXISTENT);
+    }
+    logInfo("DatabaseHandlerMap::removeCrossfaderDB removed:", crossfaderID);
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->removeCrossfader(crossfaderID);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::removeDomainDB(const am_domainID_t domainID)
+{
+    assert(domainID!=0);
+
+    if (!existDomain(domainID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    mDomainNames.erase(mDomainMap[domainID].name);
+    mDomainMap.erase(domainID);
+    logInfo("DatabaseHandlerMap::removeDomainDB removed:", domainID);
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->removeDomain(domainID);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::removeSinkClassDB(const am_sinkClass_t sinkClassID)
+{
+    assert(sinkClassID!=0);
+
+    if (mSinkClassMap.erase(sinkClassID) == 0)
+    {
+        return (E_NON_EXISTENT);
+    }
+    logInfo("DatabaseHandlerMap::removeSinkClassDB removed:", sinkClassID);
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->numberOfSinkClassesChanged();
+
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::removeSourceClassDB(const am_sourceClass_t sourceClassID)
+{
+    assert(sourceClassID!=0);
+
+    if (mSourceClassMap.erase(sourceClassID) == 0)
+    {
+        return (E_NON_EXISTENT);
+    }
+    logInfo("DatabaseHandlerMap::removeSourceClassDB removed:", sourceClassID);
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->numberOfSourceClassesChanged();
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::removeConnection(const am_connectionID_t connectionID)
+{
+    assert(connectionID!=0);
+
+    mConnectionMap.erase(connectionID);
+    logInfo("DatabaseHandlerMap::removeConnection removed:", connectionID);
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->removedConnection(connectionID);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getSourceClassInfoDB(const am_sourceID_t sourceID, am_SourceClass_s & classInfo) const
+{
+    assert(sourceID!=0);
+
+    if (!existSource(sourceID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    classInfo.sourceClassID = mSourceMap.find(sourceID)->second.sourceClassID;
+    SourceClassMap::const_iterator iter = mSourceClassMap.find(classInfo.sourceClassID);
+    if (iter != mSourceClassMap.end())
+    {
+        classInfo.name = iter->second.name;
+        classInfo.listClassProperties.insert(classInfo.listClassProperties.end(), iter->second.listClassProperties.begin(), iter->second.listClassProperties.end());
+    }
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getSinkInfoDB(const am_sinkID_t sinkID, am_Sink_s & sinkData) const
+{
+    assert(sinkID!=0);
+
+    if (!existSink(sinkID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    sinkData = mSinkMap.find(sinkID)->second;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getSourceInfoDB(const am_sourceID_t sourceID, am_Source_s & sourceData) const
+{
+    assert(sourceID!=0);
+
+    if (!existSource(sourceID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    sourceData = mSourceMap.find(sourceID)->second;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getMainConnectionInfoDB(const am_mainConnectionID_t mainConnectionID, am_MainConnection_s & mainConnectionData) const
+{
+    assert(mainConnectionID!=0);
+
+    MainConnectionMap::const_iterator iter = mMainConnectionMap.find(mainConnectionID);
+    if (iter == mMainConnectionMap.end())
+    {
+        return (E_NON_EXISTENT);
+    }
+    mainConnectionData = iter->second;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeSinkClassInfoDB(const am_SinkClass_s& sinkClass)
+{
+    assert(sinkClass.sinkClassID!=0);
+    assert(!sinkClass.listClassProperties.empty());
+
+    //check if the ID already exists
+    SinkClassMap::iterator iter = mSinkClassMap.find(sinkClass.sinkClassID);
+    if (iter == mSinkClassMap.end())
+        return (E_NON_EXISTENT);
+
+    //update only the values of the properties that are already there
+    std::vector<am_ClassProperty_s>::const_iterator Iterator = sinkClass.listClassProperties.begin();
+    for (; Iterator != sinkClass.listClassProperties.end(); ++Iterator)
+    {
+        std::vector<am_ClassProperty_s>::iterator storedIterator = iter->second.listClassProperties.begin();
+        for (; storedIterator != iter->second.listClassProperties.end(); ++storedIterator)
+        {
+            if (storedIterator->classProperty == Iterator->classProperty)
+                storedIterator->value = Iterator->value;
+        }
+    }
+
+    logInfo("DatabaseHandlerMap::setSinkClassInfoDB set setSinkClassInfo");
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeSourceClassInfoDB(const am_SourceClass_s& sourceClass)
+{
+    assert(sourceClass.sourceClassID!=0);
+    assert(!sourceClass.listClassProperties.empty());
+
+    //check if the ID already exists
+    SourceClassMap::iterator iter = mSourceClassMap.find(sourceClass.sourceClassID);
+    if (iter == mSourceClassMap.end())
+        return (E_NON_EXISTENT);
+
+    //update only the values of the properties that are already there
+    std::vector<am_ClassProperty_s>::const_iterator Iterator = sourceClass.listClassProperties.begin();
+    for (; Iterator != sourceClass.listClassProperties.end(); ++Iterator)
+    {
+        std::vector<am_ClassProperty_s>::iterator storedIterator = iter->second.listClassProperties.begin();
+        for (; storedIterator != iter->second.listClassProperties.end(); ++storedIterator)
+        {
+            if (storedIterator->classProperty == Iterator->classProperty)
+                storedIterator->value = Iterator->value;
+        }
+    }
+
+    logInfo("DatabaseHandlerMap::setSinkClassInfoDB set setSinkClassInfo");
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getSinkClassInfoDB(const am_sinkID_t sinkID, am_SinkClass_s & sinkClass) const
+{
+    assert(sinkID!=0);
+
+    if (!existSink(sinkID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    sinkClass.sinkClassID = mSinkMap.find(sinkID)->second.sinkClassID;
+    SinkClassMap::const_iterator iter = mSinkClassMap.find(sinkClass.sinkClassID);
+    if (iter != mSinkClassMap.end())
+    {
+        sinkClass.name = iter->second.name;
+        sinkClass.listClassProperties.insert(sinkClass.listClassProperties.end(), iter->second.listClassProperties.begin(), iter->second.listClassProperties.end());
+    }
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getGatewayInfoDB(const am_gatewayID_t gatewayID, am_Gateway_s & gatewayData) const
+{
+    assert(gatewayID!=0);
+
+    GatewayMap::const_iterator iter = mGatewayMap.find(gatewayID);
+    if (iter == mGatewayMap.end())
+    {
+        return (E_NON_EXISTENT);
+    }
+    gatewayData = iter->second;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getCrossfaderInfoDB(const am_crossfaderID_t crossfaderID, am_Crossfader_s & crossfaderData) const
+{
+    assert(crossfaderID!=0);
+
+    CrossfaderMap::const_iterator iter = mCrossfaderMap.find(crossfaderID);
+    if (iter == mCrossfaderMap.end())
+    {
+        return (E_NON_EXISTENT);
+    }
+    crossfaderData = iter->second;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListSinksOfDomain(const am_domainID_t domainID, std::vector<am_sinkID_t> & listSinkID) const
+{
+    assert(domainID!=0);
+    listSinkID.clear();
+    if (!existDomain(domainID))
+    {
+        return (E_NON_EXISTENT);
+    }
+
+    SinkMap::const_iterator iter = mSinkMap.begin();
+    for (; iter != mSinkMap.end(); ++iter)
+    {
+        if (!iter->second.reserved && iter->second.domainID == domainID)
+            listSinkID.push_back(iter->first);
+    }
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListSourcesOfDomain(const am_domainID_t domainID, std::vector<am_sourceID_t> & listSourceID) const
+{
+    assert(domainID!=0);
+    listSourceID.clear();
+    if (!existDomain(domainID))
+    {
+        return (E_NON_EXISTENT);
+    }
+
+    SourceMap::const_iterator iter = mSourceMap.begin();
+    for (; iter != mSourceMap.end(); ++iter)
+    {
+        if (!iter->second.reserved && iter->second.domainID == domainID)
+            listSourceID.push_back(iter->first);
+    }
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListCrossfadersOfDomain(const am_domainID_t domainID, std::vector<am_crossfaderID_t> & listCrossfader) const
+{
+    assert(domainID!=0);
+    listCrossfader.clear();
+    if (!existDomain(domainID))
+    {
+        return (E_NON_EXISTENT);
+    }
+
+    //a crossfader belongs to the domain of its source
+    CrossfaderMap::const_iterator iter = mCrossfaderMap.begin();
+    for (; iter != mCrossfaderMap.end(); ++iter)
+    {
+        SourceMap::const_iterator sourceIterator = mSourceMap.find(iter->second.sourceID);
+        if (sourceIterator != mSourceMap.end() && sourceIterator->second.domainID == domainID)
+            listCrossfader.push_back(iter->first);
+    }
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListGatewaysOfDomain(const am_domainID_t domainID, std::vector<am_gatewayID_t> & listGatewaysID) const
+{
+    assert(domainID!=0);
+    listGatewaysID.clear();
+    if (!existDomain(domainID))
+    {
+        return (E_NON_EXISTENT);
+    }
+
+    GatewayMap::const_iterator iter = mGatewayMap.begin();
+    for (; iter != mGatewayMap.end(); ++iter)
+    {
+        if (iter->second.controlDomainID == domainID)
+            listGatewaysID.push_back(iter->first);
+    }
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListMainConnections(std::vector<am_MainConnection_s> & listMainConnections) const
+{
+    listMainConnections.clear();
+    MainConnectionMap::const_iterator iter = mMainConnectionMap.begin();
+    for (; iter != mMainConnectionMap.end(); ++iter)
+        listMainConnections.push_back(iter->second);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListDomains(std::vector<am_Domain_s> & listDomains) const
+{
+    listDomains.clear();
+    DomainMap::const_iterator iter = mDomainMap.begin();
+    for (; iter != mDomainMap.end(); ++iter)
+    {
+        if (!iter->second.reserved)
+            listDomains.push_back(iter->second);
+    }
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListConnections(std::vector<am_Connection_s> & listConnections) const
+{
+    listConnections.clear();
+    ConnectionMap::const_iterator iter = mConnectionMap.begin();
+    for (; iter != mConnectionMap.end(); ++iter)
+    {
+        if (!iter->second.reserved)
+            listConnections.push_back(iter->second);
+    }
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListSinks(std::vector<am_Sink_s> & listSinks) const
+{
+    listSinks.clear();
+    SinkMap::const_iterator iter = mSinkMap.begin();
+    for (; iter != mSinkMap.end(); ++iter)
+    {
+        if (!iter->second.reserved)
+            listSinks.push_back(iter->second);
+    }
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListSources(std::vector<am_Source_s> & listSources) const
+{
+    listSources.clear();
+    SourceMap::const_iterator iter = mSourceMap.begin();
+    for (; iter != mSourceMap.end(); ++iter)
+    {
+        if (!iter->second.reserved)
+            listSources.push_back(iter->second);
+    }
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListSourceClasses(std::vector<am_SourceClass_s> & listSourceClasses) const
+{
+    listSourceClasses.clear();
+    SourceClassMap::const_iterator iter = mSourceClassMap.begin();
+    for (; iter != mSourceClassMap.end(); ++iter)
+        listSourceClasses.push_back(iter->second);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListCrossfaders(std::vector<am_Crossfader_s> & listCrossfaders) const
+{
+    listCrossfaders.clear();
+    CrossfaderMap::const_iterator iter = mCrossfaderMap.begin();
+    for (; iter != mCrossfaderMap.end(); ++iter)
+        listCrossfaders.push_back(iter->second);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListGateways(std::vector<am_Gateway_s> & listGateways) const
+{
+    listGateways.clear();
+    GatewayMap::const_iterator iter = mGatewayMap.begin();
+    for (; iter != mGatewayMap.end(); ++iter)
+        listGateways.push_back(iter->second);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListSinkClasses(std::vector<am_SinkClass_s> & listSinkClasses) const
+{
+    listSinkClasses.clear();
+    SinkClassMap::const_iterator iter = mSinkClassMap.begin();
+    for (; iter != mSinkClassMap.end(); ++iter)
+        listSinkClasses.push_back(iter->second);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListVisibleMainConnections(std::vector<am_MainConnectionType_s> & listConnections) const
+{
+    listConnections.clear();
+    am_MainConnectionType_s temp;
+    MainConnectionMap::const_iterator iter = mMainConnectionMap.begin();
+    for (; iter != mMainConnectionMap.end(); ++iter)
+    {
+        temp.mainConnectionID = iter->second.mainConnectionID;
+        temp.sourceID = iter->second.sourceID;
+        temp.sinkID = iter->second.sinkID;
+        temp.connectionState = iter->second.connectionState;
+        temp.delay = iter->second.delay;
+        listConnections.push_back(temp);
+    }
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListMainSinks(std::vector<am_SinkType_s> & listMainSinks) const
+{
+    listMainSinks.clear();
+    am_SinkType_s temp;
+    SinkMap::const_iterator iter = mSinkMap.begin();
+    for (; iter != mSinkMap.end(); ++iter)
+    {
+        if (iter->second.reserved || !iter->second.visible)
+            continue;
+        temp.name = iter->second.name;
+        temp.sinkID = iter->second.sinkID;
+        temp.availability = iter->second.available;
+        temp.muteState = iter->second.muteState;
+        temp.volume = iter->second.mainVolume;
+        temp.sinkClassID = iter->second.sinkClassID;
+        listMainSinks.push_back(temp);
+    }
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListMainSources(std::vector<am_SourceType_s> & listMainSources) const
+{
+    listMainSources.clear();
+    am_SourceType_s temp;
+    SourceMap::const_iterator iter = mSourceMap.begin();
+    for (; iter != mSourceMap.end(); ++iter)
+    {
+        if (iter->second.reserved || !iter->second.visible)
+            continue;
+        temp.name = iter->second.name;
+        temp.sourceClassID = iter->second.sourceClassID;
+        temp.availability = iter->second.available;
+        temp.sourceID = iter->second.sourceID;
+        listMainSources.push_back(temp);
+    }
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListMainSinkSoundProperties(const am_sinkID_t sinkID, std::vector<am_MainSoundProperty_s> & listSoundProperties) const
+{
+    assert(sinkID!=0);
+    if (!existSink(sinkID))
+        return (E_DATABASE_ERROR); // todo: here we could change to non existen, but not shown in sequences
+    listSoundProperties = mSinkMap.find(sinkID)->second.listMainSoundProperties;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListMainSourceSoundProperties(const am_sourceID_t sourceID, std::vector<am_MainSoundProperty_s> & listSourceProperties) const
+{
+    assert(sourceID!=0);
+    if (!existSource(sourceID))
+        return (E_DATABASE_ERROR); // todo: here we could change to non existen, but not shown in sequences
+    listSourceProperties = mSourceMap.find(sourceID)->second.listMainSoundProperties;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListSystemProperties(std::vector<am_SystemProperty_s> & listSystemProperties) const
+{
+    listSystemProperties = mSystemProperties;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListSinkConnectionFormats(const am_sinkID_t sinkID, std::vector<am_ConnectionFormat_e> & listConnectionFormats) const
+{
+    listConnectionFormats.clear();
+    SinkMap::const_iterator iter = mSinkMap.find(sinkID);
+    if (iter != mSinkMap.end())
+        listConnectionFormats = iter->second.listConnectionFormats;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListSourceConnectionFormats(const am_sourceID_t sourceID, std::vector<am_ConnectionFormat_e> & listConnectionFormats) const
+{
+    listConnectionFormats.clear();
+    SourceMap::const_iterator iter = mSourceMap.find(sourceID);
+    if (iter != mSourceMap.end())
+        listConnectionFormats = iter->second.listConnectionFormats;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getListGatewayConnectionFormats(const am_gatewayID_t gatewayID, std::vector<bool> & listConnectionFormat) const
+{
+    GatewayMap::const_iterator iter = mGatewayMap.find(gatewayID);
+    if (iter == mGatewayMap.end())
+    {
+        logError("DatabaseHandlerMap::getListGatewayConnectionFormats database error with convertionFormat");
+        return (E_DATABASE_ERROR);
+    }
+    listConnectionFormat = iter->second.convertionMatrix;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getTimingInformation(const am_mainConnectionID_t mainConnectionID, am_timeSync_t & delay) const
+{
+    assert(mainConnectionID!=0);
+    delay = -1;
+
+    MainConnectionMap::const_iterator iter = mMainConnectionMap.find(mainConnectionID);
+    if (iter != mMainConnectionMap.end())
+        delay = iter->second.delay;
+
+    if (delay == -1)
+        return (E_NOT_POSSIBLE);
+
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeDelayMainConnection(const am_timeSync_t & delay, const am_mainConnectionID_t & connectionID)
+{
+    assert(connectionID!=0);
+
+    MainConnectionMap::iterator iter = mMainConnectionMap.find(connectionID);
+    if (iter == mMainConnectionMap.end() || iter->second.delay == delay)
+        return (E_OK);
+
+    iter->second.delay = delay;
+
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->timingInformationChanged(connectionID, delay);
+
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::enterConnectionDB(const am_Connection_s& connection, am_connectionID_t& connectionID)
+{
+    assert(connection.connectionID==0);
+    assert(connection.sinkID!=0);
+    assert(connection.sourceID!=0);
+    //connection format is not checked, because it's project specific
+
+    connectionID = nextID(mCurrentConnectionID);
+    am_Connection_Database_s& newConnection = mConnectionMap[connectionID];
+    static_cast<am_Connection_s&>(newConnection) = connection;
+    newConnection.connectionID = connectionID;
+    newConnection.reserved = true;
+
+    logInfo("DatabaseHandlerMap::enterConnectionDB entered new connection sourceID=", connection.sourceID, "sinkID=", connection.sinkID, "sourceID=", connection.sourceID, "connectionFormat=", connection.connectionFormat, "assigned ID=", connectionID);
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->newConnection(newConnection);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::enterSinkClassDB(const am_SinkClass_s & sinkClass, am_sinkClass_t & sinkClassID)
+{
+    assert(sinkClass.sinkClassID<DYNAMIC_ID_BOUNDARY);
+    assert(!sinkClass.name.empty());
+
+    //if sinkClassID is zero and the first Static SinkClass was already entered, the ID is created
+    if (sinkClass.sinkClassID == 0 && !mFirstStaticSinkClass)
+    {
+        sinkClassID = nextID(mCurrentSinkClassID);
+    }
+    else
+    {
+        //check if the ID already exists
+        if (existSinkClass(sinkClass.sinkClassID))
+            return (E_ALREADY_EXISTS);
+
+        if (sinkClass.sinkClassID != 0)
+        {
+            sinkClassID = sinkClass.sinkClassID;
+        }
+        //if the first static sinkclass is entered, we need to set it onto the boundary
+        else
+        {
+            sinkClassID = DYNAMIC_ID_BOUNDARY;
+            mFirstStaticSinkClass = false;
+        }
+        useID(mCurrentSinkClassID, sinkClassID);
+    }
+
+    am_SinkClass_s& newSinkClass = mSinkClassMap[sinkClassID];
+    newSinkClass = sinkClass;
+    newSinkClass.sinkClassID = sinkClassID;
+
+    logInfo("DatabaseHandlerMap::enterSinkClassDB entered new sinkClass");
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->numberOfSinkClassesChanged();
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::enterSourceClassDB(am_sourceClass_t & sourceClassID, const am_SourceClass_s & sourceClass)
+{
+    assert(sourceClass.sourceClassID<DYNAMIC_ID_BOUNDARY);
+    assert(!sourceClass.name.empty());
+
+    //if sourceClassID is zero and the first Static SourceClass was already entered, the ID is created
+    if (sourceClass.sourceClassID == 0 && !mFirstStaticSourceClass)
+    {
+        sourceClassID = nextID(mCurrentSourceClassID);
+    }
+    else
+    {
+        //check if the ID already exists
+        if (existSourceClass(sourceClass.sourceClassID))
+            return (E_ALREADY_EXISTS);
+
+        if (sourceClass.sourceClassID != 0)
+        {
+            sourceClassID = sourceClass.sourceClassID;
+        }
+        //if the first static sourceclass is entered, we need to set it onto the boundary
+        else
+        {
+            sourceClassID = DYNAMIC_ID_BOUNDARY;
+            mFirstStaticSourceClass = false;
+        }
+        useID(mCurrentSourceClassID, sourceClassID);
+    }
+
+    am_SourceClass_s& newSourceClass = mSourceClassMap[sourceClassID];
+    newSourceClass = sourceClass;
+    newSourceClass.sourceClassID = sourceClassID;
+
+    logInfo("DatabaseHandlerMap::enterSourceClassDB entered new sourceClass");
+
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->numberOfSourceClassesChanged();
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::enterSystemProperties(const std::vector<am_SystemProperty_s> & listSystemProperties)
+{
+    assert(!listSystemProperties.empty());
+
+    mSystemProperties = listSystemProperties;
+
+    logInfo("DatabaseHandlerMap::enterSystemProperties entered system properties");
+    return (E_OK);
+}
+
+/**
+ * checks for a certain mainConnection
+ * @param mainConnectionID to be checked for
+ * @return true if it exists
+ */
+bool CAmDatabaseHandlerMap::existMainConnection(const am_mainConnectionID_t mainConnectionID) const
+{
+    return (mMainConnectionMap.find(mainConnectionID) != mMainConnectionMap.end());
+}
+
+/**
+ * checks for a certain Source
+ * @param sourceID to be checked for
+ * @return true if it exists
+ */
+bool CAmDatabaseHandlerMap::existSource(const am_sourceID_t sourceID) const
+{
+    SourceMap::const_iterator iter = mSourceMap.find(sourceID);
+    return (iter != mSourceMap.end() && !iter->second.reserved);
+}
+
+/**
+ * checks if a source name or ID exists
+ * @param sourceID the sourceID
+ * @param name the name
+ * @return true if it exits
+ */
+bool CAmDatabaseHandlerMap::existSourceNameOrID(const am_sourceID_t sourceID, const std::string & name) const
+{
+    return (existSource(sourceID) || existSourceName(name));
+}
+
+/**
+ * checks if a name exits
+ * @param name the name
+ * @return true if it exits
+ */
+bool CAmDatabaseHandlerMap::existSourceName(const std::string & name) const
+{
+    NameMap::const_iterator nameIterator = mSourceNames.find(name);
+    return (nameIterator != mSourceNames.end() && existSource(nameIterator->second));
+}
+
+/**
+ * checks for a certain Sink
+ * @param sinkID to be checked for
+ * @return true if it exists
+ */
+bool CAmDatabaseHandlerMap::existSink(const am_sinkID_t sinkID) const
+{
+    SinkMap::const_iterator iter = mSinkMap.find(sinkID);
+    return (iter != mSinkMap.end() && !iter->second.reserved);
+}
+
+/**
+ * checks if a sink with the ID or the name exists
+ * @param sinkID the ID
+ * @param name the name
+ * @return true if it exists.
+ */
+bool CAmDatabaseHandlerMap::existSinkNameOrID(const am_sinkID_t sinkID, const std::string & name) const
+{
+    return (existSink(sinkID) || existSinkName(name));
+}
+
+/**
+ * checks if a sink with the name exists
+ * @param name the name
+ * @return true if it exists
+ */
+bool CAmDatabaseHandlerMap::existSinkName(const std::string & name) const
+{
+    NameMap::const_iterator nameIterator = mSinkNames.find(name);
+    return (nameIterator != mSinkNames.end() && existSink(nameIterator->second));
+}
+
+/**
+ * checks for a certain domain
+ * @param domainID to be checked for
+ * @return true if it exists
+ */
+bool CAmDatabaseHandlerMap::existDomain(const am_domainID_t domainID) const
+{
+    DomainMap::const_iterator iter = mDomainMap.find(domainID);
+    return (iter != mDomainMap.end() && !iter->second.reserved);
+}
+
+/**
+ * checks for certain gateway
+ * @param gatewayID to be checked for
+ * @return true if it exists
+ */
+bool CAmDatabaseHandlerMap::existGateway(const am_gatewayID_t gatewayID) const
+{
+    return (mGatewayMap.find(gatewayID) != mGatewayMap.end());
+}
+
+am_Error_e CAmDatabaseHandlerMap::getDomainOfSource(const am_sourceID_t sourceID, am_domainID_t & domainID) const
+{
+    assert(sourceID!=0);
+
+    SourceMap::const_iterator iter = mSourceMap.find(sourceID);
+    if (iter == mSourceMap.end())
+    {
+        logError("DatabaseHandlerMap::getDomainOfSource no source with ID", sourceID);
+        return (E_DATABASE_ERROR);
+    }
+    domainID = iter->second.domainID;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getDomainOfSink(const am_sinkID_t sinkID, am_domainID_t & domainID) const
+{
+    assert(sinkID!=0);
+
+    SinkMap::const_iterator iter = mSinkMap.find(sinkID);
+    if (iter == mSinkMap.end())
+    {
+        logError("DatabaseHandlerMap::getDomainOfSink no sink with ID", sinkID);
+        return (E_DATABASE_ERROR);
+    }
+    domainID = iter->second.domainID;
+    return (E_OK);
+}
+
+/**
+ * checks for certain SinkClass
+ * @param sinkClassID
+ * @return true if it exists
+ */
+bool CAmDatabaseHandlerMap::existSinkClass(const am_sinkClass_t sinkClassID) const
+{
+    return (mSinkClassMap.find(sinkClassID) != mSinkClassMap.end());
+}
+
+/**
+ * checks for certain sourceClass
+ * @param sourceClassID
+ * @return true if it exists
+ */
+bool CAmDatabaseHandlerMap::existSourceClass(const am_sourceClass_t sourceClassID) const
+{
+    return (mSourceClassMap.find(sourceClassID) != mSourceClassMap.end());
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeConnectionTimingInformation(const am_connectionID_t connectionID, const am_timeSync_t delay)
+{
+    assert(connectionID!=0);
+
+    ConnectionMap::iterator connectionIterator = mConnectionMap.find(connectionID);
+    if (connectionIterator != mConnectionMap.end())
+        connectionIterator->second.delay = delay;
+
+    //now we need to find all mainConnections that use the changed connection and update their timing
+    MainConnectionMap::iterator iter = mMainConnectionMap.begin();
+    for (; iter != mMainConnectionMap.end(); ++iter)
+    {
+        const std::vector<am_connectionID_t>& route = iter->second.listConnectionID;
+        if (std::find(route.begin(), route.end(), connectionID) != route.end())
+            changeDelayMainConnection(calculateMainConnectionDelay(iter->first), iter->first);
+    }
+
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeConnectionFinal(const am_connectionID_t connectionID)
+{
+    assert(connectionID!=0);
+
+    ConnectionMap::iterator iter = mConnectionMap.find(connectionID);
+    if (iter != mConnectionMap.end())
+        iter->second.reserved = false;
+    return (E_OK);
+}
+
+/**
+ * calculates the delay of a route: the sum of all connection delays, or -1 if one of the delays is unknown
+ * @param listConnectionID the connections of the route
+ * @param delay the calculated delay
+ * @return false if a connection of the route does not exist
+ */
+bool CAmDatabaseHandlerMap::calculateRouteDelay(const std::vector<am_connectionID_t>& listConnectionID, am_timeSync_t& delay) const
+{
+    delay = 0;
+    bool unknown = false;
+    std::vector<am_connectionID_t>::const_iterator elementIterator = listConnectionID.begin();
+    for (; elementIterator != listConnectionID.end(); ++elementIterator)
+    {
+        ConnectionMap::const_iterator iter = mConnectionMap.find(*elementIterator);
+        if (iter == mConnectionMap.end())
+            return (false);
+        if (iter->second.delay < 0)
+            unknown = true;
+        else
+            delay += iter->second.delay;
+    }
+    if (unknown)
+        delay = -1;
+    return (true);
+}
+
+am_timeSync_t CAmDatabaseHandlerMap::calculateMainConnectionDelay(const am_mainConnectionID_t mainConnectionID) const
+{
+    assert(mainConnectionID!=0);
+    am_timeSync_t delay = -1;
+    MainConnectionMap::const_iterator iter = mMainConnectionMap.find(mainConnectionID);
+    if (iter != mMainConnectionMap.end())
+    {
+        //connections that are already gone do not count, as in the sql join
+        std::vector<am_connectionID_t> listExisting;
+        std::vector<am_connectionID_t>::const_iterator elementIterator = iter->second.listConnectionID.begin();
+        for (; elementIterator != iter->second.listConnectionID.end(); ++elementIterator)
+        {
+            if (mConnectionMap.find(*elementIterator) != mConnectionMap.end())
+                listExisting.push_back(*elementIterator);
+        }
+        calculateRouteDelay(listExisting, delay);
+    }
+    return (delay);
+}
+
+/**
+ * registers the Observer at the Database
+ * @param iObserver pointer to the observer
+ */
+void CAmDatabaseHandlerMap::registerObserver(CAmDatabaseObserver *iObserver)
+{
+    assert(iObserver!=NULL);
+    mpDatabaseObserver = iObserver;
+}
+
+/**
+ * starts a transaction. The maps are changed right away, but the observer holds back its notifications until the matching
+ * commitTransaction. Transactions can be nested.
+ * @return E_OK
+ */
+am_Error_e CAmDatabaseHandlerMap::beginTransaction()
+{
+    if (mTransactionDepth == 0 && mpDatabaseObserver)
+        mpDatabaseObserver->beginBatch();
+    mTransactionDepth++;
+    return (E_OK);
+}
+
+/**
+ * ends a transaction that was started with beginTransaction
+ * @return E_OK on success, E_NOT_POSSIBLE if there is no open transaction
+ */
+am_Error_e CAmDatabaseHandlerMap::commitTransaction()
+{
+    if (mTransactionDepth == 0)
+    {
+        logError("DatabaseHandlerMap::commitTransaction no transaction open");
+        return (E_NOT_POSSIBLE);
+    }
+
+    if (--mTransactionDepth == 0 && mpDatabaseObserver)
+        mpDatabaseObserver->commitBatch();
+    return (E_OK);
+}
+
+/**
+ * gives information about the visibility of a source
+ * @param sourceID the sourceID
+ * @return true if source is visible
+ */
+bool CAmDatabaseHandlerMap::sourceVisible(const am_sourceID_t sourceID) const
+{
+    assert(sourceID!=0);
+    SourceMap::const_iterator iter = mSourceMap.find(sourceID);
+    return (iter != mSourceMap.end() && !iter->second.reserved && iter->second.visible);
+}
+
+/**
+ * gives information about the visibility of a sink
+ * @param sinkID the sinkID
+ * @return true if source is visible
+ */
+bool CAmDatabaseHandlerMap::sinkVisible(const am_sinkID_t sinkID) const
+{
+    SinkMap::const_iterator iter = mSinkMap.find(sinkID);
+    return (iter != mSinkMap.end() && !iter->second.reserved && iter->second.visible);
+}
+
+/**
+ * there are no statements in the map backend, so the list is always empty
+ * @param listStatistics the statistics
+ */
+void CAmDatabaseHandlerMap::getStatementStatistics(std::vector<statementClassStatistic_s>& listStatistics) const
+{
+    listStatistics.clear();
+}
+
+void CAmDatabaseHandlerMap::resetStatementStatistics()
+{
+}
+
+/**
+ * checks if a connection already exists.
+ * Only takes sink, source and format information for search!
+ * @param connection the connection to be checked
+ * @return true if connections exists
+ */
+bool CAmDatabaseHandlerMap::existConnection(const am_Connection_s connection)
+{
+    ConnectionMap::const_iterator iter = mConnectionMap.begin();
+    for (; iter != mConnectionMap.end(); ++iter)
+    {
+        if (!iter->second.reserved && iter->second.sinkID == connection.sinkID && iter->second.sourceID == connection.sourceID && iter->second.connectionFormat == connection.connectionFormat)
+            return (true);
+    }
+    return (false);
+}
+
+/**
+ * checks if a connection with the given ID exists
+ * @param connectionID
+ * @return true if connection exits
+ */
+bool CAmDatabaseHandlerMap::existConnectionID(const am_connectionID_t connectionID)
+{
+    ConnectionMap::const_iterator iter = mConnectionMap.find(connectionID);
+    return (iter != mConnectionMap.end() && !iter->second.reserved);
+}
+
+/**
+ * checks if a CrossFader exists
+ * @param crossfaderID the ID of the crossfader to be checked
+ * @return true if exists
+ */
+bool CAmDatabaseHandlerMap::existcrossFader(const am_crossfaderID_t crossfaderID) const
+{
+    return (mCrossfaderMap.find(crossfaderID) != mCrossfaderMap.end());
+}
+
+am_Error_e CAmDatabaseHandlerMap::getSoureState(const am_sourceID_t sourceID, am_SourceState_e & sourceState) const
+{
+    assert(sourceID!=0);
+    sourceState = SS_UNKNNOWN;
+    SourceMap::const_iterator iter = mSourceMap.find(sourceID);
+    if (iter != mSourceMap.end())
+        sourceState = iter->second.sourceState;
+    else
+        logError("DatabaseHandlerMap::getSoureState no source with ID", sourceID);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeSourceState(const am_sourceID_t sourceID, const am_SourceState_e sourceState)
+{
+    assert(sourceID!=0);
+    assert(sourceState>=SS_UNKNNOWN && sourceState<=SS_MAX);
+    SourceMap::iterator iter = mSourceMap.find(sourceID);
+    if (iter != mSourceMap.end())
+        iter->second.sourceState = sourceState;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getSinkVolume(const am_sinkID_t sinkID, am_volume_t & volume) const
+{
+    assert(sinkID!=0);
+    volume = -1;
+    SinkMap::const_iterator iter = mSinkMap.find(sinkID);
+    if (iter != mSinkMap.end())
+        volume = iter->second.volume;
+    else
+        logError("DatabaseHandlerMap::getSinkVolume no sink with ID", sinkID);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getSourceVolume(const am_sourceID_t sourceID, am_volume_t & volume) const
+{
+    assert(sourceID!=0);
+    volume = -1;
+    SourceMap::const_iterator iter = mSourceMap.find(sourceID);
+    if (iter != mSourceMap.end())
+        volume = iter->second.volume;
+    else
+        logError("DatabaseHandlerMap::getSourceVolume no source with ID", sourceID);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getSinkSoundPropertyValue(const am_sinkID_t sinkID, const am_SoundPropertyType_e propertyType, int16_t & value) const
+{
+    assert(sinkID!=0);
+    if (!existSink(sinkID))
+        return (E_DATABASE_ERROR); // todo: here we could change to non existent, but not shown in sequences
+
+    const std::vector<am_SoundProperty_s>& listProperties = mSinkMap.find(sinkID)->second.listSoundProperties;
+    std::vector<am_SoundProperty_s>::const_iterator propertyIterator = listProperties.begin();
+    for (; propertyIterator != listProperties.end(); ++propertyIterator)
+    {
+        if (propertyIterator->type == propertyType)
+        {
+            value = propertyIterator->value;
+            return (E_OK);
+        }
+    }
+    logError("DatabaseHandlerMap::getSinkSoundPropertyValue no property", propertyType, "for sink", sinkID);
+    return (E_DATABASE_ERROR);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getSourceSoundPropertyValue(const am_sourceID_t sourceID, const am_SoundPropertyType_e propertyType, int16_t & value) const
+{
+    assert(sourceID!=0);
+    if (!existSource(sourceID))
+        return (E_DATABASE_ERROR); // todo: here we could change to non existent, but not shown in sequences
+
+    const std::vector<am_SoundProperty_s>& listProperties = mSourceMap.find(sourceID)->second.listSoundProperties;
+    std::vector<am_SoundProperty_s>::const_iterator propertyIterator = listProperties.begin();
+    for (; propertyIterator != listProperties.end(); ++propertyIterator)
+    {
+        if (propertyIterator->type == propertyType)
+            value = propertyIterator->value;
+    }
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getDomainState(const am_domainID_t domainID, am_DomainState_e& state) const
+{
+    assert(domainID!=0);
+    state = DS_UNKNOWN;
+    DomainMap::const_iterator iter = mDomainMap.find(domainID);
+    if (iter != mDomainMap.end())
+        state = iter->second.state;
+    else
+        logError("DatabaseHandlerMap::getDomainState no domain with ID", domainID);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::peekDomain(const std::string & name, am_domainID_t & domainID)
+{
+    NameMap::const_iterator nameIterator = mDomainNames.find(name);
+    if (nameIterator != mDomainNames.end())
+    {
+        domainID = nameIterator->second;
+        return (E_OK);
+    }
+
+    domainID = nextID(mCurrentDomainID);
+    am_Domain_Database_s& domain = mDomainMap[domainID];
+    domain.domainID = domainID;
+    domain.name = name;
+    domain.reserved = true;
+    mDomainNames[name] = domainID;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::peekSink(const std::string & name, am_sinkID_t & sinkID)
+{
+    NameMap::const_iterator nameIterator = mSinkNames.find(name);
+    if (nameIterator != mSinkNames.end())
+    {
+        sinkID = nameIterator->second;
+        return (E_OK);
+    }
+
+    if (mFirstStaticSink)
+    {
+        sinkID = DYNAMIC_ID_BOUNDARY;
+        useID(mCurrentSinkID, sinkID);
+        mFirstStaticSink = false;
+    }
+    else
+    {
+        sinkID = nextID(mCurrentSinkID);
+    }
+    am_Sink_Database_s& sink = mSinkMap[sinkID];
+    sink.sinkID = sinkID;
+    sink.name = name;
+    sink.reserved = true;
+    mSinkNames[name] = sinkID;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::peekSource(const std::string & name, am_sourceID_t & sourceID)
+{
+    NameMap::const_iterator nameIterator = mSourceNames.find(name);
+    if (nameIterator != mSourceNames.end())
+    {
+        sourceID = nameIterator->second;
+        return (E_OK);
+    }
+
+    if (mFirstStaticSource)
+    {
+        sourceID = DYNAMIC_ID_BOUNDARY;
+        useID(mCurrentSourceID, sourceID);
+        mFirstStaticSource = false;
+    }
+    else
+    {
+        sourceID = nextID(mCurrentSourceID);
+    }
+    am_Source_Database_s& source = mSourceMap[sourceID];
+    source.sourceID = sourceID;
+    source.name = name;
+    source.reserved = true;
+    mSourceNames[name] = sourceID;
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeSinkVolume(const am_sinkID_t sinkID, const am_volume_t volume)
+{
+    assert(sinkID!=0);
+
+    if (!existSink(sinkID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    mSinkMap[sinkID].volume = volume;
+    logInfo("DatabaseHandlerMap::changeSinkVolume changed volume of sink:", sinkID, "to:", volume);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeSourceVolume(const am_sourceID_t sourceID, const am_volume_t volume)
+{
+    assert(sourceID!=0);
+
+    if (!existSource(sourceID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    mSourceMap[sourceID].volume = volume;
+    logInfo("DatabaseHandlerMap::changeSourceVolume changed volume of source=:", sourceID, "to:", volume);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeSourceSoundPropertyDB(const am_SoundProperty_s & soundProperty, const am_sourceID_t sourceID)
+{
+    assert(soundProperty.type>=SP_UNKNOWN && soundProperty.type<=SP_MAX);
+    assert(sourceID!=0);
+
+    if (!existSource(sourceID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    std::vector<am_SoundProperty_s>& listProperties = mSourceMap[sourceID].listSoundProperties;
+    std::vector<am_SoundProperty_s>::iterator propertyIterator = listProperties.begin();
+    for (; propertyIterator != listProperties.end(); ++propertyIterator)
+    {
+        if (propertyIterator->type == soundProperty.type)
+            propertyIterator->value = soundProperty.value;
+    }
+    logInfo("DatabaseHandlerMap::changeSourceSoundPropertyDB changed SourceSoundProperty of source:", sourceID, "type:", soundProperty.type, "to:", soundProperty.value);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeSinkSoundPropertyDB(const am_SoundProperty_s & soundProperty, const am_sinkID_t sinkID)
+{
+    assert(soundProperty.type>=SP_UNKNOWN && soundProperty.type<=SP_MAX);
+    assert(sinkID!=0);
+
+    if (!existSink(sinkID))
+    {
+        return (E_NON_EXISTENT);
+    }
+    std::vector<am_SoundProperty_s>& listProperties = mSinkMap[sinkID].listSoundProperties;
+    std::vector<am_SoundProperty_s>::iterator propertyIterator = listProperties.begin();
+    for (; propertyIterator != listProperties.end(); ++propertyIterator)
+    {
+        if (propertyIterator->type == soundProperty.type)
+            propertyIterator->value = soundProperty.value;
+    }
+    logInfo("DatabaseHandlerMap::changeSinkSoundPropertyDB changed MainSinkSoundProperty of sink:", sinkID, "type:", soundProperty.type, "to:", soundProperty.value);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::changeCrossFaderHotSink(const am_crossfaderID_t crossfaderID, const am_HotSink_e hotsink)
+{
+    assert(crossfaderID!=0);
+    assert(hotsink>=HS_UNKNOWN && hotsink<=HS_MAX);
+
+    CrossfaderMap::iterator iter = mCrossfaderMap.find(crossfaderID);
+    if (iter == mCrossfaderMap.end())
+    {
+        return (E_NON_EXISTENT);
+    }
+    iter->second.hotSink = hotsink;
+    logInfo("DatabaseHandlerMap::changeCrossFaderHotSink changed hotsink of crossfader=", crossfaderID, "to:", hotsink);
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::getRoutingTree(bool onlyfree, CAmRoutingTree& tree, std::vector<CAmRoutingTreeItem*>& flatTree)
+{
+    size_t i = 0;
+    am_domainID_t rootID = tree.returnRootDomainID();
+    CAmRoutingTreeItem *parent = tree.returnRootItem();
+
+    do
+    {
+        if (i != 0)
+        {
+            parent = flatTree.at(i - 1);
+            rootID = parent->returnDomainID();
+        }
+
+        GatewayMap::const_iterator iter = mGatewayMap.begin();
+        for (; iter != mGatewayMap.end(); ++iter)
+        {
+            if (iter->second.domainSinkID != rootID)
+                continue;
+
+            //a gateway is not free if its sink or its source is part of a connection
+            if (onlyfree)
+            {
+                bool used = false;
+                ConnectionMap::const_iterator connectionIterator = mConnectionMap.begin();
+                for (; connectionIterator != mConnectionMap.end() && !used; ++connectionIterator)
+                {
+                    used = (connectionIterator->second.sinkID == iter->second.sinkID || connectionIterator->second.sourceID == iter->second.sourceID);
+                }
+                if (used)
+                    continue;
+            }
+            flatTree.push_back(tree.insertItem(iter->second.domainSourceID, iter->first, parent));
+        }
+        i++;
+    } while (flatTree.size() > (i - 1));
+
+    return (E_OK);
+}
+
+am_Error_e CAmDatabaseHandlerMap::peekSinkClassID(const std::string & name, am_sinkClass_t & sinkClassID)
+{
+    if (name.empty())
+        return (E_NON_EXISTENT);
+
+    SinkClassMap::const_iterator iter = mSinkClassMap.begin();
+    for (; iter != mSinkClassMap.end(); ++iter)
+    {
+        if (iter->second.name == name)
+        {
+            sinkClassID = iter->first;
+            return (E_OK);
+        }
+    }
+    return (E_NON_EXISTENT);
+}
+
+am_Error_e CAmDatabaseHandlerMap::peekSourceClassID(const std::string & name, am_sourceClass_t & sourceClassID)
+{
+    if (name.empty())
+        return (E_NON_EXISTENT);
+
+    SourceClassMap::const_iterator iter = mSourceClassMap.begin();
+    for (; iter != mSourceClassMap.end(); ++iter)
+    {
+        if (iter->second.name == name)
+        {
+            sourceClassID = iter->first;
+            return (E_OK);
+        }
+    }
+    return (E_NON_EXISTENT);
+}
+
+}
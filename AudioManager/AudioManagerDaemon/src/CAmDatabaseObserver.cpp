@@ -27,32 +27,65 @@
 #include <sys/ioctl.h>
 #include "CAmCommandSender.h"
 #include "CAmRoutingSender.h"
+#include "CAmRouter.h"
 #include "CAmTelnetServer.h"
 #include "shared/CAmDltWrapper.h"
 #include "shared/CAmSerializer.h"
 
 namespace am {
 
-CAmDatabaseObserver::CAmDatabaseObserver(CAmCommandSender *iCommandSender, CAmRoutingSender *iRoutingSender, CAmSocketHandler *iSocketHandler) :
+CAmDatabaseObserver::CAmDatabaseObserver(CAmCommandSender *iCommandSender, CAmRoutingSender *iRoutingSender, CAmRouter *iRouter, CAmSocketHandler *iSocketHandler) :
         mCommandSender(iCommandSender), //
         mRoutingSender(iRoutingSender), //
+        mRouter(iRouter), //
         mTelnetServer(NULL), //
-        mSerializer(iSocketHandler) //
+        mSerializer(iSocketHandler), //
+        mBatch(false), //
+        mBatchSinkClassesChanged(false), //
+        mBatchSourceClassesChanged(false), //
+        mBatchNewSinks(), //
+        mBatchRemovedSinks(), //
+        mBatchNewSources(), //
+        mBatchRemovedSources(), //
+        mListBatchCalls(), //
+        mListPendingChanges(), //
+        mChangesOpen(false), //
+        mDeliveredChanges(0), //
+        mDroppedChanges(0), //
+        mMaxChangeDelayNs(0), //
+        mDeferredPluginsStarted(false)
 {
     assert(mCommandSender!=0);
     assert(mRoutingSender!=0);
+    assert(mRouter!=0);
     assert(iSocketHandler!=0);
 }
 
-CAmDatabaseObserver::CAmDatabaseObserver(CAmCommandSender *iCommandSender, CAmRoutingSender *iRoutingSender, CAmSocketHandler *iSocketHandler, CAmTelnetServer *iTelnetServer) :
+CAmDatabaseObserver::CAmDatabaseObserver(CAmCommandSender *iCommandSender, CAmRoutingSender *iRoutingSender, CAmRouter *iRouter, CAmSocketHandler *iSocketHandler, CAmTelnetServer *iTelnetServer) :
         mCommandSender(iCommandSender), //
         mRoutingSender(iRoutingSender), //
+        mRouter(iRouter), //
         mTelnetServer(iTelnetServer), //
-        mSerializer(iSocketHandler) //
+        mSerializer(iSocketHandler), //
+        mBatch(false), //
+        mBatchSinkClassesChanged(false), //
+        mBatchSourceClassesChanged(false), //
+        mBatchNewSinks(), //
+        mBatchRemovedSinks(), //
+        mBatchNewSources(), //
+        mBatchRemovedSources(), //
+        mListBatchCalls(), //
+        mListPendingChanges(), //
+        mChangesOpen(false), //
+        mDeliveredChanges(0), //
+        mDroppedChanges(0), //
+        mMaxChangeDelayNs(0), //
+        mDeferredPluginsStarted(false)
 {
     assert(mTelnetServer!=0);
     assert(mCommandSender!=0);
     assert(mRoutingSender!=0);
+    assert(mRouter!=0);
     assert(iSocketHandler!=0);
 }
 
@@ -62,17 +95,27 @@ CAmDatabaseObserver::~CAmDatabaseObserver()
 
 void CAmDatabaseObserver::newMainConnection(const am_MainConnectionType_s& mainConnection)
 {
-    mSerializer.asyncCall<CAmCommandSender, const am_MainConnectionType_s>(mCommandSender, &CAmCommandSender::cbNewMainConnection, mainConnection);
+    closeChanges();
+    batchCall_s call;
+    call.type = BC_NEW_MAIN_CONNECTION;
+    call.mainConnection = mainConnection;
+    queueCall(call);
+    scheduleDeferredPlugins(mainConnection.connectionState);
 }
 
 void CAmDatabaseObserver::removedMainConnection(const am_mainConnectionID_t mainConnection)
 {
-    mSerializer.asyncCall<CAmCommandSender, const am_mainConnectionID_t>(mCommandSender, &CAmCommandSender::cbRemovedMainConnection, mainConnection);
+    closeChanges();
+    batchCall_s call;
+    call.type = BC_REMOVED_MAIN_CONNECTION;
+    call.mainConnectionID = mainConnection;
+    queueCall(call);
 }
 
 void CAmDatabaseObserver::newSink(const am_Sink_s& sink)
 {
     mRoutingSender->addSinkLookup(sink);
+    mRouter->invalidateRoutesOfSink(sink.sinkID);
     if (sink.visible)
     {
         am_SinkType_s s;
@@ -82,13 +125,20 @@ void CAmDatabaseObserver::newSink(const am_Sink_s& sink)
         s.sinkClassID = sink.sinkClassID;
         s.sinkID = sink.sinkID;
         s.volume = sink.mainVolume;
-        mSerializer.asyncCall<CAmCommandSender, const am_SinkType_s>(mCommandSender, &CAmCommandSender::cbNewSink, s);
+        if (mBatch)
+            mBatchNewSinks.push_back(s);
+        else
+        {
+            closeChanges();
+            mSerializer.asyncCall<CAmCommandSender, const am_SinkType_s>(mCommandSender, &CAmCommandSender::cbNewSink, s);
+        }
     }
 }
 
 void CAmDatabaseObserver::newSource(const am_Source_s& source)
 {
     mRoutingSender->addSourceLookup(source);
+    mRouter->invalidateRoutesOfSource(source.sourceID);
     if (source.visible)
     {
         am_SourceType_s s;
@@ -96,19 +146,25 @@ void CAmDatabaseObserver::newSource(const am_Source_s& source)
         s.name = source.name;
         s.sourceClassID = source.sourceClassID;
         s.sourceID = source.sourceID;
-        mSerializer.asyncCall<CAmCommandSender, const am_SourceType_s>(mCommandSender, &CAmCommandSender::cbNewSource, s);
+        if (mBatch)
+            mBatchNewSources.push_back(s);
+        else
+        {
+            closeChanges();
+            mSerializer.asyncCall<CAmCommandSender, const am_SourceType_s>(mCommandSender, &CAmCommandSender::cbNewSource, s);
+        }
     }
 }
 
 void CAmDatabaseObserver::newDomain(const am_Domain_s& domain)
 {
     mRoutingSender->addDomainLookup(domain);
+    mRouter->invalidateRoutes();
 }
 
 void CAmDatabaseObserver::newGateway(const am_Gateway_s& gateway)
 {
-    (void) gateway;
-    //todo: implement something
+    mRouter->addGateway(gateway);
 }
 
 void CAmDatabaseObserver::newCrossfader(const am_Crossfader_s& crossfader)
@@ -119,28 +175,59 @@ void CAmDatabaseObserver::newCrossfader(const am_Crossfader_s& crossfader)
 void CAmDatabaseObserver::removedSink(const am_sinkID_t sinkID, const bool visible)
 {
     mRoutingSender->removeSinkLookup(sinkID);
+    mRouter->invalidateRoutesOfSink(sinkID);
 
-    if (visible)
+    if (!visible)
+        return;
+
+    if (mBatch)
+    {
+        //a sink that was added in the same transaction was never reported, so its removal is not reported either
+        am_SinkType_s* batchSink = findBatchSink(sinkID);
+        if (batchSink)
+            mBatchNewSinks.erase(mBatchNewSinks.begin() + (batchSink - &mBatchNewSinks[0]));
+        else
+            mBatchRemovedSinks.push_back(sinkID);
+    }
+    else
+    {
+        closeChanges();
         mSerializer.asyncCall<CAmCommandSender, const am_sinkID_t>(mCommandSender, &CAmCommandSender::cbRemovedSink, sinkID);
+    }
 }
 
 void CAmDatabaseObserver::removedSource(const am_sourceID_t sourceID, const bool visible)
 {
     mRoutingSender->removeSourceLookup(sourceID);
+    mRouter->invalidateRoutesOfSource(sourceID);
 
-    if (visible)
+    if (!visible)
+        return;
+
+    if (mBatch)
+    {
+        am_SourceType_s* batchSource = findBatchSource(sourceID);
+        if (batchSource)
+            mBatchNewSources.erase(mBatchNewSources.begin() + (batchSource - &mBatchNewSources[0]));
+        else
+            mBatchRemovedSources.push_back(sourceID);
+    }
+    else
+    {
+        closeChanges();
         mSerializer.asyncCall<CAmCommandSender, const am_sourceID_t>(mCommandSender, &CAmCommandSender::cbRemovedSource, sourceID);
+    }
 }
 
 void CAmDatabaseObserver::removeDomain(const am_domainID_t domainID)
 {
     mRoutingSender->removeDomainLookup(domainID);
+    mRouter->invalidateRoutes();
 }
 
 void CAmDatabaseObserver::removeGateway(const am_gatewayID_t gatewayID)
 {
-    (void) gatewayID;
-    //todo: implement something?
+    mRouter->removeGateway(gatewayID);
 }
 
 void CAmDatabaseObserver::removeCrossfader(const am_crossfaderID_t crossfaderID)
@@ -148,58 +235,390 @@ void CAmDatabaseObserver::removeCrossfader(const am_crossfaderID_t crossfaderID)
     mRoutingSender->removeCrossfaderLookup(crossfaderID);
 }
 
+void CAmDatabaseObserver::newConnection(const am_Connection_s& connection)
+{
+    mRouter->addConnection(connection);
+}
+
+void CAmDatabaseObserver::removedConnection(const am_connectionID_t connectionID)
+{
+    mRouter->removeConnection(connectionID);
+}
+
 void CAmDatabaseObserver::numberOfSinkClassesChanged()
 {
+    if (mBatch)
+    {
+        mBatchSinkClassesChanged = true;
+        return;
+    }
+    closeChanges();
     mSerializer.asyncCall<CAmCommandSender>(mCommandSender, &CAmCommandSender::cbNumberOfSinkClassesChanged);
 }
 
 void CAmDatabaseObserver::numberOfSourceClassesChanged()
 {
+    if (mBatch)
+    {
+        mBatchSourceClassesChanged = true;
+        return;
+    }
+    closeChanges();
     mSerializer.asyncCall<CAmCommandSender>(mCommandSender, &CAmCommandSender::cbNumberOfSourceClassesChanged);
 }
 
 void CAmDatabaseObserver::mainConnectionStateChanged(const am_mainConnectionID_t connectionID, const am_ConnectionState_e connectionState)
 {
-    mSerializer.asyncCall<CAmCommandSender, const am_connectionID_t, const am_ConnectionState_e>(mCommandSender, &CAmCommandSender::cbMainConnectionStateChanged, connectionID, connectionState);
+    closeChanges();
+    batchCall_s call;
+    call.type = BC_MAIN_CONNECTION_STATE;
+    call.mainConnectionID = connectionID;
+    call.connectionState = connectionState;
+    queueCall(call);
+    scheduleDeferredPlugins(connectionState);
 }
 
 void CAmDatabaseObserver::mainSinkSoundPropertyChanged(const am_sinkID_t sinkID, const am_MainSoundProperty_s& SoundProperty)
 {
-    mSerializer.asyncCall<CAmCommandSender, const am_sinkID_t, const am_MainSoundProperty_s>(mCommandSender, &CAmCommandSender::cbMainSinkSoundPropertyChanged, sinkID, SoundProperty);
+    storeChange(openChanges().mapSinkSoundProperties, std::make_pair(sinkID, SoundProperty.type), SoundProperty.value);
 }
 
 void CAmDatabaseObserver::mainSourceSoundPropertyChanged(const am_sourceID_t sourceID, const am_MainSoundProperty_s & SoundProperty)
 {
-    mSerializer.asyncCall<CAmCommandSender, const am_sourceID_t, const am_MainSoundProperty_s>(mCommandSender, &CAmCommandSender::cbMainSourceSoundPropertyChanged, sourceID, SoundProperty);
+    storeChange(openChanges().mapSourceSoundProperties, std::make_pair(sourceID, SoundProperty.type), SoundProperty.value);
 }
 
 void CAmDatabaseObserver::sinkAvailabilityChanged(const am_sinkID_t sinkID, const am_Availability_s & availability)
 {
-    mSerializer.asyncCall<CAmCommandSender, const am_sinkID_t, const am_Availability_s>(mCommandSender, &CAmCommandSender::cbSinkAvailabilityChanged, sinkID, availability);
+    am_SinkType_s* batchSink = findBatchSink(sinkID);
+    if (batchSink)
+    {
+        batchSink->availability = availability;
+        return;
+    }
+    storeChange(openChanges().mapSinkAvailabilities, sinkID, availability);
 }
 
 void CAmDatabaseObserver::sourceAvailabilityChanged(const am_sourceID_t sourceID, const am_Availability_s & availability)
 {
-    mSerializer.asyncCall<CAmCommandSender, const am_sourceID_t, const am_Availability_s>(mCommandSender, &CAmCommandSender::cbSourceAvailabilityChanged, sourceID, availability);
+    am_SourceType_s* batchSource = findBatchSource(sourceID);
+    if (batchSource)
+    {
+        batchSource->availability = availability;
+        return;
+    }
+    storeChange(openChanges().mapSourceAvailabilities, sourceID, availability);
 }
 
 void CAmDatabaseObserver::volumeChanged(const am_sinkID_t sinkID, const am_mainVolume_t volume)
 {
-    mSerializer.asyncCall<CAmCommandSender, const am_sinkID_t, const am_mainVolume_t>(mCommandSender, &CAmCommandSender::cbVolumeChanged, sinkID, volume);
+    am_SinkType_s* batchSink = findBatchSink(sinkID);
+    if (batchSink)
+    {
+        batchSink->volume = volume;
+        return;
+    }
+    storeChange(openChanges().mapVolumes, sinkID, volume);
 }
 
 void CAmDatabaseObserver::sinkMuteStateChanged(const am_sinkID_t sinkID, const am_MuteState_e muteState)
 {
-    mSerializer.asyncCall<CAmCommandSender, const am_sinkID_t, const am_MuteState_e>(mCommandSender, &CAmCommandSender::cbSinkMuteStateChanged, sinkID, muteState);
+    am_SinkType_s* batchSink = findBatchSink(sinkID);
+    if (batchSink)
+    {
+        batchSink->muteState = muteState;
+        return;
+    }
+    storeChange(openChanges().mapMuteStates, sinkID, muteState);
 }
 
 void CAmDatabaseObserver::systemPropertyChanged(const am_SystemProperty_s& SystemProperty)
 {
-    mSerializer.asyncCall<CAmCommandSender, const am_SystemProperty_s>(mCommandSender, &CAmCommandSender::cbSystemPropertyChanged, SystemProperty);
+    storeChange(openChanges().mapSystemProperties, SystemProperty.type, SystemProperty.value);
 }
 
 void CAmDatabaseObserver::timingInformationChanged(const am_mainConnectionID_t mainConnection, const am_timeSync_t time)
 {
-    mSerializer.asyncCall<CAmCommandSender, const am_mainConnectionID_t, const am_timeSync_t>(mCommandSender, &CAmCommandSender::cbTimingInformationChanged, mainConnection, time);
+    storeChange(openChanges().mapTimingInformation, mainConnection, time);
 }
+
+/**
+ * looks for a sink that was added in the current transaction and not reported yet. Changes of such a sink are merged into
+ * the new sink notification.
+ * @return pointer to the collected sink, NULL if there is none
+ */
+am_SinkType_s* CAmDatabaseObserver::findBatchSink(const am_sinkID_t sinkID)
+{
+    std::vector<am_SinkType_s>::iterator iter = mBatchNewSinks.begin();
+    for (; iter != mBatchNewSinks.end(); ++iter)
+    {
+        if (iter->sinkID == sinkID)
+            return (&(*iter));
+    }
+    return (NULL);
+}
+
+/**
+ * looks for a source that was added in the current transaction and not reported yet
+ * @return pointer to the collected source, NULL if there is none
+ */
+am_SourceType_s* CAmDatabaseObserver::findBatchSource(const am_sourceID_t sourceID)
+{
+    std::vector<am_SourceType_s>::iterator iter = mBatchNewSources.begin();
+    for (; iter != mBatchNewSources.end(); ++iter)
+    {
+        if (iter->sourceID == sourceID)
+            return (&(*iter));
+    }
+    return (NULL);
+}
+
+/**
+ * called by the database when a transaction starts, from now on the notifications to the CommandSender are collected
+ */
+void CAmDatabaseObserver::beginBatch()
+{
+    //value changes of the transaction must not go into an entry that is already scheduled
+    closeChanges();
+    mBatch = true;
+}
+
+/**
+ * called by the database when a transaction is committed, sends the collected notifications.
+ * Removals are sent first, so a sink that was removed and registered again with the same ID ends up as new. The value
+ * changes and main connection notifications come last, they can refer to the new sinks and sources.
+ */
+void CAmDatabaseObserver::commitBatch()
+{
+    mBatch = false;
+    closeChanges();
+
+    std::vector<am_sinkID_t>::const_iterator removedSinkIterator = mBatchRemovedSinks.begin();
+    for (; removedSinkIterator != mBatchRemovedSinks.end(); ++removedSinkIterator)
+        mSerializer.asyncCall<CAmCommandSender, const am_sinkID_t>(mCommandSender, &CAmCommandSender::cbRemovedSink, *removedSinkIterator);
+
+    std::vector<am_sourceID_t>::const_iterator removedSourceIterator = mBatchRemovedSources.begin();
+    for (; removedSourceIterator != mBatchRemovedSources.end(); ++removedSourceIterator)
+        mSerializer.asyncCall<CAmCommandSender, const am_sourceID_t>(mCommandSender, &CAmCommandSender::cbRemovedSource, *removedSourceIterator);
+
+    std::vector<am_SinkType_s>::const_iterator sinkIterator = mBatchNewSinks.begin();
+    for (; sinkIterator != mBatchNewSinks.end(); ++sinkIterator)
+        mSerializer.asyncCall<CAmCommandSender, const am_SinkType_s>(mCommandSender, &CAmCommandSender::cbNewSink, *sinkIterator);
+
+    std::vector<am_SourceType_s>::const_iterator sourceIterator = mBatchNewSources.begin();
+    for (; sourceIterator != mBatchNewSources.end(); ++sourceIterator)
+        mSerializer.asyncCall<CAmCommandSender, const am_SourceType_s>(mCommandSender, &CAmCommandSender::cbNewSource, *sourceIterator);
+
+    if (mBatchSinkClassesChanged)
+        mSerializer.asyncCall<CAmCommandSender>(mCommandSender, &CAmCommandSender::cbNumberOfSinkClassesChanged);
+    if (mBatchSourceClassesChanged)
+        mSerializer.asyncCall<CAmCommandSender>(mCommandSender, &CAmCommandSender::cbNumberOfSourceClassesChanged);
+
+    std::vector<batchCall_s>::const_iterator callIterator = mListBatchCalls.begin();
+    for (; callIterator != mListBatchCalls.end(); ++callIterator)
+        sendCall(*callIterator);
+
+    mBatchSinkClassesChanged = false;
+    mBatchSourceClassesChanged = false;
+    mBatchRemovedSinks.clear();
+    mBatchRemovedSources.clear();
+    mBatchNewSinks.clear();
+    mBatchNewSources.clear();
+    mListBatchCalls.clear();
+}
+
+/**
+ * returns the collected value changes that a new change is added to. The first change after closeChanges() starts a new
+ * entry and schedules its dispatch via the mainloop.
+ */
+CAmDatabaseObserver::pendingChanges_s& CAmDatabaseObserver::openChanges()
+{
+    if (!mChangesOpen)
+    {
+        mListPendingChanges.push_back(pendingChanges_s());
+        clock_gettime(CLOCK_MONOTONIC, &mListPendingChanges.back().created);
+        batchCall_s call;
+        call.type = BC_DELIVER_CHANGES;
+        queueCall(call);
+        mChangesOpen = true;
+    }
+    return (mListPendingChanges.back());
+}
+
+/**
+ * needs to be called before any notification that is not collected is passed to the serializer. Changes that come
+ * afterwards are collected in a new entry that is dispatched after that notification.
+ */
+void CAmDatabaseObserver::closeChanges()
+{
+    mChangesOpen = false;
+}
+
+/**
+ * sends a notification to the CommandSender via the mainloop, or holds it back until the transaction is committed
+ */
+void CAmDatabaseObserver::queueCall(const batchCall_s& call)
+{
+    if (mBatch)
+        mListBatchCalls.push_back(call);
+    else
+        sendCall(call);
+}
+
+void CAmDatabaseObserver::sendCall(const batchCall_s& call)
+{
+    switch (call.type)
+    {
+    case BC_DELIVER_CHANGES:
+        mSerializer.asyncCall<CAmDatabaseObserver>(this, &CAmDatabaseObserver::deliverChanges);
+        break;
+    case BC_NEW_MAIN_CONNECTION:
+        mSerializer.asyncCall<CAmCommandSender, const am_MainConnectionType_s>(mCommandSender, &CAmCommandSender::cbNewMainConnection, call.mainConnection);
+        break;
+    case BC_REMOVED_MAIN_CONNECTION:
+        mSerializer.asyncCall<CAmCommandSender, const am_mainConnectionID_t>(mCommandSender, &CAmCommandSender::cbRemovedMainConnection, call.mainConnectionID);
+        break;
+    case BC_MAIN_CONNECTION_STATE:
+        mSerializer.asyncCall<CAmCommandSender, const am_connectionID_t, const am_ConnectionState_e>(mCommandSender, &CAmCommandSender::cbMainConnectionStateChanged, call.mainConnectionID, call.connectionState);
+        break;
+    default:
+        break;
+    }
+}
+
+template<class TKey, class TValue> void CAmDatabaseObserver::storeChange(std::map<TKey, TValue>& mapChanges, const TKey& key, const TValue& value)
+{
+    std::pair<typename std::map<TKey, TValue>::iterator, bool> result(mapChanges.insert(std::make_pair(key, value)));
+    if (!result.second)
+    {
+        result.first->second = value;
+        mDroppedChanges++;
+    }
+}
+
+/**
+ * called via the mainloop, sends the oldest entry of collected changes to the CommandSender
+ */
+void CAmDatabaseObserver::deliverChanges()
+{
+    assert(!mListPendingChanges.empty());
+    //the CommandSender might cause new changes, so the entry is taken from the list first
+    pendingChanges_s changes(mListPendingChanges.front());
+    mListPendingChanges.pop_front();
+    if (mListPendingChanges.empty())
+        mChangesOpen = false;
+
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t delayNs((now.tv_sec - changes.created.tv_sec) * 1000000000ULL + now.tv_nsec - changes.created.tv_nsec);
+    if (delayNs > mMaxChangeDelayNs)
+        mMaxChangeDelayNs = delayNs;
+
+    std::map<am_sinkID_t, am_Availability_s>::const_iterator sinkAvailabilityIter(changes.mapSinkAvailabilities.begin());
+    for (; sinkAvailabilityIter != changes.mapSinkAvailabilities.end(); ++sinkAvailabilityIter)
+        mCommandSender->cbSinkAvailabilityChanged(sinkAvailabilityIter->first, sinkAvailabilityIter->second);
+
+    std::map<am_sourceID_t, am_Availability_s>::const_iterator sourceAvailabilityIter(changes.mapSourceAvailabilities.begin());
+    for (; sourceAvailabilityIter != changes.mapSourceAvailabilities.end(); ++sourceAvailabilityIter)
+        mCommandSender->cbSourceAvailabilityChanged(sourceAvailabilityIter->first, sourceAvailabilityIter->second);
+
+    std::map<am_sinkID_t, am_MuteState_e>::const_iterator muteStateIter(changes.mapMuteStates.begin());
+    for (; muteStateIter != changes.mapMuteStates.end(); ++muteStateIter)
+        mCommandSender->cbSinkMuteStateChanged(muteStateIter->first, muteStateIter->second);
+
+    std::map<am_sinkID_t, am_mainVolume_t>::const_iterator volumeIter(changes.mapVolumes.begin());
+    for (; volumeIter != changes.mapVolumes.end(); ++volumeIter)
+        mCommandSender->cbVolumeChanged(volumeIter->first, volumeIter->second);
+
+    am_MainSoundProperty_s soundProperty;
+    std::map<std::pair<am_sinkID_t, am_MainSoundPropertyType_e>, int16_t>::const_iterator sinkPropertyIter(changes.mapSinkSoundProperties.begin());
+    for (; sinkPropertyIter != changes.mapSinkSoundProperties.end(); ++sinkPropertyIter)
+    {
+        soundProperty.type = sinkPropertyIter->first.second;
+        soundProperty.value = sinkPropertyIter->second;
+        mCommandSender->cbMainSinkSoundPropertyChanged(sinkPropertyIter->first.first, soundProperty);
+    }
+
+    std::map<std::pair<am_sourceID_t, am_MainSoundPropertyType_e>, int16_t>::const_iterator sourcePropertyIter(changes.mapSourceSoundProperties.begin());
+    for (; sourcePropertyIter != changes.mapSourceSoundProperties.end(); ++sourcePropertyIter)
+    {
+        soundProperty.type = sourcePropertyIter->first.second;
+        soundProperty.value = sourcePropertyIter->second;
+        mCommandSender->cbMainSourceSoundPropertyChanged(sourcePropertyIter->first.first, soundProperty);
+    }
+
+    am_SystemProperty_s systemProperty;
+    std::map<am_SystemPropertyType_e, int16_t>::const_iterator systemPropertyIter(changes.mapSystemProperties.begin());
+    for (; systemPropertyIter != changes.mapSystemProperties.end(); ++systemPropertyIter)
+    {
+        systemProperty.type = systemPropertyIter->first;
+        systemProperty.value = systemPropertyIter->second;
+        mCommandSender->cbSystemPropertyChanged(systemProperty);
+    }
+
+    std::map<am_mainConnectionID_t, am_timeSync_t>::const_iterator timingIter(changes.mapTimingInformation.begin());
+    for (; timingIter != changes.mapTimingInformation.end(); ++timingIter)
+        mCommandSender->cbTimingInformationChanged(timingIter->first, timingIter->second);
+
+    mDeliveredChanges += changes.mapSinkAvailabilities.size() + changes.mapSourceAvailabilities.size() + changes.mapMuteStates.size() + changes.mapVolumes.size() //
+            + changes.mapSinkSoundProperties.size() + changes.mapSourceSoundProperties.size() + changes.mapSystemProperties.size() + changes.mapTimingInformation.size();
+}
+
+/**
+ * returns how well the value changes were collected
+ * @param delivered number of value changes that were sent to the CommandSender
+ * @param dropped number of value changes that were replaced by a newer value of the same sink, source or property
+ * @param maxDelayNs longest time between a change and its dispatch, in nanoseconds
+ */
+void CAmDatabaseObserver::getChangeStatistics(uint32_t& delivered, uint32_t& dropped, uint64_t& maxDelayNs) const
+{
+    delivered = mDeliveredChanges;
+    dropped = mDroppedChanges;
+    maxDelayNs = mMaxChangeDelayNs;
+}
+
+/**
+ * returns the counters of the serializer that hands the changes to the mainloop
+ * @param depth number of calls that wait for execution
+ * @param maxDepth highest number of waiting calls
+ * @param calls number of executed calls
+ */
+void CAmDatabaseObserver::getQueueStatistics(uint32_t& depth, uint32_t& maxDepth, uint32_t& calls) const
+{
+    mSerializer.getQueueStatistics(depth, maxDepth, calls);
+}
+
+/**
+ * sets the change and queue counters to 0
+ */
+void CAmDatabaseObserver::resetStatistics()
+{
+    mDeliveredChanges = 0;
+    mDroppedChanges = 0;
+    mMaxChangeDelayNs = 0;
+    mSerializer.resetQueueStatistics();
+}
+
+/**
+ * the plugins that are not needed for the first audio are started when it plays, after the database change is done.
+ * Main connections can be connected by a state change or already be connected when they are entered.
+ * @param connectionState the state of a new or changed main connection
+ */
+void CAmDatabaseObserver::scheduleDeferredPlugins(const am_ConnectionState_e connectionState)
+{
+    if (connectionState != CS_CONNECTED || mDeferredPluginsStarted)
+        return;
+    mDeferredPluginsStarted = true;
+    mSerializer.asyncCall<CAmDatabaseObserver>(this, &CAmDatabaseObserver::startupDeferredPlugins);
+}
+
+/**
+ * loads and starts the routing and command plugins that were deferred to the first main connection
+ */
+void CAmDatabaseObserver::startupDeferredPlugins()
+{
+    mRoutingSender->startupDeferredInterfaces();
+    mCommandSender->startupDeferredInterfaces();
+}
+
 }
@@ -0,0 +1,246 @@
+/**
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \author Christian Mueller, christian.ei.mueller@bmw.de BMW 2011,2012
+ *
+ * \file CAmDatabaseStatementCache.cpp
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#include "CAmDatabaseStatementCache.h"
+#include <cassert>
+#include "shared/CAmDltWrapper.h"
+
+namespace am
+{
+
+/**
+ * returns the time between two timespecs in nanoseconds
+ */
+static uint64_t elapsedNs(const timespec& start, const timespec& end)
+{
+    return ((uint64_t) (end.tv_sec - start.tv_sec) * 1000000000ULL + end.tv_nsec - start.tv_nsec);
+}
+
+CAmDatabaseStatementCache::CAmDatabaseStatementCache(const size_t maxStatements) :
+        mMaxStatements(maxStatements), //
+        mUseCounter(0), //
+        mHits(0), //
+        mMisses(0), //
+        mEvictions(0), //
+        mStatements(), //
+        mActive()
+{
+}
+
+CAmDatabaseStatementCache::~CAmDatabaseStatementCache()
+{
+    clear();
+}
+
+/**
+ * hands out a compiled statement for the command. Every statement handed out must be given back with release.
+ * @param database the database the statement is compiled for
+ * @param command the sql text
+ * @param statement the compiled statement
+ * @return the sqlite error code of the compilation, SQLITE_OK on success
+ */
+int CAmDatabaseStatementCache::prepare(sqlite3* database, const char* command, sqlite3_stmt** statement)
+{
+    assert(command!=NULL);
+    assert(statement!=NULL);
+
+    activeStatement_s active;
+    clock_gettime(CLOCK_MONOTONIC, &active.start);
+    active.command = command;
+
+    StatementMap::iterator iter = mStatements.find(active.command);
+    if (iter != mStatements.end() && !iter->second.inUse)
+    {
+        mHits++;
+        iter->second.hits++;
+        iter->second.inUse = true;
+        iter->second.lastUse = ++mUseCounter;
+        *statement = iter->second.statement;
+        active.cached = true;
+        mActive[*statement] = active;
+        return (SQLITE_OK);
+    }
+
+    int eCode = sqlite3_prepare_v2(database, command, -1, statement, NULL);
+    if (eCode != SQLITE_OK)
+        return (eCode);
+
+    mMisses++;
+    active.cached = false;
+    if (iter != mStatements.end())
+    {
+        //the command is cached but in use, so this is a nested query that gets its own statement
+        iter->second.misses++;
+    }
+    else
+    {
+        if (mStatements.size() >= mMaxStatements)
+            evict();
+
+        if (mStatements.size() < mMaxStatements)
+        {
+            statementEntry_s entry;
+            entry.statement = *statement;
+            entry.inUse = true;
+            entry.lastUse = ++mUseCounter;
+            entry.hits = 0;
+            entry.misses = 1;
+            entry.timeNs = 0;
+            mStatements[active.command] = entry;
+            active.cached = true;
+        }
+    }
+    mActive[*statement] = active;
+    return (SQLITE_OK);
+}
+
+/**
+ * gives a statement back. Cached statements are reset, temporary ones are finalized.
+ * @param statement the statement that was handed out by prepare
+ * @return the sqlite error code of the reset or finalize, which reflects the last step of the statement
+ */
+int CAmDatabaseStatementCache::release(sqlite3_stmt* statement)
+{
+    if (statement == NULL)
+        return (SQLITE_OK);
+
+    ActiveMap::iterator activeIterator = mActive.find(statement);
+    if (activeIterator == mActive.end())
+    {
+        logError("DatabaseStatementCache::release statement was not handed out by the cache");
+        return (sqlite3_finalize(statement));
+    }
+
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t timeNs = elapsedNs(activeIterator->second.start, now);
+
+    int eCode = SQLITE_OK;
+    StatementMap::iterator iter = mStatements.find(activeIterator->second.command);
+    if (activeIterator->second.cached)
+    {
+        assert(iter!=mStatements.end());
+        eCode = sqlite3_reset(statement);
+        sqlite3_clear_bindings(statement);
+        iter->second.inUse = false;
+    }
+    else
+    {
+        eCode = sqlite3_finalize(statement);
+    }
+
+    if (iter != mStatements.end())
+        iter->second.timeNs += timeNs;
+
+    mActive.erase(activeIterator);
+    return (eCode);
+}
+
+/**
+ * finalizes all statements. Must be called before the database is closed.
+ */
+void CAmDatabaseStatementCache::clear()
+{
+    ActiveMap::iterator activeIterator = mActive.begin();
+    for (; activeIterator != mActive.end(); ++activeIterator)
+    {
+        if (!activeIterator->second.cached)
+            sqlite3_finalize(activeIterator->first);
+    }
+    mActive.clear();
+
+    StatementMap::iterator iter = mStatements.begin();
+    for (; iter != mStatements.end(); ++iter)
+        sqlite3_finalize(iter->second.statement);
+    mStatements.clear();
+}
+
+/**
+ * returns the usage information of all cached commands
+ * @param listStatistics the list of statistics
+ */
+void CAmDatabaseStatementCache::getStatistics(std::vector<statementStatistic_s>& listStatistics) const
+{
+    listStatistics.clear();
+    statementStatistic_s statistic;
+    StatementMap::const_iterator iter = mStatements.begin();
+    for (; iter != mStatements.end(); ++iter)
+    {
+        statistic.command = iter->first;
+        statistic.hits = iter->second.hits;
+        statistic.misses = iter->second.misses;
+        statistic.timeNs = iter->second.timeNs;
+        listStatistics.push_back(statistic);
+    }
+}
+
+/**
+ * returns the summed up counters of the cache
+ * @param hits the number of hits
+ * @param misses the number of misses
+ * @param evictions the number of statements that were dropped because the cache was full
+ */
+void CAmDatabaseStatementCache::getTotals(uint32_t& hits, uint32_t& misses, uint32_t& evictions) const
+{
+    hits = mHits;
+    misses = mMisses;
+    evictions = mEvictions;
+}
+
+/**
+ * sets all counters back to zero, the statements stay cached
+ */
+void CAmDatabaseStatementCache::resetStatistics()
+{
+    mHits = 0;
+    mMisses = 0;
+    mEvictions = 0;
+    StatementMap::iterator iter = mStatements.begin();
+    for (; iter != mStatements.end(); ++iter)
+    {
+        iter->second.hits = 0;
+        iter->second.misses = 0;
+        iter->second.timeNs = 0;
+    }
+}
+
+/**
+ * drops the least recently used statement that is not in use
+ */
+void CAmDatabaseStatementCache::evict()
+{
+    StatementMap::iterator oldest = mStatements.end();
+    StatementMap::iterator iter = mStatements.begin();
+    for (; iter != mStatements.end(); ++iter)
+    {
+        if (!iter->second.inUse && (oldest == mStatements.end() || iter->second.lastUse < oldest->second.lastUse))
+            oldest = iter;
+    }
+
+    if (oldest == mStatements.end())
+        return;
+
+    sqlite3_finalize(oldest->second.statement);
+    mStatements.erase(oldest);
+    mEvictions++;
+}
+
+}
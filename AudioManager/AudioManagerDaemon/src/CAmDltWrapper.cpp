@@ -108,19 +108,32 @@ void CAmDltWrapper::registerContext(DltContext& handle, const char *contextid, c
 #endif
 }
 
-void CAmDltWrapper::init(DltLogLevelType loglevel, DltContext* context)
+/**
+ * starts a log message. If it returns true the message must be finished with send(), otherwise nothing may be appended.
+ * @param loglevel the loglevel of the message
+ * @param context the context, NULL for the default context
+ * @return false if the loglevel is not enabled for the context
+ */
+bool CAmDltWrapper::init(DltLogLevelType loglevel, DltContext* context)
 {
     (void) loglevel;
+#ifndef WITH_DLT
+    if (!mEnableNoDLTDebug)
+        return (false);
+#endif
     pthread_mutex_lock(&mMutex);
     if (!context)
         context = &mDltContext;
 #ifdef WITH_DLT
-    dlt_user_log_write_start(context, &mDltContextData, loglevel);
+    if (dlt_user_log_write_start(context, &mDltContextData, loglevel) <= 0)
+    {
+        pthread_mutex_unlock(&mMutex);
+        return (false);
+    }
 #else
-    if(mEnableNoDLTDebug)
-        std::cout << "\e[0;34m[" << context->contextID << "]\e[0;30m\t";
+    std::cout << "\e[0;34m[" << context->contextID << "]\e[0;30m\t";
 #endif
-
+    return (true);
 }
 
 void CAmDltWrapper::send()
@@ -128,8 +141,7 @@ void CAmDltWrapper::send()
 #ifdef WITH_DLT
     dlt_user_log_write_finish(&mDltContextData);
 #else
-    if(mEnableNoDLTDebug)
-        std::cout << mDltContextData.buffer.str().c_str() << std::endl;
+    std::cout << mDltContextData.buffer.str().c_str() << std::endl;
 
     mDltContextData.buffer.str("");
     mDltContextData.buffer.clear();
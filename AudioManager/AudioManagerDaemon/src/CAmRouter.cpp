@@ -24,17 +24,55 @@
 #include <algorithm>
 #include <vector>
 #include <iterator>
-#include "CAmDatabaseHandler.h"
+#include <queue>
+#include <functional>
+#include <time.h>
+#include "IAmDatabaseHandler.h"
 #include "CAmControlSender.h"
+#include "shared/CAmDltWrapper.h"
+
+#define DEFAULT_HOP_COST 10 //!< cost of passing one gateway when only the cheapest routes are searched
+#define DEFAULT_CONVERSION_COST 5 //!< cost of every change of the connection format along a route
+#define MAX_ROUTE_SEARCH_NODES 4096 //!< limits the ways that are looked at for one search of the cheapest routes
 
 namespace am {
 
-CAmRouter::CAmRouter(CAmDatabaseHandler* iDatabaseHandler, CAmControlSender* iSender) :
+CAmRouter::CAmRouter(IAmDatabaseHandler* iDatabaseHandler, CAmControlSender* iSender) :
         mpDatabaseHandler(iDatabaseHandler), //
-        mpControlSender(iSender)
+        mpControlSender(iSender), //
+        mGateways(), //
+        mDomainGateways(), //
+        mConnections(), //
+        mSinkConnectionCount(), //
+        mSourceConnectionCount(), //
+        mGatewayInUse(), //
+        mSinkFormats(), //
+        mSourceFormats(), //
+        mRouteCache(), //
+        mRouteCacheHits(0), //
+        mRouteCacheMisses(0), //
+        mRouteCacheInvalidations(0), //
+        mRouteCalculationNs(0), //
+        mMaxRoutes(0), //
+        mHopCost(DEFAULT_HOP_COST), //
+        mConversionCost(DEFAULT_CONVERSION_COST), //
+        mGatewayCost()
 {
     assert(mpDatabaseHandler);
     assert(mpControlSender);
+
+    //take over what is already in the database, everything else is reported by the CAmDatabaseObserver
+    std::vector<am_Gateway_s> listGateways;
+    mpDatabaseHandler->getListGateways(listGateways);
+    std::vector<am_Gateway_s>::const_iterator gatewayIterator = listGateways.begin();
+    for (; gatewayIterator != listGateways.end(); ++gatewayIterator)
+        addGateway(*gatewayIterator);
+
+    std::vector<am_Connection_s> listConnections;
+    mpDatabaseHandler->getListConnections(listConnections);
+    std::vector<am_Connection_s>::const_iterator connectionIterator = listConnections.begin();
+    for (; connectionIterator != listConnections.end(); ++connectionIterator)
+        addConnection(*connectionIterator);
 }
 
 /**
@@ -46,6 +84,35 @@ CAmRouter::CAmRouter(CAmDatabaseHandler* iDatabaseHandler, CAmControlSender* iSe
  * @return E_OK in case of success
  */
 am_Error_e CAmRouter::getRoute(const bool onlyfree, const am_sourceID_t sourceID, const am_sinkID_t sinkID, std::vector<am_Route_s> & returnList)
+{
+    routeCacheKey_s key;
+    key.onlyfree = onlyfree;
+    key.sourceID = sourceID;
+    key.sinkID = sinkID;
+
+    RouteCacheMap::const_iterator iter = mRouteCache.find(key);
+    if (iter != mRouteCache.end())
+    {
+        mRouteCacheHits++;
+        returnList = iter->second;
+        return (E_OK);
+    }
+
+    mRouteCacheMisses++;
+    timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    am_Error_e error = calculateRoute(onlyfree, sourceID, sinkID, returnList);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    mRouteCalculationNs += static_cast<uint64_t>(end.tv_sec - start.tv_sec) * 1000000000 + end.tv_nsec - start.tv_nsec;
+    if (error == E_OK)
+        mRouteCache[key] = returnList;
+    return (error);
+}
+
+/**
+ * calculates the routes between a source and a sink, the parameters are the same as for getRoute
+ */
+am_Error_e CAmRouter::calculateRoute(const bool onlyfree, const am_sourceID_t sourceID, const am_sinkID_t sinkID, std::vector<am_Route_s> & returnList)
 {
     returnList.clear();
     //first find out in which domains the source and sink are
@@ -60,7 +127,7 @@ am_Error_e CAmRouter::getRoute(const bool onlyfree, const am_sourceID_t sourceID
     {
         //first get the list of possible connection formats
         std::vector<am_ConnectionFormat_e> listFormats, listPriorityConnectionFormats;
-        listPossibleConnectionFormats(sourceID, sinkID, listFormats);
+        toFormatList(possibleConnectionFormats(sourceID, sinkID), listFormats);
 
         //dummy route
         am_Route_s route;
@@ -93,121 +160,282 @@ am_Error_e CAmRouter::getRoute(const bool onlyfree, const am_sourceID_t sourceID
         return (E_OK);
 
     }
-    CAmRoutingTree routingtree(sourceDomainID); //Build up a Tree from the Source_Domain to every other domain.
-    std::vector<CAmRoutingTreeItem*> flattree; //This list is the flat tree
-    std::vector<CAmRoutingTreeItem*> matchtree;
+
+    if (mMaxRoutes != 0)
+        return (calculateBestRoutes(onlyfree, sourceID, sinkID, sourceDomainID, sinkDomainID, returnList));
+
+    std::vector<routingNode_s> listNodes; //the routing tree, the first node is the source domain
     std::vector<am_gatewayID_t> listGatewayID; //holds all gateway ids of the route
-    am_RoutingElement_s routingElement;
     am_Route_s actualRoute; //holds the actual Route
-    am_sourceID_t lastSource = 0;
+    am_Error_e error;
 
-    mpDatabaseHandler->getRoutingTree(onlyfree, routingtree, flattree); //Build up the tree out of the database as
+    buildRoutingTree(onlyfree, sourceDomainID, listNodes);
 
-    //we go through the returned flattree and look for our sink, after that flattree holds only treeItems that match
-    std::vector<CAmRoutingTreeItem*>::iterator iterator = flattree.begin();
-    for (; iterator != flattree.end(); ++iterator)
+    //every node that reaches the domain of the sink is a route, trace back the gateways for each of them
+    for (size_t nodeIndex = 1; nodeIndex < listNodes.size(); ++nodeIndex)
     {
-        if ((*iterator)->returnDomainID() == sinkDomainID)
-        {
-            matchtree.push_back(*iterator);
-        }
+        if (listNodes[nodeIndex].domainID != sinkDomainID)
+            continue;
+
+        listGatewayID.clear();
+        for (size_t index = nodeIndex; index != 0; index = listNodes[index].parent)
+            listGatewayID.push_back(listNodes[index].gatewayID);
+        std::reverse(listGatewayID.begin(), listGatewayID.end());
+
+        if ((error = buildRoute(sourceID, sinkID, sourceDomainID, sinkDomainID, listGatewayID, actualRoute)) == E_UNKNOWN)
+            return (error);
+        if (error == E_OK)
+            returnList.push_back(actualRoute);
     }
+    return (E_OK);
+}
 
-    //No we need to trace back the routes for each entry in matchtree
-    iterator = matchtree.begin();
-    for (; iterator != matchtree.end(); ++iterator)
+/**
+ * searches the cheapest routes between a source and a sink. Ways are expanded in the order of their cost, so the search
+ * can stop as soon as enough routes are found that are cheaper than every way that is still open.
+ * The cost of a way is the sum of the hop cost and the gateway cost of every gateway. Every format conversion in a gateway
+ * is added when the connection formats of a route are known.
+ * @return E_OK in case of success, routes are sorted by their cost, the cheapest first
+ */
+am_Error_e CAmRouter::calculateBestRoutes(const bool onlyfree, const am_sourceID_t sourceID, const am_sinkID_t sinkID, const am_domainID_t sourceDomainID, const am_domainID_t sinkDomainID, std::vector<am_Route_s>& returnList)
+{
+    typedef std::pair<uint32_t, size_t> openNode; //cost and index of a node that was not expanded yet
+    std::priority_queue<openNode, std::vector<openNode>, std::greater<openNode> > listOpenNodes;
+    std::vector<routingNode_s> listNodes;
+    std::vector<std::pair<uint32_t, am_Route_s> > listCandidates; //found routes with their cost, sorted by cost
+    std::vector<am_gatewayID_t> listGatewayID;
+    am_Route_s actualRoute;
+    am_Error_e error;
+
+    routingNode_s node;
+    node.domainID = sourceDomainID;
+    node.gatewayID = 0;
+    node.parent = 0;
+    node.cost = 0;
+    listNodes.push_back(node);
+    listOpenNodes.push(openNode(0, 0));
+
+    while (!listOpenNodes.empty())
     {
-        std::vector<am_RoutingElement_s> actualRoutingElement; //intermediate list of current routing pairs
-        //getting the route for the actual item
-        routingtree.getRoute(*iterator, listGatewayID); //This gives only the Gateway IDs we need more
+        uint32_t cost = listOpenNodes.top().first;
+        size_t nodeIndex = listOpenNodes.top().second;
+        listOpenNodes.pop();
 
-        //go throught the gatewayids and get more information
-        std::vector<am_gatewayID_t>::iterator gatewayIterator = listGatewayID.begin();
-        for (; gatewayIterator != listGatewayID.end(); ++gatewayIterator)
-        {
-            am_Gateway_s gatewayData;
-            if (mpDatabaseHandler->getGatewayInfoDB(*gatewayIterator, gatewayData) != E_OK)
-                return (E_UNKNOWN);
+        //conversions only make routes more expensive, so nothing that is still open can beat the routes we have
+        if (listCandidates.size() >= mMaxRoutes && listCandidates[mMaxRoutes - 1].first <= cost)
+            break;
 
-            //at the beginning of the route, we connect first the source to the first gateway
-            if (gatewayIterator == listGatewayID.begin())
-            {
-                routingElement.sourceID = sourceID;
-                routingElement.domainID = sourceDomainID;
-            }
-            else
+        if (nodeIndex != 0 && listNodes[nodeIndex].domainID == sinkDomainID)
+        {
+            listGatewayID.clear();
+            for (size_t index = nodeIndex; index != 0; index = listNodes[index].parent)
+                listGatewayID.push_back(listNodes[index].gatewayID);
+            std::reverse(listGatewayID.begin(), listGatewayID.end());
+
+            if ((error = buildRoute(sourceID, sinkID, sourceDomainID, sinkDomainID, listGatewayID, actualRoute)) == E_UNKNOWN)
+                return (error);
+            if (error != E_OK)
+                continue;
+
+            std::vector<am_RoutingElement_s>::const_iterator elementIterator = actualRoute.route.begin() + 1;
+            for (; elementIterator < actualRoute.route.end(); ++elementIterator)
             {
-                routingElement.sourceID = lastSource;
-                routingElement.domainID = gatewayData.domainSinkID;
+                if (elementIterator->connectionFormat != (elementIterator - 1)->connectionFormat)
+                    cost += mConversionCost;
             }
-            routingElement.sinkID = gatewayData.sinkID;
-            actualRoutingElement.push_back(routingElement);
-            lastSource = gatewayData.sourceID;
+
+            std::pair<uint32_t, am_Route_s> candidate(cost, actualRoute);
+            listCandidates.insert(std::upper_bound(listCandidates.begin(), listCandidates.end(), candidate, compareRouteCost), candidate);
+            continue;
         }
-        //at the end of the route, connect to the sink !
-        routingElement.sourceID = lastSource;
-        routingElement.sinkID = sinkID;
-        routingElement.domainID = sinkDomainID;
-        actualRoutingElement.push_back(routingElement);
 
-        //So now we got the route, what is missing are the connectionFormats...
+        //the way ends in the domain of the sink, it cannot come back to it
+        DomainGatewayMap::const_iterator domainIterator = mDomainGateways.find(listNodes[nodeIndex].domainID);
+        if (domainIterator == mDomainGateways.end())
+            continue;
 
-        //Step through the routes and try to use always the best connectionFormat
-        std::vector<am_RoutingElement_s>::iterator routingInterator = actualRoutingElement.begin();
-        gatewayIterator = listGatewayID.begin();
-        if (findBestWay(sinkID, sourceID, actualRoutingElement, routingInterator, gatewayIterator) != E_OK)
+        std::vector<am_gatewayID_t>::const_iterator gatewayIterator = domainIterator->second.begin();
+        for (; gatewayIterator != domainIterator->second.end() && listNodes.size() < MAX_ROUTE_SEARCH_NODES; ++gatewayIterator)
         {
-            continue;
+            if (onlyfree && *gatewayIterator < mGatewayInUse.size() && mGatewayInUse[*gatewayIterator])
+                continue;
+
+            const routingGateway_s& gateway = mGateways.find(*gatewayIterator)->second;
+            if (isInRoutingTree(listNodes, nodeIndex, gateway.domainSourceID))
+                continue;
+
+            std::map<am_gatewayID_t, uint16_t>::const_iterator costIterator = mGatewayCost.find(gateway.gatewayID);
+            node.domainID = gateway.domainSourceID;
+            node.gatewayID = gateway.gatewayID;
+            node.parent = nodeIndex;
+            node.cost = cost + mHopCost + (costIterator == mGatewayCost.end() ? 0 : costIterator->second);
+            listOpenNodes.push(openNode(node.cost, listNodes.size()));
+            listNodes.push_back(node);
         }
+    }
 
-        //add the route to the list of routes...
-        actualRoute.sourceID = sourceID;
-        actualRoute.sinkID = sinkID;
-        actualRoute.route = actualRoutingElement;
-        returnList.push_back(actualRoute);
+    if (listNodes.size() >= MAX_ROUTE_SEARCH_NODES)
+        logInfo("CAmRouter::calculateBestRoutes search was limited to", MAX_ROUTE_SEARCH_NODES, "ways");
+
+    std::vector<std::pair<uint32_t, am_Route_s> >::const_iterator candidateIterator = listCandidates.begin();
+    for (; candidateIterator != listCandidates.end() && returnList.size() < mMaxRoutes; ++candidateIterator)
+        returnList.push_back(candidateIterator->second);
+    return (E_OK);
+}
+
+/**
+ * orders found routes by their cost
+ */
+bool CAmRouter::compareRouteCost(const std::pair<uint32_t, am_Route_s>& a, const std::pair<uint32_t, am_Route_s>& b)
+{
+    return (a.first < b.first);
+}
+
+/**
+ * builds a route out of the gateways it passes and chooses the connection formats
+ * @param sourceID the source of the route
+ * @param sinkID the sink of the route
+ * @param sourceDomainID the domain of the source
+ * @param sinkDomainID the domain of the sink
+ * @param listGatewayID the gateways from the source to the sink
+ * @param route the route
+ * @return E_OK if a route was found, E_NOT_POSSIBLE if the connection formats do not match, E_UNKNOWN if a gateway is unknown
+ */
+am_Error_e CAmRouter::buildRoute(const am_sourceID_t sourceID, const am_sinkID_t sinkID, const am_domainID_t sourceDomainID, const am_domainID_t sinkDomainID, std::vector<am_gatewayID_t>& listGatewayID, am_Route_s& route)
+{
+    std::vector<am_RoutingElement_s> actualRoutingElement; //intermediate list of current routing pairs
+    am_RoutingElement_s routingElement;
+    am_sourceID_t lastSource = 0;
+
+    //go throught the gatewayids and get more information
+    std::vector<am_gatewayID_t>::iterator gatewayIterator = listGatewayID.begin();
+    for (; gatewayIterator != listGatewayID.end(); ++gatewayIterator)
+    {
+        GatewayMap::const_iterator gatewayData = mGateways.find(*gatewayIterator);
+        if (gatewayData == mGateways.end())
+            return (E_UNKNOWN);
+
+        //at the beginning of the route, we connect first the source to the first gateway
+        if (gatewayIterator == listGatewayID.begin())
+        {
+            routingElement.sourceID = sourceID;
+            routingElement.domainID = sourceDomainID;
+        }
+        else
+        {
+            routingElement.sourceID = lastSource;
+            routingElement.domainID = gatewayData->second.domainSinkID;
+        }
+        routingElement.sinkID = gatewayData->second.sinkID;
+        actualRoutingElement.push_back(routingElement);
+        lastSource = gatewayData->second.sourceID;
     }
+    //at the end of the route, connect to the sink !
+    routingElement.sourceID = lastSource;
+    routingElement.sinkID = sinkID;
+    routingElement.domainID = sinkDomainID;
+    actualRoutingElement.push_back(routingElement);
+
+    //So now we got the route, what is missing are the connectionFormats...
+
+    //find out which formats can reach the sink at all, routes without any are skipped right away
+    std::vector<connectionFormatSet> listUsableFormats;
+    if (!calculateUsableFormats(actualRoutingElement, listGatewayID, listUsableFormats))
+        return (E_NOT_POSSIBLE);
+
+    //Step through the routes and try to use always the best connectionFormat
+    std::vector<am_RoutingElement_s>::iterator routingInterator = actualRoutingElement.begin();
+    gatewayIterator = listGatewayID.begin();
+    if (findBestWay(sinkID, sourceID, actualRoutingElement, routingInterator, gatewayIterator, listUsableFormats) != E_OK)
+        return (E_NOT_POSSIBLE);
+
+    route.sourceID = sourceID;
+    route.sinkID = sinkID;
+    route.route = actualRoutingElement;
     return (E_OK);
 }
 
-void CAmRouter::listPossibleConnectionFormats(const am_sourceID_t sourceID, const am_sinkID_t sinkID, std::vector<am_ConnectionFormat_e>& listFormats) const
+/**
+ * returns the connection formats that a source and a sink have in common
+ */
+CAmRouter::connectionFormatSet CAmRouter::possibleConnectionFormats(const am_sourceID_t sourceID, const am_sinkID_t sinkID)
+{
+    std::map<am_sinkID_t, connectionFormatSet>::iterator sinkIterator = mSinkFormats.find(sinkID);
+    if (sinkIterator == mSinkFormats.end())
+    {
+        std::vector<am_ConnectionFormat_e> listSinkFormats;
+        mpDatabaseHandler->getListSinkConnectionFormats(sinkID, listSinkFormats);
+        sinkIterator = mSinkFormats.insert(std::make_pair(sinkID, toFormatSet(listSinkFormats))).first;
+    }
+
+    std::map<am_sourceID_t, connectionFormatSet>::iterator sourceIterator = mSourceFormats.find(sourceID);
+    if (sourceIterator == mSourceFormats.end())
+    {
+        std::vector<am_ConnectionFormat_e> listSourceFormats;
+        mpDatabaseHandler->getListSourceConnectionFormats(sourceID, listSourceFormats);
+        sourceIterator = mSourceFormats.insert(std::make_pair(sourceID, toFormatSet(listSourceFormats))).first;
+    }
+
+    return (sinkIterator->second & sourceIterator->second);
+}
+
+/**
+ * returns the formats a gateway can put out for a format at its sink
+ */
+CAmRouter::connectionFormatSet CAmRouter::convertedConnectionFormats(const am_gatewayID_t gatewayID, const am_ConnectionFormat_e sinkConnectionFormat) const
+{
+    GatewayMap::const_iterator iter = mGateways.find(gatewayID);
+    if (iter == mGateways.end() || sinkConnectionFormat < 0 || sinkConnectionFormat >= CF_MAX)
+        return (connectionFormatSet());
+    return (iter->second.listConversion[sinkConnectionFormat]);
+}
+
+/**
+ * calculates backwards from the sink which formats can be used on each element of a route so that the sink can still be
+ * reached. This only looks at the formats of the sinks, sources and gateways, the choice of the controller is not asked.
+ * @param listRoute the route, the connection formats are not set yet
+ * @param listGatewayID the gateways between the elements of the route
+ * @param listUsableFormats the usable formats per element of the route
+ * @return false if there is no way to the sink
+ */
+bool CAmRouter::calculateUsableFormats(const std::vector<am_RoutingElement_s>& listRoute, const std::vector<am_gatewayID_t>& listGatewayID, std::vector<connectionFormatSet>& listUsableFormats)
 {
-    std::vector<am_ConnectionFormat_e> listSourceFormats;
-    std::vector<am_ConnectionFormat_e> listSinkFormats;
-    mpDatabaseHandler->getListSinkConnectionFormats(sinkID, listSinkFormats);
-    mpDatabaseHandler->getListSourceConnectionFormats(sourceID, listSourceFormats);
-    std::sort(listSinkFormats.begin(), listSinkFormats.end()); //todo: this might be not needed if we use strictly sorted input
-    std::sort(listSourceFormats.begin(), listSourceFormats.end()); //todo: this might be not needed if we use strictly sorted input
-    std::insert_iterator<std::vector<am_ConnectionFormat_e> > inserter(listFormats, listFormats.begin());
-    set_intersection(listSourceFormats.begin(), listSourceFormats.end(), listSinkFormats.begin(), listSinkFormats.end(), inserter);
+    assert(listRoute.size()==listGatewayID.size()+1);
+
+    listUsableFormats.assign(listRoute.size(), connectionFormatSet());
+    size_t index = listRoute.size() - 1;
+    listUsableFormats[index] = possibleConnectionFormats(listRoute[index].sourceID, listRoute[index].sinkID);
+    while (index-- > 0)
+    {
+        connectionFormatSet possibleFormats = possibleConnectionFormats(listRoute[index].sourceID, listRoute[index].sinkID);
+        for (size_t format = 0; format < possibleFormats.size(); ++format)
+        {
+            if (possibleFormats.test(format) && (convertedConnectionFormats(listGatewayID[index], (am_ConnectionFormat_e) format) & listUsableFormats[index + 1]).any())
+                listUsableFormats[index].set(format);
+        }
+    }
+    return (listUsableFormats[0].any());
 }
 
-am_Error_e CAmRouter::findBestWay(am_sinkID_t sinkID, am_sourceID_t sourceID, std::vector<am_RoutingElement_s> & listRoute, std::vector<am_RoutingElement_s>::iterator routeIterator, std::vector<am_gatewayID_t>::iterator gatewayIterator)
+am_Error_e CAmRouter::findBestWay(am_sinkID_t sinkID, am_sourceID_t sourceID, std::vector<am_RoutingElement_s> & listRoute, std::vector<am_RoutingElement_s>::iterator routeIterator, std::vector<am_gatewayID_t>::iterator gatewayIterator, const std::vector<connectionFormatSet>& listUsableFormats)
 {
     am_Error_e returnError = E_NOT_POSSIBLE;
-    std::vector<am_ConnectionFormat_e> listConnectionFormats;
     std::vector<am_ConnectionFormat_e> listMergeConnectionFormats;
     std::vector<am_ConnectionFormat_e> listPriorityConnectionFormats;
     std::vector<am_RoutingElement_s>::iterator nextIterator = routeIterator + 1;
     //get best connection format
-    listPossibleConnectionFormats(routeIterator->sourceID, routeIterator->sinkID, listConnectionFormats);
+    connectionFormatSet mergeConnectionFormats = possibleConnectionFormats(routeIterator->sourceID, routeIterator->sinkID);
 
     //if we have not just started, we need to take care about the gateways...
     if (routeIterator != listRoute.begin())
     {
         //since we have to deal with Gateways, there are restrictions what connectionFormat we can take. So we need to take the subset of connections that are restricted:
-        std::vector<am_ConnectionFormat_e> listRestrictedConnectionFormats;
-        std::insert_iterator<std::vector<am_ConnectionFormat_e> > inserter(listMergeConnectionFormats, listMergeConnectionFormats.begin());
         std::vector<am_RoutingElement_s>::iterator tempIterator(routeIterator);
         tempIterator--;
-        listRestrictedOutputFormatsGateways(*gatewayIterator, (tempIterator)->connectionFormat, listRestrictedConnectionFormats);
-        std::sort(listRestrictedConnectionFormats.begin(), listRestrictedConnectionFormats.end()); //todo: this might be not needed if we use strictly sorted input
-        set_intersection(listConnectionFormats.begin(), listConnectionFormats.end(), listRestrictedConnectionFormats.begin(), listRestrictedConnectionFormats.end(), inserter);
+        mergeConnectionFormats &= convertedConnectionFormats(*gatewayIterator, tempIterator->connectionFormat);
         gatewayIterator++;
     }
-    else
-    {
-        listMergeConnectionFormats = listConnectionFormats;
-    }
+    toFormatList(mergeConnectionFormats, listMergeConnectionFormats);
 
     am_Route_s route;
     route.sinkID = sinkID;
@@ -232,10 +460,15 @@ am_Error_e CAmRouter::findBestWay(am_sinkID_t sinkID, am_sourceID_t sourceID, st
             return (E_NOT_POSSIBLE);
     }
 
+    const connectionFormatSet& usableFormats = listUsableFormats.at(routeIterator - listRoute.begin());
     for (; connectionFormatIterator != listPriorityConnectionFormats.end(); ++connectionFormatIterator)
     {
+        //formats that cannot reach the sink are not tried
+        if (*connectionFormatIterator < 0 || *connectionFormatIterator >= CF_MAX || !usableFormats.test(*connectionFormatIterator))
+            continue;
+
         routeIterator->connectionFormat = *connectionFormatIterator;
-        if ((returnError = findBestWay(sinkID, sourceID, listRoute, nextIterator, gatewayIterator)) == E_OK)
+        if ((returnError = findBestWay(sinkID, sourceID, listRoute, nextIterator, gatewayIterator, listUsableFormats)) == E_OK)
         {
             break;
         }
@@ -244,30 +477,363 @@ am_Error_e CAmRouter::findBestWay(am_sinkID_t sinkID, am_sourceID_t sourceID, st
     return (returnError);
 }
 
-void CAmRouter::listRestrictedOutputFormatsGateways(const am_gatewayID_t gatewayID, const am_ConnectionFormat_e sinkConnectionFormat, std::vector<am_ConnectionFormat_e> & listFormats) const
+/**
+ * converts a list of connection formats into a set, formats outside of the enum are dropped
+ */
+CAmRouter::connectionFormatSet CAmRouter::toFormatSet(const std::vector<am_ConnectionFormat_e>& listFormats)
+{
+    connectionFormatSet formats;
+    std::vector<am_ConnectionFormat_e>::const_iterator iter = listFormats.begin();
+    for (; iter != listFormats.end(); ++iter)
+    {
+        if (*iter >= 0 && *iter < CF_MAX)
+            formats.set(*iter);
+    }
+    return (formats);
+}
+
+/**
+ * converts a set of connection formats into a sorted list
+ */
+void CAmRouter::toFormatList(const connectionFormatSet& formats, std::vector<am_ConnectionFormat_e>& listFormats)
 {
     listFormats.clear();
-    am_Gateway_s gatewayData;
-    mpDatabaseHandler->getGatewayInfoDB(gatewayID, gatewayData);
-    std::vector<am_ConnectionFormat_e>::const_iterator rowSinkIterator = gatewayData.listSinkFormats.begin();
-    std::vector<bool>::const_iterator matrixIterator = gatewayData.convertionMatrix.begin();
+    for (size_t format = 0; format < formats.size(); ++format)
+    {
+        if (formats.test(format))
+            listFormats.push_back((am_ConnectionFormat_e) format);
+    }
+}
+
+/**
+ * searches all ways from the root domain through the gateways, breadth first.
+ * A way never enters a domain twice.
+ * @param onlyfree if true only gateways that are not connected are used
+ * @param rootDomainID the domain to start with
+ * @param listNodes the tree as a flat list, the first node is the root. Parents come always before their children.
+ */
+void CAmRouter::buildRoutingTree(const bool onlyfree, const am_domainID_t rootDomainID, std::vector<routingNode_s>& listNodes) const
+{
+    routingNode_s node;
+    node.domainID = rootDomainID;
+    node.gatewayID = 0;
+    node.parent = 0;
+    node.cost = 0;
+    listNodes.clear();
+    listNodes.push_back(node);
+
+    for (size_t nodeIndex = 0; nodeIndex < listNodes.size(); ++nodeIndex)
+    {
+        DomainGatewayMap::const_iterator domainIterator = mDomainGateways.find(listNodes[nodeIndex].domainID);
+        if (domainIterator == mDomainGateways.end())
+            continue;
+
+        std::vector<am_gatewayID_t>::const_iterator gatewayIterator = domainIterator->second.begin();
+        for (; gatewayIterator != domainIterator->second.end(); ++gatewayIterator)
+        {
+            if (onlyfree && *gatewayIterator < mGatewayInUse.size() && mGatewayInUse[*gatewayIterator])
+                continue;
+
+            const routingGateway_s& gateway = mGateways.find(*gatewayIterator)->second;
+            if (isInRoutingTree(listNodes, nodeIndex, gateway.domainSourceID))
+                continue;
+
+            node.domainID = gateway.domainSourceID;
+            node.gatewayID = gateway.gatewayID;
+            node.parent = nodeIndex;
+            listNodes.push_back(node);
+        }
+    }
+}
+
+/**
+ * checks if a domain is on the way from the root to a node
+ * @param listNodes the routing tree
+ * @param nodeIndex the node where the way ends
+ * @param domainID the domain to look for
+ * @return true if the domain is on the way
+ */
+bool CAmRouter::isInRoutingTree(const std::vector<routingNode_s>& listNodes, size_t nodeIndex, const am_domainID_t domainID) const
+{
+    for (;; nodeIndex = listNodes[nodeIndex].parent)
+    {
+        if (listNodes[nodeIndex].domainID == domainID)
+            return (true);
+        if (nodeIndex == 0)
+            return (false);
+    }
+}
+
+/**
+ * adds a gateway to the routing graph
+ * @param gateway the gateway
+ */
+void CAmRouter::addGateway(const am_Gateway_s& gateway)
+{
+    assert(gateway.gatewayID!=0);
+
+    routingGateway_s& newGateway = mGateways[gateway.gatewayID];
+    newGateway.gatewayID = gateway.gatewayID;
+    newGateway.sinkID = gateway.sinkID;
+    newGateway.sourceID = gateway.sourceID;
+    newGateway.domainSinkID = gateway.domainSinkID;
+    newGateway.domainSourceID = gateway.domainSourceID;
+
+    //the conversion matrix has one row per source format, only the first entry of a sink format counts
+    newGateway.listConversion.assign(CF_MAX, connectionFormatSet());
+    size_t sinkFormats = gateway.listSinkFormats.size();
+    for (size_t sinkIndex = 0; sinkIndex < sinkFormats; ++sinkIndex)
+    {
+        am_ConnectionFormat_e sinkFormat = gateway.listSinkFormats[sinkIndex];
+        if (sinkFormat < 0 || sinkFormat >= CF_MAX || std::find(gateway.listSinkFormats.begin(), gateway.listSinkFormats.begin() + sinkIndex, sinkFormat) != gateway.listSinkFormats.begin() + sinkIndex)
+            continue;
+        for (size_t sourceIndex = 0; sourceIndex < gateway.listSourceFormats.size(); ++sourceIndex)
+        {
+            size_t matrixIndex = sourceIndex * sinkFormats + sinkIndex;
+            am_ConnectionFormat_e sourceFormat = gateway.listSourceFormats[sourceIndex];
+            if (matrixIndex < gateway.convertionMatrix.size() && gateway.convertionMatrix[matrixIndex] && sourceFormat >= 0 && sourceFormat < CF_MAX)
+                newGateway.listConversion[sinkFormat].set(sourceFormat);
+        }
+    }
+
+    //the gateways of a domain are kept in the order of their IDs, so routes are always found in the same order
+    std::vector<am_gatewayID_t>& listGateways = mDomainGateways[gateway.domainSinkID];
+    std::vector<am_gatewayID_t>::iterator position = std::lower_bound(listGateways.begin(), listGateways.end(), gateway.gatewayID);
+    if (position == listGateways.end() || *position != gateway.gatewayID)
+        listGateways.insert(position, gateway.gatewayID);
+
+    updateGatewayInUse(newGateway);
+    invalidateRoutes();
+}
+
+/**
+ * removes a gateway from the routing graph
+ * @param gatewayID the gateway
+ */
+void CAmRouter::removeGateway(const am_gatewayID_t gatewayID)
+{
+    GatewayMap::iterator iter = mGateways.find(gatewayID);
+    if (iter == mGateways.end())
+        return;
+
+    DomainGatewayMap::iterator domainIterator = mDomainGateways.find(iter->second.domainSinkID);
+    if (domainIterator != mDomainGateways.end())
+    {
+        std::vector<am_gatewayID_t>& listGateways = domainIterator->second;
+        listGateways.erase(std::remove(listGateways.begin(), listGateways.end(), gatewayID), listGateways.end());
+        if (listGateways.empty())
+            mDomainGateways.erase(domainIterator);
+    }
+
+    if (gatewayID < mGatewayInUse.size())
+        mGatewayInUse[gatewayID] = false;
+    mGateways.erase(iter);
+    invalidateRoutes();
+}
+
+/**
+ * tells the router about a new connection. Gateways whose sink or source is connected are not free any more.
+ * @param connection the connection
+ */
+void CAmRouter::addConnection(const am_Connection_s& connection)
+{
+    assert(connection.connectionID!=0);
+
+    if (!mConnections.insert(std::make_pair(connection.connectionID, std::make_pair(connection.sinkID, connection.sourceID))).second)
+        return;
+
+    mSinkConnectionCount[connection.sinkID]++;
+    mSourceConnectionCount[connection.sourceID]++;
+    if (updateGatewaysInUse(connection.sinkID, connection.sourceID))
+        invalidateRoutesOnlyFree();
+}
+
+/**
+ * tells the router that a connection was removed
+ * @param connectionID the connection
+ */
+void CAmRouter::removeConnection(const am_connectionID_t connectionID)
+{
+    std::map<am_connectionID_t, std::pair<am_sinkID_t, am_sourceID_t> >::iterator iter = mConnections.find(connectionID);
+    if (iter == mConnections.end())
+        return;
+
+    am_sinkID_t sinkID = iter->second.first;
+    am_sourceID_t sourceID = iter->second.second;
+    mConnections.erase(iter);
+
+    if (--mSinkConnectionCount[sinkID] == 0)
+        mSinkConnectionCount.erase(sinkID);
+    if (--mSourceConnectionCount[sourceID] == 0)
+        mSourceConnectionCount.erase(sourceID);
+    if (updateGatewaysInUse(sinkID, sourceID))
+        invalidateRoutesOnlyFree();
+}
+
+/**
+ * recalculates the in use bit of all gateways with the given sink or source
+ * @return true if the bit of at least one gateway changed
+ */
+bool CAmRouter::updateGatewaysInUse(const am_sinkID_t sinkID, const am_sourceID_t sourceID)
+{
+    bool changed = false;
+    GatewayMap::const_iterator iter = mGateways.begin();
+    for (; iter != mGateways.end(); ++iter)
+    {
+        if (iter->second.sinkID == sinkID || iter->second.sourceID == sourceID)
+            changed |= updateGatewayInUse(iter->second);
+    }
+    return (changed);
+}
+
+/**
+ * recalculates the in use bit of a gateway. A gateway is in use if its sink or its source is part of a connection.
+ * @return true if the bit changed
+ */
+bool CAmRouter::updateGatewayInUse(const routingGateway_s& gateway)
+{
+    if (mGatewayInUse.size() <= gateway.gatewayID)
+        mGatewayInUse.resize(gateway.gatewayID + 1, false);
+    bool inUse = mSinkConnectionCount.count(gateway.sinkID) || mSourceConnectionCount.count(gateway.sourceID);
+    bool changed = (mGatewayInUse[gateway.gatewayID] != inUse);
+    mGatewayInUse[gateway.gatewayID] = inUse;
+    return (changed);
+}
 
-    //find the row number of the sink
-    rowSinkIterator = find(gatewayData.listSinkFormats.begin(), gatewayData.listSinkFormats.end(), sinkConnectionFormat);
-    int rowNumberSink = rowSinkIterator - gatewayData.listSinkFormats.begin();
+/**
+ * drops all cached routes
+ */
+void CAmRouter::invalidateRoutes()
+{
+    mRouteCacheInvalidations += mRouteCache.size();
+    mRouteCache.clear();
+}
 
-    //go through the convertionMatrix and find out if the conversion is possible, if yes, add connectionFormat ...
-    std::advance(matrixIterator, rowNumberSink);
+/**
+ * drops the cached routes that only use free gateways, the others do not depend on the connections
+ */
+void CAmRouter::invalidateRoutesOnlyFree()
+{
+    RouteCacheMap::iterator iter = mRouteCache.begin();
+    while (iter != mRouteCache.end())
+    {
+        if (iter->first.onlyfree)
+        {
+            mRouteCache.erase(iter++);
+            mRouteCacheInvalidations++;
+        }
+        else
+            ++iter;
+    }
+}
 
-    //iterate line-wise through the matrix and add more formats
-    do
+/**
+ * drops the cached routes and connection formats of a sink
+ * @param sinkID the sink
+ */
+void CAmRouter::invalidateRoutesOfSink(const am_sinkID_t sinkID)
+{
+    mSinkFormats.erase(sinkID);
+    RouteCacheMap::iterator iter = mRouteCache.begin();
+    while (iter != mRouteCache.end())
+    {
+        if (iter->first.sinkID == sinkID)
+        {
+            mRouteCache.erase(iter++);
+            mRouteCacheInvalidations++;
+        }
+        else
+            ++iter;
+    }
+}
+
+/**
+ * drops the cached routes and connection formats of a source
+ * @param sourceID the source
+ */
+void CAmRouter::invalidateRoutesOfSource(const am_sourceID_t sourceID)
+{
+    mSourceFormats.erase(sourceID);
+    RouteCacheMap::iterator iter = mRouteCache.begin();
+    while (iter != mRouteCache.end())
     {
-        if (*matrixIterator)
+        if (iter->first.sourceID == sourceID)
         {
-            listFormats.push_back(gatewayData.listSourceFormats.at((matrixIterator - gatewayData.convertionMatrix.begin()) / gatewayData.listSinkFormats.size()));
+            mRouteCache.erase(iter++);
+            mRouteCacheInvalidations++;
         }
-        std::advance(matrixIterator, gatewayData.listSinkFormats.size());
-    } while (gatewayData.convertionMatrix.end() - matrixIterator > 0);
+        else
+            ++iter;
+    }
+}
+
+/**
+ * returns the counters of the route cache
+ * @param hits number of getRoute calls answered from the cache
+ * @param misses number of getRoute calls that calculated the routes
+ * @param invalidations number of cached entries dropped because of changes
+ * @param entries number of entries currently in the cache
+ */
+void CAmRouter::getRouteCacheStatistics(uint32_t& hits, uint32_t& misses, uint32_t& invalidations, size_t& entries) const
+{
+    hits = mRouteCacheHits;
+    misses = mRouteCacheMisses;
+    invalidations = mRouteCacheInvalidations;
+    entries = mRouteCache.size();
+}
+
+/**
+ * returns the time spent calculating routes, one calculation is done for each cache miss
+ * @return the time in nanoseconds
+ */
+uint64_t CAmRouter::getRouteCalculationTime() const
+{
+    return (mRouteCalculationNs);
+}
+
+/**
+ * sets the counters of the route cache and the calculation time to 0, the cached routes are kept
+ */
+void CAmRouter::resetRouteCacheStatistics()
+{
+    mRouteCacheHits = 0;
+    mRouteCacheMisses = 0;
+    mRouteCacheInvalidations = 0;
+    mRouteCalculationNs = 0;
+}
+
+/**
+ * sets how many routes getRoute searches. With 0, all routes are returned in the order they are found. Otherwise only the
+ * given number of routes is returned, the cheapest first.
+ * @param maxRoutes the number of routes
+ */
+void CAmRouter::setMaxRoutes(const uint16_t maxRoutes)
+{
+    mMaxRoutes = maxRoutes;
+    invalidateRoutes();
+}
+
+/**
+ * sets the weights used to compare routes when setMaxRoutes is used
+ * @param hopCost the cost of passing a gateway
+ * @param conversionCost the cost of every change of the connection format along a route
+ */
+void CAmRouter::setRouteCost(const uint16_t hopCost, const uint16_t conversionCost)
+{
+    mHopCost = hopCost;
+    mConversionCost = conversionCost;
+    invalidateRoutes();
+}
+
+/**
+ * sets an additional cost for a gateway, for example its latency. The cost is kept when the gateway is removed and added again.
+ * @param gatewayID the gateway
+ * @param latencyCost the cost that is added for passing the gateway
+ */
+void CAmRouter::setGatewayCost(const am_gatewayID_t gatewayID, const uint16_t latencyCost)
+{
+    mGatewayCost[gatewayID] = latencyCost;
+    invalidateRoutes();
 }
 
 CAmRouter::~CAmRouter()
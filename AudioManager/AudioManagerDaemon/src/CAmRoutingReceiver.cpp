@@ -22,7 +22,7 @@
 #include "CAmRoutingReceiver.h"
 #include <cassert>
 #include <algorithm>
-#include "CAmDatabaseHandler.h"
+#include "IAmDatabaseHandler.h"
 #include "CAmRoutingSender.h"
 #include "CAmControlSender.h"
 #include "shared/CAmDltWrapper.h"
@@ -31,7 +31,7 @@
 namespace am
 {
 
-CAmRoutingReceiver::CAmRoutingReceiver(CAmDatabaseHandler *iDatabaseHandler, CAmRoutingSender *iRoutingSender, CAmControlSender *iControlSender, CAmSocketHandler *iSocketHandler) :
+CAmRoutingReceiver::CAmRoutingReceiver(IAmDatabaseHandler *iDatabaseHandler, CAmRoutingSender *iRoutingSender, CAmControlSender *iControlSender, CAmSocketHandler *iSocketHandler) :
         mpDatabaseHandler(iDatabaseHandler), //
         mpRoutingSender(iRoutingSender), //
         mpControlSender(iControlSender), //
@@ -41,7 +41,10 @@ CAmRoutingReceiver::CAmRoutingReceiver(CAmDatabaseHandler *iDatabaseHandler, CAm
         mListRundownHandles(), //
         handleCount(0), //
         mWaitStartup(false), //
-        mWaitRundown(false)
+        mWaitRundown(false), //
+        mRegistrationOpen(false), //
+        mRegistrationTimer(0), //
+        mRegistrationTimerCallback(this, &CAmRoutingReceiver::registrationTimerCallback)
 {
     assert(mpDatabaseHandler!=NULL);
     assert(mpRoutingSender!=NULL);
@@ -49,7 +52,7 @@ CAmRoutingReceiver::CAmRoutingReceiver(CAmDatabaseHandler *iDatabaseHandler, CAm
     assert(mpSocketHandler!=NULL);
 }
 
-CAmRoutingReceiver::CAmRoutingReceiver(CAmDatabaseHandler *iDatabaseHandler, CAmRoutingSender *iRoutingSender, CAmControlSender *iControlSender, CAmSocketHandler *iSocketHandler, CAmDbusWrapper *iDBusWrapper) :
+CAmRoutingReceiver::CAmRoutingReceiver(IAmDatabaseHandler *iDatabaseHandler, CAmRoutingSender *iRoutingSender, CAmControlSender *iControlSender, CAmSocketHandler *iSocketHandler, CAmDbusWrapper *iDBusWrapper) :
         mpDatabaseHandler(iDatabaseHandler), //
         mpRoutingSender(iRoutingSender), //
         mpControlSender(iControlSender), //
@@ -59,7 +62,10 @@ CAmRoutingReceiver::CAmRoutingReceiver(CAmDatabaseHandler *iDatabaseHandler, CAm
         mListRundownHandles(), //
         handleCount(0), //
         mWaitStartup(false), //
-        mWaitRundown(false)
+        mWaitRundown(false), //
+        mRegistrationOpen(false), //
+        mRegistrationTimer(0), //
+        mRegistrationTimerCallback(this, &CAmRoutingReceiver::registrationTimerCallback)
 {
     assert(mpDatabaseHandler!=NULL);
     assert(mpRoutingSender!=NULL);
@@ -70,11 +76,14 @@ CAmRoutingReceiver::CAmRoutingReceiver(CAmDatabaseHandler *iDatabaseHandler, CAm
 
 CAmRoutingReceiver::~CAmRoutingReceiver()
 {
+    commitDomainRegistration();
+    if (mRegistrationTimer != 0)
+        mpSocketHandler->removeTimer(mRegistrationTimer);
 }
 
 void CAmRoutingReceiver::ackConnect(const am_Handle_s handle, const am_connectionID_t connectionID, const am_Error_e error)
 {
-    mpRoutingSender->removeHandle(handle);
+    mpRoutingSender->traceHandleAck(handle);
     if (error == E_OK)
     {
         mpDatabaseHandler->changeConnectionFinal(connectionID);
@@ -83,21 +92,24 @@ void CAmRoutingReceiver::ackConnect(const am_Handle_s handle, const am_connectio
     {
         mpDatabaseHandler->removeConnection(connectionID);
     }
+    mpRoutingSender->removeHandle(handle);
     mpControlSender->cbAckConnect(handle, error);
 }
 
 void CAmRoutingReceiver::ackDisconnect(const am_Handle_s handle, const am_connectionID_t connectionID, const am_Error_e error)
 {
-    mpRoutingSender->removeHandle(handle);
+    mpRoutingSender->traceHandleAck(handle);
     if (error == E_OK)
     {
         mpDatabaseHandler->removeConnection(connectionID);
     }
+    mpRoutingSender->removeHandle(handle);
     mpControlSender->cbAckDisconnect(handle, error);
 }
 
 void CAmRoutingReceiver::ackSetSinkVolumeChange(const am_Handle_s handle, const am_volume_t volume, const am_Error_e error)
 {
+    mpRoutingSender->traceHandleAck(handle);
     CAmRoutingSender::am_handleData_c handleData = mpRoutingSender->returnHandleData(handle);
     if (error == E_OK && handleData.sinkID != 0)
     {
@@ -110,6 +122,7 @@ void CAmRoutingReceiver::ackSetSinkVolumeChange(const am_Handle_s handle, const
 
 void CAmRoutingReceiver::ackSetSourceVolumeChange(const am_Handle_s handle, const am_volume_t volume, const am_Error_e error)
 {
+    mpRoutingSender->traceHandleAck(handle);
     CAmRoutingSender::am_handleData_c handleData = mpRoutingSender->returnHandleData(handle);
     if (error == E_OK && handleData.sourceID != 0)
     {
@@ -122,6 +135,7 @@ void CAmRoutingReceiver::ackSetSourceVolumeChange(const am_Handle_s handle, cons
 
 void CAmRoutingReceiver::ackSetSourceState(const am_Handle_s handle, const am_Error_e error)
 {
+    mpRoutingSender->traceHandleAck(handle);
     CAmRoutingSender::am_handleData_c handleData = mpRoutingSender->returnHandleData(handle);
     if (error == E_OK && handleData.sourceID != 0)
     {
@@ -134,6 +148,7 @@ void CAmRoutingReceiver::ackSetSourceState(const am_Handle_s handle, const am_Er
 
 void CAmRoutingReceiver::ackSetSinkSoundProperty(const am_Handle_s handle, const am_Error_e error)
 {
+    mpRoutingSender->traceHandleAck(handle);
     CAmRoutingSender::am_handleData_c handleData = mpRoutingSender->returnHandleData(handle);
     if (error == E_OK && handleData.sinkID != 0)
     {
@@ -146,6 +161,7 @@ void CAmRoutingReceiver::ackSetSinkSoundProperty(const am_Handle_s handle, const
 
 void am::CAmRoutingReceiver::ackSetSinkSoundProperties(const am_Handle_s handle, const am_Error_e error)
 {
+    mpRoutingSender->traceHandleAck(handle);
     CAmRoutingSender::am_handleData_c handleData = mpRoutingSender->returnHandleData(handle);
     if (error == E_OK && handleData.sinkID != 0)
     {
@@ -162,6 +178,7 @@ void am::CAmRoutingReceiver::ackSetSinkSoundProperties(const am_Handle_s handle,
 
 void CAmRoutingReceiver::ackSetSourceSoundProperty(const am_Handle_s handle, const am_Error_e error)
 {
+    mpRoutingSender->traceHandleAck(handle);
     CAmRoutingSender::am_handleData_c handleData = mpRoutingSender->returnHandleData(handle);
     if (error == E_OK && handleData.sourceID != 0)
     {
@@ -173,6 +190,7 @@ void CAmRoutingReceiver::ackSetSourceSoundProperty(const am_Handle_s handle, con
 
 void am::CAmRoutingReceiver::ackSetSourceSoundProperties(const am_Handle_s handle, const am_Error_e error)
 {
+    mpRoutingSender->traceHandleAck(handle);
     CAmRoutingSender::am_handleData_c handleData = mpRoutingSender->returnHandleData(handle);
     if (error == E_OK && handleData.sourceID != 0)
     {
@@ -189,6 +207,7 @@ void am::CAmRoutingReceiver::ackSetSourceSoundProperties(const am_Handle_s handl
 
 void CAmRoutingReceiver::ackCrossFading(const am_Handle_s handle, const am_HotSink_e hotSink, const am_Error_e error)
 {
+    mpRoutingSender->traceHandleAck(handle);
     CAmRoutingSender::am_handleData_c handleData = mpRoutingSender->returnHandleData(handle);
     if (error == E_OK && handleData.crossfaderID != 0)
     {
@@ -215,14 +234,33 @@ am_Error_e CAmRoutingReceiver::peekDomain(const std::string & name, am_domainID_
 
 }
 
+/**
+ * registers a domain. The domain and everything that is registered in the same dispatch of the mainloop is written to the
+ * database in one transaction, so the command side is notified once for the whole batch. The transaction is committed on
+ * the next mainloop iteration, or earlier by hookDomainRegistrationComplete or deregisterDomain.
+ */
 am_Error_e CAmRoutingReceiver::registerDomain(const am_Domain_s & domainData, am_domainID_t & domainID)
 {
+    if (!mRegistrationOpen && mpDatabaseHandler->beginTransaction() == E_OK)
+    {
+        //the shortest timeout fires as soon as the current dispatch returns to the mainloop
+        timespec timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_nsec = 1;
+        am_Error_e timerError = (mRegistrationTimer == 0) ? mpSocketHandler->addTimer(timeout, &mRegistrationTimerCallback, mRegistrationTimer, NULL) : mpSocketHandler->updateTimer(mRegistrationTimer, timeout);
+        if (timerError == E_OK)
+            mRegistrationOpen = true;
+        else
+            mpDatabaseHandler->commitTransaction();
+    }
     return (mpControlSender->hookSystemRegisterDomain(domainData, domainID));
 }
 
 am_Error_e CAmRoutingReceiver::deregisterDomain(const am_domainID_t domainID)
 {
-    return (mpControlSender->hookSystemDeregisterDomain(domainID));
+    am_Error_e error = mpControlSender->hookSystemDeregisterDomain(domainID);
+    commitDomainRegistration();
+    return (error);
 }
 
 am_Error_e CAmRoutingReceiver::registerGateway(const am_Gateway_s & gatewayData, am_gatewayID_t & gatewayID)
@@ -282,9 +320,34 @@ void CAmRoutingReceiver::hookInterruptStatusChange(const am_sourceID_t sourceID,
 
 void CAmRoutingReceiver::hookDomainRegistrationComplete(const am_domainID_t domainID)
 {
+    //commit first, so the controller sees the domain as it is published
+    commitDomainRegistration();
     mpControlSender->hookSystemDomainRegistrationComplete(domainID);
 }
 
+/**
+ * commits the transaction that was opened by registerDomain, if it is still open
+ */
+void CAmRoutingReceiver::commitDomainRegistration()
+{
+    if (!mRegistrationOpen)
+        return;
+    mRegistrationOpen = false;
+    mpSocketHandler->stopTimer(mRegistrationTimer);
+    mpDatabaseHandler->commitTransaction();
+}
+
+/**
+ * called by the mainloop after the dispatch in which a domain registered, so a domain that never completes its
+ * registration does not keep the transaction open
+ */
+void CAmRoutingReceiver::registrationTimerCallback(sh_timerHandle_t handle, void* userData)
+{
+    (void) handle;
+    (void) userData;
+    commitDomainRegistration();
+}
+
 void CAmRoutingReceiver::hookSinkAvailablityStatusChange(const am_sinkID_t sinkID, const am_Availability_s & availability)
 {
     mpControlSender->hookSystemSinkAvailablityStateChange(sinkID, availability);
@@ -343,9 +406,14 @@ void CAmRoutingReceiver::getInterfaceVersion(std::string & version) const
 
 void CAmRoutingReceiver::confirmRoutingReady(const uint16_t handle)
 {
+    mpRoutingSender->traceReadyConfirm(handle);
     mListStartupHandles.erase(std::remove(mListStartupHandles.begin(), mListStartupHandles.end(), handle), mListStartupHandles.end());
     if (mWaitStartup && mListStartupHandles.empty())
+    {
+        //the controller is told only once, deferred plugins that confirm later do not start the routing again
+        mWaitStartup = false;
         mpControlSender->confirmRoutingReady();
+    }
 }
 
 void CAmRoutingReceiver::confirmRoutingRundown(const uint16_t handle)
@@ -21,11 +21,13 @@
 
 #include "CAmRoutingSender.h"
 #include <utility>
+#include <algorithm>
 #include <dirent.h>
 #include <dlfcn.h>
 #include <cassert>
 #include <iostream>
 #include <sstream>
+#include <time.h>
 #include "CAmRoutingReceiver.h"
 #include "TAmPluginTemplate.h"
 #include "shared/CAmDltWrapper.h"
@@ -36,16 +38,28 @@ namespace am
 #define REQUIRED_INTERFACE_VERSION_MAJOR 1  //!< major interface version. All versions smaller than this will be rejected
 #define REQUIRED_INTERFACE_VERSION_MINOR 0 //!< minor interface version. All versions smaller than this will be rejected
 
-CAmRoutingSender::CAmRoutingSender(const std::vector<std::string>& listOfPluginDirectories) :
-        mHandleCount(0), //
-        mlistActiveHandles(), //
+static uint64_t monotonicNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec);
+}
+
+CAmRoutingSender::CAmRoutingSender(const std::vector<std::string>& listOfPluginDirectories, const unsigned int loadThreads, const std::vector<std::string>& listDeferredPlugins) :
+        mListHandleSlots(), //
+        mListFreeSlots(), //
+        mListOutstandingHandles(H_MAX, 0), //
         mListInterfaces(), //
+        mListPluginStartup(), //
+        mListDeferredLibraries(), //
+        mLoadThreads(loadThreads), //
+        mRoutingReady(false), //
         mMapConnectionInterface(), //
         mMapCrossfaderInterface(), //
         mMapDomainInterface(), //
         mMapSinkInterface(), //
         mMapSourceInterface(), //
-        mMapHandleInterface(), //
+        mMapHandleStatistics(), //
         mpRoutingReceiver()
 {
     std::vector<std::string> sharedLibraryNameList;
@@ -77,9 +91,17 @@ CAmRoutingSender::CAmRoutingSender(const std::vector<std::string>& listOfPluginD
 
             if (regularFile && sharedLibExtension)
             {
-                logInfo("RoutingSender::RoutingSender adding file: ", entryName);
                 std::string name(directoryName);
-                sharedLibraryNameList.push_back(name + "/" + entryName);
+                if (std::find(listDeferredPlugins.begin(), listDeferredPlugins.end(), entryName) != listDeferredPlugins.end())
+                {
+                    logInfo("RoutingSender::RoutingSender deferring file: ", entryName);
+                    mListDeferredLibraries.push_back(name + "/" + entryName);
+                }
+                else
+                {
+                    logInfo("RoutingSender::RoutingSender adding file: ", entryName);
+                    sharedLibraryNameList.push_back(name + "/" + entryName);
+                }
             }
             else
             {
@@ -90,30 +112,27 @@ CAmRoutingSender::CAmRoutingSender(const std::vector<std::string>& listOfPluginD
         closedir(directory);
     }
 
-    // iterate all communicator plugins and start them
-    std::vector<std::string>::iterator iter = sharedLibraryNameList.begin();
-    std::vector<std::string>::iterator iterEnd = sharedLibraryNameList.end();
-
-    for (; iter != iterEnd; ++iter)
-    {
-        logInfo("RoutingSender::RoutingSender try loading: ", *iter);
-
-        IAmRoutingSend* (*createFunc)();
-        void* tempLibHandle = NULL;
-        createFunc = getCreateFunction<IAmRoutingSend*()>(*iter, tempLibHandle);
-
-        if (!createFunc)
-        {
-            logError("RoutingSender::RoutingSender Entry point of RoutingPlugin not found");
-            continue;
-        }
+    loadInterfaces(sharedLibraryNameList, false);
+}
 
-        IAmRoutingSend* router = createFunc();
+/**
+ * loads plugins with mLoadThreads threads and appends the ones that are usable to mListInterfaces
+ * @param listLibraries full paths of the libraries
+ * @param deferred true if the plugins are loaded after the first main connection
+ */
+void CAmRoutingSender::loadInterfaces(const std::vector<std::string>& listLibraries, const bool deferred)
+{
+    std::vector<TAmPluginLoader<IAmRoutingSend>::load_s> listLoaded;
+    TAmPluginLoader<IAmRoutingSend>::load(listLibraries, mLoadThreads, listLoaded);
 
+    //the checks are done in the order of the list, so the order of the interfaces does not depend on the threads
+    std::vector<TAmPluginLoader<IAmRoutingSend>::load_s>::iterator iter = listLoaded.begin();
+    for (; iter != listLoaded.end(); ++iter)
+    {
+        IAmRoutingSend* router = iter->plugin;
         if (!router)
         {
-            logError("RoutingSender::RoutingSender RoutingPlugin initialization failed. Entry Function not callable");
-            dlclose(tempLibHandle);
+            logError("RoutingSender::loadInterfaces RoutingPlugin could not be loaded", iter->libname);
             continue;
         }
 
@@ -129,7 +148,7 @@ CAmRoutingSender::CAmRoutingSender(const std::vector<std::string>& listOfPluginD
         if (majorVersion < REQUIRED_INTERFACE_VERSION_MAJOR || ((majorVersion == REQUIRED_INTERFACE_VERSION_MAJOR) && (minorVersion > REQUIRED_INTERFACE_VERSION_MINOR)))
         {
             logInfo("RoutingPlugin initialization failed. Version of Interface to old");
-            dlclose(tempLibHandle);
+            dlclose(iter->libraryHandle);
             continue;
         }
 
@@ -137,21 +156,32 @@ CAmRoutingSender::CAmRoutingSender(const std::vector<std::string>& listOfPluginD
         router->returnBusName(routerInterface.busName);
         assert(!routerInterface.busName.empty());
         mListInterfaces.push_back(routerInterface);
-        mListLibraryHandles.push_back(tempLibHandle);
+        mListLibraryHandles.push_back(iter->libraryHandle);
+
+        pluginStartup_s startup;
+        startup.name = iter->libname;
+        startup.deferred = deferred;
+        startup.loadNs = iter->loadNs;
+        startup.createdNs = iter->createdNs;
+        startup.startupNs = 0;
+        startup.readyNs = 0;
+        startup.readyHandle = 0;
+        mListPluginStartup.push_back(startup);
+        logInfo("RoutingSender::loadInterfaces loaded", iter->libname, "in", (iter->createdNs - iter->loadNs) / 1000, "us");
     }
 }
 
 CAmRoutingSender::~CAmRoutingSender()
 {
     //unloadLibraries();
-    HandlesMap::iterator it = mlistActiveHandles.begin();
+    std::vector<handleSlot_s>::iterator it = mListHandleSlots.begin();
 
     //clean up heap if existent
-    for (; it != mlistActiveHandles.end(); ++it)
+    for (; it != mListHandleSlots.end(); ++it)
     {
-        if (it->first.handleType == H_SETSINKSOUNDPROPERTIES || it->first.handleType == H_SETSOURCESOUNDPROPERTIES)
+        if (it->handleType == H_SETSINKSOUNDPROPERTIES || it->handleType == H_SETSOURCESOUNDPROPERTIES)
         {
-            delete it->second.soundProperties;
+            delete it->handleData.soundProperties;
         }
     }
 }
@@ -161,26 +191,59 @@ am_Error_e CAmRoutingSender::startupInterfaces(CAmRoutingReceiver *iRoutingRecei
     mpRoutingReceiver = iRoutingReceiver;
     am_Error_e returnError = E_OK;
 
-    std::vector<InterfaceNamePairs>::iterator iter = mListInterfaces.begin();
-    std::vector<InterfaceNamePairs>::iterator iterEnd = mListInterfaces.end();
-    for (; iter < iterEnd; ++iter)
+    for (size_t i = 0; i < mListInterfaces.size(); i++)
+    {
+        am_Error_e error = mListInterfaces[i].routingInterface->startupInterface(iRoutingReceiver);
+        if (error != E_OK)
+        {
+            returnError = error;
+        }
+        if (i < mListPluginStartup.size())
+            mListPluginStartup[i].startupNs = pluginClockNs();
+    }
+    return (returnError);
+}
+
+/**
+ * loads and starts the plugins that were deferred to the first main connection. If the routing is already ready, the
+ * new plugins get their setRoutingReady right after their startup.
+ * @return E_OK or the last error of startupInterface
+ */
+am_Error_e CAmRoutingSender::startupDeferredInterfaces()
+{
+    if (mListDeferredLibraries.empty())
+        return (E_OK);
+    assert(mpRoutingReceiver!=NULL);
+
+    logInfo("RoutingSender::startupDeferredInterfaces loading", mListDeferredLibraries.size(), "deferred plugins");
+    size_t first = mListInterfaces.size();
+    loadInterfaces(mListDeferredLibraries, true);
+    mListDeferredLibraries.clear();
+
+    am_Error_e returnError = E_OK;
+    for (size_t i = first; i < mListInterfaces.size(); i++)
     {
-        am_Error_e error = (*iter).routingInterface->startupInterface(iRoutingReceiver);
+        am_Error_e error = mListInterfaces[i].routingInterface->startupInterface(mpRoutingReceiver);
         if (error != E_OK)
         {
             returnError = error;
         }
+        mListPluginStartup[i].startupNs = pluginClockNs();
+        if (mRoutingReady)
+        {
+            mListPluginStartup[i].readyHandle = mpRoutingReceiver->getStartupHandle();
+            mListInterfaces[i].routingInterface->setRoutingReady(mListPluginStartup[i].readyHandle);
+        }
     }
     return (returnError);
 }
 
 am_Error_e CAmRoutingSender::asyncAbort(const am_Handle_s& handle)
 {
-    HandleInterfaceMap::iterator iter = mMapHandleInterface.begin();
-    iter = mMapHandleInterface.find(handle.handle);
-    if (iter != mMapHandleInterface.end())
+    handleSlot_s* slot = findHandle(handle);
+    if (slot)
     {
-        return (iter->second->asyncAbort(handle));
+        return (slot->routingInterface->asyncAbort(handle));
     }
 
     return (E_NON_EXISTENT);
@@ -194,10 +257,11 @@ am_Error_e CAmRoutingSender::asyncConnect(am_Handle_s& handle, const am_connecti
     if (iter != mMapSinkInterface.end())
     {
         handleData.connectionID = connectionID;
-        handle = createHandle(handleData, H_CONNECT);
+        handle = createHandle(handleData, H_CONNECT, iter->second);
+        if (handle.handle == 0)
+            return (E_NOT_POSSIBLE);
         mMapConnectionInterface.insert(std::make_pair(connectionID, iter->second));
-        mMapHandleInterface.insert(std::make_pair(+ handle.handle, iter->second));
-        return (iter->second->asyncConnect(handle, connectionID, sourceID, sinkID, connectionFormat));
+        return (handleDispatched(handle, iter->second->asyncConnect(handle, connectionID, sourceID, sinkID, connectionFormat)));
     }
 
     return (E_NON_EXISTENT);
@@ -211,9 +275,10 @@ am_Error_e CAmRoutingSender::asyncDisconnect(am_Handle_s& handle, const am_conne
     if (iter != mMapConnectionInterface.end())
     {
         handleData.connectionID = connectionID;
-        handle = createHandle(handleData, H_DISCONNECT);
-        mMapHandleInterface.insert(std::make_pair(+ handle.handle, iter->second));
-        am_Error_e returnVal = iter->second->asyncDisconnect(handle, connectionID);
+        handle = createHandle(handleData, H_DISCONNECT, iter->second);
+        if (handle.handle == 0)
+            return (E_NOT_POSSIBLE);
+        am_Error_e returnVal = handleDispatched(handle, iter->second->asyncDisconnect(handle, connectionID));
         mMapConnectionInterface.erase(iter);
         return (returnVal);
     }
@@ -230,9 +295,10 @@ am_Error_e CAmRoutingSender::asyncSetSinkVolume(am_Handle_s& handle, const am_si
     {
         handleData.sinkID = sinkID;
         handleData.volume = volume;
-        handle = createHandle(handleData, H_SETSINKVOLUME);
-        mMapHandleInterface.insert(std::make_pair(+ handle.handle, iter->second));
-        return (iter->second->asyncSetSinkVolume(handle, sinkID, volume, ramp, time));
+        handle = createHandle(handleData, H_SETSINKVOLUME, iter->second);
+        if (handle.handle == 0)
+            return (E_NOT_POSSIBLE);
+        return (handleDispatched(handle, iter->second->asyncSetSinkVolume(handle, sinkID, volume, ramp, time)));
     }
     return (E_NON_EXISTENT);
 }
@@ -246,9 +312,10 @@ am_Error_e CAmRoutingSender::asyncSetSourceVolume(am_Handle_s& handle, const am_
     {
         handleData.sourceID = sourceID;
         handleData.volume = volume;
-        handle = createHandle(handleData, H_SETSOURCEVOLUME);
-        mMapHandleInterface.insert(std::make_pair(+ handle.handle, iter->second));
-        return (iter->second->asyncSetSourceVolume(handle, sourceID, volume, ramp, time));
+        handle = createHandle(handleData, H_SETSOURCEVOLUME, iter->second);
+        if (handle.handle == 0)
+            return (E_NOT_POSSIBLE);
+        return (handleDispatched(handle, iter->second->asyncSetSourceVolume(handle, sourceID, volume, ramp, time)));
     }
     return (E_NON_EXISTENT);
 }
@@ -262,9 +329,10 @@ am_Error_e CAmRoutingSender::asyncSetSourceState(am_Handle_s& handle, const am_s
     {
         handleData.sourceID = sourceID;
         handleData.sourceState = state;
-        handle = createHandle(handleData, H_SETSOURCESTATE);
-        mMapHandleInterface.insert(std::make_pair(+ handle.handle, iter->second));
-        return (iter->second->asyncSetSourceState(handle, sourceID, state));
+        handle = createHandle(handleData, H_SETSOURCESTATE, iter->second);
+        if (handle.handle == 0)
+            return (E_NOT_POSSIBLE);
+        return (handleDispatched(handle, iter->second->asyncSetSourceState(handle, sourceID, state)));
     }
     return (E_NON_EXISTENT);
 }
@@ -278,9 +346,10 @@ am_Error_e CAmRoutingSender::asyncSetSinkSoundProperty(am_Handle_s& handle, cons
     {
         handleData.sinkID = sinkID;
         handleData.soundPropery = soundProperty;
-        handle = createHandle(handleData, H_SETSINKSOUNDPROPERTY);
-        mMapHandleInterface.insert(std::make_pair(+ handle.handle, iter->second));
-        return (iter->second->asyncSetSinkSoundProperty(handle, sinkID, soundProperty));
+        handle = createHandle(handleData, H_SETSINKSOUNDPROPERTY, iter->second);
+        if (handle.handle == 0)
+            return (E_NOT_POSSIBLE);
+        return (handleDispatched(handle, iter->second->asyncSetSinkSoundProperty(handle, sinkID, soundProperty)));
     }
     return (E_NON_EXISTENT);
 }
@@ -294,9 +363,10 @@ am_Error_e CAmRoutingSender::asyncSetSourceSoundProperty(am_Handle_s& handle, co
     {
         handleData.sourceID = sourceID;
         handleData.soundPropery = soundProperty;
-        handle = createHandle(handleData, H_SETSOURCESOUNDPROPERTY);
-        mMapHandleInterface.insert(std::make_pair(+ handle.handle, iter->second));
-        return (iter->second->asyncSetSourceSoundProperty(handle, sourceID, soundProperty));
+        handle = createHandle(handleData, H_SETSOURCESOUNDPROPERTY, iter->second);
+        if (handle.handle == 0)
+            return (E_NOT_POSSIBLE);
+        return (handleDispatched(handle, iter->second->asyncSetSourceSoundProperty(handle, sourceID, soundProperty)));
     }
     return (E_NON_EXISTENT);
 }
@@ -310,9 +380,10 @@ am_Error_e CAmRoutingSender::asyncSetSourceSoundProperties(am_Handle_s& handle,
     {
         handleData.sourceID = sourceID;
         handleData.soundProperties = new std::vector<am_SoundProperty_s>(listSoundProperties);
-        handle = createHandle(handleData, H_SETSOURCESOUNDPROPERTIES);
-        mMapHandleInterface.insert(std::make_pair(+ handle.handle, iter->second));
-        return (iter->second->asyncSetSourceSoundProperties(handle, sourceID, listSoundProperties));
+        handle = createHandle(handleData, H_SETSOURCESOUNDPROPERTIES, iter->second);
+        if (handle.handle == 0)
+            return (E_NOT_POSSIBLE);
+        return (handleDispatched(handle, iter->second->asyncSetSourceSoundProperties(handle, sourceID, listSoundProperties)));
     }
     return (E_NON_EXISTENT);
 }
@@ -326,9 +397,10 @@ am_Error_e CAmRoutingSender::asyncSetSinkSoundProperties(am_Handle_s& handle, co
     {
         handleData.sinkID = sinkID;
         handleData.soundProperties = new std::vector<am_SoundProperty_s>(listSoundProperties);
-        handle = createHandle(handleData, H_SETSINKSOUNDPROPERTIES);
-        mMapHandleInterface.insert(std::make_pair(+ handle.handle, iter->second));
-        return (iter->second->asyncSetSinkSoundProperties(handle, sinkID, listSoundProperties));
+        handle = createHandle(handleData, H_SETSINKSOUNDPROPERTIES, iter->second);
+        if (handle.handle == 0)
+            return (E_NOT_POSSIBLE);
+        return (handleDispatched(handle, iter->second->asyncSetSinkSoundProperties(handle, sinkID, listSoundProperties)));
     }
     return (E_NON_EXISTENT);
 
@@ -343,9 +415,10 @@ am_Error_e CAmRoutingSender::asyncCrossFade(am_Handle_s& handle, const am_crossf
     {
         handleData.crossfaderID = crossfaderID;
         handleData.hotSink = hotSink;
-        handle = createHandle(handleData, H_CROSSFADE);
-        mMapHandleInterface.insert(std::make_pair(+ handle.handle, iter->second));
-        return (iter->second->asyncCrossFade(handle, crossfaderID, hotSink, rampType, time));
+        handle = createHandle(handleData, H_CROSSFADE, iter->second);
+        if (handle.handle == 0)
+            return (E_NOT_POSSIBLE);
+        return (handleDispatched(handle, iter->second->asyncCrossFade(handle, crossfaderID, hotSink, rampType, time)));
     }
     return (E_NON_EXISTENT);
 }
@@ -505,51 +578,253 @@ am_Error_e CAmRoutingSender::removeCrossfaderLookup(const am_crossfaderID_t cros
 /**
  * removes a handle from the list
  * @param handle to be removed
- * @return E_OK in case of success
+ * @return E_OK in case of success, E_UNKNOWN if the handle is not active
  */
 am_Error_e CAmRoutingSender::removeHandle(const am_Handle_s& handle)
 {
-    if (mlistActiveHandles.erase(handle))
-        return (E_OK);
-    return (E_UNKNOWN);
+    handleSlot_s* slot = findHandle(handle);
+    if (!slot)
+    {
+        logError("RoutingSender::removeHandle unknown or stale handle", handle.handle, "type", static_cast<int16_t>(handle.handleType));
+        return (E_UNKNOWN);
+    }
+    finishTrace(handle, *slot);
+    releaseSlot(handle, *slot);
+    return (E_OK);
+}
+
+/**
+ * stamps the arrival of the ack of a handle. Must be called when the ack enters the daemon, before the database is
+ * updated. Acks of unknown handles are ignored.
+ * @param handle the acked handle
+ */
+void CAmRoutingSender::traceHandleAck(const am_Handle_s& handle)
+{
+    handleSlot_s* slot = findHandle(handle);
+    if (slot && slot->acked == 0)
+        slot->acked = monotonicNs();
+}
+
+/**
+ * returns the latencies of all finished handles, one entry for each handle type on each routing plugin
+ * @param listStatistics the statistics
+ */
+void CAmRoutingSender::getHandleStatistics(std::vector<handleStatistic_s>& listStatistics) const
+{
+    listStatistics.clear();
+    HandleStatisticMap::const_iterator iter = mMapHandleStatistics.begin();
+    for (; iter != mMapHandleStatistics.end(); ++iter)
+        listStatistics.push_back(iter->second);
+}
+
+/**
+ * returns the number of active handles
+ * @param listCounts the number of active handles for each am_Handle_e, indexed by the handle type
+ */
+void CAmRoutingSender::getOutstandingHandles(std::vector<uint16_t>& listCounts) const
+{
+    listCounts = mListOutstandingHandles;
+}
+
+/**
+ * returns the number of active handles of each routing plugin
+ * @param mapCounts the number of active handles by busname, plugins without active handles are listed with 0
+ */
+void CAmRoutingSender::getOutstandingHandlesOfPlugins(std::map<std::string, uint16_t>& mapCounts) const
+{
+    mapCounts.clear();
+    std::map<IAmRoutingSend*, std::string> mapNames;
+    std::vector<InterfaceNamePairs>::const_iterator nameIter = mListInterfaces.begin();
+    for (; nameIter != mListInterfaces.end(); ++nameIter)
+    {
+        mapNames[nameIter->routingInterface] = nameIter->busName;
+        mapCounts[nameIter->busName] = 0;
+    }
+    std::vector<handleSlot_s>::const_iterator iter = mListHandleSlots.begin();
+    for (; iter != mListHandleSlots.end(); ++iter)
+    {
+        if (iter->handleType != H_UNKNOWN)
+            mapCounts[mapNames[iter->routingInterface]]++;
+    }
+}
+
+/**
+ * drops the latencies of all finished handles
+ */
+void CAmRoutingSender::resetHandleStatistics()
+{
+    mMapHandleStatistics.clear();
 }
 
 am_Error_e CAmRoutingSender::getListHandles(std::vector<am_Handle_s> & listHandles) const
 {
     listHandles.clear();
-    HandlesMap::const_iterator it = mlistActiveHandles.begin();
-    for (; it != mlistActiveHandles.end(); ++it)
+    am_Handle_s handle;
+    for (size_t index = 0; index < mListHandleSlots.size(); index++)
     {
-        listHandles.push_back(it->first);
+        if (mListHandleSlots[index].handleType == H_UNKNOWN)
+            continue;
+        handle.handle = index + 1;
+        handle.handleType = mListHandleSlots[index].handleType;
+        listHandles.push_back(handle);
     }
     return (E_OK);
 }
 
 /**
- * creates a handle and adds it to the list of handles
+ * creates a handle and adds it to the table of handles.
+ * A free slot is reused only if HANDLE_REUSE_DISTANCE other slots were freed after it, otherwise the table grows.
  * @param handleData the data that should be saves together with the handle
  * @param type the type of handle to be created
- * @return the handle
+ * @param routingInterface the plugin that handles the handle
+ * @return the handle, the handle value is 0 if all HANDLE_MAX_SLOTS handles are in use. In that case the
+ *         soundProperties of the handleData are deleted.
  */
-am_Handle_s CAmRoutingSender::createHandle(const am_handleData_c& handleData, const am_Handle_e type)
+am_Handle_s CAmRoutingSender::createHandle(const am_handleData_c& handleData, const am_Handle_e type, IAmRoutingSend* routingInterface)
 {
     am_Handle_s handle;
-    handle.handle = ++mHandleCount; //todo: handle overflows here...
     handle.handleType = type;
-    mlistActiveHandles.insert(std::make_pair(handle, handleData));
+    uint16_t index;
+    if (mListFreeSlots.size() > HANDLE_REUSE_DISTANCE || (!mListFreeSlots.empty() && mListHandleSlots.size() >= HANDLE_MAX_SLOTS))
+    {
+        index = mListFreeSlots.front();
+        mListFreeSlots.pop_front();
+    }
+    else if (mListHandleSlots.size() < HANDLE_MAX_SLOTS)
+    {
+        index = mListHandleSlots.size();
+        mListHandleSlots.push_back(handleSlot_s());
+    }
+    else
+    {
+        logError("RoutingSender::createHandle all handles are in use");
+        if (type == H_SETSINKSOUNDPROPERTIES || type == H_SETSOURCESOUNDPROPERTIES)
+            delete handleData.soundProperties;
+        handle.handle = 0;
+        return (handle);
+    }
+
+    handleSlot_s& slot(mListHandleSlots[index]);
+    slot.handleType = type;
+    slot.handleData = handleData;
+    slot.routingInterface = routingInterface;
+    slot.created = monotonicNs();
+    slot.dispatched = 0;
+    slot.acked = 0;
+    mListOutstandingHandles[type]++;
+    handle.handle = index + 1;
     return (handle);
 }
 
+/**
+ * looks up an active handle. Handles whose slot is free or was reused for another handle type are stale.
+ * @param handle the handle
+ * @return the slot or NULL if the handle is not active
+ */
+CAmRoutingSender::handleSlot_s* CAmRoutingSender::findHandle(const am_Handle_s& handle)
+{
+    if (handle.handle == 0 || handle.handle > mListHandleSlots.size())
+        return (NULL);
+    handleSlot_s& slot(mListHandleSlots[handle.handle - 1]);
+    if (slot.handleType == H_UNKNOWN || slot.handleType != handle.handleType)
+        return (NULL);
+    return (&slot);
+}
+
+void CAmRoutingSender::releaseSlot(const am_Handle_s& handle, handleSlot_s& slot)
+{
+    mListOutstandingHandles[slot.handleType]--;
+    slot.handleType = H_UNKNOWN;
+    slot.routingInterface = NULL;
+    mListFreeSlots.push_back(handle.handle - 1);
+}
+
+/**
+ * stamps the return of the async call of the plugin. Handles that the plugin refused are released right away because
+ * they will never be acked.
+ * @param handle the handle
+ * @param error the return value of the async call
+ * @return error
+ */
+am_Error_e CAmRoutingSender::handleDispatched(const am_Handle_s& handle, const am_Error_e error)
+{
+    handleSlot_s* slot = findHandle(handle);
+    if (!slot)
+        return (error); //the plugin acked and the handle was removed within the async call
+    if (error != E_OK)
+    {
+        if (slot->handleType == H_SETSINKSOUNDPROPERTIES || slot->handleType == H_SETSOURCESOUNDPROPERTIES)
+            delete slot->handleData.soundProperties;
+        releaseSlot(handle, *slot);
+    }
+    else if (slot->acked == 0)
+    {
+        slot->dispatched = monotonicNs();
+    }
+    return (error);
+}
+
+void CAmRoutingSender::finishTrace(const am_Handle_s& handle, const handleSlot_s& slot)
+{
+    uint64_t removed = monotonicNs();
+    uint64_t acked = (slot.acked == 0 ? removed : slot.acked);
+    uint64_t dispatched = (slot.dispatched == 0 || slot.dispatched > acked ? acked : slot.dispatched);
+
+    std::pair<HandleStatisticMap::iterator, bool> inserted = mMapHandleStatistics.insert(std::make_pair(std::make_pair(slot.routingInterface, slot.handleType), handleStatistic_s()));
+    handleStatistic_s& statistic(inserted.first->second);
+    if (inserted.second)
+    {
+        statistic.handleType = slot.handleType;
+        statistic.count = 0;
+        statistic.dispatchNs = 0;
+        statistic.pluginNs = 0;
+        statistic.storeNs = 0;
+        statistic.maxNs = 0;
+        for (int i = 0; i < HANDLE_LATENCY_BUCKETS; i++)
+            statistic.histogram[i] = 0;
+        std::vector<InterfaceNamePairs>::const_iterator nameIter = mListInterfaces.begin();
+        for (; nameIter != mListInterfaces.end(); ++nameIter)
+        {
+            if (nameIter->routingInterface == slot.routingInterface)
+                statistic.busName = nameIter->busName;
+        }
+    }
+
+    uint64_t total = removed - slot.created;
+    statistic.count++;
+    statistic.dispatchNs += dispatched - slot.created;
+    statistic.pluginNs += acked - dispatched;
+    statistic.storeNs += removed - acked;
+    if (total > statistic.maxNs)
+        statistic.maxNs = total;
+    int bucket = 0;
+    uint64_t limitNs = 1000000;
+    while (bucket < HANDLE_LATENCY_BUCKETS - 1 && total >= limitNs)
+    {
+        bucket++;
+        limitNs *= 2;
+    }
+    statistic.histogram[bucket]++;
+
+    if (total >= static_cast<uint64_t>(HANDLE_LATENCY_WARN_TIME) * 1000000)
+    {
+        logInfo("RoutingSender::finishTrace slow handle", handle.handle, static_cast<int16_t>(slot.handleType), statistic.busName, "total/dispatch/plugin/store us", total / 1000, (dispatched - slot.created) / 1000, (acked - dispatched) / 1000, (removed - acked) / 1000);
+    }
+}
+
 /**
  * returns the data that belong to handles
  * @param handle the handle
- * @return a class holding the handle data
+ * @return a class holding the handle data, all zero if the handle is not active
  */
 CAmRoutingSender::am_handleData_c CAmRoutingSender::returnHandleData(const am_Handle_s handle) const
 {
-    HandlesMap::const_iterator it = mlistActiveHandles.begin();
-    it = mlistActiveHandles.find(handle);
-    return (it->second);
+    if (handle.handle == 0 || handle.handle > mListHandleSlots.size())
+        return (am_handleData_c());
+    const handleSlot_s& slot(mListHandleSlots[handle.handle - 1]);
+    if (slot.handleType == H_UNKNOWN || slot.handleType != handle.handleType)
+        return (am_handleData_c());
+    return (slot.handleData);
 }
 
 void CAmRoutingSender::setRoutingReady()
@@ -566,17 +841,18 @@ void CAmRoutingSender::setRoutingReady()
     //set the receiver ready to wait for replies
     mpRoutingReceiver->waitOnStartup(true);
 
-    std::vector<InterfaceNamePairs>::iterator iter = mListInterfaces.begin();
-    std::vector<InterfaceNamePairs>::iterator iterEnd = mListInterfaces.end();
-    std::vector<uint16_t>::const_iterator handleIter(listStartupHandles.begin());
-    for (; iter < iterEnd; ++iter)
+    mRoutingReady = true;
+    for (size_t i = 0; i < mListInterfaces.size(); i++)
     {
-        (*iter).routingInterface->setRoutingReady(*(handleIter++));
+        if (i < mListPluginStartup.size())
+            mListPluginStartup[i].readyHandle = listStartupHandles[i];
+        mListInterfaces[i].routingInterface->setRoutingReady(listStartupHandles[i]);
     }
 }
 
 void CAmRoutingSender::setRoutingRundown()
 {
+    mRoutingReady = false;
     mpRoutingReceiver->waitOnRundown(false);
     //create a list of handles
     std::vector<uint16_t> listStartupHandles;
@@ -617,6 +893,33 @@ am_Error_e CAmRoutingSender::getListPlugins(std::vector<std::string>& interfaces
     return (E_OK);
 }
 
+/**
+ * returns the startup timeline of the loaded plugins, see pluginStartup_s
+ * @param listStartup the timeline, in the order the plugins were loaded
+ */
+void CAmRoutingSender::getPluginStartupTimes(std::vector<pluginStartup_s>& listStartup) const
+{
+    listStartup = mListPluginStartup;
+}
+
+/**
+ * stamps the ready time of the plugin that got the startup handle, called by the RoutingReceiver
+ * @param handle the handle of confirmRoutingReady
+ */
+void CAmRoutingSender::traceReadyConfirm(const uint16_t handle)
+{
+    std::vector<pluginStartup_s>::iterator iter = mListPluginStartup.begin();
+    for (; iter != mListPluginStartup.end(); ++iter)
+    {
+        if (iter->readyHandle == handle && iter->readyNs == 0)
+        {
+            iter->readyNs = pluginClockNs();
+            logInfo("RoutingSender::traceReadyConfirm", iter->name, "ready after", (iter->readyNs - iter->loadNs) / 1000, "us");
+            return;
+        }
+    }
+}
+
 void CAmRoutingSender::getInterfaceVersion(std::string & version) const
 {
     version = RoutingSendVersion;
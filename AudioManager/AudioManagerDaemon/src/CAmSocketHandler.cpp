@@ -25,10 +25,16 @@
 #include <sys/fcntl.h>
 #include <sys/errno.h>
 #include <sys/poll.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <climits>
+#include <limits>
 #include <time.h>
 #include <algorithm>
 #include <features.h>
 #include <csignal>
+#include <stdexcept>
 #include "shared/CAmDltWrapper.h"
 
 namespace am
@@ -36,35 +42,93 @@ namespace am
 
 CAmSocketHandler* CAmSocketHandler::mInstance=NULL;
 
+/**
+ * converts the timeout for the next timer into milliseconds for epoll_pwait.
+ * The value is rounded up, so that a timer is never woken up before it is due.
+ * @param timeout the timeout, NULL if no timer is active
+ * @return the timeout in milliseconds, -1 for no timeout
+ */
+static int timeoutMs(const timespec* timeout)
+{
+    if (timeout == NULL)
+        return (-1);
+    if (timeout->tv_sec >= INT_MAX / 1000 - 1)
+        return (INT_MAX);
+    return (timeout->tv_sec * 1000 + (timeout->tv_nsec + 999999) / 1000000);
+}
+
+/**
+ * returns the nanoseconds since start
+ */
+static uint64_t elapsedNs(const timespec& start)
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (static_cast<uint64_t>(now.tv_sec - start.tv_sec) * MAX_NS + now.tv_nsec - start.tv_nsec);
+}
+
 CAmSocketHandler::CAmSocketHandler() :
+        receiverCallbackT(this, &CAmSocketHandler::receiverCallback), //
+        checkerCallbackT(this, &CAmSocketHandler::checkerCallback), //
+        timerFdCallbackT(this, &CAmSocketHandler::timerFdCallback), //
         mPipe(),
+        mEpollFd(-1), //
+        mListEpollEvent(1), //
         mListPoll(), //
+        mListFdFirstHandle(), //
+        mListFreePollHandle(), //
+        mListRemovedPollHandle(), //
+        mListFired(), //
         mListTimer(), //
+        mListFreeTimerHandle(), //
         mListActiveTimer(), //
-        mLastInsertedHandle(0), //
-        mLastInsertedPollHandle(0), //
-        mRecreatePollfds(true), //
-        mStartTime(), //
-        receiverCallbackT(this, &CAmSocketHandler::receiverCallback),//
-        checkerCallbackT(this, &CAmSocketHandler::checkerCallback)//
+        mNumberActiveTimer(0), //
+        mTimerSequence(0), //
+        mTimerFd(-1), //
+        mTimerFdHandle(0), //
+        mTimerFdDeadline(), //
+        mWakeups(0), //
+        mBusyNs(0)
 {
     gDispatchDone = 1;
     mInstance=this;
 
+    if ((mEpollFd = epoll_create1(EPOLL_CLOEXEC)) == -1)
+    {
+        logError("CAmSocketHandler could not create epoll instance!", errno);
+        throw std::runtime_error("CAmSocketHandler could not create epoll instance!");
+    }
+
     if (pipe(mPipe) == -1)
     {
         logError("CAmSerializer could not create pipe!");
     }
 
-    //add the pipe to the poll - nothing needs to be proccessed here we just need the pipe to trigger the ppoll
+    //add the pipe to the poll - nothing needs to be proccessed here we just need the pipe to trigger the epoll_pwait
     short event = 0;
     sh_pollHandle_t handle;
     event |= POLLIN;
     addFDPoll(mPipe[0], event, NULL, &receiverCallbackT, &checkerCallbackT, NULL, NULL, handle);
+
+    //the timerfd wakes up the mainloop with the precision of the timers, without it the timeout of epoll_pwait is used
+    mTimerFdDeadline.tv_sec = mTimerFdDeadline.tv_nsec = 0;
+    if ((mTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) == -1)
+    {
+        logError("CAmSocketHandler could not create timerfd, using the timeout of epoll_pwait", errno);
+    }
+    else if (addFDPoll(mTimerFd, POLLIN, NULL, &timerFdCallbackT, NULL, NULL, NULL, mTimerFdHandle) != E_OK)
+    {
+        close(mTimerFd);
+        mTimerFd = -1;
+    }
 }
 
 CAmSocketHandler::~CAmSocketHandler()
 {
+    if (mTimerFd != -1)
+        close(mTimerFd);
+    if (mEpollFd != -1)
+        close(mEpollFd);
 }
 
 //todo: maybe have some: give me more time returned?
@@ -74,7 +138,7 @@ CAmSocketHandler::~CAmSocketHandler()
 void CAmSocketHandler::start_listenting()
 {
     gDispatchDone = 0;
-    int16_t pollStatus;
+    int pollStatus;
 
     //prepare the signalmask
     sigset_t sigmask;
@@ -85,26 +149,21 @@ void CAmSocketHandler::start_listenting()
     sigaddset(&sigmask, SIGHUP);
     sigaddset(&sigmask, SIGQUIT);
 
-    clock_gettime(CLOCK_MONOTONIC, &mStartTime);
     while (!gDispatchDone)
     {
+        //the handles that were removed during the last loop are not referenced anymore and can be reused
+        mListFreePollHandle.insert(mListFreePollHandle.end(), mListRemovedPollHandle.begin(), mListRemovedPollHandle.end());
+        mListRemovedPollHandle.clear();
+
         //first we go through the registered filedescriptors and check if someone needs preparation:
         std::for_each(mListPoll.begin(), mListPoll.end(), CAmShCallPrep());
 
-        if (mRecreatePollfds)
-        {
-            mfdPollingArray.clear();
-            //there was a change in the setup, so we need to recreate the fdarray from the list
-            std::for_each(mListPoll.begin(), mListPoll.end(), CAmShCopyPollfd(mfdPollingArray));
-            mRecreatePollfds = false;
-        }
+        armTimerFd();
 
-        timerCorrection();
-
-        //block until something is on a filedescriptor
+        //block until something is on a filedescriptor or the next timer is up
 
         timespec buffertime;
-        if ((pollStatus = ppoll(&mfdPollingArray[0], mfdPollingArray.size(), insertTime(buffertime), &sigmask)) < 0)
+        if ((pollStatus = epoll_pwait(mEpollFd, &mListEpollEvent[0], mListEpollEvent.size(), timeoutMs(insertTime(buffertime)), &sigmask)) < 0)
         {
             if (errno == EINTR)
             {
@@ -113,52 +172,23 @@ void CAmSocketHandler::start_listenting()
             }
             else
             {
-                logError("SocketHandler::start_listenting ppoll returned with error", errno);
+                logError("SocketHandler::start_listenting epoll_pwait returned with error", errno);
                 exit(0);
             }
         }
+        timespec wakeup;
+        clock_gettime(CLOCK_MONOTONIC, &wakeup);
+        mWakeups++;
 
         if (pollStatus != 0) //only check filedescriptors if there was a change
         {
             //todo: here could be a timer that makes sure naughty plugins return!
-
-            //freeze mListPoll by copying it - otherwise we get problems when we want to manipulate it during the next lines
-            std::list<sh_poll_s> listPoll;
-            mListPoll_t::iterator listmPollIt;
-
-            //remove all filedescriptors who did not fire
-            std::vector<pollfd>::iterator it = mfdPollingArray.begin();
-            do
-            {
-                it = std::find_if(it, mfdPollingArray.end(), eventFired);
-                if (it != mfdPollingArray.end())
-                {
-                    listmPollIt = mListPoll.begin();
-                    std::advance(listmPollIt, std::distance(mfdPollingArray.begin(), it));
-                    listPoll.push_back(*listmPollIt);
-                    listPoll.back().pollfdValue = *it;
-                    it++;
-                }
-            } while (it != mfdPollingArray.end());
-
-            //stage 1, call firedCB
-            std::for_each(listPoll.begin(), listPoll.end(), CAmShCallFire());
-
-            //stage 2, lets ask around if some dispatching is necessary, the ones who need stay on the list
-            listPoll.remove_if(noDispatching);
-
-            //stage 3, the ones left need to dispatch, we do this as long as there is something to dispatch..
-            do
-            {
-                listPoll.remove_if(dispatchingFinished);
-            } while (!listPoll.empty());
-
-        }
-        else //Timerevent
-        {
-            //this was a timer event, we need to take care about the timers
-            timerUp();
+            dispatchFired(pollStatus);
         }
+
+        //the timers are checked after every wakeup, so that busy filedescriptors cannot hold them back
+        timerUp();
+        mBusyNs += elapsedNs(wakeup);
     }
 }
 
@@ -168,16 +198,6 @@ void CAmSocketHandler::start_listenting()
 void CAmSocketHandler::stop_listening()
 {
     gDispatchDone = 1;
-
-    //this is for all running timers only - we need to handle the additional offset here
-    if (!mListActiveTimer.empty())
-    {
-        timespec currentTime, correctionTime;
-        clock_gettime(CLOCK_MONOTONIC, &currentTime);
-        correctionTime = timespecSub(currentTime, mStartTime);
-        std::for_each(mListActiveTimer.begin(), mListActiveTimer.end(), CAmShSubstractTime(correctionTime));
-    }
-
 }
 
 /**
@@ -197,9 +217,26 @@ am_Error_e CAmSocketHandler::addFDPoll(const int fd, const short event, IAmShPol
     if (!fdIsValid(fd))
         return (E_NON_EXISTENT);
 
-    sh_poll_s pollData;
+    sh_pollHandle_t newHandle;
+    if (!mListFreePollHandle.empty())
+    {
+        newHandle = mListFreePollHandle.back();
+        mListFreePollHandle.pop_back();
+    }
+    else
+    {
+        if (mListPoll.size() >= std::numeric_limits<sh_pollHandle_t>::max())
+        {
+            logError("SocketHandler::addFDPoll no more poll handles available");
+            return (E_NOT_POSSIBLE);
+        }
+        mListPoll.push_back(sh_poll_s());
+        newHandle = mListPoll.size();
+    }
+
+    sh_poll_s& pollData = mListPoll[newHandle - 1];
     pollData.pollfdValue.fd = fd;
-    pollData.handle = ++mLastInsertedPollHandle;
+    pollData.handle = newHandle;
     pollData.pollfdValue.events = event;
     pollData.pollfdValue.revents = 0;
     pollData.userData = userData;
@@ -207,13 +244,29 @@ am_Error_e CAmSocketHandler::addFDPoll(const int fd, const short event, IAmShPol
     pollData.firedCB = fired;
     pollData.checkCB = check;
     pollData.dispatchCB = dispatch;
+    pollData.isValid = true;
+    pollData.wakeups = 0;
+    pollData.dispatchNs = 0;
 
-    //add new data to the list
-    mListPoll.push_back(pollData);
+    //the new poll becomes the first one of the filedescriptor
+    if ((size_t) fd >= mListFdFirstHandle.size())
+        mListFdFirstHandle.resize(fd + 1, 0);
+    pollData.nextOnFd = mListFdFirstHandle[fd];
+    mListFdFirstHandle[fd] = newHandle;
 
-    mRecreatePollfds = true;
+    if (updateEpoll(fd) != E_OK)
+    {
+        mListFdFirstHandle[fd] = pollData.nextOnFd;
+        pollData.isValid = false;
+        mListFreePollHandle.push_back(newHandle);
+        return (E_NOT_POSSIBLE);
+    }
 
-    handle = pollData.handle;
+    //there can never be more filedescriptors than polls
+    if (mListEpollEvent.size() < mListPoll.size())
+        mListEpollEvent.resize(mListPoll.size());
+
+    handle = newHandle;
     return (E_OK);
 }
 
@@ -224,55 +277,71 @@ am_Error_e CAmSocketHandler::addFDPoll(const int fd, const short event, IAmShPol
  */
 am_Error_e CAmSocketHandler::removeFDPoll(const sh_pollHandle_t handle)
 {
-    mListPoll_t::iterator iterator = mListPoll.begin();
+    sh_poll_s* poll = getPoll(handle);
+    if (!poll)
+        return (E_UNKNOWN);
 
-    for (; iterator != mListPoll.end(); ++iterator)
-    {
-        if (iterator->handle == handle)
-        {
-            iterator = mListPoll.erase(iterator);
-            mRecreatePollfds = true;
-            return (E_OK);
-        }
-    }
-    return (E_UNKNOWN);
+    const int fd = poll->pollfdValue.fd;
+    sh_pollHandle_t* link = &mListFdFirstHandle[fd];
+    while (*link != handle)
+        link = &mListPoll[*link - 1].nextOnFd;
+    *link = poll->nextOnFd;
+
+    poll->isValid = false;
+    poll->nextOnFd = 0;
+
+    //the handle might still be on the fired list, so it is reused not before the next loop
+    mListRemovedPollHandle.push_back(handle);
+
+    updateEpoll(fd);
+    return (E_OK);
 }
 
 /**
  * adds a timer to the list of timers. The callback will be fired when the timer is up.
- * This is not a high precise timer, it is very coarse. It is meant to be used for timeouts when waiting
- * for an answer via a filedescriptor.
+ * It is meant to be used for timeouts when waiting for an answer via a filedescriptor.
+ * The timer is kept on a heap by its CLOCK_MONOTONIC deadline, so adding, restarting and stopping is O(log n).
+ * A removed handle is reused only if TIMER_HANDLE_REUSE_DISTANCE other handles were removed after it.
  * One time timer. If you need again a timer, you need to add a new timer in the callback of the old one.
  * @param timeouts timeouts time until the callback is fired
  * @param callback callback the callback
  * @param handle handle the handle that is created for the timer is returned. Can be used to remove the timer
  * @param userData pointer always passed with the call
- * @return E_OK in case of success
+ * @return E_OK in case of success, E_NOT_POSSIBLE if no more handles are available
  */
 am_Error_e CAmSocketHandler::addTimer(const timespec timeouts, IAmShTimerCallBack* callback, sh_timerHandle_t& handle, void * userData)
 {
     assert(!((timeouts.tv_sec==0) && (timeouts.tv_nsec==0)));
     assert(callback!=NULL);
 
-    sh_timer_s timerItem;
+    sh_timerHandle_t newHandle;
+    if (mListFreeTimerHandle.size() > TIMER_HANDLE_REUSE_DISTANCE || (!mListFreeTimerHandle.empty() && mListTimer.size() >= std::numeric_limits<sh_timerHandle_t>::max()))
+    {
+        newHandle = mListFreeTimerHandle.front();
+        mListFreeTimerHandle.pop_front();
+    }
+    else if (mListTimer.size() < std::numeric_limits<sh_timerHandle_t>::max())
+    {
+        mListTimer.push_back(sh_timer_s());
+        newHandle = mListTimer.size();
+    }
+    else
+    {
+        logError("SocketHandler::addTimer no more timer handles available");
+        return (E_NOT_POSSIBLE);
+    }
 
-    //create a new handle for the timer
-    handle = ++mLastInsertedHandle; //todo: overflow ruling !o
-    timerItem.handle = handle;
-    timerItem.countdown = timeouts;
+    sh_timer_s& timerItem = mListTimer[newHandle - 1];
+    timerItem.handle = newHandle;
+    timerItem.timeout = timeouts;
     timerItem.callback = callback;
     timerItem.userData = userData;
+    timerItem.isValid = true;
+    timerItem.isActive = false;
 
-    mListTimer.push_back(timerItem);
+    startTimer(timerItem);
 
-    //we add here the time difference between startTime and currenttime, because this time will be substracted later on in timecorrection
-    timespec currentTime;
-    clock_gettime(CLOCK_MONOTONIC, &currentTime);
-    if (!gDispatchDone) //the mainloop is started
-        timerItem.countdown = timespecAdd(timeouts, timespecSub(currentTime, mStartTime));
-
-    mListActiveTimer.push_back(timerItem);
-    mListActiveTimer.sort(compareCountdown);
+    handle = newHandle;
     return (E_OK);
 }
 
@@ -288,16 +357,14 @@ am_Error_e CAmSocketHandler::removeTimer(const sh_timerHandle_t handle)
     //stop the current timer
     stopTimer(handle);
 
-    std::list<sh_timer_s>::iterator it(mListTimer.begin());
-    for (; it != mListTimer.end(); ++it)
-    {
-        if (it->handle == handle)
-        {
-            it = mListTimer.erase(it);
-            return (E_OK);
-        }
-    }
-    return (E_UNKNOWN);
+    sh_timer_s* timer = getTimer(handle);
+    if (!timer)
+        return (E_UNKNOWN);
+
+    //entries of the timer that are still on the heap are stale now, the handle goes to the end of the free list
+    timer->isValid = false;
+    mListFreeTimerHandle.push_back(handle);
+    return (E_OK);
 }
 
 /**
@@ -308,143 +375,237 @@ am_Error_e CAmSocketHandler::removeTimer(const sh_timerHandle_t handle)
  */
 am_Error_e CAmSocketHandler::updateTimer(const sh_timerHandle_t handle, const timespec timeouts)
 {
-    //update the mList ....
-    sh_timer_s timerItem;
-    std::list<sh_timer_s>::iterator it(mListTimer.begin()), activeIt(mListActiveTimer.begin());
-    bool found(false);
-    for (; it != mListTimer.end(); ++it)
-    {
-        if (it->handle == handle)
-        {
-            it->countdown = timeouts;
-            timerItem = *it;
-            found = true;
-            break;
-        }
-    }
-    if (!found)
+    sh_timer_s* timer = getTimer(handle);
+    if (!timer)
         return (E_NON_EXISTENT);
 
-    found = false;
+    timer->timeout = timeouts;
+    startTimer(*timer);
+    return (E_OK);
+}
 
-    //we add here the time difference between startTime and currenttime, because this time will be substracted later on in timecorrection
-    timespec currentTime, timeoutsCorrected;
-    currentTime.tv_nsec=timeoutsCorrected.tv_nsec=0;
-    currentTime.tv_sec=timeoutsCorrected.tv_sec=0;
-    clock_gettime(CLOCK_MONOTONIC, &currentTime);
-    if (!gDispatchDone) //the mainloop is started
-        timeoutsCorrected = timespecAdd(timeouts, timespecSub(currentTime, mStartTime));
+/**
+ * restarts a timer with the original value
+ * @param handle
+ * @return E_OK on success, E_NON_EXISTENT if the handle was not found
+ */
+am_Error_e CAmSocketHandler::restartTimer(const sh_timerHandle_t handle)
+{
+    sh_timer_s* timer = getTimer(handle);
+    if (!timer)
+        return (E_NON_EXISTENT);
 
-    for (; activeIt != mListActiveTimer.end(); ++activeIt)
-    {
-        if (activeIt->handle == handle)
-        {
-            activeIt->countdown = timeoutsCorrected;
-            found = true;
-            break;
-        }
-    }
+    startTimer(*timer);
+    return (E_OK);
+}
 
-    if (!found)
-        timerItem.countdown = timeoutsCorrected;
-    mListActiveTimer.push_back(timerItem);
+/**
+ * stops a timer
+ * @param handle
+ * @return E_OK on success, E_NON_EXISTENT if the handle was not found
+ */
+am_Error_e CAmSocketHandler::stopTimer(const sh_timerHandle_t handle)
+{
+    sh_timer_s* timer = getTimer(handle);
+    if (!timer || !timer->isActive)
+        return (E_NON_EXISTENT);
 
-    mListActiveTimer.sort(compareCountdown);
+    //the entry stays on the heap and is dropped when it comes to the front
+    timer->isActive = false;
+    mNumberActiveTimer--;
     return (E_OK);
 }
 
 /**
- * restarts a timer with the original value
+ * updates the eventFlags of a poll
  * @param handle
- * @return E_OK on success, E_NON_EXISTENT if the handle was not found
+ * @param events
+ * @return @return E_OK on succsess, E_NON_EXISTENT if fd was not found
  */
-am_Error_e CAmSocketHandler::restartTimer(const sh_timerHandle_t handle)
+am_Error_e CAmSocketHandler::updateEventFlags(const sh_pollHandle_t handle, const short events)
 {
-    sh_timer_s timerItem; //!<the original timer value
-    //find the original value
-    std::list<sh_timer_s>::iterator it(mListTimer.begin()), activeIt(mListActiveTimer.begin());
-    bool found(false);
-    for (; it != mListTimer.end(); ++it)
+    sh_poll_s* poll = getPoll(handle);
+    if (!poll)
+        return (E_UNKNOWN);
+
+    poll->pollfdValue.events = events;
+    return (updateEpoll(poll->pollfdValue.fd));
+}
+
+/**
+ * returns the poll of a handle
+ * @param handle
+ * @return the poll, NULL if the handle is not in use
+ */
+CAmSocketHandler::sh_poll_s* CAmSocketHandler::getPoll(const sh_pollHandle_t handle)
+{
+    if (handle == 0 || handle > mListPoll.size() || !mListPoll[handle - 1].isValid)
+        return (NULL);
+    return (&mListPoll[handle - 1]);
+}
+
+/**
+ * registers a filedescriptor at epoll with the events of all polls on it.
+ * The same filedescriptor can be polled more than once (dbus uses one watch for reading and one for writing),
+ * epoll only takes it once, so the events are merged here and split up again in dispatchFired.
+ * @param fd the filedescriptor
+ * @return E_OK on success, E_NOT_POSSIBLE if epoll did not accept the filedescriptor
+ */
+am_Error_e CAmSocketHandler::updateEpoll(const int fd)
+{
+    epoll_event event;
+    event.events = 0;
+    event.data.u64 = 0;
+    event.data.fd = fd;
+
+    sh_pollHandle_t handle = mListFdFirstHandle[fd];
+    if (handle == 0)
     {
-        if (it->handle == handle)
+        //the filedescriptor might be closed already, then epoll removed it on its own
+        epoll_ctl(mEpollFd, EPOLL_CTL_DEL, fd, &event);
+        return (E_OK);
+    }
+
+    for (; handle != 0; handle = mListPoll[handle - 1].nextOnFd)
+        event.events |= (unsigned short) mListPoll[handle - 1].pollfdValue.events;
+
+    if (epoll_ctl(mEpollFd, EPOLL_CTL_MOD, fd, &event) == 0)
+        return (E_OK);
+    if (errno == ENOENT && epoll_ctl(mEpollFd, EPOLL_CTL_ADD, fd, &event) == 0)
+        return (E_OK);
+
+    logError("SocketHandler::updateEpoll could not register filedescriptor", fd, "error", errno);
+    return (E_NOT_POSSIBLE);
+}
+
+/**
+ * calls the callbacks of all polls that fired.
+ * The handles are collected on mListFired, which keeps its memory between the loops.
+ * Polls that are removed in one of the callbacks are skipped in the following stages.
+ * @param numberEvents the number of events returned by epoll_pwait
+ */
+void CAmSocketHandler::dispatchFired(const int numberEvents)
+{
+    mListFired.clear();
+    for (int i = 0; i < numberEvents; i++)
+    {
+        const int fd = mListEpollEvent[i].data.fd;
+        const short revents = mListEpollEvent[i].events;
+        if ((size_t) fd >= mListFdFirstHandle.size())
+            continue;
+
+        for (sh_pollHandle_t handle = mListFdFirstHandle[fd]; handle != 0; handle = mListPoll[handle - 1].nextOnFd)
         {
-            timerItem = *it;
-            found = true;
-            break;
+            pollfd& pollfdValue = mListPoll[handle - 1].pollfdValue;
+            pollfdValue.revents = revents & (pollfdValue.events | POLLERR | POLLHUP);
+            if (pollfdValue.revents != 0)
+            {
+                mListFired.push_back(handle);
+                mListPoll[handle - 1].wakeups++;
+            }
         }
     }
-    if (!found)
-        return (E_NON_EXISTENT);
 
-    found = false;
+    //the callbacks may add polls, so the slots are copied before each call
+    sh_poll_s poll;
+    size_t numberLeft;
+    timespec start;
 
-    //we add here the time difference between startTime and currenttime, because this time will be substracted later on in timecorrection
-    timespec currentTime, timeoutsCorrected;
-    clock_gettime(CLOCK_MONOTONIC, &currentTime);
-    if (!gDispatchDone) //the mainloop is started
+    //stage 1, call firedCB
+    for (size_t i = 0; i < mListFired.size(); i++)
+    {
+        sh_poll_s* firedPoll = getPoll(mListFired[i]);
+        if (!firedPoll || !firedPoll->firedCB)
+            continue;
+        poll = *firedPoll;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        poll.firedCB->Call(poll.pollfdValue, poll.handle, poll.userData);
+        addDispatchTime(poll.handle, start);
+    }
+
+    //stage 2, lets ask around if some dispatching is necessary, the ones who need stay on the list
+    numberLeft = 0;
+    for (size_t i = 0; i < mListFired.size(); i++)
     {
-        timeoutsCorrected = timespecAdd(timerItem.countdown, timespecSub(currentTime, mStartTime));
-        timerItem.countdown = timeoutsCorrected;
+        sh_poll_s* firedPoll = getPoll(mListFired[i]);
+        if (!firedPoll || !firedPoll->checkCB)
+            continue;
+        poll = *firedPoll;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (poll.checkCB->Call(poll.handle, poll.userData))
+            mListFired[numberLeft++] = poll.handle;
+        addDispatchTime(poll.handle, start);
     }
+    mListFired.resize(numberLeft);
 
-    for (; activeIt != mListActiveTimer.end(); ++activeIt)
+    //stage 3, the ones left need to dispatch, we do this as long as there is something to dispatch..
+    while (!mListFired.empty())
     {
-        if (activeIt->handle == handle)
+        numberLeft = 0;
+        for (size_t i = 0; i < mListFired.size(); i++)
         {
-            activeIt->countdown = timerItem.countdown;
-            found = true;
-            break;
+            sh_poll_s* firedPoll = getPoll(mListFired[i]);
+            if (!firedPoll || !firedPoll->dispatchCB)
+                continue;
+            poll = *firedPoll;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            if (poll.dispatchCB->Call(poll.handle, poll.userData))
+                mListFired[numberLeft++] = poll.handle;
+            addDispatchTime(poll.handle, start);
         }
+        mListFired.resize(numberLeft);
     }
+}
 
-    if (!found)
-        mListActiveTimer.push_back(timerItem);
-
-    mListActiveTimer.sort(compareCountdown);
-
-    return (E_OK);
+/**
+ * adds the time since start to the dispatch time of a poll. Slots of removed polls are only reused in the next loop, so
+ * the slot still belongs to the poll.
+ * @param handle the handle of the poll
+ * @param start the time the callback was called
+ */
+void CAmSocketHandler::addDispatchTime(const sh_pollHandle_t handle, const timespec& start)
+{
+    mListPoll[handle - 1].dispatchNs += elapsedNs(start);
 }
 
 /**
- * stops a timer
- * @param handle
- * @return E_OK on success, E_NON_EXISTENT if the handle was not found
+ * returns the counters of the mainloop
+ * @param wakeups number of times the mainloop woke up
+ * @param busyNs time spent between the wakeups and the next wait in nanoseconds
+ * @param listPolls the counters of each registered filedescriptor
  */
-am_Error_e CAmSocketHandler::stopTimer(const sh_timerHandle_t handle)
+void CAmSocketHandler::getStatistics(uint32_t& wakeups, uint64_t& busyNs, std::vector<sh_pollStatistic_s>& listPolls) const
 {
-    //go through the list and remove the timer with the handle
-    std::list<sh_timer_s>::iterator it(mListActiveTimer.begin());
-    for (; it != mListActiveTimer.end(); ++it)
+    wakeups = mWakeups;
+    busyNs = mBusyNs;
+    listPolls.clear();
+    sh_pollStatistic_s statistic;
+    mListPoll_t::const_iterator iter = mListPoll.begin();
+    for (; iter != mListPoll.end(); ++iter)
     {
-        if (it->handle == handle)
-        {
-            it = mListActiveTimer.erase(it);
-            return (E_OK);
-        }
+        if (!iter->isValid)
+            continue;
+        statistic.handle = iter->handle;
+        statistic.fd = iter->pollfdValue.fd;
+        statistic.wakeups = iter->wakeups;
+        statistic.dispatchNs = iter->dispatchNs;
+        listPolls.push_back(statistic);
     }
-    return (E_NON_EXISTENT);
 }
 
 /**
- * updates the eventFlags of a poll
- * @param handle
- * @param events
- * @return @return E_OK on succsess, E_NON_EXISTENT if fd was not found
+ * sets all counters of the mainloop to 0
  */
-am_Error_e CAmSocketHandler::updateEventFlags(const sh_pollHandle_t handle, const short events)
+void CAmSocketHandler::resetStatistics()
 {
-    mListPoll_t::iterator iterator = mListPoll.begin();
-
-    for (; iterator != mListPoll.end(); ++iterator)
+    mWakeups = 0;
+    mBusyNs = 0;
+    mListPoll_t::iterator iter = mListPoll.begin();
+    for (; iter != mListPoll.end(); ++iter)
     {
-        if (iterator->handle == handle)
-        {
-            iterator->pollfdValue.events = events;
-            mRecreatePollfds = true;
-            return (E_OK);
-        }
+        iter->wakeups = 0;
+        iter->dispatchNs = 0;
     }
-    return (E_UNKNOWN);
 }
 
 /**
@@ -458,63 +619,145 @@ bool CAmSocketHandler::fdIsValid(const int fd) const
 }
 
 /**
- * timer is up.
+ * returns the timer of a handle
+ * @param handle
+ * @return the timer, NULL if the handle is not in use
  */
-void CAmSocketHandler::timerUp()
+CAmSocketHandler::sh_timer_s* CAmSocketHandler::getTimer(const sh_timerHandle_t handle)
 {
-    //find out the timedifference to starttime
-    timespec currentTime, diffTime;
-    clock_gettime(CLOCK_MONOTONIC, &currentTime);
-    diffTime = timespecSub(currentTime, mStartTime);
-
-    //now we need to substract the diffTime from all timers and see if they are up
-    std::list<sh_timer_s>::reverse_iterator overflowIter = std::find_if(mListActiveTimer.rbegin(), mListActiveTimer.rend(), CAmShCountdownUp(diffTime));
+    if (handle == 0 || handle > mListTimer.size() || !mListTimer[handle - 1].isValid)
+        return (NULL);
+    return (&mListTimer[handle - 1]);
+}
 
-    //copy all fired timers into a list
-    std::vector<sh_timer_s> tempList(overflowIter, mListActiveTimer.rend());
+/**
+ * starts a new run of a timer, a run that is still going on is replaced
+ * @param timer
+ */
+void CAmSocketHandler::startTimer(sh_timer_s& timer)
+{
+    sh_timerDeadline_s entry;
+    clock_gettime(CLOCK_MONOTONIC, &entry.deadline);
+    entry.deadline = timespecAdd(entry.deadline, timer.timeout);
+    entry.handle = timer.handle;
+    entry.sequence = timer.sequence = ++mTimerSequence;
+
+    if (!timer.isActive)
+        mNumberActiveTimer++;
+    timer.isActive = true;
+
+    //restarted and stopped timers leave their old entries behind, clean up before they outnumber the running ones
+    if (mListActiveTimer.size() > 2 * mNumberActiveTimer + 16)
+        removeStaleTimerRuns();
+
+    mListActiveTimer.push_back(entry);
+    std::push_heap(mListActiveTimer.begin(), mListActiveTimer.end(), compareDeadline);
+}
 
-    //erase all fired timers
-    std::list<sh_timer_s>::iterator it(overflowIter.base());
-    mListActiveTimer.erase(mListActiveTimer.begin(), it);
+/**
+ * checks if a heap entry belongs to a run of a timer that was stopped, restarted or removed
+ * @param entry
+ * @return true if the entry is to be ignored
+ */
+bool CAmSocketHandler::isTimerRunStale(const sh_timerDeadline_s& entry)
+{
+    sh_timer_s* timer = getTimer(entry.handle);
+    return (!timer || !timer->isActive || timer->sequence != entry.sequence);
+}
 
-    //call the callbacks for the timers
-    std::for_each(tempList.begin(), tempList.end(), CAmShCallTimer());
+/**
+ * rebuilds the heap with the entries of the running timers only
+ */
+void CAmSocketHandler::removeStaleTimerRuns()
+{
+    size_t numberLeft = 0;
+    for (size_t i = 0; i < mListActiveTimer.size(); i++)
+    {
+        if (!isTimerRunStale(mListActiveTimer[i]))
+            mListActiveTimer[numberLeft++] = mListActiveTimer[i];
+    }
+    mListActiveTimer.resize(numberLeft);
+    std::make_heap(mListActiveTimer.begin(), mListActiveTimer.end(), compareDeadline);
 }
 
 /**
- * correct timers and fire the ones who are up
+ * calls the callbacks of all timers that are up.
  */
-void CAmSocketHandler::timerCorrection()
+void CAmSocketHandler::timerUp()
 {
-    //get the current time and calculate the correction value
-    timespec currentTime, correctionTime;
+    if (mListActiveTimer.empty())
+        return;
+
+    timespec currentTime;
     clock_gettime(CLOCK_MONOTONIC, &currentTime);
-    correctionTime = timespecSub(currentTime, mStartTime);
-    mStartTime = currentTime;
 
-    if (!mListActiveTimer.empty())
+    //timers that are started in the callbacks are due after currentTime, so this ends
+    while (!mListActiveTimer.empty())
     {
+        sh_timerDeadline_s entry = mListActiveTimer.front();
+        bool stale = isTimerRunStale(entry);
+        if (!stale && timespecCompare(entry.deadline, currentTime) > 0)
+            break;
+
+        std::pop_heap(mListActiveTimer.begin(), mListActiveTimer.end(), compareDeadline);
+        mListActiveTimer.pop_back();
+        if (stale)
+            continue;
+
+        sh_timer_s& timer = mListTimer[entry.handle - 1];
+        timer.isActive = false;
+        mNumberActiveTimer--;
+        IAmShTimerCallBack* callback = timer.callback;
+        void* userData = timer.userData;
+        callback->Call(entry.handle, userData);
+    }
+}
 
-        //subtract the correction value from all items in the list
-        std::for_each(mListActiveTimer.begin(), mListActiveTimer.end(), CAmShSubstractTime(correctionTime));
+/**
+ * arms the timerfd with the deadline of the next timer
+ */
+void CAmSocketHandler::armTimerFd()
+{
+    if (mTimerFd == -1)
+        return;
 
-        //find the last occurrence of zero -> timer overflowed
-        std::list<sh_timer_s>::reverse_iterator overflowIter = std::find_if(mListActiveTimer.rbegin(), mListActiveTimer.rend(), CAmShCountdownZero());
+    //drop the stopped runs from the front, so that the timerfd does not wake up for nothing
+    while (!mListActiveTimer.empty() && isTimerRunStale(mListActiveTimer.front()))
+    {
+        std::pop_heap(mListActiveTimer.begin(), mListActiveTimer.end(), compareDeadline);
+        mListActiveTimer.pop_back();
+    }
 
-        //only if a timer overflowed
-        if (overflowIter != mListActiveTimer.rend())
-        {
-            //copy all timers that need to be called to a new list
-            std::vector<sh_timer_s> tempList(overflowIter, mListActiveTimer.rend());
+    itimerspec timerValue;
+    timerValue.it_interval.tv_sec = timerValue.it_interval.tv_nsec = 0;
+    timerValue.it_value.tv_sec = timerValue.it_value.tv_nsec = 0;
+    if (!mListActiveTimer.empty())
+        timerValue.it_value = mListActiveTimer.front().deadline;
 
-            //erase all fired timers
-            std::list<sh_timer_s>::iterator it(overflowIter.base());
-            mListActiveTimer.erase(mListActiveTimer.begin(), it);
+    if (timespecCompare(timerValue.it_value, mTimerFdDeadline) == 0)
+        return;
 
-            //call the callbacks for the timers
-            std::for_each(tempList.begin(), tempList.end(), CAmShCallTimer());
-        }
+    if (timerfd_settime(mTimerFd, TFD_TIMER_ABSTIME, &timerValue, NULL) == -1)
+    {
+        logError("SocketHandler::armTimerFd timerfd_settime failed", errno);
+        return;
     }
+    mTimerFdDeadline = timerValue.it_value;
+}
+
+/**
+ * the timerfd fired, the timers are called after the dispatching
+ */
+void CAmSocketHandler::timerFdCallback(const pollfd pollfd, const sh_pollHandle_t handle, void* userData)
+{
+    (void) handle;
+    (void) userData;
+    uint64_t expirations;
+    if (read(pollfd.fd, &expirations, sizeof(expirations)) == -1 && errno != EAGAIN)
+        logError("SocketHandler::timerFdCallback could not read timerfd", errno);
+
+    //the timerfd is disarmed now
+    mTimerFdDeadline.tv_sec = mTimerFdDeadline.tv_nsec = 0;
 }
 
 void CAmSocketHandler::exit_mainloop()
@@ -536,22 +779,19 @@ void CAmSocketHandler::static_exit_mainloop()
 }
 
 /**
- * is used to set the pointer for the ppoll command
+ * is used to get the timeout of the next timer for epoll_pwait, if there is no timerfd
  * @param buffertime
- * @return
+ * @return the time until the next timer is up, NULL if the timerfd is used or no timer is running
  */
 inline timespec* CAmSocketHandler::insertTime(timespec& buffertime)
 {
-    if (!mListActiveTimer.empty())
-    {
-        buffertime = mListActiveTimer.front().countdown;
-        return (&buffertime);
-    }
-    else
-    {
+    if (mTimerFd != -1 || mListActiveTimer.empty())
         return (NULL);
-    }
-}
 
+    timespec currentTime;
+    clock_gettime(CLOCK_MONOTONIC, &currentTime);
+    buffertime = timespecSub(mListActiveTimer.front().deadline, currentTime);
+    return (&buffertime);
 }
 
+}
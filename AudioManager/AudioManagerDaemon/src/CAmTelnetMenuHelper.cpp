@@ -22,31 +22,35 @@
 
 #include "CAmTelnetMenuHelper.h"
 #include <cassert>
+#include <iomanip>
 #include "config.h"
 #include "CAmRouter.h"
 #include "CAmTelnetServer.h"
-#include "CAmDatabaseHandler.h"
+#include "IAmDatabaseHandler.h"
 #include "CAmControlSender.h"
 #include "CAmCommandSender.h"
 #include "CAmRoutingSender.h"
 #include "CAmRoutingReceiver.h"
 #include "CAmCommandReceiver.h"
 #include "CAmControlReceiver.h"
+#include "CAmDatabaseObserver.h"
 #include "shared/CAmDltWrapper.h"
 
 static const std::string COLOR_WELCOME("\033[1;33m\033[44m");
 static const std::string COLOR_HEAD("\033[1m\033[42m");
 static const std::string COLOR_DEFAULT("\033[0m");
 
+#define MAX_NS 1000000000L
+
 
 namespace am {
 
 CAmTelnetMenuHelper* CAmTelnetMenuHelper::instance = NULL;
 
 /****************************************************************************/
-CAmTelnetMenuHelper::CAmTelnetMenuHelper(CAmSocketHandler *iSocketHandler, CAmCommandSender *iCommandSender, CAmCommandReceiver *iCommandReceiver, CAmRoutingSender *iRoutingSender, CAmRoutingReceiver *iRoutingReceiver, CAmControlSender *iControlSender, CAmControlReceiver *iControlReceiver, CAmDatabaseHandler *iDatabasehandler, CAmRouter *iRouter, CAmTelnetServer *iTelnetServer)
+CAmTelnetMenuHelper::CAmTelnetMenuHelper(CAmSocketHandler *iSocketHandler, CAmCommandSender *iCommandSender, CAmCommandReceiver *iCommandReceiver, CAmRoutingSender *iRoutingSender, CAmRoutingReceiver *iRoutingReceiver, CAmControlSender *iControlSender, CAmControlReceiver *iControlReceiver, IAmDatabaseHandler *iDatabasehandler, CAmRouter *iRouter, CAmTelnetServer *iTelnetServer)
 /****************************************************************************/
-:mpTelenetServer(iTelnetServer), mpSocketHandler(iSocketHandler), mpCommandSender(iCommandSender), mpCommandReceiver(iCommandReceiver), mpRoutingSender(iRoutingSender), mpRoutingReceiver(iRoutingReceiver), mpControlSender(iControlSender), mpControlReceiver(iControlReceiver), mpDatabasehandler(iDatabasehandler), mpRouter(iRouter)
+:perfTimerCB(this, &CAmTelnetMenuHelper::perfTimerCallback), mpTelenetServer(iTelnetServer), mpSocketHandler(iSocketHandler), mpCommandSender(iCommandSender), mpCommandReceiver(iCommandReceiver), mpRoutingSender(iRoutingSender), mpRoutingReceiver(iRoutingReceiver), mpControlSender(iControlSender), mpControlReceiver(iControlReceiver), mpDatabasehandler(iDatabasehandler), mpRouter(iRouter), mpDatabaseObserver(NULL), mMapPerfSessions()
 {
     instance = this;
     createCommandMaps();
@@ -56,6 +60,19 @@ CAmTelnetMenuHelper::CAmTelnetMenuHelper(CAmSocketHandler *iSocketHandler, CAmCo
 CAmTelnetMenuHelper::~CAmTelnetMenuHelper()
 /****************************************************************************/
 {
+    std::map<int, perfSession_s>::iterator it = mMapPerfSessions.begin();
+    for (; it != mMapPerfSessions.end(); ++it)
+    {
+        if (it->second.timer != 0)
+            mpSocketHandler->removeTimer(it->second.timer);
+    }
+}
+
+/****************************************************************************/
+void CAmTelnetMenuHelper::setDatabaseObserver(CAmDatabaseObserver *iDatabaseObserver)
+/****************************************************************************/
+{
+    mpDatabaseObserver = iDatabaseObserver;
 }
 
 /****************************************************************************/
@@ -68,6 +85,7 @@ void CAmTelnetMenuHelper::createCommandMaps()
     mRootCommands.insert(std::make_pair("list", sCommandPrototypeInfo("Go into 'list'-submenu", &CAmTelnetMenuHelper::rootListCommand)));
     mRootCommands.insert(std::make_pair("info", sCommandPrototypeInfo("Go into 'info'-submenu", &CAmTelnetMenuHelper::rootInfoCommand)));
     mRootCommands.insert(std::make_pair("set", sCommandPrototypeInfo("Go into 'set'-submenu", &CAmTelnetMenuHelper::rootSetCommand)));
+    mRootCommands.insert(std::make_pair("perf", sCommandPrototypeInfo("Go into 'perf'-submenu", &CAmTelnetMenuHelper::rootPerfCommand)));
     mRootCommands.insert(std::make_pair("get", sCommandPrototypeInfo("Go into 'get'-submenu", &CAmTelnetMenuHelper::rootGetCommand)));
     mRootCommands.insert(std::make_pair("exit", sCommandPrototypeInfo("quit telnet session", &CAmTelnetMenuHelper::exitCommand)));
     // List commands
@@ -105,8 +123,17 @@ void CAmTelnetMenuHelper::createCommandMaps()
     // Info comands
     mInfoCommands.insert(std::make_pair("help", sCommandPrototypeInfo(std::string("show all possible commands"), &CAmTelnetMenuHelper::helpCommand)));
     mInfoCommands.insert(std::make_pair("sysprop", sCommandPrototypeInfo("show all systemproperties", &CAmTelnetMenuHelper::infoSystempropertiesCommand)));
+    mInfoCommands.insert(std::make_pair("routecache", sCommandPrototypeInfo("show the counters of the route cache", &CAmTelnetMenuHelper::infoRouteCacheCommand)));
+    mInfoCommands.insert(std::make_pair("handles", sCommandPrototypeInfo("show the latencies of the finished handles\n\t  per handle type and routing plugin", &CAmTelnetMenuHelper::infoHandlesCommand)));
     mInfoCommands.insert(std::make_pair("..", sCommandPrototypeInfo("one step back in menu tree (back to root folder)", &CAmTelnetMenuHelper::oneStepBackCommand)));
     mInfoCommands.insert(std::make_pair("exit", sCommandPrototypeInfo("close telnet session", &CAmTelnetMenuHelper::exitCommand)));
+    // Perf commands
+    mPerfCommands.insert(std::make_pair("help", sCommandPrototypeInfo(std::string("show all possible commands"), &CAmTelnetMenuHelper::helpCommand)));
+    mPerfCommands.insert(std::make_pair("show", sCommandPrototypeInfo("show the performance counters, the rates are\n\t  calculated since the last output", &CAmTelnetMenuHelper::perfShowCommand)));
+    mPerfCommands.insert(std::make_pair("reset", sCommandPrototypeInfo("reset all performance counters", &CAmTelnetMenuHelper::perfResetCommand)));
+    mPerfCommands.insert(std::make_pair("stream", sCommandPrototypeInfo("use 'stream seconds' to show the counters\n\t  periodically, 'stream 0' stops", &CAmTelnetMenuHelper::perfStreamCommand)));
+    mPerfCommands.insert(std::make_pair("..", sCommandPrototypeInfo("one step back in menu tree (back to root folder)", &CAmTelnetMenuHelper::oneStepBackCommand)));
+    mPerfCommands.insert(std::make_pair("exit", sCommandPrototypeInfo("close telnet session", &CAmTelnetMenuHelper::exitCommand)));
 }
 
 /****************************************************************************/
@@ -145,6 +172,8 @@ void CAmTelnetMenuHelper::socketConnectionsClosed(int filedescriptor)
     {
         logError("[TN] socketConnectionsClosed, fd not found, ", filedescriptor);
     }
+    stopPerfStream(filedescriptor);
+    mMapPerfSessions.erase(filedescriptor);
 }
 
 /****************************************************************************/
@@ -203,6 +232,14 @@ void CAmTelnetMenuHelper::enterCmdQueue(std::queue<std::string>& CmdQueue, int&
             else
                 sendError(filedescriptor, "Command not found\n");
 
+            break;
+        case ePerfState:
+            cmditer = mPerfCommands.find(cmd);
+            if (mPerfCommands.end() != cmditer)
+                cmditer->second.CommandPrototype(CmdQueue, filedescriptor);
+            else
+                sendError(filedescriptor, "Command not found\n");
+
             break;
         default:
             break;
@@ -253,6 +290,9 @@ void CAmTelnetMenuHelper::sendCurrentCmdPrompt(int& filedescriptor)
         case eInfoState:
             outputstream << "\\Info>";
             break;
+        case ePerfState:
+            outputstream << "\\Perf>";
+            break;
         default:
             break;
         }
@@ -301,6 +341,9 @@ void CAmTelnetMenuHelper::oneStepBackCommandExec(std::queue<std::string>& CmdQue
             it->second = eRootState;
             ;
             break;
+        case ePerfState:
+            it->second = eRootState;
+            break;
         default:
             it->second = eRootState;
             break;
@@ -329,6 +372,8 @@ void CAmTelnetMenuHelper::exitCommandExec(std::queue<std::string>& CmdQueue, int
     output << "bye!" << COLOR_DEFAULT << std::endl;
     sendTelnetLine(filedescriptor, output);
     tCommandMap::iterator iter;
+    stopPerfStream(filedescriptor);
+    mMapPerfSessions.erase(filedescriptor);
     it = mCurrentMainStateMap.find(filedescriptor);
     if (it != mCurrentMainStateMap.end())
     {
@@ -408,6 +453,14 @@ void CAmTelnetMenuHelper::helpCommandExec(std::queue<std::string>& CmdQueue, int
                 cmdIter++;
             }
             break;
+        case ePerfState:
+            cmdIter = mPerfCommands.begin();
+            while (cmdIter != mPerfCommands.end())
+            {
+                line << cmdIter->first << "\t\t- " << cmdIter->second.info << std::endl;
+                cmdIter++;
+            }
+            break;
         default:
             break;
         }
@@ -497,6 +550,26 @@ void CAmTelnetMenuHelper::rootInfoCommandExec(std::queue<std::string>& CmdQueue,
     }
 }
 
+/****************************************************************************/
+void CAmTelnetMenuHelper::rootPerfCommand(std::queue<std::string>& CmdQueue, int& filedescriptor)
+/****************************************************************************/
+{
+    instance->rootPerfCommandExec(CmdQueue, filedescriptor);
+}
+
+/****************************************************************************/
+void CAmTelnetMenuHelper::rootPerfCommandExec(std::queue<std::string>& CmdQueue, int& filedescriptor)
+/****************************************************************************/
+{
+    (void) (CmdQueue);
+    std::map<int, EMainState>::iterator it;
+    it = mCurrentMainStateMap.find(filedescriptor);
+    if (it != mCurrentMainStateMap.end())
+    {
+        it->second = ePerfState;
+    }
+}
+
 /****************************************************************************/
 void CAmTelnetMenuHelper::listConnectionsCommand(std::queue<std::string>& CmdQueue, int& filedescriptor)
 /****************************************************************************/
@@ -932,6 +1005,368 @@ void CAmTelnetMenuHelper::infoSystempropertiesCommandExec(std::queue<std::string
     }
 }
 
+/****************************************************************************/
+void CAmTelnetMenuHelper::infoRouteCacheCommand(std::queue<std::string>& CmdQueue, int& filedescriptor)
+/****************************************************************************/
+{
+    instance->infoRouteCacheCommandExec(CmdQueue, filedescriptor);
+}
+
+/****************************************************************************/
+void CAmTelnetMenuHelper::infoRouteCacheCommandExec(std::queue<std::string>& CmdQueue, int& filedescriptor)
+/****************************************************************************/
+{
+    (void) (CmdQueue);
+    uint32_t hits, misses, invalidations;
+    size_t entries;
+    mpRouter->getRouteCacheStatistics(hits, misses, invalidations, entries);
+    std::stringstream output;
+    output << "\tRoute cache: " << entries << " entries" << std::endl;
+    output << "\tHits: " << hits << " Misses: " << misses << " Invalidations: " << invalidations << std::endl;
+    sendTelnetLine(filedescriptor, output);
+}
+
+/****************************************************************************/
+void CAmTelnetMenuHelper::infoHandlesCommand(std::queue<std::string>& CmdQueue, int& filedescriptor)
+/****************************************************************************/
+{
+    instance->infoHandlesCommandExec(CmdQueue, filedescriptor);
+}
+
+/****************************************************************************/
+void CAmTelnetMenuHelper::infoHandlesCommandExec(std::queue<std::string>& CmdQueue, int& filedescriptor)
+/****************************************************************************/
+{
+    (void) (CmdQueue);
+    static const char* handleNames[H_MAX] =
+    { "UNKNOWN", "CONNECT", "DISCONNECT", "SETSOURCESTATE", "SETSINKVOLUME", "SETSOURCEVOLUME", "SETSINKSOUNDPROPERTY", "SETSOURCESOUNDPROPERTY", "SETSINKSOUNDPROPERTIES", "SETSOURCESOUNDPROPERTIES", "CROSSFADE" };
+    std::vector<CAmRoutingSender::handleStatistic_s> listStatistics;
+    mpRoutingSender->getHandleStatistics(listStatistics);
+    std::stringstream output;
+    output << "\tHandle latencies in us (average over the handles, max of creation to removal):" << std::endl;
+    std::vector<CAmRoutingSender::handleStatistic_s>::const_iterator iter = listStatistics.begin();
+    for (; iter != listStatistics.end(); ++iter)
+    {
+        output << "\t" << iter->busName << " " << (iter->handleType < H_MAX ? handleNames[iter->handleType] : "?") << ": " << iter->count << " handles";
+        output << ", dispatch: " << iter->dispatchNs / iter->count / 1000 << ", plugin: " << iter->pluginNs / iter->count / 1000;
+        output << ", store: " << iter->storeNs / iter->count / 1000 << ", max: " << iter->maxNs / 1000 << std::endl;
+        output << "\t  histogram (<1ms <2ms <4ms ...):";
+        for (int i = 0; i < HANDLE_LATENCY_BUCKETS; i++)
+            output << " " << iter->histogram[i];
+        output << std::endl;
+    }
+    std::vector<uint16_t> listCounts;
+    mpRoutingSender->getOutstandingHandles(listCounts);
+    output << "\tOutstanding handles:";
+    for (size_t type = H_CONNECT; type < listCounts.size(); type++)
+        output << " " << handleNames[type] << ": " << listCounts[type];
+    output << std::endl;
+    sendTelnetLine(filedescriptor, output);
+}
+
+/****************************************************************************/
+void CAmTelnetMenuHelper::perfShowCommand(std::queue<std::string>& CmdQueue, int& filedescriptor)
+/****************************************************************************/
+{
+    instance->perfShowCommandExec(CmdQueue, filedescriptor);
+}
+
+/****************************************************************************/
+void CAmTelnetMenuHelper::perfShowCommandExec(std::queue<std::string>& CmdQueue, int& filedescriptor)
+/****************************************************************************/
+{
+    (void) (CmdQueue);
+    std::stringstream output;
+    writePerfCounters(filedescriptor, output);
+    sendTelnetLine(filedescriptor, output);
+}
+
+/****************************************************************************/
+void CAmTelnetMenuHelper::perfResetCommand(std::queue<std::string>& CmdQueue, int& filedescriptor)
+/****************************************************************************/
+{
+    instance->perfResetCommandExec(CmdQueue, filedescriptor);
+}
+
+/****************************************************************************/
+void CAmTelnetMenuHelper::perfResetCommandExec(std::queue<std::string>& CmdQueue, int& filedescriptor)
+/****************************************************************************/
+{
+    (void) (CmdQueue);
+    mpDatabasehandler->resetStatementStatistics();
+    mpRouter->resetRouteCacheStatistics();
+    mpSocketHandler->resetStatistics();
+    mpRoutingSender->resetHandleStatistics();
+    mpCommandSender->resetDeliveryStatistics();
+    if (mpDatabaseObserver)
+        mpDatabaseObserver->resetStatistics();
+
+    //the counters of all sessions start from zero again, so the rates are calculated from now on
+    perfCounters_s counters;
+    collectPerfCounters(counters);
+    std::map<int, perfSession_s>::iterator it = mMapPerfSessions.begin();
+    for (; it != mMapPerfSessions.end(); ++it)
+        it->second.counters = counters;
+
+    std::stringstream output;
+    output << "\tPerformance counters reset" << std::endl;
+    sendTelnetLine(filedescriptor, output);
+    logInfo("[TN] perfResetCommandExec, counters reset by fd ", filedescriptor);
+}
+
+/****************************************************************************/
+void CAmTelnetMenuHelper::perfStreamCommand(std::queue<std::string>& CmdQueue, int& filedescriptor)
+/****************************************************************************/
+{
+    instance->perfStreamCommandExec(CmdQueue, filedescriptor);
+}
+
+/****************************************************************************/
+void CAmTelnetMenuHelper::perfStreamCommandExec(std::queue<std::string>& CmdQueue, int& filedescriptor)
+/****************************************************************************/
+{
+    if (CmdQueue.empty())
+    {
+        sendError(filedescriptor, "Not enough arguments to stream, please enter 'seconds' after command");
+        return;
+    }
+    uint16_t seconds = 0;
+    std::istringstream istream_seconds(CmdQueue.front());
+    CmdQueue.pop();
+    if (!(istream_seconds >> seconds))
+    {
+        sendError(filedescriptor, "Error parsing stream 'seconds'");
+        return;
+    }
+
+    std::stringstream output;
+    if (seconds == 0)
+    {
+        stopPerfStream(filedescriptor);
+        output << "\tStreaming stopped" << std::endl;
+        sendTelnetLine(filedescriptor, output);
+        return;
+    }
+
+    //this also creates the session if it did not show the counters before
+    std::stringstream counters;
+    writePerfCounters(filedescriptor, counters);
+
+    timespec timeout;
+    timeout.tv_sec = seconds;
+    timeout.tv_nsec = 0;
+    perfSession_s& session = mMapPerfSessions[filedescriptor];
+    if (session.timer == 0)
+    {
+        if (E_OK != mpSocketHandler->addTimer(timeout, &perfTimerCB, session.timer, NULL))
+        {
+            session.timer = 0;
+            sendError(filedescriptor, "Error adding the stream timer");
+            return;
+        }
+    }
+    else
+    {
+        mpSocketHandler->updateTimer(session.timer, timeout);
+    }
+    output << "\tStreaming every " << seconds << " s, use 'stream 0' to stop" << std::endl << counters.str();
+    sendTelnetLine(filedescriptor, output);
+}
+
+/****************************************************************************/
+void CAmTelnetMenuHelper::perfTimerCallback(sh_timerHandle_t handle, void* userData)
+/****************************************************************************/
+{
+    (void) userData;
+    std::map<int, perfSession_s>::iterator it = mMapPerfSessions.begin();
+    for (; it != mMapPerfSessions.end(); ++it)
+    {
+        if (it->second.timer == handle)
+            break;
+    }
+    if (it == mMapPerfSessions.end())
+    {
+        logError("[TN] perfTimerCallback, no session for timer ", handle);
+        mpSocketHandler->removeTimer(handle);
+        return;
+    }
+
+    int filedescriptor = it->first;
+    std::stringstream output;
+    output << std::endl;
+    writePerfCounters(filedescriptor, output);
+    //the client might be gone without saying bye, so do not get killed by SIGPIPE but stop streaming
+    if (send(filedescriptor, output.str().c_str(), output.str().size(), MSG_NOSIGNAL) < 0)
+    {
+        logInfo("[TN] perfTimerCallback, could not send, stop streaming to fd ", filedescriptor);
+        stopPerfStream(filedescriptor);
+        return;
+    }
+    sendCurrentCmdPrompt(filedescriptor);
+    mpSocketHandler->restartTimer(handle);
+}
+
+/**
+ * takes the totals of all counters that are shown as rates
+ * @param counters the totals
+ */
+void CAmTelnetMenuHelper::collectPerfCounters(perfCounters_s& counters) const
+{
+    clock_gettime(CLOCK_MONOTONIC, &counters.time);
+
+    std::vector<IAmDatabaseHandler::statementClassStatistic_s> listStatements;
+    mpDatabasehandler->getStatementStatistics(listStatements);
+    counters.statements = 0;
+    std::vector<IAmDatabaseHandler::statementClassStatistic_s>::const_iterator statementIter = listStatements.begin();
+    for (; statementIter != listStatements.end(); ++statementIter)
+        counters.statements += statementIter->count;
+
+    uint32_t hits, invalidations;
+    size_t entries;
+    mpRouter->getRouteCacheStatistics(hits, counters.routeCalculations, invalidations, entries);
+
+    std::vector<CAmSocketHandler::sh_pollStatistic_s> listPolls;
+    mpSocketHandler->getStatistics(counters.wakeups, counters.busyNs, listPolls);
+
+    counters.serializerCalls = 0;
+    if (mpDatabaseObserver)
+    {
+        uint32_t depth, maxDepth;
+        mpDatabaseObserver->getQueueStatistics(depth, maxDepth, counters.serializerCalls);
+    }
+
+    std::vector<CAmRoutingSender::handleStatistic_s> listHandles;
+    mpRoutingSender->getHandleStatistics(listHandles);
+    counters.finishedHandles = 0;
+    std::vector<CAmRoutingSender::handleStatistic_s>::const_iterator handleIter = listHandles.begin();
+    for (; handleIter != listHandles.end(); ++handleIter)
+        counters.finishedHandles += handleIter->count;
+}
+
+/**
+ * writes all performance counters of the daemon. The rates are calculated against the counters of the last output to
+ * the same session, the first output of a session shows the totals only.
+ * @param filedescriptor the telnet session
+ * @param output the stream the counters are written to
+ */
+void CAmTelnetMenuHelper::writePerfCounters(const int filedescriptor, std::stringstream& output)
+{
+    perfCounters_s counters;
+    collectPerfCounters(counters);
+
+    std::map<int, perfSession_s>::iterator sessionIter = mMapPerfSessions.find(filedescriptor);
+    if (sessionIter == mMapPerfSessions.end())
+    {
+        perfSession_s newSession;
+        newSession.counters = counters;
+        newSession.timer = 0;
+        sessionIter = mMapPerfSessions.insert(std::make_pair(filedescriptor, newSession)).first;
+    }
+    perfCounters_s& last = sessionIter->second.counters;
+    double seconds = (counters.time.tv_sec - last.time.tv_sec) + (counters.time.tv_nsec - last.time.tv_nsec) / static_cast<double>(MAX_NS);
+    bool showRates = (seconds > 0.0);
+
+    output << std::fixed << std::setprecision(1);
+    if (showRates)
+        output << "\tPerformance counters, rates per second over the last " << seconds << " s:" << std::endl;
+    else
+        output << "\tPerformance counters, rates are shown from the next output on:" << std::endl;
+
+    //database
+    std::vector<IAmDatabaseHandler::statementClassStatistic_s> listStatements;
+    mpDatabasehandler->getStatementStatistics(listStatements);
+    output << "\tDatabase: " << counters.statements << " statements";
+    if (showRates)
+        output << ", " << (counters.statements - last.statements) / seconds << "/s";
+    output << std::endl;
+    std::vector<IAmDatabaseHandler::statementClassStatistic_s>::const_iterator statementIter = listStatements.begin();
+    for (; statementIter != listStatements.end(); ++statementIter)
+    {
+        output << "\t  " << statementIter->name << ": " << statementIter->count << " statements, " << statementIter->timeNs / 1000 << " us";
+        if (statementIter->count)
+            output << ", avg " << statementIter->timeNs / statementIter->count / 1000 << " us";
+        output << std::endl;
+    }
+
+    //router
+    uint32_t hits, misses, invalidations;
+    size_t entries;
+    mpRouter->getRouteCacheStatistics(hits, misses, invalidations, entries);
+    uint64_t calculationNs = mpRouter->getRouteCalculationTime();
+    output << "\tRouter: " << misses << " route calculations";
+    if (showRates)
+        output << ", " << (counters.routeCalculations - last.routeCalculations) / seconds << "/s";
+    if (misses)
+        output << ", avg " << calculationNs / misses / 1000 << " us";
+    output << ", cache hits: " << hits << ", invalidations: " << invalidations << std::endl;
+
+    //mainloop
+    uint32_t wakeups;
+    uint64_t busyNs;
+    std::vector<CAmSocketHandler::sh_pollStatistic_s> listPolls;
+    mpSocketHandler->getStatistics(wakeups, busyNs, listPolls);
+    output << "\tMainloop: " << wakeups << " wakeups, busy " << busyNs / 1000 << " us";
+    if (showRates)
+        output << ", " << (counters.wakeups - last.wakeups) / seconds << " wakeups/s, busy " << (counters.busyNs - last.busyNs) / (seconds * MAX_NS) * 100.0 << " %";
+    output << std::endl;
+    std::vector<CAmSocketHandler::sh_pollStatistic_s>::const_iterator pollIter = listPolls.begin();
+    for (; pollIter != listPolls.end(); ++pollIter)
+        output << "\t  fd " << pollIter->fd << " (handle " << pollIter->handle << "): " << pollIter->wakeups << " wakeups, " << pollIter->dispatchNs / 1000 << " us" << std::endl;
+
+    //database observer
+    if (mpDatabaseObserver)
+    {
+        uint32_t depth, maxDepth, calls, delivered, dropped;
+        uint64_t maxDelayNs;
+        mpDatabaseObserver->getQueueStatistics(depth, maxDepth, calls);
+        mpDatabaseObserver->getChangeStatistics(delivered, dropped, maxDelayNs);
+        output << "\tSerializer: queue depth " << depth << ", max " << maxDepth << ", " << calls << " calls";
+        if (showRates)
+            output << ", " << (counters.serializerCalls - last.serializerCalls) / seconds << "/s";
+        output << std::endl;
+        output << "\tValue changes: " << delivered << " delivered, " << dropped << " coalesced, max delay " << maxDelayNs / 1000 << " us" << std::endl;
+    }
+
+    //routing plugins
+    std::map<std::string, uint16_t> mapOutstanding;
+    mpRoutingSender->getOutstandingHandlesOfPlugins(mapOutstanding);
+    output << "\tRouting plugins: " << counters.finishedHandles << " finished handles";
+    if (showRates)
+        output << ", " << (counters.finishedHandles - last.finishedHandles) / seconds << "/s";
+    output << std::endl;
+    std::map<std::string, uint16_t>::const_iterator outstandingIter = mapOutstanding.begin();
+    for (; outstandingIter != mapOutstanding.end(); ++outstandingIter)
+        output << "\t  " << outstandingIter->first << ": " << outstandingIter->second << " outstanding handles" << std::endl;
+
+    //command plugins
+    std::vector<CAmCommandSender::deliveryStatistic_s> listDeliveries;
+    mpCommandSender->getDeliveryStatistics(listDeliveries);
+    output << "\tCommand plugins:" << std::endl;
+    std::vector<CAmCommandSender::deliveryStatistic_s>::const_iterator deliveryIter = listDeliveries.begin();
+    for (; deliveryIter != listDeliveries.end(); ++deliveryIter)
+    {
+        output << "\t  " << deliveryIter->plugin << ": " << deliveryIter->calls << " calls";
+        if (deliveryIter->calls)
+            output << ", avg " << deliveryIter->timeNs / deliveryIter->calls / 1000 << " us, max " << deliveryIter->maxTimeNs / 1000 << " us";
+        output << std::endl;
+    }
+
+    last = counters;
+}
+
+/**
+ * stops the periodic output of a session
+ * @param filedescriptor the telnet session
+ */
+void CAmTelnetMenuHelper::stopPerfStream(const int filedescriptor)
+{
+    std::map<int, perfSession_s>::iterator it = mMapPerfSessions.find(filedescriptor);
+    if (it == mMapPerfSessions.end() || it->second.timer == 0)
+        return;
+    mpSocketHandler->removeTimer(it->second.timer);
+    it->second.timer = 0;
+}
+
 /****************************************************************************/
 void CAmTelnetMenuHelper::setRoutingCommand(std::queue<std::string>& CmdQueue, int& filedescriptor)
 /****************************************************************************/
@@ -1309,6 +1744,22 @@ void CAmTelnetMenuHelper::listPluginsCommandExec(std::queue<std::string>& CmdQue
     {
         sendError(filedescriptor, "ERROR: mRoutingSender->getListPlugins");
     }
+
+    std::vector<pluginStartup_s> listStartup, listRoutingStartup;
+    mpCommandSender->getPluginStartupTimes(listStartup);
+    mpRoutingSender->getPluginStartupTimes(listRoutingStartup);
+    listStartup.insert(listStartup.end(), listRoutingStartup.begin(), listRoutingStartup.end());
+    output << std::endl << "\tStartup timeline in ms since boot (opened, created, started, ready):" << std::endl;
+    std::vector<pluginStartup_s>::const_iterator startupIter = listStartup.begin();
+    for (; startupIter != listStartup.end(); ++startupIter)
+    {
+        output << startupIter->name << (startupIter->deferred ? " (deferred)" : "") << ": " << startupIter->loadNs / 1000000 << ", " << startupIter->createdNs / 1000000;
+        output << ", " << startupIter->startupNs / 1000000 << ", ";
+        if (startupIter->readyNs)
+            output << startupIter->readyNs / 1000000 << std::endl;
+        else
+            output << "-" << std::endl;
+    }
     sendTelnetLine(filedescriptor, output);
 }
 
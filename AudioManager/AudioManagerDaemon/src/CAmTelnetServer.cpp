@@ -34,7 +34,7 @@
 #include <iostream>
 #include <iterator>
 #include <unistd.h>
-#include "CAmDatabaseHandler.h"
+#include "IAmDatabaseHandler.h"
 #include "CAmRoutingSender.h"
 #include "CAmTelnetMenuHelper.h"
 #include "shared/CAmDltWrapper.h"
@@ -46,7 +46,7 @@ CAmTelnetServer* CAmTelnetServer::mpInstance = NULL;
 
 #define PRINT_BOOL(var) var ? output+="true\t\t" : output+="false\t\t";
 
-CAmTelnetServer::CAmTelnetServer(CAmSocketHandler *iSocketHandler, CAmCommandSender *iCommandSender, CAmCommandReceiver *iCommandReceiver, CAmRoutingSender *iRoutingSender, CAmRoutingReceiver *iRoutingReceiver, CAmControlSender *iControlSender, CAmControlReceiver *iControlReceiver, CAmDatabaseHandler *iDatabasehandler, CAmRouter *iRouter, unsigned int servPort, unsigned int maxConnections) :
+CAmTelnetServer::CAmTelnetServer(CAmSocketHandler *iSocketHandler, CAmCommandSender *iCommandSender, CAmCommandReceiver *iCommandReceiver, CAmRoutingSender *iRoutingSender, CAmRoutingReceiver *iRoutingReceiver, CAmControlSender *iControlSender, CAmControlReceiver *iControlReceiver, IAmDatabaseHandler *iDatabasehandler, CAmRouter *iRouter, unsigned int servPort, unsigned int maxConnections) :
         telnetConnectFiredCB(this, &CAmTelnetServer::connectSocket), //
         telnetReceiveFiredCB(this, &CAmTelnetServer::receiveData), //
         telnetDispatchCB(this, &CAmTelnetServer::dispatchData), //
@@ -164,6 +164,15 @@ void CAmTelnetServer::disconnectClient(int filedescriptor)
     }
 }
 
+/**
+ * sets the database observer, so that the telnet sessions can show its counters
+ * @param iDatabaseObserver the observer
+ */
+void CAmTelnetServer::setDatabaseObserver(CAmDatabaseObserver *iDatabaseObserver)
+{
+    mTelnetMenuHelper.setDatabaseObserver(iDatabaseObserver);
+}
+
 void CAmTelnetServer::receiveData(const pollfd pollfd, const sh_pollHandle_t handle, void *userData)
 {
     (void) handle;
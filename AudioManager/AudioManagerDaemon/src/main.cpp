@@ -45,10 +45,15 @@
 #include <fcntl.h>
 #include <csignal>
 #include <cstring>
+#include <cctype>
+#include <algorithm>
 #include <cstdio>
 #include <new>
+#include <memory>
+#include <fstream>
 #include "CAmRouter.h"
 #include "CAmDatabaseHandler.h"
+#include "CAmDatabaseHandlerMap.h"
 #include "CAmControlSender.h"
 #include "CAmCommandSender.h"
 #include "CAmRoutingSender.h"
@@ -77,20 +82,31 @@ const char* USAGE_DESCRIPTION = "Usage:\tAudioManagerDaemon [options]\n"
         "\t-T: DbusType to be used by CAmDbusWrapper (0=DBUS_SESSION[default], 1=DBUS_SYSTEM)\t\n"
 #endif
         "\t-p<path> path for sqlite database (default is in memory)\t\n"
+        "\t-s<Name> database storage backend: sqlite[default] or map (in memory, no sql)\t\n"
+        "\t-D<key>=<value> sqlite setting: path, journal_mode, synchronous, cache_size or mmap_size\t\n"
+        "\t-f<file> read sqlite settings from <file>, one <key>=<value> per line\t\n"
         "\t-t<port> port for telnetconnection\t\n"
         "\t-m<max> number of max telnetconnections\t\n"
+        "\t-k<max> number of cheapest routes the router searches (default 0 returns all routes)\t\n"
         "\t-c<Name> use controllerPlugin <Name> (full path with .so ending)\t\n"
         "\t-l<Name> replace command plugin directory with <Name> (full path)\t\n"
         "\t-r<Name> replace routing plugin directory with <Name> (full path)\t\n"
         "\t-L<Name> add command plugin directory with <Name> (full path)\t\n"
-        "\t-R<Name> add routing plugin directory with <Name> (full path)\t\n";
+        "\t-R<Name> add routing plugin directory with <Name> (full path)\t\n"
+        "\t-j<threads> number of threads that load the command and routing plugins (default 1)\t\n"
+        "\t-a<Name> start plugin <Name> (file name with .so ending) after the first main connection is connected\t\n";
 
 std::string controllerPlugin = std::string(CONTROLLER_PLUGIN);
 std::vector<std::string> listCommandPluginDirs;
 std::vector<std::string> listRoutingPluginDirs;
 std::string databasePath = std::string(":memory:");
+std::string databaseStorage = std::string("sqlite");
+CAmDatabaseHandler::databaseSettings_s databaseSettings;
 unsigned int telnetport = DEFAULT_TELNETPORT;
 unsigned int maxConnections = MAX_TELNETCONNECTIONS;
+unsigned int maxRoutes = 0;
+unsigned int pluginLoadThreads = 1;
+std::vector<std::string> listDeferredPlugins;
 int fd0, fd1, fd2;
 bool enableNoDLTDebug = false;
 
@@ -159,6 +175,60 @@ void daemonize()
     }
 }
 
+/**
+ * applies one database setting. The key path selects the database file, :memory: keeps the database in memory.
+ * All other keys are sqlite pragmas, see CAmDatabaseHandler::databaseSettings_s.
+ * @param option the setting as <key>=<value>
+ * @return false if the setting is not valid
+ */
+bool setDatabaseOption(const std::string& option)
+{
+    size_t position = option.find('=');
+    if (position == std::string::npos)
+        return (false);
+
+    std::string key = option.substr(0, position);
+    std::string value = option.substr(position + 1);
+    if (key == "path")
+    {
+        if (value.empty())
+            return (false);
+        databasePath = value;
+        return (true);
+    }
+    return (databaseSettings.set(key, value));
+}
+
+/**
+ * reads the database settings from a file. Every line holds one <key>=<value>, empty lines and lines starting with # are
+ * ignored. Settings given on the commandline after the file overwrite the ones of the file.
+ * @param fileName the configuration file
+ * @return false if the file cannot be read or holds an invalid setting
+ */
+bool readDatabaseConfig(const char* fileName)
+{
+    std::ifstream file(fileName);
+    if (!file)
+    {
+        printf("Cannot read database configuration %s\n", fileName);
+        return (false);
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
+        if (line.empty() || line[0] == '#')
+            continue;
+        if (!setDatabaseOption(line))
+        {
+            printf("Invalid database setting %s in %s\n", line.c_str(), fileName);
+            return (false);
+        }
+    }
+    return (true);
+}
+
 /**
  * parses the command line
  * @param argc
@@ -170,15 +240,15 @@ void parseCommandLine(int argc, char **argv)
     {
 #ifdef WITH_DLT
     #ifdef WITH_DBUS_WRAPPER
-            int option = getopt(argc, argv, "h::v::c::l::r::L::R::d::t::m::i::p::T::");
+            int option = getopt(argc, argv, "h::v::c::l::r::L::R::d::t::m::k::i::p::T::s::D::f::j::a::");
     #else
-            int option = getopt(argc, argv, "h::v::c::l::r::L::R::d::t::m::i::p::");
+            int option = getopt(argc, argv, "h::v::c::l::r::L::R::d::t::m::k::i::p::s::D::f::j::a::");
     #endif //WITH_DBUS_WRAPPER
 #else
     #ifdef WITH_DBUS_WRAPPER
-            int option = getopt(argc, argv, "h::v::V::c::l::r::L::R::d::t::m::i::p::T::");
+            int option = getopt(argc, argv, "h::v::V::c::l::r::L::R::d::t::m::k::i::p::T::s::D::f::j::a::");
     #else
-            int option = getopt(argc, argv, "h::v::V::c::l::r::L::R::d::t::m::i::p::");
+            int option = getopt(argc, argv, "h::v::V::c::l::r::L::R::d::t::m::k::i::p::s::D::f::j::a::");
     #endif //WITH_DBUS_WRAPPER
 #endif
 
@@ -189,10 +259,19 @@ void parseCommandLine(int argc, char **argv)
             printf("\tAudioManagerDaemon Version:\t\t%s\n", DAEMONVERSION);
             printf("\tTelnet portNumber:\t\t\t%i\n", telnetport);
             printf("\tTelnet maxConnections:\t\t\t%i\n", maxConnections);
+            printf("\tRouter maxRoutes:\t\t\t%i\n", maxRoutes);
+            printf("\tDatabase storage backend:\t\t%s\n", databaseStorage.c_str());
             printf("\tSqlite Database path:\t\t\t%s\n", databasePath.c_str());
+            printf("\tSqlite journal_mode:\t\t\t%s\n", databaseSettings.journalMode.empty() ? "default" : databaseSettings.journalMode.c_str());
+            printf("\tSqlite synchronous:\t\t\t%s\n", databaseSettings.synchronous.empty() ? "default" : databaseSettings.synchronous.c_str());
+            printf("\tSqlite cache_size:\t\t\t%i\n", databaseSettings.cacheSize);
+            printf("\tSqlite mmap_size:\t\t\t%lli\n", (long long) databaseSettings.mmapSize);
             printf("\tControllerPlugin: \t\t\t%s\n", controllerPlugin.c_str());
             printf("\tDirectory of CommandPlugins: \t\t%s\n", listCommandPluginDirs.front().c_str());
             printf("\tDirectory of RoutingPlugins: \t\t%s\n", listRoutingPluginDirs.front().c_str());
+            printf("\tPlugin loader threads: \t\t\t%i\n", pluginLoadThreads);
+            for (std::vector<std::string>::const_iterator iter = listDeferredPlugins.begin(); iter != listDeferredPlugins.end(); ++iter)
+                printf("\tDeferred plugin: \t\t\t%s\n", iter->c_str());
             exit(0);
             break;
         case 't':
@@ -203,10 +282,41 @@ void parseCommandLine(int argc, char **argv)
             assert(atoi(optarg)!=0);
             maxConnections = atoi(optarg);
             break;
+        case 'k':
+            assert(optarg!=NULL);
+            maxRoutes = atoi(optarg);
+            break;
         case 'p':
             assert(!controllerPlugin.empty());
             databasePath = std::string(optarg);
             break;
+        case 's':
+            assert(optarg!=NULL);
+            databaseStorage = std::string(optarg);
+            if (databaseStorage != "sqlite" && databaseStorage != "map")
+            {
+                printf("Unknown database storage backend %s\n", optarg);
+                puts(USAGE_DESCRIPTION);
+                exit(-1);
+            }
+            break;
+        case 'D':
+            assert(optarg!=NULL);
+            if (!setDatabaseOption(std::string(optarg)))
+            {
+                printf("Invalid database setting %s\n", optarg);
+                puts(USAGE_DESCRIPTION);
+                exit(-1);
+            }
+            break;
+        case 'f':
+            assert(optarg!=NULL);
+            if (!readDatabaseConfig(optarg))
+            {
+                puts(USAGE_DESCRIPTION);
+                exit(-1);
+            }
+            break;
         case 'd':
             daemonize();
             break;
@@ -224,6 +334,15 @@ void parseCommandLine(int argc, char **argv)
         case 'R':
             listRoutingPluginDirs.push_back(std::string(optarg));
             break;
+        case 'j':
+            assert(atoi(optarg)!=0);
+            pluginLoadThreads = atoi(optarg);
+            break;
+        case 'a':
+            assert(optarg!=NULL);
+            assert(std::string(optarg).find(".so")!=std::string::npos);
+            listDeferredPlugins.push_back(std::string(optarg));
+            break;
         case 'c':
             controllerPlugin = std::string(optarg);
             assert(!controllerPlugin.empty());
@@ -289,11 +408,18 @@ void mainProgram()
     CAmWatchdog iWatchdog(&iSocketHandler);
 #endif /*WITH_SYSTEMD_WATCHDOG*/
 
-    CAmDatabaseHandler iDatabaseHandler(databasePath);
-    CAmRoutingSender iRoutingSender(listRoutingPluginDirs);
-    CAmCommandSender iCommandSender(listCommandPluginDirs);
+    //the storage backend is chosen on the commandline, the rest of the daemon only sees the interface
+    std::auto_ptr<IAmDatabaseHandler> pDatabaseHandler;
+    if (databaseStorage == "map")
+        pDatabaseHandler.reset(new CAmDatabaseHandlerMap());
+    else
+        pDatabaseHandler.reset(new CAmDatabaseHandler(databasePath, databaseSettings));
+    IAmDatabaseHandler& iDatabaseHandler(*pDatabaseHandler);
+    CAmRoutingSender iRoutingSender(listRoutingPluginDirs, pluginLoadThreads, listDeferredPlugins);
+    CAmCommandSender iCommandSender(listCommandPluginDirs, pluginLoadThreads, listDeferredPlugins);
     CAmControlSender iControlSender(controllerPlugin);
     CAmRouter iRouter(&iDatabaseHandler, &iControlSender);
+    iRouter.setMaxRoutes(maxRoutes);
 
 #ifdef WITH_DBUS_WRAPPER
     CAmCommandReceiver iCommandReceiver(&iDatabaseHandler, &iControlSender, &iSocketHandler, &iDBusWrapper);
@@ -307,9 +433,10 @@ void mainProgram()
 
 #ifdef WITH_TELNET
     CAmTelnetServer iTelnetServer(&iSocketHandler, &iCommandSender, &iCommandReceiver, &iRoutingSender, &iRoutingReceiver, &iControlSender, &iControlReceiver, &iDatabaseHandler, &iRouter, telnetport, maxConnections);
-    CAmDatabaseObserver iObserver(&iCommandSender, &iRoutingSender, &iSocketHandler, &iTelnetServer);
+    CAmDatabaseObserver iObserver(&iCommandSender, &iRoutingSender, &iRouter, &iSocketHandler, &iTelnetServer);
+    iTelnetServer.setDatabaseObserver(&iObserver);
 #else /*WITH_TELNET*/
-    CAmDatabaseObserver iObserver(&iCommandSender,&iRoutingSender, &iSocketHandler);
+    CAmDatabaseObserver iObserver(&iCommandSender, &iRoutingSender, &iRouter, &iSocketHandler);
 #endif
 
     iDatabaseHandler.registerObserver(&iObserver);
@@ -0,0 +1,403 @@
+/**
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \author Christian Mueller, christian.ei.mueller@bmw.de BMW 2011,2012
+ *
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#include "CAmBenchmark.h"
+#include <algorithm>
+#include <sstream>
+#include <iostream>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "shared/CAmDltWrapper.h"
+
+using namespace am;
+using namespace testing;
+
+static uint64_t nowNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec * 1000000000ULL + now.tv_nsec);
+}
+
+static void recordValue(const std::string& name, const double value)
+{
+    std::ostringstream stream;
+    stream << value;
+    ::testing::Test::RecordProperty(name.c_str(), stream.str().c_str());
+    std::cout << "[ RESULT   ] " << name << " = " << stream.str() << std::endl;
+}
+
+/**
+ * records the number of operations per second
+ */
+static void recordRate(const std::string& name, const uint32_t operations, const uint64_t durationNs)
+{
+    recordValue(name + "_per_s", durationNs ? operations * 1000000000.0 / durationNs : 0.0);
+}
+
+/**
+ * records median, 90th and 99th percentile and maximum of the samples in microseconds
+ */
+static void recordPercentiles(const std::string& name, std::vector<uint64_t> listSamples)
+{
+    ASSERT_FALSE(listSamples.empty());
+    std::sort(listSamples.begin(), listSamples.end());
+    size_t last(listSamples.size() - 1);
+    recordValue(name + "_p50_us", listSamples[last * 50 / 100] / 1000.0);
+    recordValue(name + "_p90_us", listSamples[last * 90 / 100] / 1000.0);
+    recordValue(name + "_p99_us", listSamples[last * 99 / 100] / 1000.0);
+    recordValue(name + "_max_us", listSamples[last] / 1000.0);
+}
+
+ACTION(returnConnectionFormat){
+arg4=arg3;
+}
+
+CAmBenchmark::CAmBenchmark() :
+        plistRoutingPluginDirs(), //
+        plistCommandPluginDirs(), //
+        pSocketHandler(), //
+        pDatabaseHandler(std::string(":memory:")), //
+        pControlSender(std::string("")), //
+        pRouter(&pDatabaseHandler, &pControlSender), //
+        pRoutingSender(plistRoutingPluginDirs), //
+        pCommandSender(plistCommandPluginDirs), //
+        pMockInterface(), //
+        pMockControlInterface(), //
+        pCommandInterfaceBackdoor(), //
+        pControlInterfaceBackdoor(), //
+        pObserver(&pCommandSender, &pRoutingSender, &pRouter, &pSocketHandler), //
+        pCF(), //
+        pListFirstDomainSources(), //
+        pListLastDomainSinks()
+{
+    pDatabaseHandler.registerObserver(&pObserver);
+    pCommandInterfaceBackdoor.injectInterface(&pCommandSender, &pMockInterface);
+    pControlInterfaceBackdoor.replaceController(&pControlSender, &pMockControlInterface);
+    ON_CALL(pMockControlInterface,getConnectionFormatChoice(_,_,_,_,_)).WillByDefault(DoAll(returnConnectionFormat(), Return(E_OK)));
+}
+
+CAmBenchmark::~CAmBenchmark()
+{
+}
+
+/**
+ * creates a chain of domains. Neighbouring domains are linked by the given number of gateways, so a route from the first
+ * to the last domain has domains-1 gateway hops and gateways^(domains-1) alternatives.
+ * @param domains number of domains
+ * @param gateways number of gateways between two neighbouring domains
+ * @param elements number of sinks and of sources in each domain, without the ones of the gateways
+ */
+void CAmBenchmark::createTopology(const uint16_t domains, const uint16_t gateways, const uint16_t elements)
+{
+    std::vector<am_domainID_t> listDomainIDs;
+    for (uint16_t i = 0; i < domains; i++)
+    {
+        std::ostringstream name;
+        name << "domain" << i;
+        am_Domain_s domain;
+        pCF.createDomain(domain);
+        domain.domainID = 0;
+        domain.name = name.str();
+        domain.busname = name.str() + "bus";
+        domain.state = DS_CONTROLLED;
+        am_domainID_t domainID;
+        ASSERT_EQ(E_OK, pDatabaseHandler.enterDomainDB(domain,domainID));
+        listDomainIDs.push_back(domainID);
+
+        for (uint16_t j = 0; j < elements; j++)
+        {
+            std::ostringstream elementName;
+            elementName << name.str() << "element" << j;
+            am_Sink_s sink;
+            am_sinkID_t sinkID;
+            pCF.createSink(sink);
+            sink.sinkID = 0;
+            sink.domainID = domainID;
+            sink.name = elementName.str();
+            sink.listConnectionFormats.clear();
+            sink.listConnectionFormats.push_back(CF_GENIVI_ANALOG);
+            ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID));
+            am_Source_s source;
+            am_sourceID_t sourceID;
+            pCF.createSource(source);
+            source.sourceID = 0;
+            source.domainID = domainID;
+            source.name = elementName.str();
+            source.listConnectionFormats.clear();
+            source.listConnectionFormats.push_back(CF_GENIVI_ANALOG);
+            ASSERT_EQ(E_OK, pDatabaseHandler.enterSourceDB(source,sourceID));
+            if (i == 0)
+                pListFirstDomainSources.push_back(sourceID);
+            if (i == domains - 1)
+                pListLastDomainSinks.push_back(sinkID);
+        }
+    }
+
+    for (uint16_t i = 0; i + 1 < domains; i++)
+    {
+        for (uint16_t j = 0; j < gateways; j++)
+        {
+            std::ostringstream name;
+            name << "gateway" << i << "_" << j;
+            am_Sink_s sink;
+            am_sinkID_t sinkID;
+            pCF.createSink(sink);
+            sink.sinkID = 0;
+            sink.domainID = listDomainIDs[i];
+            sink.name = name.str();
+            sink.visible = false;
+            sink.listConnectionFormats.clear();
+            sink.listConnectionFormats.push_back(CF_GENIVI_ANALOG);
+            ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID));
+            am_Source_s source;
+            am_sourceID_t sourceID;
+            pCF.createSource(source);
+            source.sourceID = 0;
+            source.domainID = listDomainIDs[i + 1];
+            source.name = name.str();
+            source.visible = false;
+            source.listConnectionFormats.clear();
+            source.listConnectionFormats.push_back(CF_GENIVI_ANALOG);
+            ASSERT_EQ(E_OK, pDatabaseHandler.enterSourceDB(source,sourceID));
+
+            am_Gateway_s gateway;
+            am_gatewayID_t gatewayID;
+            pCF.createGateway(gateway);
+            gateway.gatewayID = 0;
+            gateway.name = name.str();
+            gateway.sinkID = sinkID;
+            gateway.sourceID = sourceID;
+            gateway.controlDomainID = listDomainIDs[i];
+            gateway.domainSinkID = listDomainIDs[i];
+            gateway.domainSourceID = listDomainIDs[i + 1];
+            gateway.listSinkFormats = sink.listConnectionFormats;
+            gateway.listSourceFormats = source.listConnectionFormats;
+            gateway.convertionMatrix.assign(1, true);
+            ASSERT_EQ(E_OK, pDatabaseHandler.enterGatewayDB(gateway,gatewayID));
+        }
+    }
+}
+
+CAmSerializerProbe::CAmSerializerProbe(CAmSocketHandler* socketHandler) :
+        mSocketHandler(socketHandler), //
+        mSerializer(socketHandler), //
+        mCount(0), //
+        mListRoundTripNs()
+{
+}
+
+int CAmSerializerProbe::answer()
+{
+    return (1);
+}
+
+void CAmSerializerProbe::count()
+{
+    mCount++;
+}
+
+void CAmSerializerProbe::stop()
+{
+    mSocketHandler->stop_listening();
+}
+
+static void* serializerCaller(void* data)
+{
+    CAmSerializerProbe* probe(static_cast<CAmSerializerProbe*>(data));
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        int answer(0);
+        uint64_t start(nowNs());
+        probe->mSerializer.syncCall<CAmSerializerProbe, int>(probe, &CAmSerializerProbe::answer, answer);
+        probe->mListRoundTripNs.push_back(nowNs() - start);
+    }
+    probe->mSerializer.asyncCall<CAmSerializerProbe>(probe, &CAmSerializerProbe::stop);
+    return (NULL);
+}
+
+CAmWakeupProbe::CAmWakeupProbe(CAmSocketHandler* socketHandler, const uint32_t passes) :
+        pFiredCallback(this, &CAmWakeupProbe::fired), //
+        mSocketHandler(socketHandler), //
+        mPipe(), //
+        mPasses(passes), //
+        mWriteNs(0), //
+        mListWakeupNs()
+{
+    if (pipe(mPipe) != 0)
+        mPipe[0] = mPipe[1] = -1;
+}
+
+CAmWakeupProbe::~CAmWakeupProbe()
+{
+    close(mPipe[0]);
+    close(mPipe[1]);
+}
+
+void CAmWakeupProbe::start()
+{
+    mWriteNs = nowNs();
+    ASSERT_EQ(1, write(mPipe[1], "x", 1));
+}
+
+void CAmWakeupProbe::fired(const pollfd pollfd, const sh_pollHandle_t handle, void* userData)
+{
+    (void) handle;
+    (void) userData;
+    char buffer;
+    ASSERT_EQ(1, read(pollfd.fd, &buffer, 1));
+    mListWakeupNs.push_back(nowNs() - mWriteNs);
+    if (mListWakeupNs.size() < mPasses)
+        start();
+    else
+        mSocketHandler->stop_listening();
+}
+
+TEST_F(CAmBenchmark,database)
+{
+    const uint16_t elements(200);
+    am_Sink_s sink;
+    am_Source_s source;
+    std::vector<am_sinkID_t> listSinkIDs;
+    pCF.createSink(sink);
+    pCF.createSource(source);
+
+    uint64_t start(nowNs());
+    for (uint16_t i = 0; i < elements; i++)
+    {
+        std::ostringstream name;
+        name << "sink" << i;
+        sink.sinkID = 0;
+        sink.name = name.str();
+        am_sinkID_t sinkID;
+        ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID));
+        listSinkIDs.push_back(sinkID);
+    }
+    recordRate("enterSinkDB", elements, nowNs() - start);
+
+    start = nowNs();
+    for (uint16_t i = 0; i < elements; i++)
+    {
+        std::ostringstream name;
+        name << "source" << i;
+        source.sourceID = 0;
+        source.name = name.str();
+        am_sourceID_t sourceID;
+        ASSERT_EQ(E_OK, pDatabaseHandler.enterSourceDB(source,sourceID));
+    }
+    recordRate("enterSourceDB", elements, nowNs() - start);
+
+    start = nowNs();
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+        ASSERT_EQ(E_OK, pDatabaseHandler.changeSinkMainVolumeDB(i % 100, listSinkIDs[i % elements]));
+    recordRate("changeSinkMainVolumeDB", BENCHMARK_ITERATIONS, nowNs() - start);
+
+    am_MainSoundProperty_s soundProperty;
+    soundProperty.type = sink.listMainSoundProperties.empty() ? MSP_UNKNOWN : sink.listMainSoundProperties[0].type;
+    start = nowNs();
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        soundProperty.value = i % 100;
+        pDatabaseHandler.changeMainSinkSoundPropertyDB(soundProperty, listSinkIDs[i % elements]);
+    }
+    recordRate("changeMainSinkSoundPropertyDB", BENCHMARK_ITERATIONS, nowNs() - start);
+
+    std::vector<am_Sink_s> listSinks;
+    start = nowNs();
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS / 10; i++)
+        ASSERT_EQ(E_OK, pDatabaseHandler.getListSinks(listSinks));
+    recordRate("getListSinks", BENCHMARK_ITERATIONS / 10, nowNs() - start);
+    ASSERT_EQ(elements, listSinks.size());
+
+    std::vector<am_SinkType_s> listMainSinks;
+    start = nowNs();
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS / 10; i++)
+        ASSERT_EQ(E_OK, pDatabaseHandler.getListMainSinks(listMainSinks));
+    recordRate("getListMainSinks", BENCHMARK_ITERATIONS / 10, nowNs() - start);
+}
+
+TEST_F(CAmBenchmark,routerGetRoute)
+{
+    createTopology(5, 2, 10);
+    ASSERT_FALSE(pListFirstDomainSources.empty());
+    ASSERT_FALSE(pListLastDomainSinks.empty());
+
+    std::vector<uint64_t> listUncachedNs, listCachedNs;
+    std::vector<am_Route_s> listRoutes;
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        am_sourceID_t sourceID(pListFirstDomainSources[i % pListFirstDomainSources.size()]);
+        am_sinkID_t sinkID(pListLastDomainSinks[(i / pListFirstDomainSources.size()) % pListLastDomainSinks.size()]);
+
+        pRouter.invalidateRoutes();
+        uint64_t start(nowNs());
+        ASSERT_EQ(E_OK, pRouter.getRoute(false,sourceID,sinkID,listRoutes));
+        listUncachedNs.push_back(nowNs() - start);
+        ASSERT_EQ(16u, listRoutes.size());
+
+        start = nowNs();
+        ASSERT_EQ(E_OK, pRouter.getRoute(false,sourceID,sinkID,listRoutes));
+        listCachedNs.push_back(nowNs() - start);
+    }
+    recordPercentiles("getRoute_uncached", listUncachedNs);
+    recordPercentiles("getRoute_cached", listCachedNs);
+}
+
+TEST_F(CAmBenchmark,socketHandlerWakeup)
+{
+    CAmWakeupProbe probe(&pSocketHandler, BENCHMARK_ITERATIONS);
+    sh_pollHandle_t handle;
+    ASSERT_EQ(E_OK, pSocketHandler.addFDPoll(probe.mPipe[0], POLLIN, NULL, &probe.pFiredCallback, NULL, NULL, NULL, handle));
+    probe.start();
+    pSocketHandler.start_listenting();
+    ASSERT_EQ(BENCHMARK_ITERATIONS, probe.mListWakeupNs.size());
+    recordPercentiles("socketHandler_wakeup", probe.mListWakeupNs);
+    pSocketHandler.removeFDPoll(handle);
+}
+
+TEST_F(CAmBenchmark,serializer)
+{
+    CAmSerializerProbe probe(&pSocketHandler);
+
+    //synchronous calls from another thread, each one waits for the mainloop
+    pthread_t caller;
+    ASSERT_EQ(0, pthread_create(&caller, NULL, &serializerCaller, &probe));
+    pSocketHandler.start_listenting();
+    pthread_join(caller, NULL);
+    ASSERT_EQ(BENCHMARK_ITERATIONS, probe.mListRoundTripNs.size());
+    recordPercentiles("serializer_syncCall", probe.mListRoundTripNs);
+
+    //asynchronous calls queued up front and dispatched in one go
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+        probe.mSerializer.asyncCall<CAmSerializerProbe>(&probe, &CAmSerializerProbe::count);
+    probe.mSerializer.asyncCall<CAmSerializerProbe>(&probe, &CAmSerializerProbe::stop);
+    uint64_t start(nowNs());
+    pSocketHandler.start_listenting();
+    recordRate("serializer_asyncCall_dispatch", BENCHMARK_ITERATIONS, nowNs() - start);
+    ASSERT_EQ(BENCHMARK_ITERATIONS, probe.mCount);
+}
+
+int main(int argc, char **argv)
+{
+    CAmDltWrapper::instance()->registerApp("bench", "CAmBenchmark");
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,120 @@
+/**
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \author Christian Mueller, christian.ei.mueller@bmw.de BMW 2011,2012
+ *
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#define UNIT_TEST 1
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <string>
+#include <vector>
+#include "CAmDatabaseHandler.h"
+#include "CAmControlReceiver.h"
+#include "CAmControlSender.h"
+#include "CAmDatabaseObserver.h"
+#include "CAmRoutingSender.h"
+#include "CAmRouter.h"
+#include "shared/CAmSocketHandler.h"
+#include "shared/CAmSerializer.h"
+#include "../IAmControlBackdoor.h"
+#include "../IAmCommandBackdoor.h"
+#include "../CAmCommonFunctions.h"
+#include "../MockIAmControlSend.h"
+#include "../MockIAmCommandSend.h"
+
+/**
+ * number of measured calls per benchmark
+ */
+#ifndef BENCHMARK_ITERATIONS
+#define BENCHMARK_ITERATIONS 2000u
+#endif
+
+namespace am
+{
+
+/**
+ * The benchmarks measure the daemon parts without plugins. Each result is printed and recorded as property of its test,
+ * so running with --gtest_output=xml:<file> writes all results in a machine readable form.
+ */
+class CAmBenchmark: public ::testing::Test
+{
+public:
+    CAmBenchmark();
+    ~CAmBenchmark();
+    std::vector<std::string> plistRoutingPluginDirs;
+    std::vector<std::string> plistCommandPluginDirs;
+    CAmSocketHandler pSocketHandler;
+    CAmDatabaseHandler pDatabaseHandler;
+    CAmControlSender pControlSender;
+    CAmRouter pRouter;
+    CAmRoutingSender pRoutingSender;
+    CAmCommandSender pCommandSender;
+    ::testing::NiceMock<MockIAmCommandSend> pMockInterface;
+    ::testing::NiceMock<MockIAmControlSend> pMockControlInterface;
+    IAmCommandBackdoor pCommandInterfaceBackdoor;
+    IAmControlBackdoor pControlInterfaceBackdoor;
+    CAmDatabaseObserver pObserver;
+    CAmCommonFunctions pCF;
+    std::vector<am_sourceID_t> pListFirstDomainSources; //!< sources of the first domain of the topology
+    std::vector<am_sinkID_t> pListLastDomainSinks; //!< sinks of the last domain of the topology
+
+    void createTopology(const uint16_t domains, const uint16_t gateways, const uint16_t elements);
+};
+
+/**
+ * answers the calls of the serializer benchmark on the mainloop
+ */
+class CAmSerializerProbe
+{
+public:
+    CAmSerializerProbe(CAmSocketHandler* socketHandler);
+    int answer();
+    void count();
+    void stop();
+    CAmSocketHandler* mSocketHandler;
+    CAmSerializer mSerializer;
+    uint32_t mCount;
+    std::vector<uint64_t> mListRoundTripNs;
+};
+
+/**
+ * passes one byte through a pipe back and forth via the mainloop, each pass is one wakeup of the sockethandler
+ */
+class CAmWakeupProbe
+{
+public:
+    CAmWakeupProbe(CAmSocketHandler* socketHandler, const uint32_t passes);
+    ~CAmWakeupProbe();
+    void fired(const pollfd pollfd, const sh_pollHandle_t handle, void* userData);
+    void start();
+    TAmShPollFired<CAmWakeupProbe> pFiredCallback;
+    CAmSocketHandler* mSocketHandler;
+    int mPipe[2];
+    uint32_t mPasses;
+    uint64_t mWriteNs;
+    std::vector<uint64_t> mListWakeupNs;
+};
+
+}
+
+#endif /* BENCHMARK_H_ */
@@ -43,7 +43,7 @@ CAmControlInterfaceTest::CAmControlInterfaceTest() :
         pControlInterfaceBackdoor(), //
         pControlSender(std::string("")), //
         pRouter(&pDatabaseHandler,&pControlSender), //
-        pDatabaseObserver(&pCommandSender, &pRoutingSender, &pSocketHandler), //
+        pDatabaseObserver(&pCommandSender, &pRoutingSender, &pRouter, &pSocketHandler), //
         pControlReceiver(&pDatabaseHandler, &pRoutingSender, &pCommandSender, &pSocketHandler, &pRouter), //
         pRoutingReceiver(&pDatabaseHandler, &pRoutingSender, &pControlSender, &pSocketHandler, pDBusWrapper)
 {
@@ -19,10 +19,12 @@
  */
 
 #include "CAmDatabaseHandlerTest.h"
+#include "CAmRoutingReceiver.h"
 #include <algorithm>
 #include <string>
 #include <vector>
 #include <set>
+#include <unistd.h>
 #include "shared/CAmDltWrapper.h"
 
 using namespace am;
@@ -39,7 +41,7 @@ CAmDatabaseHandlerTest::CAmDatabaseHandlerTest() :
         plistRoutingPluginDirs(), //
         plistCommandPluginDirs(), //
         pSocketHandler(),//
-        pDatabaseHandler(std::string(":memory:")), //
+        pDatabaseHandler(*createDatabaseHandler(GetParam())), //
         pRoutingSender(plistRoutingPluginDirs), //
         pCommandSender(plistCommandPluginDirs), //
         pMockInterface(), //
@@ -48,7 +50,7 @@ CAmDatabaseHandlerTest::CAmDatabaseHandlerTest() :
         pControlSender(""), //
         pRouter(&pDatabaseHandler, &pControlSender), //
         pControlReceiver(&pDatabaseHandler, &pRoutingSender, &pCommandSender,  &pSocketHandler, &pRouter), //
-        pObserver(&pCommandSender,&pRoutingSender, &pSocketHandler)
+        pObserver(&pCommandSender, &pRoutingSender, &pRouter, &pSocketHandler)
 {
     pDatabaseHandler.registerObserver(&pObserver);
     pCommandInterfaceBackdoor.injectInterface(&pCommandSender, &pMockInterface);
@@ -56,6 +58,40 @@ CAmDatabaseHandlerTest::CAmDatabaseHandlerTest() :
 
 CAmDatabaseHandlerTest::~CAmDatabaseHandlerTest()
 {
+    delete &pDatabaseHandler;
+}
+
+IAmDatabaseHandler* CAmDatabaseHandlerTest::createDatabaseHandler(const std::string& storage)
+{
+    CAmDatabaseHandler::databaseSettings_s settings;
+    if (storage == "map")
+        return (new CAmDatabaseHandlerMap());
+    if (storage == "sqlite-wal")
+    {
+        settings.set("journal_mode", "WAL");
+        settings.set("synchronous", "NORMAL");
+        settings.set("cache_size", "-4096");
+        settings.set("mmap_size", "1048576");
+        return (new CAmDatabaseHandler(std::string(TEST_DATABASE_FILE), settings));
+    }
+    if (storage == "sqlite-nosync")
+    {
+        settings.set("journal_mode", "MEMORY");
+        settings.set("synchronous", "OFF");
+        return (new CAmDatabaseHandler(std::string(TEST_DATABASE_FILE), settings));
+    }
+    return (new CAmDatabaseHandler(std::string(":memory:")));
+}
+
+/**
+ * removes the database file of the file backed modes together with its journal files, so that the next run starts clean
+ */
+void CAmDatabaseHandlerTest::removeDatabaseFile()
+{
+    unlink(TEST_DATABASE_FILE);
+    unlink(TEST_DATABASE_FILE "-wal");
+    unlink(TEST_DATABASE_FILE "-shm");
+    unlink(TEST_DATABASE_FILE "-journal");
 }
 
 void CAmDatabaseHandlerTest::createMainConnectionSetup()
@@ -130,15 +166,30 @@ void CAmDatabaseHandlerTest::createMainConnectionSetup()
     ASSERT_EQ(true, equal);
 }
 
+CAmMainloopStopper::CAmMainloopStopper(CAmSocketHandler *socketHandler) :
+        pStopCallback(this, &CAmMainloopStopper::stop), //
+        mSocketHandler(socketHandler)
+{
+}
+
+void CAmMainloopStopper::stop(sh_timerHandle_t handle, void* userData)
+{
+    (void) handle;
+    (void) userData;
+    mSocketHandler->stop_listening();
+}
+
 void CAmDatabaseHandlerTest::SetUp()
 {
 }
 
 void CAmDatabaseHandlerTest::TearDown()
 {
+    //the handler still has the file open, it goes away when the handler is deleted
+    removeDatabaseFile();
 }
 
-TEST_F(CAmDatabaseHandlerTest,getMainConnectionInfo)
+TEST_P(CAmDatabaseHandlerTest,getMainConnectionInfo)
 {
     //fill the connection database
     am_Connection_s connection;
@@ -214,7 +265,7 @@ TEST_F(CAmDatabaseHandlerTest,getMainConnectionInfo)
 
 }
 
-TEST_F(CAmDatabaseHandlerTest,getSinKInfo)
+TEST_P(CAmDatabaseHandlerTest,getSinKInfo)
 {
     //fill the connection database
     am_Sink_s staticSink, firstDynamicSink, secondDynamicSink;
@@ -275,7 +326,7 @@ TEST_F(CAmDatabaseHandlerTest,getSinKInfo)
 
 }
 
-TEST_F(CAmDatabaseHandlerTest,getSourceInfo)
+TEST_P(CAmDatabaseHandlerTest,getSourceInfo)
 {
     //fill the connection database
     am_Source_s staticSource, firstDynamicSource, secondDynamicSource;
@@ -340,7 +391,7 @@ TEST_F(CAmDatabaseHandlerTest,getSourceInfo)
 
 }
 
-TEST_F(CAmDatabaseHandlerTest, peekSourceID)
+TEST_P(CAmDatabaseHandlerTest, peekSourceID)
 {
 
     std::string sourceName("myClassID");
@@ -364,7 +415,7 @@ TEST_F(CAmDatabaseHandlerTest, peekSourceID)
     ASSERT_EQ(sourceClassID, peekID);
 }
 
-TEST_F(CAmDatabaseHandlerTest, peekSinkID)
+TEST_P(CAmDatabaseHandlerTest, peekSinkID)
 {
 
     std::string sinkName("myClassID");
@@ -388,7 +439,7 @@ TEST_F(CAmDatabaseHandlerTest, peekSinkID)
     ASSERT_EQ(sinkClassID, peekID);
 }
 
-TEST_F(CAmDatabaseHandlerTest,crossfaders)
+TEST_P(CAmDatabaseHandlerTest,crossfaders)
 {
 
 
@@ -428,7 +479,7 @@ TEST_F(CAmDatabaseHandlerTest,crossfaders)
     ASSERT_EQ(crossfader.name.compare(listCrossfaders[0].name), 0);
 }
 
-TEST_F(CAmDatabaseHandlerTest,crossfadersGetFromDomain)
+TEST_P(CAmDatabaseHandlerTest,crossfadersGetFromDomain)
 {
 
 
@@ -471,7 +522,7 @@ TEST_F(CAmDatabaseHandlerTest,crossfadersGetFromDomain)
 
 }
 
-TEST_F(CAmDatabaseHandlerTest,sourceState)
+TEST_P(CAmDatabaseHandlerTest,sourceState)
 {
     am_Source_s source;
     am_sourceID_t sourceID;
@@ -491,7 +542,7 @@ TEST_F(CAmDatabaseHandlerTest,sourceState)
     ASSERT_EQ(listSources[0].sourceState, SS_ON);
 }
 
-TEST_F(CAmDatabaseHandlerTest,sinkVolumeChange)
+TEST_P(CAmDatabaseHandlerTest,sinkVolumeChange)
 {
     am_Sink_s sink;
     am_sinkID_t sinkID;
@@ -509,7 +560,7 @@ TEST_F(CAmDatabaseHandlerTest,sinkVolumeChange)
     ASSERT_EQ(listSinks[0].volume, 34);
 }
 
-TEST_F(CAmDatabaseHandlerTest,sourceVolumeChange)
+TEST_P(CAmDatabaseHandlerTest,sourceVolumeChange)
 {
     am_Source_s source;
     am_sourceID_t sourceID;
@@ -527,7 +578,7 @@ TEST_F(CAmDatabaseHandlerTest,sourceVolumeChange)
     ASSERT_EQ(listSources[0].volume, 34);
 }
 
-TEST_F(CAmDatabaseHandlerTest, peekSource)
+TEST_P(CAmDatabaseHandlerTest, peekSource)
 {
     std::vector<am_Source_s> listSources;
     am_sourceID_t sourceID, source2ID, source3ID;
@@ -558,7 +609,7 @@ TEST_F(CAmDatabaseHandlerTest, peekSource)
     ASSERT_EQ(source3ID, source2ID);
 }
 
-TEST_F(CAmDatabaseHandlerTest, peekSourceDouble)
+TEST_P(CAmDatabaseHandlerTest, peekSourceDouble)
 {
     std::vector<am_Source_s> listSources;
     am_sourceID_t sourceID;
@@ -589,7 +640,7 @@ TEST_F(CAmDatabaseHandlerTest, peekSourceDouble)
     ASSERT_TRUE(listSources[0].sourceID==sourceID);
 }
 
-TEST_F(CAmDatabaseHandlerTest, peekSink)
+TEST_P(CAmDatabaseHandlerTest, peekSink)
 {
     std::vector<am_Sink_s> listSinks;
     am_sinkID_t sinkID, sink2ID, sink3ID;
@@ -620,7 +671,7 @@ TEST_F(CAmDatabaseHandlerTest, peekSink)
     ASSERT_EQ(sink3ID, sink2ID);
 }
 
-TEST_F(CAmDatabaseHandlerTest, peekSinkDouble)
+TEST_P(CAmDatabaseHandlerTest, peekSinkDouble)
 {
     std::vector<am_Sink_s> listSinks;
     am_sinkID_t sinkID;
@@ -651,7 +702,7 @@ TEST_F(CAmDatabaseHandlerTest, peekSinkDouble)
     ASSERT_TRUE(listSinks[0].sinkID==sinkID);
 }
 
-TEST_F(CAmDatabaseHandlerTest,changeConnectionTimingInformationCheckMainConnection)
+TEST_P(CAmDatabaseHandlerTest,changeConnectionTimingInformationCheckMainConnection)
 {
     std::vector<am_Connection_s> connectionList;
     std::vector<am_MainConnectionType_s> mainList;
@@ -676,7 +727,7 @@ TEST_F(CAmDatabaseHandlerTest,changeConnectionTimingInformationCheckMainConnecti
     ASSERT_EQ(mainList[0].delay, 216);
 }
 
-TEST_F(CAmDatabaseHandlerTest,changeConnectionTimingInformation)
+TEST_P(CAmDatabaseHandlerTest,changeConnectionTimingInformation)
 {
     am_Connection_s connection;
     am_connectionID_t connectionID;
@@ -693,7 +744,7 @@ TEST_F(CAmDatabaseHandlerTest,changeConnectionTimingInformation)
     ASSERT_TRUE(connectionList[0].delay==24);
 }
 
-TEST_F(CAmDatabaseHandlerTest,getSinkClassOfSink)
+TEST_P(CAmDatabaseHandlerTest,getSinkClassOfSink)
 {
     std::vector<am_SinkClass_s> sinkClassList;
     std::vector<am_ClassProperty_s> classPropertyList;
@@ -731,7 +782,7 @@ TEST_F(CAmDatabaseHandlerTest,getSinkClassOfSink)
     ASSERT_TRUE(std::equal(sinkClassList[0].listClassProperties.begin(),sinkClassList[0].listClassProperties.end(),returnClass.listClassProperties.begin(),equalClassProperties));
 }
 
-TEST_F(CAmDatabaseHandlerTest,getSourceClassOfSource)
+TEST_P(CAmDatabaseHandlerTest,getSourceClassOfSource)
 {
     std::vector<am_SourceClass_s> sourceClassList;
     std::vector<am_ClassProperty_s> classPropertyList;
@@ -765,7 +816,7 @@ TEST_F(CAmDatabaseHandlerTest,getSourceClassOfSource)
     ASSERT_TRUE(std::equal(sourceClassList[0].listClassProperties.begin(),sourceClassList[0].listClassProperties.end(),sinkSourceClass.listClassProperties.begin(),equalClassProperties));
 }
 
-TEST_F(CAmDatabaseHandlerTest,removeSourceClass)
+TEST_P(CAmDatabaseHandlerTest,removeSourceClass)
 {
     std::vector<am_SourceClass_s> sourceClassList;
     std::vector<am_ClassProperty_s> classPropertyList;
@@ -793,7 +844,7 @@ TEST_F(CAmDatabaseHandlerTest,removeSourceClass)
     ASSERT_TRUE(sourceClassList.empty());
 }
 
-TEST_F(CAmDatabaseHandlerTest,updateSourceClass)
+TEST_P(CAmDatabaseHandlerTest,updateSourceClass)
 {
     std::vector<am_SourceClass_s> sourceClassList;
     std::vector<am_ClassProperty_s> classPropertyList, changedPropertyList;
@@ -826,7 +877,7 @@ TEST_F(CAmDatabaseHandlerTest,updateSourceClass)
     ASSERT_TRUE(std::equal(sourceClassList[0].listClassProperties.begin(),sourceClassList[0].listClassProperties.end(),changedPropertyList.begin(),equalClassProperties));
 }
 
-TEST_F(CAmDatabaseHandlerTest,enterSourceClass)
+TEST_P(CAmDatabaseHandlerTest,enterSourceClass)
 {
     std::vector<am_SourceClass_s> sourceClassList;
     std::vector<am_ClassProperty_s> classPropertyList;
@@ -851,7 +902,7 @@ TEST_F(CAmDatabaseHandlerTest,enterSourceClass)
     ASSERT_TRUE(std::equal(sourceClassList[0].listClassProperties.begin(),sourceClassList[0].listClassProperties.end(),classPropertyList.begin(),equalClassProperties));
 }
 
-TEST_F(CAmDatabaseHandlerTest,enterSourceClassStatic)
+TEST_P(CAmDatabaseHandlerTest,enterSourceClassStatic)
 {
     std::vector<am_SourceClass_s> sourceClassList;
     std::vector<am_ClassProperty_s> classPropertyList;
@@ -876,7 +927,7 @@ TEST_F(CAmDatabaseHandlerTest,enterSourceClassStatic)
     ASSERT_TRUE(std::equal(sourceClassList[0].listClassProperties.begin(),sourceClassList[0].listClassProperties.end(),classPropertyList.begin(),equalClassProperties));
 }
 
-TEST_F(CAmDatabaseHandlerTest,removeSinkClass)
+TEST_P(CAmDatabaseHandlerTest,removeSinkClass)
 {
     std::vector<am_SinkClass_s> sinkClassList;
     std::vector<am_ClassProperty_s> classPropertyList;
@@ -904,7 +955,7 @@ TEST_F(CAmDatabaseHandlerTest,removeSinkClass)
     ASSERT_TRUE(sinkClassList.empty());
 }
 
-TEST_F(CAmDatabaseHandlerTest,updateSinkClass)
+TEST_P(CAmDatabaseHandlerTest,updateSinkClass)
 {
     std::vector<am_SinkClass_s> sinkClassList;
     std::vector<am_ClassProperty_s> classPropertyList, changedPropertyList;
@@ -937,7 +988,7 @@ TEST_F(CAmDatabaseHandlerTest,updateSinkClass)
     ASSERT_TRUE(std::equal(sinkClassList[0].listClassProperties.begin(),sinkClassList[0].listClassProperties.end(),changedPropertyList.begin(),equalClassProperties));
 }
 
-TEST_F(CAmDatabaseHandlerTest,enterSinkClass)
+TEST_P(CAmDatabaseHandlerTest,enterSinkClass)
 {
     std::vector<am_SinkClass_s> sinkClassList;
     std::vector<am_ClassProperty_s> classPropertyList;
@@ -962,7 +1013,7 @@ TEST_F(CAmDatabaseHandlerTest,enterSinkClass)
     ASSERT_TRUE(std::equal(sinkClassList[0].listClassProperties.begin(),sinkClassList[0].listClassProperties.end(),classPropertyList.begin(),equalClassProperties));
 }
 
-TEST_F(CAmDatabaseHandlerTest,enterSinkClassStatic)
+TEST_P(CAmDatabaseHandlerTest,enterSinkClassStatic)
 {
     std::vector<am_SinkClass_s> sinkClassList;
     std::vector<am_ClassProperty_s> classPropertyList;
@@ -987,7 +1038,7 @@ TEST_F(CAmDatabaseHandlerTest,enterSinkClassStatic)
     ASSERT_TRUE(std::equal(sinkClassList[0].listClassProperties.begin(),sinkClassList[0].listClassProperties.end(),classPropertyList.begin(),equalClassProperties));
 }
 
-TEST_F(CAmDatabaseHandlerTest, changeSystemProperty)
+TEST_P(CAmDatabaseHandlerTest, changeSystemProperty)
 {
     std::vector<am_SystemProperty_s> listSystemProperties, listReturn;
     am_SystemProperty_s systemProperty;
@@ -1003,7 +1054,7 @@ TEST_F(CAmDatabaseHandlerTest, changeSystemProperty)
     ASSERT_EQ(listReturn[0].value, systemProperty.value);
 }
 
-TEST_F(CAmDatabaseHandlerTest, systemProperties)
+TEST_P(CAmDatabaseHandlerTest, systemProperties)
 {
     std::vector<am_SystemProperty_s> listSystemProperties, listReturn;
     am_SystemProperty_s systemProperty;
@@ -1018,7 +1069,7 @@ TEST_F(CAmDatabaseHandlerTest, systemProperties)
     ASSERT_EQ(listReturn[0].value, systemProperty.value);
 }
 
-TEST_F(CAmDatabaseHandlerTest,enterSourcesCorrect)
+TEST_P(CAmDatabaseHandlerTest,enterSourcesCorrect)
 {
     //fill the connection database
     am_Source_s staticSource, firstDynamicSource, secondDynamicSource;
@@ -1078,7 +1129,7 @@ TEST_F(CAmDatabaseHandlerTest,enterSourcesCorrect)
     ASSERT_EQ(true, equal);
 }
 
-TEST_F(CAmDatabaseHandlerTest, changeSourceMainSoundProperty)
+TEST_P(CAmDatabaseHandlerTest, changeSourceMainSoundProperty)
 {
     std::vector<am_Source_s> listSources;
     am_Source_s source;
@@ -1102,7 +1153,7 @@ TEST_F(CAmDatabaseHandlerTest, changeSourceMainSoundProperty)
     }
 }
 
-TEST_F(CAmDatabaseHandlerTest, changeSinkMuteState)
+TEST_P(CAmDatabaseHandlerTest, changeSinkMuteState)
 {
     std::vector<am_Sink_s> listSinks;
     am_Sink_s sink;
@@ -1117,7 +1168,7 @@ TEST_F(CAmDatabaseHandlerTest, changeSinkMuteState)
     ASSERT_EQ(muteState, listSinks[0].muteState);
 }
 
-TEST_F(CAmDatabaseHandlerTest, changeSinkMainSoundProperty)
+TEST_P(CAmDatabaseHandlerTest, changeSinkMainSoundProperty)
 {
     std::vector<am_Sink_s> listSinks;
     am_Sink_s sink;
@@ -1142,7 +1193,7 @@ TEST_F(CAmDatabaseHandlerTest, changeSinkMainSoundProperty)
     }
 }
 
-TEST_F(CAmDatabaseHandlerTest, peekDomain)
+TEST_P(CAmDatabaseHandlerTest, peekDomain)
 {
     std::vector<am_Domain_s> listDomains;
     am_Domain_s domain;
@@ -1160,7 +1211,7 @@ TEST_F(CAmDatabaseHandlerTest, peekDomain)
     ASSERT_TRUE(listDomains[0].domainID==domainID);
 }
 
-TEST_F(CAmDatabaseHandlerTest, peekDomainFirstEntered)
+TEST_P(CAmDatabaseHandlerTest, peekDomainFirstEntered)
 {
     std::vector<am_Domain_s> listDomains;
     am_Domain_s domain;
@@ -1175,7 +1226,7 @@ TEST_F(CAmDatabaseHandlerTest, peekDomainFirstEntered)
     ASSERT_TRUE(listDomains.size()==1);
 }
 
-TEST_F(CAmDatabaseHandlerTest, changeDomainState)
+TEST_P(CAmDatabaseHandlerTest, changeDomainState)
 {
     std::vector<am_Domain_s> listDomains;
     am_Domain_s domain;
@@ -1188,7 +1239,7 @@ TEST_F(CAmDatabaseHandlerTest, changeDomainState)
     ASSERT_EQ(newState, listDomains[0].state);
 }
 
-TEST_F(CAmDatabaseHandlerTest, changeMainConnectionState)
+TEST_P(CAmDatabaseHandlerTest, changeMainConnectionState)
 {
     std::vector<am_MainConnection_s> listMainConnections;
     createMainConnectionSetup();
@@ -1198,7 +1249,7 @@ TEST_F(CAmDatabaseHandlerTest, changeMainConnectionState)
     ASSERT_EQ(CS_DISCONNECTING, listMainConnections[0].connectionState);
 }
 
-TEST_F(CAmDatabaseHandlerTest, changeSinkAvailability)
+TEST_P(CAmDatabaseHandlerTest, changeSinkAvailability)
 {
     std::vector<am_Sink_s> listSinks;
     am_Sink_s sink;
@@ -1216,7 +1267,7 @@ TEST_F(CAmDatabaseHandlerTest, changeSinkAvailability)
     ASSERT_EQ(availability.availabilityReason, listSinks[0].available.availabilityReason);
 }
 
-TEST_F(CAmDatabaseHandlerTest, changeSourceAvailability)
+TEST_P(CAmDatabaseHandlerTest, changeSourceAvailability)
 {
     std::vector<am_Source_s> listSources;
     am_Source_s source;
@@ -1235,7 +1286,7 @@ TEST_F(CAmDatabaseHandlerTest, changeSourceAvailability)
     ASSERT_EQ(availability.availabilityReason, listSources[0].available.availabilityReason);
 }
 
-TEST_F(CAmDatabaseHandlerTest,changeMainConnectionRoute)
+TEST_P(CAmDatabaseHandlerTest,changeMainConnectionRoute)
 {
     std::vector<am_MainConnection_s> originalList;
     std::vector<am_MainConnection_s> newList;
@@ -1282,7 +1333,7 @@ TEST_F(CAmDatabaseHandlerTest,changeMainConnectionRoute)
     ASSERT_FALSE(std::equal(newList[0].listConnectionID.begin(),newList[0].listConnectionID.end(),originalList[0].listConnectionID.begin()));
 }
 
-TEST_F(CAmDatabaseHandlerTest,changeMainSinkVolume)
+TEST_P(CAmDatabaseHandlerTest,changeMainSinkVolume)
 {
     am_Sink_s sink;
     am_sinkID_t sinkID;
@@ -1298,7 +1349,7 @@ TEST_F(CAmDatabaseHandlerTest,changeMainSinkVolume)
     ASSERT_EQ(listSinks[0].mainVolume, newVol);
 }
 
-TEST_F(CAmDatabaseHandlerTest,getMainSourceSoundProperties)
+TEST_P(CAmDatabaseHandlerTest,getMainSourceSoundProperties)
 {
     am_Source_s source;
     am_sourceID_t sourceID;
@@ -1312,7 +1363,7 @@ TEST_F(CAmDatabaseHandlerTest,getMainSourceSoundProperties)
     ASSERT_TRUE(std::equal(mainSoundProperties.begin(),mainSoundProperties.end(),listMainSoundProperties.begin(),equalMainSoundProperty));
 }
 
-TEST_F(CAmDatabaseHandlerTest,getMainSinkSoundProperties)
+TEST_P(CAmDatabaseHandlerTest,getMainSinkSoundProperties)
 {
     am_Sink_s sink;
     am_sinkID_t sinkID;
@@ -1326,7 +1377,7 @@ TEST_F(CAmDatabaseHandlerTest,getMainSinkSoundProperties)
     ASSERT_TRUE(std::equal(mainSoundProperties.begin(),mainSoundProperties.end(),listMainSoundProperties.begin(),equalMainSoundProperty));
 }
 
-TEST_F(CAmDatabaseHandlerTest,getMainSources)
+TEST_P(CAmDatabaseHandlerTest,getMainSources)
 {
     am_Source_s source, source1, source2;
     am_sourceID_t sourceID;
@@ -1358,7 +1409,7 @@ TEST_F(CAmDatabaseHandlerTest,getMainSources)
     ASSERT_TRUE(equal);
 }
 
-TEST_F(CAmDatabaseHandlerTest,getMainSinks)
+TEST_P(CAmDatabaseHandlerTest,getMainSinks)
 {
     am_Sink_s sink, sink1, sink2;
     am_sinkID_t sinkID;
@@ -1389,7 +1440,7 @@ TEST_F(CAmDatabaseHandlerTest,getMainSinks)
     ASSERT_TRUE(equal);
 }
 
-TEST_F(CAmDatabaseHandlerTest,getVisibleMainConnections)
+TEST_P(CAmDatabaseHandlerTest,getVisibleMainConnections)
 {
     createMainConnectionSetup();
     std::vector<am_MainConnectionType_s> listVisibleMainConnections;
@@ -1403,7 +1454,7 @@ TEST_F(CAmDatabaseHandlerTest,getVisibleMainConnections)
     ASSERT_EQ(listMainConnections[0].sourceID, listVisibleMainConnections[0].sourceID);
 }
 
-TEST_F(CAmDatabaseHandlerTest,getListSourcesOfDomain)
+TEST_P(CAmDatabaseHandlerTest,getListSourcesOfDomain)
 {
     am_Source_s source, source2;
     am_Domain_s domain;
@@ -1434,7 +1485,7 @@ TEST_F(CAmDatabaseHandlerTest,getListSourcesOfDomain)
     ASSERT_TRUE(std::equal(sourceList.begin(),sourceList.end(),sourceCheckList.begin()) && !sourceList.empty());
 }
 
-TEST_F(CAmDatabaseHandlerTest,getListSinksOfDomain)
+TEST_P(CAmDatabaseHandlerTest,getListSinksOfDomain)
 {
     am_Sink_s sink, sink2;
     am_Domain_s domain;
@@ -1463,7 +1514,7 @@ TEST_F(CAmDatabaseHandlerTest,getListSinksOfDomain)
     ASSERT_TRUE(std::equal(sinkList.begin(),sinkList.end(),sinkCheckList.begin()) && !sinkList.empty());
 }
 
-TEST_F(CAmDatabaseHandlerTest,getListGatewaysOfDomain)
+TEST_P(CAmDatabaseHandlerTest,getListGatewaysOfDomain)
 {
 
 
@@ -1512,7 +1563,7 @@ TEST_F(CAmDatabaseHandlerTest,getListGatewaysOfDomain)
     ASSERT_TRUE(std::equal(gatewayList.begin(),gatewayList.end(),gatewayCheckList.begin()) && !gatewayList.empty());
 }
 
-TEST_F(CAmDatabaseHandlerTest,removeDomain)
+TEST_P(CAmDatabaseHandlerTest,removeDomain)
 {
     am_Domain_s domain;
     am_domainID_t domainID;
@@ -1527,7 +1578,7 @@ TEST_F(CAmDatabaseHandlerTest,removeDomain)
     ASSERT_TRUE(listDomains.empty());
 }
 
-TEST_F(CAmDatabaseHandlerTest,removeGateway)
+TEST_P(CAmDatabaseHandlerTest,removeGateway)
 {
 
 
@@ -1554,7 +1605,7 @@ TEST_F(CAmDatabaseHandlerTest,removeGateway)
     ASSERT_TRUE(listGateways.empty());
 }
 
-TEST_F(CAmDatabaseHandlerTest,removeSink)
+TEST_P(CAmDatabaseHandlerTest,removeSink)
 {
     am_Sink_s sink;
     am_sinkID_t sinkID;
@@ -1570,7 +1621,7 @@ TEST_F(CAmDatabaseHandlerTest,removeSink)
     ASSERT_TRUE(listSinks.empty());
 }
 
-TEST_F(CAmDatabaseHandlerTest,removeSource)
+TEST_P(CAmDatabaseHandlerTest,removeSource)
 {
     //fill the connection database
     am_Source_s source;
@@ -1588,7 +1639,7 @@ TEST_F(CAmDatabaseHandlerTest,removeSource)
     ASSERT_TRUE(listSources.empty());
 }
 
-TEST_F(CAmDatabaseHandlerTest, removeMainConnection)
+TEST_P(CAmDatabaseHandlerTest, removeMainConnection)
 {
     createMainConnectionSetup();
 
@@ -1597,31 +1648,31 @@ TEST_F(CAmDatabaseHandlerTest, removeMainConnection)
         << "ERROR: database error";
 }
 
-TEST_F(CAmDatabaseHandlerTest,removeNonexistentMainConnectionFail)
+TEST_P(CAmDatabaseHandlerTest,removeNonexistentMainConnectionFail)
 {
     ASSERT_EQ(E_NON_EXISTENT,pDatabaseHandler.removeMainConnectionDB(34))
         << "ERROR: database error";
 }
 
-TEST_F(CAmDatabaseHandlerTest,removeNonexistentSource)
+TEST_P(CAmDatabaseHandlerTest,removeNonexistentSource)
 {
     ASSERT_EQ(E_NON_EXISTENT,pDatabaseHandler.removeSourceDB(3))
         << "ERROR: database error";
 }
 
-TEST_F(CAmDatabaseHandlerTest,removeNonexistentSink)
+TEST_P(CAmDatabaseHandlerTest,removeNonexistentSink)
 {
     ASSERT_EQ(E_NON_EXISTENT,pDatabaseHandler.removeSinkDB(2))
         << "ERROR: database error";
 }
 
-TEST_F(CAmDatabaseHandlerTest,removeNonexistentGateway)
+TEST_P(CAmDatabaseHandlerTest,removeNonexistentGateway)
 {
     ASSERT_EQ(E_NON_EXISTENT,pDatabaseHandler.removeGatewayDB(12))
         << "ERROR: database error";
 }
 
-TEST_F(CAmDatabaseHandlerTest,registerGatewayCorrect)
+TEST_P(CAmDatabaseHandlerTest,registerGatewayCorrect)
 {
 
 
@@ -1685,7 +1736,7 @@ TEST_F(CAmDatabaseHandlerTest,registerGatewayCorrect)
     ASSERT_EQ(true, equal);
 }
 
-TEST_F(CAmDatabaseHandlerTest,getGatewayInfo)
+TEST_P(CAmDatabaseHandlerTest,getGatewayInfo)
 {
 
 
@@ -1754,7 +1805,7 @@ TEST_F(CAmDatabaseHandlerTest,getGatewayInfo)
 
 }
 
-TEST_F(CAmDatabaseHandlerTest,enterSinkThatAlreadyExistFail)
+TEST_P(CAmDatabaseHandlerTest,enterSinkThatAlreadyExistFail)
 {
     //fill the connection database
     am_Sink_s staticSink, SecondSink;
@@ -1778,7 +1829,7 @@ TEST_F(CAmDatabaseHandlerTest,enterSinkThatAlreadyExistFail)
         << "ERROR: database error";
 }
 
-TEST_F(CAmDatabaseHandlerTest,enterSourcesThatAlreadyExistFail)
+TEST_P(CAmDatabaseHandlerTest,enterSourcesThatAlreadyExistFail)
 {
     //fill the connection database
     am_Source_s staticSource, SecondSource;
@@ -1799,7 +1850,7 @@ TEST_F(CAmDatabaseHandlerTest,enterSourcesThatAlreadyExistFail)
         << "ERROR: database error";
 }
 
-TEST_F(CAmDatabaseHandlerTest,registerDomainCorrect)
+TEST_P(CAmDatabaseHandlerTest,registerDomainCorrect)
 {
     //initialize domain
     std::vector<am_Domain_s> returnList;
@@ -1826,7 +1877,7 @@ TEST_F(CAmDatabaseHandlerTest,registerDomainCorrect)
     ASSERT_EQ(true, equal);
 }
 
-TEST_F(CAmDatabaseHandlerTest,registerConnectionCorrect)
+TEST_P(CAmDatabaseHandlerTest,registerConnectionCorrect)
 {
     am_Connection_s connection;
     am_connectionID_t connectionID;
@@ -1853,12 +1904,12 @@ TEST_F(CAmDatabaseHandlerTest,registerConnectionCorrect)
     ASSERT_EQ(true, equal);
 }
 
-TEST_F(CAmDatabaseHandlerTest,enterMainConnectionCorrect)
+TEST_P(CAmDatabaseHandlerTest,enterMainConnectionCorrect)
 {
     createMainConnectionSetup();
 }
 
-TEST_F(CAmDatabaseHandlerTest,enterSinksCorrect)
+TEST_P(CAmDatabaseHandlerTest,enterSinksCorrect)
 {
     //fill the connection database
     am_Sink_s staticSink, firstDynamicSink, secondDynamicSink;
@@ -1915,6 +1966,367 @@ TEST_F(CAmDatabaseHandlerTest,enterSinksCorrect)
     ASSERT_EQ(true, equal);
 }
 
+TEST_P(CAmDatabaseHandlerTest,transactionNested)
+{
+    am_Sink_s sink;
+    am_sinkID_t sinkID;
+    std::vector<am_Sink_s> listSinks;
+    pCF.createSink(sink);
+
+    ASSERT_EQ(E_NOT_POSSIBLE, pDatabaseHandler.commitTransaction());
+    ASSERT_EQ(E_OK, pDatabaseHandler.beginTransaction());
+    ASSERT_EQ(E_OK, pDatabaseHandler.beginTransaction());
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID));
+
+    //changes are visible within the transaction
+    ASSERT_TRUE(pDatabaseHandler.existSink(sinkID));
+    ASSERT_EQ(E_OK, pDatabaseHandler.commitTransaction());
+    ASSERT_EQ(E_OK, pDatabaseHandler.commitTransaction());
+    ASSERT_EQ(E_NOT_POSSIBLE, pDatabaseHandler.commitTransaction());
+
+    ASSERT_EQ(E_OK, pDatabaseHandler.getListSinks(listSinks));
+    ASSERT_EQ(1u, listSinks.size());
+    ASSERT_EQ(sinkID, listSinks[0].sinkID);
+}
+
+TEST_P(CAmDatabaseHandlerTest,transactionCoalescesNotifications)
+{
+    CAmMainloopStopper stopper(&pSocketHandler);
+    am_Sink_s sink;
+    am_sinkID_t sinkID1, sinkID2;
+    am_SinkClass_s sinkClass;
+    am_sinkClass_t sinkClassID;
+    pCF.createSink(sink);
+    sinkClass.sinkClassID = 0;
+
+    //the first sink is removed again and never reported, the second one is reported once with its last volume
+    EXPECT_CALL(pMockInterface,cbNewSink(Field(&am_SinkType_s::volume, 20))).Times(1);
+    EXPECT_CALL(pMockInterface,cbRemovedSink(_)).Times(0);
+    EXPECT_CALL(pMockInterface,cbVolumeChanged(_,_)).Times(0);
+    EXPECT_CALL(pMockInterface,cbNumberOfSinkClassesChanged()).Times(1);
+
+    ASSERT_EQ(E_OK, pDatabaseHandler.beginTransaction());
+    sink.name = "sink1";
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID1));
+    sink.name = "sink2";
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID2));
+    ASSERT_EQ(E_OK, pDatabaseHandler.removeSinkDB(sinkID1));
+    ASSERT_EQ(E_OK, pDatabaseHandler.changeSinkMainVolumeDB(20,sinkID2));
+    sinkClass.name = "class1";
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkClassDB(sinkClass,sinkClassID));
+    sinkClass.sinkClassID = 0;
+    sinkClass.name = "class2";
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkClassDB(sinkClass,sinkClassID));
+    ASSERT_EQ(E_OK, pDatabaseHandler.commitTransaction());
+
+    //dispatch what the observer sent to the command side
+    timespec timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_nsec = 100000000;
+    sh_timerHandle_t handle;
+    pSocketHandler.addTimer(timeout, &stopper.pStopCallback, handle, NULL);
+    pSocketHandler.start_listenting();
+}
+
+TEST_P(CAmDatabaseHandlerTest,transactionSendsChangesAfterNewSink)
+{
+    CAmMainloopStopper stopper(&pSocketHandler);
+    am_Sink_s sink;
+    am_sinkID_t sinkID;
+    am_MainSoundProperty_s property;
+    pCF.createSink(sink);
+    property.type = MSP_UNKNOWN;
+    property.value = 33;
+
+    //the sound property of a sink of the transaction is reported after the sink itself
+    {
+        InSequence sequence;
+        EXPECT_CALL(pMockInterface,cbNewSink(_)).Times(1);
+        EXPECT_CALL(pMockInterface,cbMainSinkSoundPropertyChanged(_,Field(&am_MainSoundProperty_s::value, 33))).Times(1);
+    }
+
+    ASSERT_EQ(E_OK, pDatabaseHandler.beginTransaction());
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID));
+    ASSERT_EQ(E_OK, pDatabaseHandler.changeMainSinkSoundPropertyDB(property,sinkID));
+    ASSERT_EQ(E_OK, pDatabaseHandler.commitTransaction());
+
+    timespec timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_nsec = 100000000;
+    sh_timerHandle_t handle;
+    pSocketHandler.addTimer(timeout, &stopper.pStopCallback, handle, NULL);
+    pSocketHandler.start_listenting();
+}
+
+TEST_P(CAmDatabaseHandlerTest,domainRegistrationWithoutComplete)
+{
+    CAmMainloopStopper stopper(&pSocketHandler);
+    MockIAmControlSend mockControlInterface;
+    IAmControlBackdoor controlInterfaceBackdoor;
+    controlInterfaceBackdoor.replaceController(&pControlSender, &mockControlInterface);
+    CAmRoutingReceiver routingReceiver(&pDatabaseHandler, &pRoutingSender, &pControlSender, &pSocketHandler);
+    am_Domain_s domain;
+    am_domainID_t domainID;
+    am_Sink_s sink;
+    am_sinkID_t sinkID;
+    pCF.createDomain(domain);
+    pCF.createSink(sink);
+
+    //the domain registers a sink in the same dispatch and never sends hookDomainRegistrationComplete
+    EXPECT_CALL(mockControlInterface,hookSystemRegisterDomain(_,_)).WillOnce(Return(E_OK));
+    EXPECT_CALL(mockControlInterface,hookSystemDomainRegistrationComplete(_)).Times(0);
+    EXPECT_CALL(pMockInterface,cbNewSink(_)).Times(1);
+    ASSERT_EQ(E_OK, routingReceiver.registerDomain(domain,domainID));
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID));
+
+    //the next mainloop iteration commits the registration and the new sink is reported
+    timespec timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_nsec = 100000000;
+    sh_timerHandle_t handle;
+    pSocketHandler.addTimer(timeout, &stopper.pStopCallback, handle, NULL);
+    pSocketHandler.start_listenting();
+    ASSERT_EQ(E_NOT_POSSIBLE, pDatabaseHandler.commitTransaction());
+}
+
+TEST_P(CAmDatabaseHandlerTest,valueChangesAreCoalesced)
+{
+    CAmMainloopStopper stopper(&pSocketHandler);
+    am_Sink_s sink;
+    am_sinkID_t sinkID1, sinkID2;
+    pCF.createSink(sink);
+
+    //only the last volume before the second sink is reported, the volume after it comes after the new sink
+    {
+        InSequence sequence;
+        EXPECT_CALL(pMockInterface,cbNewSink(Field(&am_SinkType_s::name, "sink1"))).Times(1);
+        EXPECT_CALL(pMockInterface,cbVolumeChanged(_,20)).Times(1);
+        EXPECT_CALL(pMockInterface,cbNewSink(Field(&am_SinkType_s::name, "sink2"))).Times(1);
+        EXPECT_CALL(pMockInterface,cbVolumeChanged(_,30)).Times(1);
+    }
+    EXPECT_CALL(pMockInterface,cbVolumeChanged(_,10)).Times(0);
+
+    sink.name = "sink1";
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID1));
+    ASSERT_EQ(E_OK, pDatabaseHandler.changeSinkMainVolumeDB(10,sinkID1));
+    ASSERT_EQ(E_OK, pDatabaseHandler.changeSinkMainVolumeDB(20,sinkID1));
+    sink.name = "sink2";
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID2));
+    ASSERT_EQ(E_OK, pDatabaseHandler.changeSinkMainVolumeDB(30,sinkID1));
+
+    timespec timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_nsec = 100000000;
+    sh_timerHandle_t handle;
+    pSocketHandler.addTimer(timeout, &stopper.pStopCallback, handle, NULL);
+    pSocketHandler.start_listenting();
+
+    uint32_t delivered, dropped;
+    uint64_t maxDelayNs;
+    pObserver.getChangeStatistics(delivered, dropped, maxDelayNs);
+    ASSERT_EQ(2u, delivered);
+    ASSERT_EQ(1u, dropped);
+}
+
+TEST(CAmDatabaseStatementCacheTest, statementsAreReused)
+{
+    CAmDatabaseHandler databaseHandler(std::string(":memory:"));
+    CAmCommonFunctions cF;
+    am_Sink_s sink;
+    am_sinkID_t sinkID;
+    cF.createSink(sink);
+    ASSERT_EQ(E_OK, databaseHandler.enterSinkDB(sink,sinkID));
+
+    const std::string command("UPDATE Sinks SET volume=? WHERE sinkID=?");
+    ASSERT_EQ(E_OK, databaseHandler.changeSinkVolume(sinkID,10));
+    ASSERT_EQ(E_OK, databaseHandler.changeSinkVolume(sinkID,20));
+    ASSERT_EQ(E_OK, databaseHandler.changeSinkVolume(sinkID,30));
+
+    am_volume_t volume;
+    ASSERT_EQ(E_OK, databaseHandler.getSinkVolume(sinkID,volume));
+    ASSERT_EQ(30, volume);
+
+    std::vector<CAmDatabaseStatementCache::statementStatistic_s> listStatistics;
+    databaseHandler.getStatementCache().getStatistics(listStatistics);
+    std::vector<CAmDatabaseStatementCache::statementStatistic_s>::iterator iter = listStatistics.begin();
+    for (; iter != listStatistics.end() && iter->command != command; ++iter)
+        ;
+    ASSERT_TRUE(iter != listStatistics.end());
+    ASSERT_EQ(1u, iter->misses);
+    ASSERT_EQ(2u, iter->hits);
+
+    uint32_t hits, misses, evictions;
+    databaseHandler.getStatementCache().getTotals(hits, misses, evictions);
+    ASSERT_LT(0u, hits);
+    ASSERT_EQ(0u, evictions);
+}
+
+TEST(CAmDatabaseStatementCacheTest, nestedUseAndEviction)
+{
+    sqlite3* database = NULL;
+    ASSERT_EQ(SQLITE_OK, sqlite3_open(":memory:", &database));
+    {
+        CAmDatabaseStatementCache cache(2);
+        sqlite3_stmt *outer = NULL, *inner = NULL, *other = NULL;
+        ASSERT_EQ(SQLITE_OK, cache.prepare(database, "SELECT 1", &outer));
+        ASSERT_EQ(SQLITE_OK, cache.prepare(database, "SELECT 1", &inner));
+        ASSERT_NE(outer, inner);
+        ASSERT_EQ(SQLITE_ROW, sqlite3_step(inner));
+        ASSERT_EQ(SQLITE_OK, cache.release(inner));
+        ASSERT_EQ(SQLITE_OK, cache.release(outer));
+
+        ASSERT_EQ(SQLITE_OK, cache.prepare(database, "SELECT 1", &inner));
+        ASSERT_EQ(outer, inner);
+        ASSERT_EQ(SQLITE_OK, cache.release(inner));
+
+        ASSERT_EQ(SQLITE_OK, cache.prepare(database, "SELECT 2", &other));
+        ASSERT_EQ(SQLITE_OK, cache.release(other));
+        ASSERT_EQ(SQLITE_OK, cache.prepare(database, "SELECT 3", &other));
+        ASSERT_EQ(SQLITE_OK, cache.release(other));
+
+        uint32_t hits, misses, evictions;
+        cache.getTotals(hits, misses, evictions);
+        ASSERT_EQ(1u, hits);
+        ASSERT_EQ(4u, misses);
+        ASSERT_EQ(1u, evictions);
+
+        std::vector<CAmDatabaseStatementCache::statementStatistic_s> listStatistics;
+        cache.getStatistics(listStatistics);
+        ASSERT_EQ(2u, listStatistics.size());
+        ASSERT_EQ(std::string("SELECT 2"), listStatistics[0].command);
+        ASSERT_EQ(std::string("SELECT 3"), listStatistics[1].command);
+    }
+    sqlite3_close(database);
+}
+
+TEST(CAmDatabaseStatementCacheTest, listSinksUsesConstantNumberOfQueries)
+{
+    CAmDatabaseHandler databaseHandler(std::string(":memory:"));
+    CAmCommonFunctions cF;
+    am_Sink_s sink;
+    am_sinkID_t sinkID;
+    cF.createSink(sink);
+    for (int i = 0; i < 50; i++)
+    {
+        sink.name = "sink" + std::string(1, 'a' + i % 26) + std::string(1, 'a' + i / 26);
+        ASSERT_EQ(E_OK, databaseHandler.enterSinkDB(sink,sinkID));
+    }
+
+    uint32_t hits, misses, evictions, hitsBefore, missesBefore;
+    databaseHandler.getStatementCache().getTotals(hitsBefore, missesBefore, evictions);
+    std::vector<am_Sink_s> listSinks;
+    ASSERT_EQ(E_OK, databaseHandler.getListSinks(listSinks));
+    ASSERT_EQ(50u, listSinks.size());
+    std::vector<am_Sink_s>::iterator iter = listSinks.begin();
+    for (; iter != listSinks.end(); ++iter)
+    {
+        ASSERT_EQ(sink.listConnectionFormats.size(), iter->listConnectionFormats.size());
+        ASSERT_EQ(sink.listSoundProperties.size(), iter->listSoundProperties.size());
+        ASSERT_EQ(sink.listMainSoundProperties.size(), iter->listMainSoundProperties.size());
+    }
+
+    databaseHandler.getStatementCache().getTotals(hits, misses, evictions);
+    ASSERT_EQ(4u, hits + misses - hitsBefore - missesBefore);
+}
+
+TEST(CAmDatabaseSnapshotTest, listsAreReadOnlyAfterChanges)
+{
+    CAmDatabaseHandler databaseHandler(std::string(":memory:"));
+    CAmCommonFunctions cF;
+    am_Sink_s sink;
+    am_sinkID_t sinkID;
+    am_Source_s source;
+    am_sourceID_t sourceID;
+    cF.createSink(sink);
+    cF.createSource(source);
+    ASSERT_EQ(E_OK, databaseHandler.enterSinkDB(sink,sinkID));
+    ASSERT_EQ(E_OK, databaseHandler.enterSourceDB(source,sourceID));
+
+    uint32_t hits, misses, evictions, hitsBefore, missesBefore;
+    std::vector<am_SinkType_s> listMainSinks;
+    std::vector<am_Sink_s> listSinks;
+    ASSERT_EQ(E_OK, databaseHandler.getListMainSinks(listMainSinks));
+    ASSERT_EQ(E_OK, databaseHandler.getListSinks(listSinks));
+
+    //nothing changed, so no query is needed
+    databaseHandler.getStatementCache().getTotals(hitsBefore, missesBefore, evictions);
+    for (int i = 0; i < 10; i++)
+    {
+        ASSERT_EQ(E_OK, databaseHandler.getListMainSinks(listMainSinks));
+        ASSERT_EQ(E_OK, databaseHandler.getListSinks(listSinks));
+    }
+    databaseHandler.getStatementCache().getTotals(hits, misses, evictions);
+    ASSERT_EQ(0u, hits + misses - hitsBefore - missesBefore);
+    ASSERT_EQ(1u, listMainSinks.size());
+    ASSERT_EQ(sink.mainVolume, listMainSinks[0].volume);
+
+    //a change of a source does not touch the sink lists
+    ASSERT_EQ(E_OK, databaseHandler.changeSourceVolume(sourceID,10));
+    databaseHandler.getStatementCache().getTotals(hitsBefore, missesBefore, evictions);
+    ASSERT_EQ(E_OK, databaseHandler.getListMainSinks(listMainSinks));
+    databaseHandler.getStatementCache().getTotals(hits, misses, evictions);
+    ASSERT_EQ(0u, hits + misses - hitsBefore - missesBefore);
+
+    //a change of the sink is seen by both lists
+    ASSERT_EQ(E_OK, databaseHandler.changeSinkMainVolumeDB(40,sinkID));
+    ASSERT_EQ(E_OK, databaseHandler.getListMainSinks(listMainSinks));
+    ASSERT_EQ(40, listMainSinks[0].volume);
+    ASSERT_EQ(E_OK, databaseHandler.getListSinks(listSinks));
+    ASSERT_EQ(40, listSinks[0].mainVolume);
+
+    //also if only a related table changed
+    am_SoundProperty_s soundProperty = sink.listSoundProperties[0];
+    soundProperty.value = 99;
+    ASSERT_EQ(E_OK, databaseHandler.changeSinkSoundPropertyDB(soundProperty,sinkID));
+    ASSERT_EQ(E_OK, databaseHandler.getListSinks(listSinks));
+    ASSERT_EQ(99, listSinks[0].listSoundProperties[0].value);
+
+    std::vector<CAmDatabaseHandler::snapshotStatistic_s> listStatistics;
+    databaseHandler.getSnapshotStatistics(listStatistics);
+    std::vector<CAmDatabaseHandler::snapshotStatistic_s>::iterator iter = listStatistics.begin();
+    for (; iter != listStatistics.end(); ++iter)
+    {
+        if (iter->name == "MainSinks")
+        {
+            ASSERT_EQ(2u, iter->builds);
+            ASSERT_EQ(11u, iter->hits);
+        }
+        if (iter->name == "Sinks")
+        {
+            ASSERT_EQ(3u, iter->builds);
+            ASSERT_EQ(10u, iter->hits);
+        }
+    }
+}
+
+TEST(CAmDatabaseSettingsTest, settingsAreApplied)
+{
+    CAmDatabaseHandler::databaseSettings_s settings;
+    ASSERT_FALSE(settings.set("journal_mode", "FAST"));
+    ASSERT_FALSE(settings.set("synchronous", "4"));
+    ASSERT_FALSE(settings.set("cache_size", "big"));
+    ASSERT_FALSE(settings.set("mmap_size", "-1"));
+    ASSERT_FALSE(settings.set("page_size", "4096"));
+    ASSERT_TRUE(settings.set("journal_mode", "wal"));
+    ASSERT_TRUE(settings.set("synchronous", "off"));
+    ASSERT_TRUE(settings.set("cache_size", "-4096"));
+
+    {
+        CAmDatabaseHandler databaseHandler(std::string(TEST_DATABASE_FILE), settings);
+        ASSERT_EQ("WAL", databaseHandler.getSettings().journalMode);
+        ASSERT_EQ("OFF", databaseHandler.getSettings().synchronous);
+        ASSERT_EQ(-4096, databaseHandler.getSettings().cacheSize);
+    }
+    CAmDatabaseHandlerTest::removeDatabaseFile();
+
+    //an in-memory database has no journal file, sqlite keeps it in memory whatever is asked for
+    CAmDatabaseHandler databaseHandler(std::string(":memory:"), settings);
+    ASSERT_EQ("MEMORY", databaseHandler.getSettings().journalMode);
+    ASSERT_EQ("OFF", databaseHandler.getSettings().synchronous);
+}
+
+INSTANTIATE_TEST_CASE_P(DatabaseBackends, CAmDatabaseHandlerTest,::testing::Values(std::string("sqlite"), std::string("sqlite-wal"), std::string("sqlite-nosync"), std::string("map")));
+
 //Commented out - gives always a warning..
 //TEST_F(databaseTest,registerDomainFailonID0)
 //{
@@ -27,6 +27,7 @@
 #include "gmock/gmock.h"
 
 #include "CAmDatabaseHandler.h"
+#include "CAmDatabaseHandlerMap.h"
 #include "CAmControlReceiver.h"
 #include "CAmControlSender.h"
 #include "CAmDatabaseObserver.h"
@@ -43,7 +44,25 @@
 namespace am
 {
 
-class CAmDatabaseHandlerTest: public ::testing::Test
+#define TEST_DATABASE_FILE "/tmp/AmDatabaseHandlerTest.db" //!< the database file for the sqlite modes that are not in memory
+
+/**
+ * stops the mainloop when its timer fires, so that the calls queued by the serializer can be dispatched in a test
+ */
+class CAmMainloopStopper
+{
+public:
+    CAmMainloopStopper(CAmSocketHandler *socketHandler);
+    void stop(sh_timerHandle_t handle, void* userData);
+    TAmShTimerCallBack<CAmMainloopStopper> pStopCallback;
+private:
+    CAmSocketHandler *mSocketHandler;
+};
+
+/**
+ * runs every test against each storage backend, the parameter names the backend
+ */
+class CAmDatabaseHandlerTest: public ::testing::TestWithParam<std::string>
 {
 public:
     CAmDatabaseHandlerTest();
@@ -51,7 +70,7 @@ public:
     std::vector<std::string> plistRoutingPluginDirs;
     std::vector<std::string> plistCommandPluginDirs;
     CAmSocketHandler pSocketHandler;
-    CAmDatabaseHandler pDatabaseHandler;
+    IAmDatabaseHandler& pDatabaseHandler;
     CAmRoutingSender pRoutingSender;
     CAmCommandSender pCommandSender;
     MockIAmCommandSend pMockInterface;
@@ -66,6 +85,8 @@ public:
     void TearDown();
 
     void createMainConnectionSetup();
+    static IAmDatabaseHandler* createDatabaseHandler(const std::string& storage);
+    static void removeDatabaseFile();
 };
 
 }
@@ -19,6 +19,7 @@
  */
 
 #include "CAmRoutingInterfaceTest.h"
+#include "CAmRoutingReceiver.h"
 #include "shared/CAmDltWrapper.h"
 
 using namespace am;
@@ -37,7 +38,9 @@ CAmRoutingInterfaceTest::CAmRoutingInterfaceTest() :
         pRoutingInterfaceBackdoor(), //
         pCommandInterfaceBackdoor(), //
         pControlReceiver(&pDatabaseHandler, &pRoutingSender, &pCommandSender, &pSocketHandler, &pRouter), //
-        pObserver(&pCommandSender, &pRoutingSender, &pSocketHandler)
+        pObserver(&pCommandSender, &pRoutingSender, &pRouter, &pSocketHandler), //
+        pCF(), //
+        pStopCallback(this, &CAmRoutingInterfaceTest::stopMainloop)
 {
     pDatabaseHandler.registerObserver(&pObserver);
     pRoutingInterfaceBackdoor.unloadPlugins(&pRoutingSender);
@@ -59,6 +62,27 @@ void CAmRoutingInterfaceTest::TearDown()
 {
 }
 
+/**
+ * runs the mainloop for 100ms, so that the calls queued by the serializer are dispatched
+ */
+void CAmRoutingInterfaceTest::runMainloop()
+{
+    timespec timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_nsec = 100000000;
+    sh_timerHandle_t handle;
+    pSocketHandler.addTimer(timeout, &pStopCallback, handle, NULL);
+    pSocketHandler.start_listenting();
+    pSocketHandler.removeTimer(handle);
+}
+
+void CAmRoutingInterfaceTest::stopMainloop(sh_timerHandle_t handle, void* userData)
+{
+    (void) handle;
+    (void) userData;
+    pSocketHandler.stop_listening();
+}
+
 TEST_F(CAmRoutingInterfaceTest,abort)
 {
     am_Sink_s sink;
@@ -430,6 +454,239 @@ TEST_F(CAmRoutingInterfaceTest,setSourceStateNoChange)
     ASSERT_EQ(E_NO_CHANGE, pControlReceiver.setSourceState(handle,sourceID,state));
 }
 
+TEST_F(CAmRoutingInterfaceTest,handleLatencies)
+{
+    am_Sink_s sink;
+    am_sinkID_t sinkID;
+    am_Domain_s domain;
+    am_domainID_t domainID;
+    am_Handle_s handle, refusedHandle;
+    am_connectionID_t connectionID;
+    std::vector<CAmRoutingSender::handleStatistic_s> listStatistics;
+    pCF.createSink(sink);
+    pCF.createDomain(domain);
+    domain.name = "mock";
+    domain.busname = "mock";
+    sink.sinkID = 2;
+    sink.domainID = 1;
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterDomainDB(domain,domainID));
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID));
+    EXPECT_CALL(pMockInterface,asyncConnect(_,_,1,sinkID,CF_GENIVI_ANALOG)).WillOnce(Return(E_OK)).WillOnce(Return(E_NOT_POSSIBLE));
+    ASSERT_EQ(E_OK, pControlReceiver.connect(handle,connectionID,CF_GENIVI_ANALOG,1,2));
+    ASSERT_EQ(E_NOT_POSSIBLE, pControlReceiver.connect(refusedHandle,connectionID,CF_GENIVI_ANALOG,1,2));
+    pRoutingSender.getHandleStatistics(listStatistics);
+    ASSERT_TRUE(listStatistics.empty());
+
+    pRoutingSender.traceHandleAck(handle);
+    ASSERT_EQ(E_OK, pRoutingSender.removeHandle(handle));
+    //the refused handle was released right away and never shows up in the statistics
+    ASSERT_EQ(E_UNKNOWN, pRoutingSender.removeHandle(refusedHandle));
+    pRoutingSender.getHandleStatistics(listStatistics);
+    ASSERT_EQ(1u, listStatistics.size());
+    ASSERT_EQ(H_CONNECT, listStatistics[0].handleType);
+    ASSERT_EQ(std::string("mock"), listStatistics[0].busName);
+    ASSERT_EQ(1u, listStatistics[0].count);
+    ASSERT_LE(listStatistics[0].dispatchNs + listStatistics[0].pluginNs + listStatistics[0].storeNs, listStatistics[0].maxNs);
+    uint32_t histogramCount = 0;
+    for (int i = 0; i < HANDLE_LATENCY_BUCKETS; i++)
+        histogramCount += listStatistics[0].histogram[i];
+    ASSERT_EQ(1u, histogramCount);
+}
+
+TEST_F(CAmRoutingInterfaceTest,handleTable)
+{
+    am_Sink_s sink;
+    am_sinkID_t sinkID;
+    am_Domain_s domain;
+    am_domainID_t domainID;
+    am_Handle_s handle, staleHandle;
+    am_connectionID_t connectionID;
+    std::vector<am_Handle_s> listHandles;
+    std::vector<uint16_t> listCounts;
+    pCF.createSink(sink);
+    pCF.createDomain(domain);
+    domain.name = "mock";
+    domain.busname = "mock";
+    sink.sinkID = 2;
+    sink.domainID = 1;
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterDomainDB(domain,domainID));
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID));
+    EXPECT_CALL(pMockInterface,asyncConnect(_,_,1,sinkID,CF_GENIVI_ANALOG)).WillRepeatedly(Return(E_OK));
+    ASSERT_EQ(E_OK, pControlReceiver.connect(staleHandle,connectionID,CF_GENIVI_ANALOG,1,2));
+    pRoutingSender.getOutstandingHandles(listCounts);
+    ASSERT_EQ(static_cast<size_t>(H_MAX), listCounts.size());
+    ASSERT_EQ(1, listCounts[H_CONNECT]);
+    ASSERT_EQ(connectionID, pRoutingSender.returnHandleData(staleHandle).connectionID);
+    ASSERT_EQ(E_OK, pRoutingSender.removeHandle(staleHandle));
+    pRoutingSender.getOutstandingHandles(listCounts);
+    ASSERT_EQ(0, listCounts[H_CONNECT]);
+
+    //a released handle is not reused before HANDLE_REUSE_DISTANCE other handles were released
+    for (int i = 0; i < HANDLE_REUSE_DISTANCE; i++)
+    {
+        ASSERT_EQ(E_OK, pControlReceiver.connect(handle,connectionID,CF_GENIVI_ANALOG,1,2));
+        ASSERT_NE(staleHandle.handle, handle.handle);
+        ASSERT_EQ(E_UNKNOWN, pRoutingSender.removeHandle(staleHandle));
+        ASSERT_EQ(0, pRoutingSender.returnHandleData(staleHandle).connectionID);
+        ASSERT_EQ(E_OK, pRoutingSender.removeHandle(handle));
+    }
+    ASSERT_EQ(E_OK, pControlReceiver.connect(handle,connectionID,CF_GENIVI_ANALOG,1,2));
+    ASSERT_EQ(staleHandle.handle, handle.handle);
+    ASSERT_EQ(E_OK, pControlReceiver.getListHandles(listHandles));
+    ASSERT_EQ(1u, listHandles.size());
+
+    //the same handle value with another type is stale as well
+    staleHandle.handleType = H_SETSINKVOLUME;
+    ASSERT_EQ(E_UNKNOWN, pRoutingSender.removeHandle(staleHandle));
+    ASSERT_EQ(E_OK, pRoutingSender.removeHandle(handle));
+}
+
+TEST_F(CAmRoutingInterfaceTest,pluginStartupTimeline)
+{
+    CAmRoutingReceiver routingReceiver(&pDatabaseHandler, &pRoutingSender, &pControlSender, &pSocketHandler);
+    EXPECT_CALL(pMockInterface,startupInterface(&routingReceiver)).WillOnce(Return(E_OK));
+    ASSERT_EQ(E_OK, pRoutingSender.startupInterfaces(&routingReceiver));
+
+    std::vector<pluginStartup_s> listStartup;
+    pRoutingSender.getPluginStartupTimes(listStartup);
+    ASSERT_EQ(1u, listStartup.size());
+    EXPECT_EQ(std::string("mock"), listStartup[0].name);
+    EXPECT_FALSE(listStartup[0].deferred);
+    EXPECT_GT(listStartup[0].startupNs, 0u);
+    EXPECT_EQ(0u, listStartup[0].readyNs);
+
+    //the ready time is stamped with the handle the plugin got, an unknown handle changes nothing
+    uint16_t handle = 0;
+    EXPECT_CALL(pMockInterface,setRoutingReady(_)).WillOnce(SaveArg<0>(&handle));
+    pRoutingSender.setRoutingReady();
+    ASSERT_NE(0, handle);
+    pRoutingSender.traceReadyConfirm(handle + 1);
+    pRoutingSender.getPluginStartupTimes(listStartup);
+    EXPECT_EQ(0u, listStartup[0].readyNs);
+    pRoutingSender.traceReadyConfirm(handle);
+    pRoutingSender.getPluginStartupTimes(listStartup);
+    EXPECT_EQ(handle, listStartup[0].readyHandle);
+    EXPECT_GE(listStartup[0].readyNs, listStartup[0].startupNs);
+
+    //nothing was deferred, so there is nothing to start
+    EXPECT_EQ(E_OK, pRoutingSender.startupDeferredInterfaces());
+    pRoutingSender.getPluginStartupTimes(listStartup);
+    EXPECT_EQ(1u, listStartup.size());
+}
+
+TEST_F(CAmRoutingInterfaceTest,pluginsLoadWithThreads)
+{
+    std::vector<std::string> listLibraries;
+    listLibraries.push_back(std::string(TEST_PLUGIN_DIR) + "/libTestRoutingPluginC.so");
+    listLibraries.push_back(std::string(TEST_PLUGIN_DIR) + "/libTestRoutingPluginA.so");
+    listLibraries.push_back(std::string(TEST_PLUGIN_DIR) + "/libTestRoutingPluginB.so");
+    std::vector<TAmPluginLoader<IAmRoutingSend>::load_s> listLoaded;
+    TAmPluginLoader<IAmRoutingSend>::load(listLibraries, 3, listLoaded);
+
+    //the results keep the order of the list, no matter which thread loaded them
+    const char* listBusNames[] =
+    { "TestRoutingPluginC", "TestRoutingPluginA", "TestRoutingPluginB" };
+    ASSERT_EQ(listLibraries.size(), listLoaded.size());
+    for (size_t i = 0; i < listLoaded.size(); i++)
+    {
+        EXPECT_EQ(listLibraries[i], listLoaded[i].libname);
+        ASSERT_TRUE(listLoaded[i].plugin!=NULL);
+        std::string busName;
+        listLoaded[i].plugin->returnBusName(busName);
+        EXPECT_EQ(std::string(listBusNames[i]), busName);
+        delete listLoaded[i].plugin;
+    }
+
+    //each factory takes TEST_PLUGIN_LOAD_DELAY, with three threads they were all running at the same time
+    EXPECT_LT(listLoaded[1].loadNs, listLoaded[0].createdNs);
+    EXPECT_LT(listLoaded[2].loadNs, listLoaded[0].createdNs);
+
+    //the routing sender starts the plugins in the order they were found, with any number of loader threads
+    std::vector<std::string> listDirectories(1, TEST_PLUGIN_DIR);
+    CAmRoutingSender routingSender(listDirectories, 2);
+    CAmRoutingReceiver routingReceiver(&pDatabaseHandler, &routingSender, &pControlSender, &pSocketHandler);
+    ASSERT_EQ(E_OK, routingSender.startupInterfaces(&routingReceiver));
+    std::vector<pluginStartup_s> listStartup;
+    routingSender.getPluginStartupTimes(listStartup);
+    ASSERT_EQ(3u, listStartup.size());
+    for (size_t i = 0; i < listStartup.size(); i++)
+    {
+        EXPECT_FALSE(listStartup[i].deferred);
+        EXPECT_GT(listStartup[i].createdNs, listStartup[i].loadNs);
+        EXPECT_GT(listStartup[i].startupNs, 0u);
+        if (i > 0)
+        {
+            EXPECT_GE(listStartup[i].startupNs, listStartup[i - 1].startupNs);
+        }
+    }
+}
+
+TEST_F(CAmRoutingInterfaceTest,deferredPluginStartsOnFirstConnection)
+{
+    std::vector<std::string> listDirectories(1, TEST_PLUGIN_DIR);
+    std::vector<std::string> listDeferred(1, "libTestRoutingPluginB.so");
+    CAmRoutingSender routingSender(listDirectories, 2, listDeferred);
+    CAmDatabaseObserver observer(&pCommandSender, &routingSender, &pRouter, &pSocketHandler);
+    CAmRoutingReceiver routingReceiver(&pDatabaseHandler, &routingSender, &pControlSender, &pSocketHandler);
+    ASSERT_EQ(E_OK, routingSender.startupInterfaces(&routingReceiver));
+
+    std::vector<pluginStartup_s> listStartup;
+    routingSender.getPluginStartupTimes(listStartup);
+    ASSERT_EQ(2u, listStartup.size());
+    for (size_t i = 0; i < listStartup.size(); i++)
+    {
+        EXPECT_FALSE(listStartup[i].deferred);
+        EXPECT_EQ(std::string::npos, listStartup[i].name.find("libTestRoutingPluginB.so"));
+    }
+
+    //a connection that is not connected yet does not start the deferred plugin
+    observer.mainConnectionStateChanged(1, CS_CONNECTING);
+    runMainloop();
+    routingSender.getPluginStartupTimes(listStartup);
+    ASSERT_EQ(2u, listStartup.size());
+
+    //the first connected main connection starts it, once
+    observer.mainConnectionStateChanged(1, CS_CONNECTED);
+    observer.mainConnectionStateChanged(2, CS_CONNECTED);
+    runMainloop();
+    routingSender.getPluginStartupTimes(listStartup);
+    ASSERT_EQ(3u, listStartup.size());
+    EXPECT_TRUE(listStartup[2].deferred);
+    EXPECT_NE(std::string::npos, listStartup[2].name.find("libTestRoutingPluginB.so"));
+    EXPECT_GT(listStartup[2].startupNs, 0u);
+
+    observer.mainConnectionStateChanged(1, CS_DISCONNECTED);
+    observer.mainConnectionStateChanged(1, CS_CONNECTED);
+    runMainloop();
+    routingSender.getPluginStartupTimes(listStartup);
+    EXPECT_EQ(3u, listStartup.size());
+
+    //a main connection that is already connected when it is entered starts it as well
+    CAmRoutingSender secondRoutingSender(listDirectories, 2, listDeferred);
+    CAmDatabaseObserver secondObserver(&pCommandSender, &secondRoutingSender, &pRouter, &pSocketHandler);
+    CAmRoutingReceiver secondRoutingReceiver(&pDatabaseHandler, &secondRoutingSender, &pControlSender, &pSocketHandler);
+    ASSERT_EQ(E_OK, secondRoutingSender.startupInterfaces(&secondRoutingReceiver));
+    am_MainConnectionType_s mainConnection;
+    mainConnection.mainConnectionID = 1;
+    mainConnection.sourceID = 1;
+    mainConnection.sinkID = 1;
+    mainConnection.delay = 0;
+    mainConnection.connectionState = CS_CONNECTING;
+    secondObserver.newMainConnection(mainConnection);
+    runMainloop();
+    secondRoutingSender.getPluginStartupTimes(listStartup);
+    ASSERT_EQ(2u, listStartup.size());
+
+    mainConnection.mainConnectionID = 2;
+    mainConnection.connectionState = CS_CONNECTED;
+    secondObserver.newMainConnection(mainConnection);
+    secondObserver.mainConnectionStateChanged(1, CS_CONNECTED);
+    runMainloop();
+    secondRoutingSender.getPluginStartupTimes(listStartup);
+    ASSERT_EQ(3u, listStartup.size());
+    EXPECT_TRUE(listStartup[2].deferred);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -41,6 +41,13 @@
 namespace am
 {
 
+/**
+ * the directory of the test plugins libTestRoutingPluginA.so, libTestRoutingPluginB.so and libTestRoutingPluginC.so
+ */
+#ifndef TEST_PLUGIN_DIR
+#define TEST_PLUGIN_DIR "testplugins"
+#endif
+
 class CAmRoutingInterfaceTest: public ::testing::Test
 {
 public:
@@ -60,8 +67,12 @@ public:
     CAmControlReceiver pControlReceiver;
     CAmDatabaseObserver pObserver;
     CAmCommonFunctions pCF;
+    TAmShTimerCallBack<CAmRoutingInterfaceTest> pStopCallback;
     void SetUp();
     void TearDown();
+
+    void runMainloop();
+    void stopMainloop(sh_timerHandle_t handle, void* userData);
 };
 
 }
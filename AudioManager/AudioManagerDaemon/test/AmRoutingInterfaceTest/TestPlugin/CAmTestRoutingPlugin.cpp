@@ -0,0 +1,167 @@
+/**
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \author Christian Mueller, christian.ei.mueller@bmw.de BMW 2011,2012
+ *
+ * \file CAmTestRoutingPlugin.cpp
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#include <unistd.h>
+#include "routing/IAmRoutingSend.h"
+
+/**
+ * time in ms the factory of the test plugin takes, so that loading with several threads can be told apart
+ */
+#ifndef TEST_PLUGIN_LOAD_DELAY
+#define TEST_PLUGIN_LOAD_DELAY 100
+#endif
+
+namespace am
+{
+
+/**
+ * a routing plugin that does nothing. It is built several times with different names to test the loading of plugins.
+ */
+class CAmTestRoutingPlugin: public IAmRoutingSend
+{
+public:
+    CAmTestRoutingPlugin()
+    {
+    }
+    ~CAmTestRoutingPlugin()
+    {
+    }
+    am_Error_e startupInterface(IAmRoutingReceive* routingreceiveinterface)
+    {
+        (void) routingreceiveinterface;
+        return (E_OK);
+    }
+    void setRoutingReady(const uint16_t handle)
+    {
+        (void) handle;
+    }
+    void setRoutingRundown(const uint16_t handle)
+    {
+        (void) handle;
+    }
+    am_Error_e asyncAbort(const am_Handle_s handle)
+    {
+        (void) handle;
+        return (E_NOT_POSSIBLE);
+    }
+    am_Error_e asyncConnect(const am_Handle_s handle, const am_connectionID_t connectionID, const am_sourceID_t sourceID, const am_sinkID_t sinkID, const am_ConnectionFormat_e connectionFormat)
+    {
+        (void) handle;
+        (void) connectionID;
+        (void) sourceID;
+        (void) sinkID;
+        (void) connectionFormat;
+        return (E_NOT_POSSIBLE);
+    }
+    am_Error_e asyncDisconnect(const am_Handle_s handle, const am_connectionID_t connectionID)
+    {
+        (void) handle;
+        (void) connectionID;
+        return (E_NOT_POSSIBLE);
+    }
+    am_Error_e asyncSetSinkVolume(const am_Handle_s handle, const am_sinkID_t sinkID, const am_volume_t volume, const am_RampType_e ramp, const am_time_t time)
+    {
+        (void) handle;
+        (void) sinkID;
+        (void) volume;
+        (void) ramp;
+        (void) time;
+        return (E_NOT_POSSIBLE);
+    }
+    am_Error_e asyncSetSourceVolume(const am_Handle_s handle, const am_sourceID_t sourceID, const am_volume_t volume, const am_RampType_e ramp, const am_time_t time)
+    {
+        (void) handle;
+        (void) sourceID;
+        (void) volume;
+        (void) ramp;
+        (void) time;
+        return (E_NOT_POSSIBLE);
+    }
+    am_Error_e asyncSetSourceState(const am_Handle_s handle, const am_sourceID_t sourceID, const am_SourceState_e state)
+    {
+        (void) handle;
+        (void) sourceID;
+        (void) state;
+        return (E_NOT_POSSIBLE);
+    }
+    am_Error_e asyncSetSinkSoundProperties(const am_Handle_s handle, const am_sinkID_t sinkID, const std::vector<am_SoundProperty_s>& listSoundProperties)
+    {
+        (void) handle;
+        (void) sinkID;
+        (void) listSoundProperties;
+        return (E_NOT_POSSIBLE);
+    }
+    am_Error_e asyncSetSinkSoundProperty(const am_Handle_s handle, const am_sinkID_t sinkID, const am_SoundProperty_s& soundProperty)
+    {
+        (void) handle;
+        (void) sinkID;
+        (void) soundProperty;
+        return (E_NOT_POSSIBLE);
+    }
+    am_Error_e asyncSetSourceSoundProperties(const am_Handle_s handle, const am_sourceID_t sourceID, const std::vector<am_SoundProperty_s>& listSoundProperties)
+    {
+        (void) handle;
+        (void) sourceID;
+        (void) listSoundProperties;
+        return (E_NOT_POSSIBLE);
+    }
+    am_Error_e asyncSetSourceSoundProperty(const am_Handle_s handle, const am_sourceID_t sourceID, const am_SoundProperty_s& soundProperty)
+    {
+        (void) handle;
+        (void) sourceID;
+        (void) soundProperty;
+        return (E_NOT_POSSIBLE);
+    }
+    am_Error_e asyncCrossFade(const am_Handle_s handle, const am_crossfaderID_t crossfaderID, const am_HotSink_e hotSink, const am_RampType_e rampType, const am_time_t time)
+    {
+        (void) handle;
+        (void) crossfaderID;
+        (void) hotSink;
+        (void) rampType;
+        (void) time;
+        return (E_NOT_POSSIBLE);
+    }
+    am_Error_e setDomainState(const am_domainID_t domainID, const am_DomainState_e domainState)
+    {
+        (void) domainID;
+        (void) domainState;
+        return (E_NOT_POSSIBLE);
+    }
+    am_Error_e returnBusName(std::string& BusName) const
+    {
+        BusName = TEST_PLUGIN_NAME;
+        return (E_OK);
+    }
+    void getInterfaceVersion(std::string& version) const
+    {
+        version = RoutingSendVersion;
+    }
+};
+
+}
+
+using namespace am;
+
+extern "C" IAmRoutingSend* TEST_PLUGIN_FACTORY()
+{
+    usleep(TEST_PLUGIN_LOAD_DELAY * 1000);
+    return (new CAmTestRoutingPlugin());
+}
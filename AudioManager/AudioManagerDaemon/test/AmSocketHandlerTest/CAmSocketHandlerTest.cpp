@@ -138,6 +138,268 @@ TEST(CAmSocketHandlerTest,playWithTimers)
 }
 
 
+TEST(CAmSocketHandlerTest,pollSameFiledescriptorTwice)
+{
+    CAmSocketHandler myHandler;
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    ASSERT_EQ(1, write(fds[1], "x", 1));
+
+    CAmSharedFdPlugin plugin(&myHandler, fds[0]);
+    ASSERT_NE(0, plugin.mReadHandle);
+    ASSERT_NE(0, plugin.mWriteHandle);
+    ASSERT_NE(plugin.mReadHandle, plugin.mWriteHandle);
+
+    timespec timeout;
+    timeout.tv_sec = 2;
+    timeout.tv_nsec = 0;
+    sh_timerHandle_t timerHandle;
+    myHandler.addTimer(timeout, &plugin.timeoutCB, timerHandle, NULL);
+    myHandler.start_listenting();
+
+    //both polls fired once, the write poll removed itself in its callback
+    EXPECT_EQ(1, plugin.mReadCount);
+    EXPECT_EQ(1, plugin.mWriteCount);
+    EXPECT_EQ(E_UNKNOWN, myHandler.removeFDPoll(plugin.mWriteHandle));
+    EXPECT_EQ(E_UNKNOWN, myHandler.updateEventFlags(plugin.mWriteHandle, POLLOUT));
+    EXPECT_EQ(E_OK, myHandler.updateEventFlags(plugin.mReadHandle, 0));
+    EXPECT_EQ(E_OK, myHandler.removeFDPoll(plugin.mReadHandle));
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(CAmSocketHandlerTest,timersFireInOrder)
+{
+    CAmSocketHandler myHandler;
+    CAmBusyTimerPlugin plugin(&myHandler);
+    sh_timerHandle_t handles[5], lastHandle, stoppedHandle;
+    timespec timeout;
+    timeout.tv_sec = 0;
+
+    //added in reverse order of their deadlines
+    for (int i = 4; i >= 0; i--)
+    {
+        timeout.tv_nsec = (i + 1) * 20000000;
+        ASSERT_EQ(E_OK, myHandler.addTimer(timeout, &plugin.timerCB, handles[i], NULL));
+    }
+    timeout.tv_nsec = 10000000;
+    ASSERT_EQ(E_OK, myHandler.addTimer(timeout, &plugin.timerCB, stoppedHandle, NULL));
+    timeout.tv_nsec = 200000000;
+    ASSERT_EQ(E_OK, myHandler.addTimer(timeout, &plugin.lastTimerCB, lastHandle, NULL));
+
+    //the stopped timer does not fire, the updated one moves to the end
+    ASSERT_EQ(E_OK, myHandler.stopTimer(stoppedHandle));
+    ASSERT_EQ(E_NON_EXISTENT, myHandler.stopTimer(stoppedHandle));
+    timeout.tv_nsec = 150000000;
+    ASSERT_EQ(E_OK, myHandler.updateTimer(handles[0], timeout));
+    myHandler.start_listenting();
+
+    ASSERT_EQ(6u, plugin.mListFiredTimer.size());
+    EXPECT_EQ(handles[1], plugin.mListFiredTimer[0]);
+    EXPECT_EQ(handles[2], plugin.mListFiredTimer[1]);
+    EXPECT_EQ(handles[3], plugin.mListFiredTimer[2]);
+    EXPECT_EQ(handles[4], plugin.mListFiredTimer[3]);
+    EXPECT_EQ(handles[0], plugin.mListFiredTimer[4]);
+    EXPECT_EQ(lastHandle, plugin.mListFiredTimer[5]);
+
+    //a fired timer can be restarted, a removed one is gone
+    EXPECT_EQ(E_OK, myHandler.restartTimer(handles[1]));
+    EXPECT_EQ(E_OK, myHandler.removeTimer(handles[1]));
+    EXPECT_EQ(E_UNKNOWN, myHandler.removeTimer(handles[1]));
+    EXPECT_EQ(E_NON_EXISTENT, myHandler.restartTimer(handles[1]));
+}
+
+TEST(CAmSocketHandlerTest,removedTimerHandleIsNotReusedRightAway)
+{
+    CAmSocketHandler myHandler;
+    CAmBusyTimerPlugin plugin(&myHandler);
+    std::vector<sh_timerHandle_t> listHandles(TIMER_HANDLE_REUSE_DISTANCE + 1);
+    sh_timerHandle_t staleHandle, newHandle;
+    timespec timeout;
+    timeout.tv_sec = 10;
+    timeout.tv_nsec = 0;
+
+    //a stale handle does not hit the timer that is added next
+    ASSERT_EQ(E_OK, myHandler.addTimer(timeout, &plugin.timerCB, staleHandle, NULL));
+    ASSERT_EQ(E_OK, myHandler.removeTimer(staleHandle));
+    ASSERT_EQ(E_OK, myHandler.addTimer(timeout, &plugin.timerCB, newHandle, NULL));
+    EXPECT_NE(staleHandle, newHandle);
+    EXPECT_EQ(E_NON_EXISTENT, myHandler.stopTimer(staleHandle));
+    EXPECT_EQ(E_UNKNOWN, myHandler.removeTimer(staleHandle));
+    EXPECT_EQ(E_OK, myHandler.stopTimer(newHandle));
+
+    //once enough other handles were removed after it, the oldest free handle is reused
+    for (size_t i = 0; i < listHandles.size(); i++)
+        ASSERT_EQ(E_OK, myHandler.addTimer(timeout, &plugin.timerCB, listHandles[i], NULL));
+    for (size_t i = 0; i < listHandles.size(); i++)
+        ASSERT_EQ(E_OK, myHandler.removeTimer(listHandles[i]));
+    ASSERT_EQ(E_OK, myHandler.addTimer(timeout, &plugin.timerCB, newHandle, NULL));
+    EXPECT_EQ(staleHandle, newHandle);
+}
+
+TEST(CAmSocketHandlerTest,timersFireWhileFiledescriptorIsBusy)
+{
+    CAmSocketHandler myHandler;
+    CAmBusyTimerPlugin plugin(&myHandler);
+
+    //the data is never read, so the filedescriptor fires on every loop
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    ASSERT_EQ(1, write(fds[1], "x", 1));
+    sh_pollHandle_t pollHandle;
+    ASSERT_EQ(E_OK, myHandler.addFDPoll(fds[0], POLLIN, NULL, &plugin.busyFiredCB, NULL, NULL, NULL, pollHandle));
+
+    timespec timeout, start, end;
+    timeout.tv_sec = 0;
+    timeout.tv_nsec = 50000000;
+    sh_timerHandle_t timerHandle;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ASSERT_EQ(E_OK, myHandler.addTimer(timeout, &plugin.lastTimerCB, timerHandle, NULL));
+    myHandler.start_listenting();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    ASSERT_EQ(1u, plugin.mListFiredTimer.size());
+    EXPECT_EQ(timerHandle, plugin.mListFiredTimer[0]);
+    EXPECT_GT(plugin.mBusyCount, 1);
+    long elapsedNs = (end.tv_sec - start.tv_sec) * 1000000000L + end.tv_nsec - start.tv_nsec;
+    EXPECT_GE(elapsedNs, timeout.tv_nsec);
+
+    myHandler.removeFDPoll(pollHandle);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(CAmSocketHandlerTest,statisticsOfBusyFiledescriptor)
+{
+    CAmSocketHandler myHandler;
+    CAmBusyTimerPlugin plugin(&myHandler);
+
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    ASSERT_EQ(1, write(fds[1], "x", 1));
+    sh_pollHandle_t pollHandle;
+    ASSERT_EQ(E_OK, myHandler.addFDPoll(fds[0], POLLIN, NULL, &plugin.busyFiredCB, NULL, NULL, NULL, pollHandle));
+
+    timespec timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_nsec = 20000000;
+    sh_timerHandle_t timerHandle;
+    ASSERT_EQ(E_OK, myHandler.addTimer(timeout, &plugin.lastTimerCB, timerHandle, NULL));
+    myHandler.start_listenting();
+
+    uint32_t wakeups;
+    uint64_t busyNs;
+    std::vector<CAmSocketHandler::sh_pollStatistic_s> listPolls;
+    myHandler.getStatistics(wakeups, busyNs, listPolls);
+    EXPECT_GE(wakeups, static_cast<uint32_t>(plugin.mBusyCount));
+    EXPECT_GT(busyNs, 0u);
+    std::vector<CAmSocketHandler::sh_pollStatistic_s>::const_iterator iter = listPolls.begin();
+    for (; iter != listPolls.end(); ++iter)
+    {
+        if (iter->handle == pollHandle)
+            break;
+    }
+    ASSERT_TRUE(iter != listPolls.end());
+    EXPECT_EQ(fds[0], iter->fd);
+    EXPECT_EQ(static_cast<uint32_t>(plugin.mBusyCount), iter->wakeups);
+    EXPECT_GT(iter->dispatchNs, 0u);
+    EXPECT_LE(iter->dispatchNs, busyNs);
+
+    //after a reset all counters start from zero
+    myHandler.resetStatistics();
+    myHandler.getStatistics(wakeups, busyNs, listPolls);
+    EXPECT_EQ(0u, wakeups);
+    EXPECT_EQ(0u, busyNs);
+    for (iter = listPolls.begin(); iter != listPolls.end(); ++iter)
+    {
+        EXPECT_EQ(0u, iter->wakeups);
+        EXPECT_EQ(0u, iter->dispatchNs);
+    }
+
+    myHandler.removeFDPoll(pollHandle);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+#define SERIALIZER_THREADS 4
+#define SERIALIZER_CALLS 1000
+
+struct serializerTestData_s
+{
+    CAmSerializer* serializer;
+    CAmSerializerTarget* target;
+    int failedSyncCalls;
+};
+
+void* serializerWorker(void* data)
+{
+    serializerTestData_s* testData = static_cast<serializerTestData_s*>(data);
+    int value = 0, retVal = 0;
+    std::vector<int> values(3, 1);
+    for (int i = 0; i < SERIALIZER_CALLS; i++)
+    {
+        testData->serializer->asyncCall<CAmSerializerTarget>(testData->target, &CAmSerializerTarget::increment);
+        if (i % 100 == 0)
+        {
+            int expected = value + 1;
+            testData->serializer->syncCall<CAmSerializerTarget, int, int&, int>(testData->target, &CAmSerializerTarget::addOne, retVal, value);
+            if (value != expected)
+                __sync_add_and_fetch(&testData->failedSyncCalls, 1);
+
+            //the asynchronous call works on a copy, the synchronous one writes back
+            testData->serializer->asyncCall<CAmSerializerTarget, std::vector<int> >(testData->target, &CAmSerializerTarget::addValues, values);
+            size_t expectedSize = values.size() + 1;
+            testData->serializer->syncCall<CAmSerializerTarget, int, std::vector<int>&, std::vector<int> >(testData->target, &CAmSerializerTarget::appendValue, retVal, values);
+            if (values.size() != expectedSize || retVal != (int) expectedSize - 1)
+                __sync_add_and_fetch(&testData->failedSyncCalls, 1);
+        }
+    }
+    return (NULL);
+}
+
+void* serializerController(void* data)
+{
+    serializerTestData_s* testData = static_cast<serializerTestData_s*>(data);
+    pthread_t workers[SERIALIZER_THREADS];
+    for (int i = 0; i < SERIALIZER_THREADS; i++)
+        pthread_create(&workers[i], NULL, serializerWorker, data);
+    for (int i = 0; i < SERIALIZER_THREADS; i++)
+        pthread_join(workers[i], NULL);
+    testData->serializer->asyncCall<CAmSerializerTarget>(testData->target, &CAmSerializerTarget::stop);
+    return (NULL);
+}
+
+TEST(CAmSocketHandlerTest,serializeCallsFromThreads)
+{
+    CAmSocketHandler myHandler;
+    CAmSerializer serializer(&myHandler);
+    CAmSerializerTarget target(&myHandler);
+    serializerTestData_s testData;
+    testData.serializer = &serializer;
+    testData.target = &target;
+    testData.failedSyncCalls = 0;
+
+    pthread_t controller;
+    pthread_create(&controller, NULL, serializerController, &testData);
+    myHandler.start_listenting();
+    pthread_join(controller, NULL);
+
+    //all calls were executed in the mainloop, the synchronous calls wrote back their argument
+    EXPECT_EQ(SERIALIZER_THREADS * SERIALIZER_CALLS, target.mCounter);
+    //each thread sent its vector 10 times, growing from 3 to 12 elements
+    EXPECT_EQ(SERIALIZER_THREADS * (3 + 12) * 10 / 2, target.mValueCount);
+    EXPECT_FALSE(target.mWrongThread);
+    EXPECT_EQ(0, testData.failedSyncCalls);
+
+    //every thread made 1000 increments and 10 rounds of three calls, plus the stop call
+    uint32_t depth, maxDepth, calls;
+    serializer.getQueueStatistics(depth, maxDepth, calls);
+    EXPECT_EQ(0u, depth);
+    EXPECT_GT(maxDepth, 0u);
+    EXPECT_EQ(static_cast<uint32_t>(SERIALIZER_THREADS * (SERIALIZER_CALLS + 30) + 1), calls);
+}
+
 TEST(CAmSocketHandlerTest,playWithUNIXSockets)
 {
     pthread_t serverThread;
@@ -342,6 +604,120 @@ bool am::CAmSamplePlugin::dispatchData(const sh_pollHandle_t handle, void *userD
     return false;
 }
 
+am::CAmSharedFdPlugin::CAmSharedFdPlugin(CAmSocketHandler *mySocketHandler, const int fd) :
+        readFiredCB(this, &CAmSharedFdPlugin::readFired), //
+        writeFiredCB(this, &CAmSharedFdPlugin::writeFired), //
+        timeoutCB(this, &CAmSharedFdPlugin::timeout), //
+        mSocketHandler(mySocketHandler), //
+        mReadHandle(0), //
+        mWriteHandle(0), //
+        mReadCount(0), //
+        mWriteCount(0)
+{
+    mSocketHandler->addFDPoll(fd, POLLIN, NULL, &readFiredCB, NULL, NULL, NULL, mReadHandle);
+    mSocketHandler->addFDPoll(fd, POLLOUT, NULL, &writeFiredCB, NULL, NULL, NULL, mWriteHandle);
+}
+
+void am::CAmSharedFdPlugin::readFired(const pollfd pollfd, const sh_pollHandle_t handle, void *userData)
+{
+    (void) userData;
+    EXPECT_EQ(mReadHandle, handle);
+    EXPECT_TRUE(pollfd.revents & POLLIN);
+    EXPECT_FALSE(pollfd.revents & POLLOUT);
+    char buffer;
+    EXPECT_EQ(1, read(pollfd.fd, &buffer, 1));
+    mReadCount++;
+    mSocketHandler->stop_listening();
+}
+
+void am::CAmSharedFdPlugin::writeFired(const pollfd pollfd, const sh_pollHandle_t handle, void *userData)
+{
+    (void) userData;
+    EXPECT_EQ(mWriteHandle, handle);
+    EXPECT_TRUE(pollfd.revents & POLLOUT);
+    EXPECT_FALSE(pollfd.revents & POLLIN);
+    mWriteCount++;
+    EXPECT_EQ(E_OK, mSocketHandler->removeFDPoll(handle));
+}
+
+void am::CAmSharedFdPlugin::timeout(sh_timerHandle_t handle, void *userData)
+{
+    (void) handle;
+    (void) userData;
+    mSocketHandler->stop_listening();
+}
+
+am::CAmSerializerTarget::CAmSerializerTarget(CAmSocketHandler *mySocketHandler) :
+        mSocketHandler(mySocketHandler), //
+        mCounter(0), //
+        mValueCount(0), //
+        mMainThread(pthread_self()), //
+        mWrongThread(false)
+{
+}
+
+void am::CAmSerializerTarget::increment()
+{
+    if (!pthread_equal(mMainThread, pthread_self()))
+        mWrongThread = true;
+    mCounter++;
+}
+
+int am::CAmSerializerTarget::addOne(int& value)
+{
+    if (!pthread_equal(mMainThread, pthread_self()))
+        mWrongThread = true;
+    value++;
+    return (mCounter);
+}
+
+void am::CAmSerializerTarget::addValues(std::vector<int> values)
+{
+    mValueCount += values.size();
+}
+
+int am::CAmSerializerTarget::appendValue(std::vector<int>& values)
+{
+    values.push_back(0);
+    return (values.size() - 1);
+}
+
+void am::CAmSerializerTarget::stop()
+{
+    mSocketHandler->stop_listening();
+}
+
+am::CAmBusyTimerPlugin::CAmBusyTimerPlugin(CAmSocketHandler *mySocketHandler) :
+        busyFiredCB(this, &CAmBusyTimerPlugin::busyFired), //
+        timerCB(this, &CAmBusyTimerPlugin::timerFired), //
+        lastTimerCB(this, &CAmBusyTimerPlugin::lastTimerFired), //
+        mSocketHandler(mySocketHandler), //
+        mBusyCount(0), //
+        mListFiredTimer()
+{
+}
+
+void am::CAmBusyTimerPlugin::busyFired(const pollfd pollfd, const sh_pollHandle_t handle, void *userData)
+{
+    (void) pollfd;
+    (void) handle;
+    (void) userData;
+    mBusyCount++;
+}
+
+void am::CAmBusyTimerPlugin::timerFired(sh_timerHandle_t handle, void *userData)
+{
+    (void) userData;
+    mListFiredTimer.push_back(handle);
+}
+
+void am::CAmBusyTimerPlugin::lastTimerFired(sh_timerHandle_t handle, void *userData)
+{
+    (void) userData;
+    mListFiredTimer.push_back(handle);
+    mSocketHandler->stop_listening();
+}
+
 bool am::CAmSamplePlugin::check(const sh_pollHandle_t handle, void *userData)
 {
     (void) handle;
@@ -23,7 +23,9 @@
 
 #include "gtest/gtest.h"
 #include <queue>
+#include <vector>
 #include "shared/CAmSocketHandler.h"
+#include "shared/CAmSerializer.h"
 
 namespace am
 {
@@ -70,6 +72,52 @@ public:
     CAmSocketHandler *mSocketHandler;
 };
 
+class CAmSharedFdPlugin
+{
+public:
+    CAmSharedFdPlugin(CAmSocketHandler *mySocketHandler, const int fd);
+    void readFired(const pollfd pollfd, const sh_pollHandle_t handle, void* userData);
+    void writeFired(const pollfd pollfd, const sh_pollHandle_t handle, void* userData);
+    void timeout(sh_timerHandle_t handle, void* userData);
+    TAmShPollFired<CAmSharedFdPlugin> readFiredCB;
+    TAmShPollFired<CAmSharedFdPlugin> writeFiredCB;
+    TAmShTimerCallBack<CAmSharedFdPlugin> timeoutCB;
+    CAmSocketHandler *mSocketHandler;
+    sh_pollHandle_t mReadHandle, mWriteHandle;
+    int mReadCount, mWriteCount;
+};
+
+class CAmBusyTimerPlugin
+{
+public:
+    CAmBusyTimerPlugin(CAmSocketHandler *mySocketHandler);
+    void busyFired(const pollfd pollfd, const sh_pollHandle_t handle, void* userData);
+    void timerFired(sh_timerHandle_t handle, void* userData);
+    void lastTimerFired(sh_timerHandle_t handle, void* userData);
+    TAmShPollFired<CAmBusyTimerPlugin> busyFiredCB;
+    TAmShTimerCallBack<CAmBusyTimerPlugin> timerCB;
+    TAmShTimerCallBack<CAmBusyTimerPlugin> lastTimerCB;
+    CAmSocketHandler *mSocketHandler;
+    int mBusyCount;
+    std::vector<sh_timerHandle_t> mListFiredTimer;
+};
+
+class CAmSerializerTarget
+{
+public:
+    CAmSerializerTarget(CAmSocketHandler *mySocketHandler);
+    void increment();
+    int addOne(int& value);
+    void addValues(std::vector<int> values);
+    int appendValue(std::vector<int>& values);
+    void stop();
+    CAmSocketHandler *mSocketHandler;
+    int mCounter;
+    int mValueCount;
+    pthread_t mMainThread;
+    bool mWrongThread;
+};
+
 class CAmSocketHandlerTest: public ::testing::Test
 {
 public:
@@ -39,6 +39,7 @@ bool IAmCommandBackdoor::unloadPlugins(CAmCommandSender *CommandSender)
     assert(CommandSender != NULL);
     CommandSender->unloadLibraries();
     CommandSender->mListInterfaces.clear();
+    CommandSender->mListPluginStartup.clear();
     if (CommandSender->mListInterfaces.empty())
         return true;
     return false;
@@ -49,6 +50,7 @@ bool IAmCommandBackdoor::injectInterface(CAmCommandSender *CommandSender, IAmCom
     assert(CommandSender != NULL);
     assert(CommandSendInterface != NULL);
     CommandSender->mListInterfaces.push_back(CommandSendInterface);
+    CommandSender->mListPluginStartup.push_back(pluginStartup_s());
     return true;
 }
 
@@ -64,6 +66,7 @@ bool IAmRoutingBackdoor::unloadPlugins(CAmRoutingSender *RoutingSender)
     assert(RoutingSender != NULL);
     RoutingSender->unloadLibraries();
     RoutingSender->mListInterfaces.clear();
+    RoutingSender->mListPluginStartup.clear();
     if (RoutingSender->mListInterfaces.empty())
         return true;
     return false;
@@ -78,6 +81,9 @@ bool IAmRoutingBackdoor::injectInterface(CAmRoutingSender *RoutingSender, IAmRou
     newInterfacePair.routingInterface = newInterface;
     newInterfacePair.busName = busname;
     RoutingSender->mListInterfaces.push_back(newInterfacePair);
+    pluginStartup_s startup = pluginStartup_s();
+    startup.name = busname;
+    RoutingSender->mListPluginStartup.push_back(startup);
     return true;
 }
 
@@ -2,5 +2,6 @@
 #define _COMMANDDBUS_CONFIG_H
 
 #cmakedefine COMMAND_DBUS_INTROSPECTION_FILE "@COMMAND_DBUS_INTROSPECTION_FILE@"
+#cmakedefine COMMAND_DBUS_SIGNAL_WINDOW @COMMAND_DBUS_SIGNAL_WINDOW@
 
 #endif /* _COMMANDDBUS_CONFIG_H */
@@ -23,7 +23,9 @@
 #include <sstream>
 #include <string>
 #include <list>
+#include <map>
 #include "audiomanagertypes.h"
+#include "shared/CAmSocketHandler.h"
 
 
 namespace am
@@ -69,6 +71,25 @@ public:
      */
     void sendMessage();
 
+    /**
+     * sets the socketHandler that is used to collect the signals. Without it, signals are sent right away.
+     * @param socketHandler pointer to the socketHandler
+     */
+    void setSocketHandler(CAmSocketHandler* socketHandler);
+
+    /**
+     * queues the signal that was built with initSignal and append. Queued signals are sent together after
+     * COMMAND_DBUS_SIGNAL_WINDOW ms. A queued signal with the same key is superseded and dropped.
+     * @param key identifies what the signal updates, for example the signal name and the sinkID. Signals with an
+     * empty key are never dropped.
+     */
+    void sendSignal(const std::string& key);
+
+    /**
+     * sends out all queued signals
+     */
+    void flushSignals();
+
     /**
      * the get functions return a value from the received dbus message
      * @return
@@ -103,7 +124,24 @@ public:
     void append(const std::vector<am::am_SystemProperty_s>& listSystemProperties);
 
 private:
-
+    struct signal_s
+    {
+        std::string key; //!< the coalescing key, empty if the signal is never dropped
+        DBusMessage* message; //!< the signal
+    };
+
+    typedef std::list<signal_s> SignalList; //!< signals in the order they are sent
+    typedef std::map<std::string, SignalList::iterator> SignalKeyMap; //!< queued signals by key
+
+    void signalTimerCallback(sh_timerHandle_t handle, void* userData);
+    void sendSignalMessage(DBusMessage* message);
+
+    TAmShTimerCallBack<CAmDbusMessageHandler> mSignalTimerCallback; //!< callback of the signal timer
+    CAmSocketHandler* mpSocketHandler; //!< the socketHandler, NULL if signals are sent right away
+    sh_timerHandle_t mSignalTimer; //!< timer that sends the queued signals
+    bool mSignalTimerRunning; //!< true while signals wait for the timer
+    SignalList mListSignals; //!< the queued signals
+    SignalKeyMap mMapSignalKeys; //!< the queued signals with a key
     DBusMessageIter mDBusMessageIter;
     DBusError mDBusError;
     dbus_uint32_t mSerial;
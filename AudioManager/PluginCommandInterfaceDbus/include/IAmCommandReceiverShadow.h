@@ -25,6 +25,7 @@
 #include "config.h"
 #include "command/IAmCommandReceive.h"
 #include "CAmDbusMessageHandler.h"
+#include "shared/CAmDbusDispatchTable.h"
 #include "shared/CAmDbusWrapper.h"
 
 namespace am
@@ -66,7 +67,7 @@ public:
      */
     void setCommandReceiver(IAmCommandReceive*& receiver);
 private:
-    typedef std::map<std::string, CallBackMethod> functionMap_t;
+    typedef CAmDbusDispatchTable<CallBackMethod> functionMap_t;
     functionMap_t mFunctionMap;
     CAmDbusMessageHandler mDBUSMessageHandler;
     IAmCommandReceive* mpIAmCommandReceive;
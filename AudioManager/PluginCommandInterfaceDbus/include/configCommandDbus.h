@@ -2,5 +2,6 @@
 #define _COMMANDDBUS_CONFIG_H
 
 #define COMMAND_DBUS_INTROSPECTION_FILE "/usr/share/audiomanager/CommandInterface.xml"
+#define COMMAND_DBUS_SIGNAL_WINDOW 20
 
 #endif /* _COMMANDDBUS_CONFIG_H */
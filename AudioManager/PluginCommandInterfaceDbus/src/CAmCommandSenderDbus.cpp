@@ -21,6 +21,7 @@
 #include <vector>
 #include <cassert>
 #include <set>
+#include <sstream>
 #include "CAmDbusMessageHandler.h"
 #include "shared/CAmDltWrapper.h"
 
@@ -28,6 +29,16 @@
 using namespace am;
 DLT_DECLARE_CONTEXT(commandDbus)
 
+/**
+ * builds the key of a signal, a queued signal is superseded by a newer one with the same key
+ */
+static std::string signalKey(const char* signalName, const int id = 0, const int type = 0)
+{
+    std::ostringstream key;
+    key << signalName << "/" << id << "/" << type;
+    return (key.str());
+}
+
 
 /**
  * factory for plugin loading
@@ -74,6 +85,11 @@ am_Error_e CAmCommandSenderDbus::startupInterface(IAmCommandReceive* commandrece
     mpCAmDbusWrapper->getDBusConnection(connection);
     assert(connection!=NULL);
     mCAmDbusMessageHandler.setDBusConnection(connection);
+
+    //signals are collected on the mainloop and sent together
+    CAmSocketHandler* socketHandler = NULL;
+    if (mpIAmCommandReceive->getSocketHandler(socketHandler) == E_OK && socketHandler != NULL)
+        mCAmDbusMessageHandler.setSocketHandler(socketHandler);
     return (E_OK);
 }
 
@@ -104,7 +120,7 @@ void CAmCommandSenderDbus::cbNewMainConnection(const am_MainConnectionType_s& ma
     if (mReady)
     {
         mCAmDbusMessageHandler.initSignal(std::string(MY_NODE), std::string("NumberOfMainConnectionsChanged"));
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(signalKey("NumberOfMainConnectionsChanged"));
     }
 }
 
@@ -117,7 +133,7 @@ void CAmCommandSenderDbus::cbRemovedMainConnection(const am_mainConnectionID_t m
     if (mReady)
     {
         mCAmDbusMessageHandler.initSignal(std::string(MY_NODE), std::string("NumberOfMainConnectionsChanged"));
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(signalKey("NumberOfMainConnectionsChanged"));
     }
 }
 
@@ -131,7 +147,7 @@ void CAmCommandSenderDbus::cbNewSink(const am_SinkType_s& sink)
         mCAmDbusMessageHandler.append(sink);
 
         log(&commandDbus, DLT_LOG_INFO, "send signal SinkAdded");
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(std::string());
     }
 }
 
@@ -146,7 +162,7 @@ void CAmCommandSenderDbus::cbRemovedSink(const am_sinkID_t sinkID)
         mCAmDbusMessageHandler.append(sinkID);
 
         log(&commandDbus, DLT_LOG_INFO, "send signal SinkAdded");
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(std::string());
     }
 }
 
@@ -160,7 +176,7 @@ void CAmCommandSenderDbus::cbNewSource(const am_SourceType_s& source)
         mCAmDbusMessageHandler.append(source);
 
         log(&commandDbus, DLT_LOG_INFO, "send signal SourceAdded");
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(std::string());
     }
 }
 
@@ -173,7 +189,7 @@ void am::CAmCommandSenderDbus::cbRemovedSource(const am_sourceID_t source)
 
         log(&commandDbus, DLT_LOG_INFO, "send signal SourceRemoved");
 
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(std::string());
     }
 }
 
@@ -184,7 +200,7 @@ void CAmCommandSenderDbus::cbNumberOfSinkClassesChanged()
     if (mReady)
     {
         mCAmDbusMessageHandler.initSignal(std::string(MY_NODE), std::string("NumberOfSinkClassesChanged"));
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(signalKey("NumberOfSinkClassesChanged"));
     }
 }
 
@@ -195,7 +211,7 @@ void CAmCommandSenderDbus::cbNumberOfSourceClassesChanged()
     if (mReady)
     {
         mCAmDbusMessageHandler.initSignal(std::string(MY_NODE), std::string("NumberOfSourceClassesChanged"));
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(signalKey("NumberOfSourceClassesChanged"));
     }
 }
 
@@ -208,7 +224,7 @@ void CAmCommandSenderDbus::cbMainConnectionStateChanged(const am_mainConnectionI
         mCAmDbusMessageHandler.initSignal(std::string(MY_NODE), std::string("MainConnectionStateChanged"));
         mCAmDbusMessageHandler.append((dbus_uint16_t) connectionID);
         mCAmDbusMessageHandler.append((dbus_int16_t) connectionState);
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(signalKey("MainConnectionStateChanged", connectionID));
     }
 }
 
@@ -221,7 +237,7 @@ void CAmCommandSenderDbus::cbMainSinkSoundPropertyChanged(const am_sinkID_t sink
         mCAmDbusMessageHandler.initSignal(std::string(MY_NODE), std::string("MainSinkSoundPropertyChanged"));
         mCAmDbusMessageHandler.append((dbus_uint16_t) sinkID);
         mCAmDbusMessageHandler.append(soundProperty);
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(signalKey("MainSinkSoundPropertyChanged", sinkID, soundProperty.type));
     }
 }
 
@@ -234,7 +250,7 @@ void CAmCommandSenderDbus::cbMainSourceSoundPropertyChanged(const am_sourceID_t
         mCAmDbusMessageHandler.initSignal(std::string(MY_NODE), std::string("MainSourceSoundPropertyChanged"));
         mCAmDbusMessageHandler.append((dbus_uint16_t) sourceID);
         mCAmDbusMessageHandler.append(SoundProperty);
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(signalKey("MainSourceSoundPropertyChanged", sourceID, SoundProperty.type));
     }
 }
 
@@ -247,7 +263,7 @@ void CAmCommandSenderDbus::cbSinkAvailabilityChanged(const am_sinkID_t sinkID, c
         mCAmDbusMessageHandler.initSignal(std::string(MY_NODE), std::string("SinkAvailabilityChanged"));
         mCAmDbusMessageHandler.append((dbus_uint16_t) sinkID);
         mCAmDbusMessageHandler.append(availability);
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(signalKey("SinkAvailabilityChanged", sinkID));
     }
 }
 
@@ -260,7 +276,7 @@ void CAmCommandSenderDbus::cbSourceAvailabilityChanged(const am_sourceID_t sourc
         mCAmDbusMessageHandler.initSignal(std::string(MY_NODE), std::string("SourceAvailabilityChanged"));
         mCAmDbusMessageHandler.append((dbus_uint16_t) sourceID);
         mCAmDbusMessageHandler.append(availability);
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(signalKey("SourceAvailabilityChanged", sourceID));
     }
 }
 
@@ -273,7 +289,7 @@ void CAmCommandSenderDbus::cbVolumeChanged(const am_sinkID_t sinkID, const am_ma
         mCAmDbusMessageHandler.initSignal(std::string(MY_NODE), std::string("VolumeChanged"));
         mCAmDbusMessageHandler.append((dbus_uint16_t) sinkID);
         mCAmDbusMessageHandler.append((dbus_int16_t) volume);
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(signalKey("VolumeChanged", sinkID));
     }
 }
 
@@ -286,7 +302,7 @@ void CAmCommandSenderDbus::cbSinkMuteStateChanged(const am_sinkID_t sinkID, cons
         mCAmDbusMessageHandler.initSignal(std::string(MY_NODE), std::string("SinkMuteStateChanged"));
         mCAmDbusMessageHandler.append((dbus_uint16_t) sinkID);
         mCAmDbusMessageHandler.append((dbus_int16_t) muteState);
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(signalKey("SinkMuteStateChanged", sinkID));
     }
 }
 
@@ -298,7 +314,7 @@ void CAmCommandSenderDbus::cbSystemPropertyChanged(const am_SystemProperty_s & S
     {
         mCAmDbusMessageHandler.initSignal(std::string(MY_NODE), std::string("SystemPropertyChanged"));
         mCAmDbusMessageHandler.append(SystemProperty);
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(signalKey("SystemPropertyChanged", SystemProperty.type));
     }
 }
 
@@ -311,7 +327,7 @@ void am::CAmCommandSenderDbus::cbTimingInformationChanged(const am_mainConnectio
         mCAmDbusMessageHandler.initSignal(std::string(MY_NODE), std::string("TimingInformationChanged"));
         mCAmDbusMessageHandler.append((dbus_uint16_t) mainConnectionID);
         mCAmDbusMessageHandler.append((dbus_int16_t) time);
-        mCAmDbusMessageHandler.sendMessage();
+        mCAmDbusMessageHandler.sendSignal(signalKey("TimingInformationChanged", mainConnectionID));
     }
 }
 
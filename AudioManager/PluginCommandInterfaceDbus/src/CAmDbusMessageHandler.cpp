@@ -17,6 +17,7 @@
 
 #include "CAmDbusMessageHandler.h"
 #include "config.h"
+#include "configCommandDbus.h"
 #include <cstdlib>
 #include <cassert>
 #include <vector>
@@ -29,6 +30,12 @@ namespace am
 {
 
 CAmDbusMessageHandler::CAmDbusMessageHandler() :
+        mSignalTimerCallback(this, &CAmDbusMessageHandler::signalTimerCallback), //
+        mpSocketHandler(NULL), //
+        mSignalTimer(0), //
+        mSignalTimerRunning(false), //
+        mListSignals(), //
+        mMapSignalKeys(), //
         mDBusMessageIter(), //
         mDBusError(), //
         mSerial(0), //
@@ -44,6 +51,11 @@ CAmDbusMessageHandler::CAmDbusMessageHandler() :
 
 CAmDbusMessageHandler::~CAmDbusMessageHandler()
 {
+    if (mpSocketHandler)
+        mpSocketHandler->removeTimer(mSignalTimer);
+    SignalList::iterator iter = mListSignals.begin();
+    for (; iter != mListSignals.end(); ++iter)
+        dbus_message_unref(iter->message);
     log(&commandDbus, DLT_LOG_INFO, "DBUSMessageHandler destructed");
 }
 
@@ -111,6 +123,101 @@ void CAmDbusMessageHandler::sendMessage()
     mpDBusMessage = NULL;
 }
 
+void CAmDbusMessageHandler::setSocketHandler(CAmSocketHandler* socketHandler)
+{
+    assert(socketHandler!=NULL);
+    assert(mpSocketHandler==NULL);
+    timespec window;
+    window.tv_sec = COMMAND_DBUS_SIGNAL_WINDOW / 1000;
+    window.tv_nsec = (COMMAND_DBUS_SIGNAL_WINDOW % 1000) * 1000000L;
+    if (socketHandler->addTimer(window, &mSignalTimerCallback, mSignalTimer, NULL) != E_OK)
+    {
+        log(&commandDbus, DLT_LOG_ERROR, "DBusMessageHandler::setSocketHandler could not add the signal timer, signals are sent right away");
+        return;
+    }
+    //the timer only runs while signals are queued
+    socketHandler->stopTimer(mSignalTimer);
+    mpSocketHandler = socketHandler;
+}
+
+void CAmDbusMessageHandler::sendSignal(const std::string& key)
+{
+    assert(mpDBusConnection!=NULL);
+    if (mpDBusMessage == NULL)
+        return;
+    DBusMessage* message = mpDBusMessage;
+    mpDBusMessage = NULL;
+
+    if (mpSocketHandler == NULL)
+    {
+        sendSignalMessage(message);
+        return;
+    }
+
+    if (!key.empty())
+    {
+        //the queued signal is outdated, the new one goes to the end so that the order of the updates is kept
+        SignalKeyMap::iterator keyIter = mMapSignalKeys.find(key);
+        if (keyIter != mMapSignalKeys.end())
+        {
+            dbus_message_unref(keyIter->second->message);
+            mListSignals.erase(keyIter->second);
+            mMapSignalKeys.erase(keyIter);
+        }
+    }
+
+    signal_s signal;
+    signal.key = key;
+    signal.message = message;
+    SignalList::iterator iter = mListSignals.insert(mListSignals.end(), signal);
+    if (!key.empty())
+        mMapSignalKeys[key] = iter;
+
+    if (!mSignalTimerRunning)
+    {
+        mpSocketHandler->restartTimer(mSignalTimer);
+        mSignalTimerRunning = true;
+    }
+}
+
+void CAmDbusMessageHandler::flushSignals()
+{
+    if (mSignalTimerRunning)
+    {
+        mpSocketHandler->stopTimer(mSignalTimer);
+        mSignalTimerRunning = false;
+    }
+
+    SignalList listSignals;
+    listSignals.swap(mListSignals);
+    mMapSignalKeys.clear();
+    SignalList::iterator iter = listSignals.begin();
+    for (; iter != listSignals.end(); ++iter)
+        sendSignalMessage(iter->message);
+}
+
+void CAmDbusMessageHandler::signalTimerCallback(sh_timerHandle_t handle, void* userData)
+{
+    (void) handle;
+    (void) userData;
+    mSignalTimerRunning = false;
+    flushSignals();
+}
+
+/**
+ * hands the signal to dbus. dbus writes as much as the socket takes right away, the rest is written by the mainloop
+ * when the socket is writable again, so there is no need to flush.
+ */
+void CAmDbusMessageHandler::sendSignalMessage(DBusMessage* message)
+{
+    dbus_uint32_t serial = 1;
+    if (!dbus_connection_send(mpDBusConnection, message, &serial))
+    {
+        log(&commandDbus, DLT_LOG_ERROR, "DBusMessageHandler::sendSignalMessage cannot send message!");
+    }
+    dbus_message_unref(message);
+}
+
 char* CAmDbusMessageHandler::getString()
 {
     char* param = NULL;
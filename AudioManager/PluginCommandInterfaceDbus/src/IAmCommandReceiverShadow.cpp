@@ -383,13 +383,9 @@ DBusHandlerResult IAmCommandReceiverShadow::receiveCallbackDelegate(DBusConnecti
         return (DBUS_HANDLER_RESULT_HANDLED);
     }
 
-    functionMap_t::iterator iter = mFunctionMap.begin();
-    std::string k(dbus_message_get_member(msg));
-    iter = mFunctionMap.find(k);
-    if (iter != mFunctionMap.end())
+    CallBackMethod cb;
+    if (mFunctionMap.find(dbus_message_get_member(msg), cb))
     {
-        std::string p(iter->first);
-        CallBackMethod cb = iter->second;
         (this->*cb)(conn, msg);
         return (DBUS_HANDLER_RESULT_HANDLED);
     }
@@ -419,23 +415,24 @@ void IAmCommandReceiverShadow::setCommandReceiver(IAmCommandReceive*& receiver)
 IAmCommandReceiverShadow::functionMap_t IAmCommandReceiverShadow::createMap()
 {
     functionMap_t m;
-    m["Connect"] = &IAmCommandReceiverShadow::connect;
-    m["Disconnect"] = &IAmCommandReceiverShadow::disconnect;
-    m["SetVolume"] = &IAmCommandReceiverShadow::setVolume;
-    m["VolumeStep"] = &IAmCommandReceiverShadow::volumeStep;
-    m["SetSinkMuteState"] = &IAmCommandReceiverShadow::setSinkMuteState;
-    m["SetMainSinkSoundProperty"] = &IAmCommandReceiverShadow::setMainSinkSoundProperty;
-    m["SetMainSourceSoundProperty"] = &IAmCommandReceiverShadow::setMainSourceSoundProperty;
-    m["GetListMainConnections"] = &IAmCommandReceiverShadow::getListMainConnections;
-    m["GetListMainSinks"] = &IAmCommandReceiverShadow::getListMainSinks;
-    m["GetListMainSources"] = &IAmCommandReceiverShadow::getListMainSources;
-    m["GetListMainSinkSoundProperties"] = &IAmCommandReceiverShadow::getListMainSinkSoundProperties;
-    m["GetListMainSourceSoundProperties"] = &IAmCommandReceiverShadow::getListMainSourceSoundProperties;
-    m["GetListSourceClasses"] = &IAmCommandReceiverShadow::getListSourceClasses;
-    m["GetListSinkClasses"] = &IAmCommandReceiverShadow::getListSinkClasses;
-    m["GetListSystemProperties"] = &IAmCommandReceiverShadow::getListSystemProperties;
-    m["GetTimingInformation"] = &IAmCommandReceiverShadow::getTimingInformation;
-    m["SetSystemProperty"] = &IAmCommandReceiverShadow::setSystemProperty;
+    m.add("Connect", &IAmCommandReceiverShadow::connect);
+    m.add("Disconnect", &IAmCommandReceiverShadow::disconnect);
+    m.add("SetVolume", &IAmCommandReceiverShadow::setVolume);
+    m.add("VolumeStep", &IAmCommandReceiverShadow::volumeStep);
+    m.add("SetSinkMuteState", &IAmCommandReceiverShadow::setSinkMuteState);
+    m.add("SetMainSinkSoundProperty", &IAmCommandReceiverShadow::setMainSinkSoundProperty);
+    m.add("SetMainSourceSoundProperty", &IAmCommandReceiverShadow::setMainSourceSoundProperty);
+    m.add("GetListMainConnections", &IAmCommandReceiverShadow::getListMainConnections);
+    m.add("GetListMainSinks", &IAmCommandReceiverShadow::getListMainSinks);
+    m.add("GetListMainSources", &IAmCommandReceiverShadow::getListMainSources);
+    m.add("GetListMainSinkSoundProperties", &IAmCommandReceiverShadow::getListMainSinkSoundProperties);
+    m.add("GetListMainSourceSoundProperties", &IAmCommandReceiverShadow::getListMainSourceSoundProperties);
+    m.add("GetListSourceClasses", &IAmCommandReceiverShadow::getListSourceClasses);
+    m.add("GetListSinkClasses", &IAmCommandReceiverShadow::getListSinkClasses);
+    m.add("GetListSystemProperties", &IAmCommandReceiverShadow::getListSystemProperties);
+    m.add("GetTimingInformation", &IAmCommandReceiverShadow::getTimingInformation);
+    m.add("SetSystemProperty", &IAmCommandReceiverShadow::setSystemProperty);
+    m.build();
     return (m);
 }
 
@@ -781,6 +781,96 @@ TEST_F(CAmCommandSenderDbusSignalTest,cbSourceAvailabilityChanged)
 
 }
 
+CAmSignalTestStopper::CAmSignalTestStopper(CAmSocketHandler *socketHandler) :
+        pTimerCallback(this, &CAmSignalTestStopper::timerCallback), //
+        mSocketHandler(socketHandler)
+{
+}
+
+void CAmSignalTestStopper::timerCallback(sh_timerHandle_t handle, void* userData)
+{
+    (void) handle;
+    (void) userData;
+    mSocketHandler->stop_listening();
+}
+
+TEST_F(CAmCommandSenderDbusSignalTest,signalsAreCoalescedPerKey)
+{
+    CAmSocketHandler pSocketHandler;
+    CAmDbusWrapper pDBusWrapper(&pSocketHandler);
+    MockIAmCommandReceive pReceiveInterface;
+    CAmCommandSenderDbus pCommandSender;
+    CAmSignalTestStopper pStopper(&pSocketHandler);
+
+    //a second connection that records the signals the plugin emits
+    DBusError error;
+    dbus_error_init(&error);
+    DBusConnection* receiver = dbus_bus_get_private(DBUS_BUS_SESSION, &error);
+    ASSERT_TRUE(receiver!=NULL);
+    dbus_bus_add_match(receiver, "type='signal',member='VolumeChanged'", &error);
+    dbus_bus_add_match(receiver, "type='signal',member='SinkMuteStateChanged'", &error);
+    ASSERT_FALSE(dbus_error_is_set(&error));
+
+    //with a socketHandler, the signals are collected on the mainloop
+    EXPECT_CALL(pReceiveInterface,getDBusConnectionWrapper(_)).WillRepeatedly(DoAll(SetArgReferee<0>(&pDBusWrapper), Return(E_OK)));
+    EXPECT_CALL(pReceiveInterface,getSocketHandler(_)).WillOnce(DoAll(SetArgReferee<0>(&pSocketHandler), Return(E_OK)));
+    EXPECT_CALL(pReceiveInterface, confirmCommandReady(10));
+    pCommandSender.startupInterface(&pReceiveInterface);
+    pCommandSender.setCommandReady(10);
+
+    //all in one mainloop turn. A signal that supersedes a queued one takes its place at the end of the queue.
+    pCommandSender.cbVolumeChanged(23, 1);
+    pCommandSender.cbSinkMuteStateChanged(42, MS_MUTED);
+    pCommandSender.cbVolumeChanged(23, 2);
+    pCommandSender.cbVolumeChanged(24, 5);
+    pCommandSender.cbSinkMuteStateChanged(42, MS_UNMUTED);
+    pCommandSender.cbVolumeChanged(23, 3);
+
+    timespec timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_nsec = 200000000;
+    sh_timerHandle_t handle;
+    ASSERT_EQ(E_OK, pSocketHandler.addTimer(timeout, &pStopper.pTimerCallback, handle, NULL));
+    pSocketHandler.start_listenting();
+
+    std::vector<std::string> listSignals;
+    std::vector<dbus_uint16_t> listIDs;
+    std::vector<dbus_int16_t> listValues;
+    //the mainloop has sent everything, give the bus some time to deliver it
+    for (int i = 0; i < 10 && dbus_connection_read_write(receiver, 50); i++)
+    {
+        DBusMessage* message;
+        while ((message = dbus_connection_pop_message(receiver)) != NULL)
+        {
+            dbus_uint16_t id = 0;
+            dbus_int16_t value = 0;
+            //skips NameAcquired, which the bus sends without a match
+            if (dbus_message_get_type(message) == DBUS_MESSAGE_TYPE_SIGNAL && dbus_message_get_args(message, NULL, DBUS_TYPE_UINT16, &id, DBUS_TYPE_INT16, &value, DBUS_TYPE_INVALID))
+            {
+                listSignals.push_back(dbus_message_get_member(message));
+                listIDs.push_back(id);
+                listValues.push_back(value);
+            }
+            dbus_message_unref(message);
+        }
+    }
+
+    //only the last value per key, in the order of the last updates
+    ASSERT_EQ(3u, listSignals.size());
+    EXPECT_EQ("VolumeChanged", listSignals[0]);
+    EXPECT_EQ(24, listIDs[0]);
+    EXPECT_EQ(5, listValues[0]);
+    EXPECT_EQ("SinkMuteStateChanged", listSignals[1]);
+    EXPECT_EQ(42, listIDs[1]);
+    EXPECT_EQ(MS_UNMUTED, listValues[1]);
+    EXPECT_EQ("VolumeChanged", listSignals[2]);
+    EXPECT_EQ(23, listIDs[2]);
+    EXPECT_EQ(3, listValues[2]);
+
+    dbus_connection_close(receiver);
+    dbus_connection_unref(receiver);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
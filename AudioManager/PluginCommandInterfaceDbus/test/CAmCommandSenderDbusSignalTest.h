@@ -24,10 +24,24 @@
 
 #define UNIT_TEST 1
 
+#include "shared/CAmSocketHandler.h"
+
 namespace am {
 
 class IAmCommandSend;
 
+/**
+ * stops the mainloop when its timer fires
+ */
+class CAmSignalTestStopper
+{
+public:
+    CAmSignalTestStopper(CAmSocketHandler *socketHandler);
+    void timerCallback(sh_timerHandle_t handle, void * userData);
+    TAmShTimerCallBack<CAmSignalTestStopper> pTimerCallback;
+    CAmSocketHandler *mSocketHandler;
+};
+
 class CAmCommandSenderDbusSignalTest: public ::testing::Test
 {
 public:
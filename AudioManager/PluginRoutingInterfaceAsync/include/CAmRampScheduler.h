@@ -0,0 +1,104 @@
+/**
+ *  Copyright (c) 2012 BMW
+ *
+ *  \author Christian Mueller, christian.ei.mueller@bmw.de BMW 2011,2012
+ *
+ *  \copyright
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction,
+ *  including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ *  THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For further information see http://www.genivi.org/.
+ */
+
+#ifndef RAMPSCHEDULER_H_
+#define RAMPSCHEDULER_H_
+
+#include "audiomanagertypes.h"
+#include <pthread.h>
+#include <time.h>
+#include <map>
+#include <vector>
+
+/**
+ * number of volume ticks per second that are acknowledged for one ramp
+ */
+#ifndef RAMP_TICK_RATE
+#define RAMP_TICK_RATE 25
+#endif
+
+/**
+ * duration in ms of a RAMP_GENIVI_NO_PLOP ramp
+ */
+#ifndef RAMP_NO_PLOP_TIME
+#define RAMP_NO_PLOP_TIME 20
+#endif
+
+namespace am
+{
+
+class CAmRoutingSenderAsync;
+class IAmRoutingReceiverShadow;
+
+/**
+ * Runs the volume ramps of all sinks and sources on one thread.
+ * Each ramp follows the curve given by its am_RampType_e over the requested time. All ramps are evaluated at the same
+ * tick, so the thread only wakes up with the tick rate or when a ramp ends. A tick is only acknowledged if the volume
+ * changed since the last acknowledged tick. All acks are sent by the ramp thread, so no tick of a ramp comes after its
+ * final ack.
+ */
+class CAmRampScheduler
+{
+public:
+    CAmRampScheduler(CAmRoutingSenderAsync* asyncSender, const uint16_t tickRate = RAMP_TICK_RATE);
+    ~CAmRampScheduler();
+    void start(IAmRoutingReceiverShadow* shadow);
+    void stop();
+    void startSinkRamp(const am_Handle_s handle, const am_sinkID_t sinkID, const am_volume_t currentVolume, const am_volume_t volume, const am_RampType_e ramp, const am_time_t time);
+    void startSourceRamp(const am_Handle_s handle, const am_sourceID_t sourceID, const am_volume_t currentVolume, const am_volume_t volume, const am_RampType_e ramp, const am_time_t time);
+    bool cancelRamp(const uint16_t handle);
+
+private:
+    struct ramp_s
+    {
+        am_Handle_s handle; //!< the handle of the volume change
+        bool isSink; //!< true for sinks, false for sources
+        uint16_t elementID; //!< the sinkID or sourceID
+        am_volume_t startVolume; //!< the volume when the ramp was started
+        am_volume_t volume; //!< the target volume
+        am_volume_t currentVolume; //!< the volume at the last evaluation
+        am_volume_t ackedVolume; //!< the volume of the last acknowledged tick
+        am_RampType_e rampType; //!< the curve of the ramp
+        timespec start; //!< start time of the ramp
+        timespec end; //!< end time of the ramp
+        timespec nextTick; //!< earliest time of the next acknowledged tick
+        bool canceled; //!< true if the ramp was canceled, the ramp thread acknowledges it with E_ABORTED
+    };
+
+    typedef std::map<uint16_t, ramp_s> RampMap; //!< active ramps by handle
+
+    static void* rampThread(void* data);
+    void run();
+    void startRamp(ramp_s& ramp, const am_time_t time);
+    void evaluate(ramp_s& ramp, const timespec& now) const;
+    void finish(const ramp_s& ramp, const am_Error_e error);
+    void tick(const ramp_s& ramp);
+
+    CAmRoutingSenderAsync* mAsyncSender; //!< pointer to the routing sender, used to update the volumes
+    IAmRoutingReceiverShadow* mShadow; //!< pointer to the shadow, used for the acks
+    const uint16_t mTickRate; //!< number of ticks per second
+    RampMap mRamps; //!< the active ramps
+    pthread_t mThread; //!< the ramp thread
+    pthread_mutex_t mMutex; //!< protects mRamps and mQuit
+    pthread_cond_t mCond; //!< signaled when ramps are added or removed
+    bool mRunning; //!< true while the thread is running
+    bool mQuit; //!< tells the thread to return
+};
+
+}
+
+#endif /* RAMPSCHEDULER_H_ */
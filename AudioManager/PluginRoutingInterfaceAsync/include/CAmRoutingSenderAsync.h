@@ -20,9 +20,11 @@
 
 #include "routing/IAmRoutingSend.h"
 #include "IAmRoutingReceiverShadow.h"
+#include "CAmRampScheduler.h"
 #include <semaphore.h>
 #include <memory.h>
 #include <map>
+#include <deque>
 
 namespace am
 {
@@ -69,51 +71,102 @@ private:
 };
 
 /**
- * This class handles the threadpool
+ * maximum number of jobs waiting for a free thread
+ */
+#ifndef POOL_QUEUE_SIZE
+#define POOL_QUEUE_SIZE 64
+#endif
+
+/**
+ * This class handles the threadpool.
+ * Work is put into a bounded queue and picked up by the next free thread. Threads are created on demand up to the
+ * maximum number, so bursts of requests are queued instead of being refused.
  */
 class CAmWorkerThreadPool
 {
 public:
+    /**
+     * usage information of one thread
+     */
+    struct workerStatistic_s
+    {
+        uint16_t thread; //!< number of the thread
+        uint32_t jobs; //!< number of finished jobs
+        uint32_t canceled; //!< number of jobs that were canceled while running
+        uint64_t busyNs; //!< time spent working in nanoseconds
+    };
+
     /**
      * creates the pool. Give the max number of threads as argument
      * @param numThreads max number of threads
+     * @param maxQueue max number of jobs that wait for a thread
      */
-    CAmWorkerThreadPool(int numThreads);
+    CAmWorkerThreadPool(int numThreads, size_t maxQueue = POOL_QUEUE_SIZE);
     virtual ~CAmWorkerThreadPool();
 
     /**
-     * assigns a thread to a worker class and starts working.
-     * @param worker
-     * @return the actual assigned workerID or -1 in case no thread is free
+     * queues a worker, it is started as soon as a thread is free. This is called on the mainloop, so a full queue
+     * is not waited for.
+     * @param worker the pool takes the ownership, unless -1 is returned
+     * @return the assigned workerID or -1 in case the queue is full
      */
     int16_t startWork(CAmWorker* worker);
     /**
-     * cancels a thread
-     * @param workerID thread to be canceled
-     * @return true if thread was found, false if not
+     * cancels a worker. Queued workers are removed and their cancelWork is called, running ones are signaled.
+     * @param workerID worker to be canceled
+     * @return true if the worker was found, false if not
      */
     bool cancelWork(int workerID);
 
     /**
-     * the workers call this function upon completion of their task
-     * @param threadID
+     * stops all threads. Running workers are canceled, queued ones are dropped.
+     */
+    void stop();
+
+    /**
+     * returns the usage of the threads and the queue
+     * @param listStatistics one entry per created thread
+     * @param queueHighWater the maximum number of queued jobs
+     * @param rejected number of startWork calls that found the queue full
      */
-    void finishedWork(pthread_t threadID);
+    void getStatistics(std::vector<workerStatistic_s>& listStatistics, uint32_t& queueHighWater, uint32_t& rejected) const;
 
 private:
-    static void* CAmWorkerThread(void* data);
-    int mNumThreads;
     struct threadInfo_s
     {
-        uint16_t workerID;
-        pthread_t threadID;
-        bool busy;
-        sem_t block;
-        sem_t cancel;
-        CAmWorker *worker;
+        CAmWorkerThreadPool* pool; //!< the pool the thread belongs to
+        uint16_t thread; //!< number of the thread
+        pthread_t threadID; //!< the thread
+        sem_t cancel; //!< posted to cancel the running worker
+        int16_t workerID; //!< the running worker, 0 if idle
+        uint32_t jobs; //!< number of finished jobs
+        uint32_t canceled; //!< number of canceled jobs
+        uint64_t busyNs; //!< time spent working
     };
-    std::vector<threadInfo_s> mListWorkers; //<! list of all workers
-    static pthread_mutex_t mBlockingMutex; //<! mutex to block the acces of the list
+
+    struct job_s
+    {
+        int16_t workerID; //!< the id handed out by startWork
+        CAmWorker* worker; //!< the worker
+    };
+
+    static void* CAmWorkerThread(void* data);
+    void work(threadInfo_s& info);
+    void createThread();
+    int16_t nextWorkerID();
+
+    int mMaxThreads; //!< maximum number of threads
+    int mNumThreads; //!< number of created threads
+    int mIdleThreads; //!< number of threads waiting for work
+    size_t mMaxQueue; //!< maximum number of queued jobs
+    int16_t mWorkerIDCount; //!< last handed out workerID
+    bool mQuit; //!< tells the threads to return
+    uint32_t mQueueHighWater; //!< maximum number of queued jobs
+    uint32_t mRejected; //!< number of startWork calls that found the queue full
+    std::vector<threadInfo_s> mListWorkers; //<! list of all threads, sized for the maximum so that the entries never move
+    std::deque<job_s> mQueue; //!< jobs waiting for a thread
+    mutable pthread_mutex_t mMutex; //!< protects the queue and the thread list
+    pthread_cond_t mWorkCond; //!< signaled when work is queued
 };
 
 class CAmRoutingSenderAsync: public IAmRoutingSend
@@ -218,6 +271,34 @@ private:
     std::vector<am_Sink_s> createSinkTable();
     std::vector<am_Source_s> createSourceTable();
     std::vector<am_Gateway_s> createGatewayTable();
+
+    /**
+     * threadsafe copy of a sink
+     * @return false if the sink does not exist
+     */
+    bool getSinkSafe(am_sinkID_t sinkID, am_Sink_s& sink);
+
+    /**
+     * threadsafe copy of a source
+     * @return false if the source does not exist
+     */
+    bool getSourceSafe(am_sourceID_t sourceID, am_Source_s& source);
+
+    /**
+     * looks up a sink by its ID, mSinksMutex must be locked
+     * @return NULL if the sink does not exist
+     */
+    am_Sink_s* findSink(am_sinkID_t sinkID);
+
+    /**
+     * looks up a source by its ID, mSourcesMutex must be locked
+     * @return NULL if the source does not exist
+     */
+    am_Source_s* findSource(am_sourceID_t sourceID);
+
+    void indexSinks();
+    void indexSources();
+
     IAmRoutingReceiverShadow* mShadow;
     IAmRoutingReceive* mReceiveInterface;
     CAmSocketHandler *mSocketHandler;
@@ -225,9 +306,12 @@ private:
     std::vector<am_Sink_s> mSinks;
     std::vector<am_Source_s> mSources;
     std::vector<am_Gateway_s> mGateways;
+    std::map<am_sinkID_t, size_t> mMapSinkIndex; //!< position of the sinks in mSinks by sinkID
+    std::map<am_sourceID_t, size_t> mMapSourceIndex; //!< position of the sources in mSources by sourceID
     std::map<uint16_t, int16_t> mMapHandleWorker;
     std::map<am_connectionID_t, am_RoutingElement_s> mMapConnectionIDRoute;
     CAmWorkerThreadPool mPool;
+    CAmRampScheduler mRampScheduler; //!< runs the volume ramps of all sinks and sources
     pthread_t mInterruptThread;
     static pthread_mutex_t mMapConnectionMutex;
     static pthread_mutex_t mMapHandleWorkerMutex;
@@ -280,40 +364,6 @@ private:
 #include <sys/signalfd.h>
 #include <signal.h>
 
-class asyncSetSinkVolumeWorker: public CAmWorker
-{
-public:
-    asyncSetSinkVolumeWorker(CAmRoutingSenderAsync * asyncSender, CAmWorkerThreadPool* pool, IAmRoutingReceiverShadow* shadow, const am_volume_t currentVolume, const am_Handle_s handle, const am_sinkID_t sinkID, const am_volume_t volume, const am_RampType_e ramp, const am_time_t time);
-    void start2work();
-    void cancelWork();
-private:
-    CAmRoutingSenderAsync * mAsyncSender;
-    IAmRoutingReceiverShadow *mShadow;
-    am_volume_t mCurrentVolume;
-    am_Handle_s mHandle;
-    am_sinkID_t mSinkID;
-    am_volume_t mVolume;
-    am_RampType_e mRamp;
-    am_time_t mTime;
-};
-
-class asyncSetSourceVolumeWorker: public CAmWorker
-{
-public:
-    asyncSetSourceVolumeWorker(CAmRoutingSenderAsync * asyncSender, CAmWorkerThreadPool* pool, IAmRoutingReceiverShadow* shadow, const am_volume_t currentVolume, const am_Handle_s handle, const am_sourceID_t SourceID, const am_volume_t volume, const am_RampType_e ramp, const am_time_t time);
-    void start2work();
-    void cancelWork();
-private:
-    CAmRoutingSenderAsync * mAsyncSender;
-    IAmRoutingReceiverShadow *mShadow;
-    am_volume_t mCurrentVolume;
-    am_Handle_s mHandle;
-    am_sourceID_t mSourceID;
-    am_volume_t mVolume;
-    am_RampType_e mRamp;
-    am_time_t mTime;
-};
-
 class asyncSetSourceStateWorker: public CAmWorker
 {
 public:
@@ -0,0 +1,340 @@
+/**
+ *  Copyright (c) 2012 BMW
+ *
+ *  \author Christian Mueller, christian.ei.mueller@bmw.de BMW 2011,2012
+ *
+ *  \copyright
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction,
+ *  including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ *  THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For further information see http://www.genivi.org/.
+ */
+
+#include "CAmRampScheduler.h"
+#include "CAmRoutingSenderAsync.h"
+#include "IAmRoutingReceiverShadow.h"
+#include <cassert>
+#include <cmath>
+#include "shared/CAmDltWrapper.h"
+
+#define MAX_NS 1000000000L
+
+/**
+ * steepness of the exponential ramps
+ */
+#define RAMP_EXP_FACTOR 4.0
+
+namespace am
+{
+
+static void addNs(timespec& time, const long ns)
+{
+    time.tv_sec += ns / MAX_NS;
+    time.tv_nsec += ns % MAX_NS;
+    if (time.tv_nsec >= MAX_NS)
+    {
+        time.tv_sec++;
+        time.tv_nsec -= MAX_NS;
+    }
+}
+
+static bool isBefore(const timespec& a, const timespec& b)
+{
+    return (a.tv_sec < b.tv_sec || (a.tv_sec == b.tv_sec && a.tv_nsec < b.tv_nsec));
+}
+
+static double elapsedMs(const timespec& start, const timespec& end)
+{
+    return ((end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1000000.0);
+}
+
+CAmRampScheduler::CAmRampScheduler(CAmRoutingSenderAsync* asyncSender, const uint16_t tickRate) :
+        mAsyncSender(asyncSender), //
+        mShadow(NULL), //
+        mTickRate(tickRate), //
+        mRamps(), //
+        mThread(), //
+        mMutex(), //
+        mCond(), //
+        mRunning(false), //
+        mQuit(false)
+{
+    assert(mTickRate>0);
+    pthread_mutex_init(&mMutex, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&mCond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+CAmRampScheduler::~CAmRampScheduler()
+{
+    stop();
+    pthread_cond_destroy(&mCond);
+    pthread_mutex_destroy(&mMutex);
+}
+
+/**
+ * starts the ramp thread
+ * @param shadow the shadow that receives the acks
+ */
+void CAmRampScheduler::start(IAmRoutingReceiverShadow* shadow)
+{
+    assert(shadow!=NULL);
+    assert(!mRunning);
+    mShadow = shadow;
+    mQuit = false;
+    if (pthread_create(&mThread, NULL, &CAmRampScheduler::rampThread, this) != 0)
+    {
+        logError("RampScheduler::start could not create thread");
+        return;
+    }
+    mRunning = true;
+}
+
+/**
+ * stops the ramp thread. Ramps that are still running are dropped without ack.
+ */
+void CAmRampScheduler::stop()
+{
+    if (!mRunning)
+        return;
+    pthread_mutex_lock(&mMutex);
+    mQuit = true;
+    pthread_cond_signal(&mCond);
+    pthread_mutex_unlock(&mMutex);
+    pthread_join(mThread, NULL);
+    mRunning = false;
+    mRamps.clear();
+}
+
+void CAmRampScheduler::startSinkRamp(const am_Handle_s handle, const am_sinkID_t sinkID, const am_volume_t currentVolume, const am_volume_t volume, const am_RampType_e ramp, const am_time_t time)
+{
+    ramp_s newRamp;
+    newRamp.handle = handle;
+    newRamp.isSink = true;
+    newRamp.elementID = sinkID;
+    newRamp.startVolume = currentVolume;
+    newRamp.volume = volume;
+    newRamp.rampType = ramp;
+    startRamp(newRamp, time);
+}
+
+void CAmRampScheduler::startSourceRamp(const am_Handle_s handle, const am_sourceID_t sourceID, const am_volume_t currentVolume, const am_volume_t volume, const am_RampType_e ramp, const am_time_t time)
+{
+    ramp_s newRamp;
+    newRamp.handle = handle;
+    newRamp.isSink = false;
+    newRamp.elementID = sourceID;
+    newRamp.startVolume = currentVolume;
+    newRamp.volume = volume;
+    newRamp.rampType = ramp;
+    startRamp(newRamp, time);
+}
+
+/**
+ * aborts a ramp. The volume that was reached is kept and acknowledged with E_ABORTED by the ramp thread, after the
+ * ticks of the ramp that are already on their way.
+ * @param handle the handle of the ramp
+ * @return false if there is no ramp for the handle, either because it never existed or because it is already finished
+ *         or canceled
+ */
+bool CAmRampScheduler::cancelRamp(const uint16_t handle)
+{
+    pthread_mutex_lock(&mMutex);
+    RampMap::iterator iter = mRamps.find(handle);
+    if (iter == mRamps.end() || iter->second.canceled)
+    {
+        pthread_mutex_unlock(&mMutex);
+        return (false);
+    }
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    evaluate(iter->second, now);
+    iter->second.canceled = true;
+    pthread_cond_signal(&mCond);
+    pthread_mutex_unlock(&mMutex);
+    return (true);
+}
+
+void* CAmRampScheduler::rampThread(void* data)
+{
+    static_cast<CAmRampScheduler*>(data)->run();
+    return (NULL);
+}
+
+void CAmRampScheduler::startRamp(ramp_s& ramp, const am_time_t time)
+{
+    long durationMs = time;
+    switch (ramp.rampType)
+    {
+    case RAMP_GENIVI_NO_PLOP:
+        if (durationMs > RAMP_NO_PLOP_TIME)
+            durationMs = RAMP_NO_PLOP_TIME;
+        break;
+    case RAMP_GENIVI_LINEAR:
+    case RAMP_GENIVI_EXP:
+    case RAMP_GENIVI_EXP_INV:
+        break;
+    default:
+        durationMs = 0;
+        break;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &ramp.start);
+    ramp.end = ramp.start;
+    addNs(ramp.end, durationMs * 1000000L);
+    ramp.nextTick = ramp.start;
+    ramp.currentVolume = ramp.startVolume;
+    ramp.ackedVolume = ramp.startVolume;
+    ramp.canceled = false;
+
+    pthread_mutex_lock(&mMutex);
+    mRamps[ramp.handle.handle] = ramp;
+    pthread_cond_signal(&mCond);
+    pthread_mutex_unlock(&mMutex);
+}
+
+/**
+ * calculates the volume of the ramp at the given time
+ */
+void CAmRampScheduler::evaluate(ramp_s& ramp, const timespec& now) const
+{
+    double duration = elapsedMs(ramp.start, ramp.end);
+    if (duration <= 0.0 || !isBefore(now, ramp.end))
+    {
+        ramp.currentVolume = ramp.volume;
+        return;
+    }
+
+    double progress = elapsedMs(ramp.start, now) / duration;
+    double scale = exp(RAMP_EXP_FACTOR) - 1.0;
+    switch (ramp.rampType)
+    {
+    case RAMP_GENIVI_EXP:
+        //slow start, fast end
+        progress = (exp(RAMP_EXP_FACTOR * progress) - 1.0) / scale;
+        break;
+    case RAMP_GENIVI_EXP_INV:
+        //fast start, slow end
+        progress = 1.0 - (exp(RAMP_EXP_FACTOR * (1.0 - progress)) - 1.0) / scale;
+        break;
+    default:
+        break;
+    }
+    ramp.currentVolume = ramp.startVolume + static_cast<am_volume_t>(floor((ramp.volume - ramp.startVolume) * progress + 0.5));
+}
+
+void CAmRampScheduler::finish(const ramp_s& ramp, const am_Error_e error)
+{
+    if (ramp.isSink)
+    {
+        mAsyncSender->updateSinkVolumeSafe(ramp.elementID, ramp.currentVolume);
+        mAsyncSender->removeHandleSafe(ramp.handle.handle);
+        mShadow->ackSetSinkVolumeChange(ramp.handle, ramp.currentVolume, error);
+    }
+    else
+    {
+        mAsyncSender->updateSourceVolumeSafe(ramp.elementID, ramp.currentVolume);
+        mAsyncSender->removeHandleSafe(ramp.handle.handle);
+        mShadow->ackSetSourceVolumeChange(ramp.handle, ramp.currentVolume, error);
+    }
+}
+
+void CAmRampScheduler::tick(const ramp_s& ramp)
+{
+    if (ramp.isSink)
+        mShadow->ackSinkVolumeTick(ramp.handle, ramp.elementID, ramp.currentVolume);
+    else
+        mShadow->ackSourceVolumeTick(ramp.handle, ramp.elementID, ramp.currentVolume);
+}
+
+/**
+ * the loop of the ramp thread. The acks are sent without holding the lock, so cancelRamp and the start functions never
+ * wait for the shadow. Only this thread sends acks, the ticks of one pass are sent before the final acks.
+ */
+void CAmRampScheduler::run()
+{
+    std::vector<ramp_s> listFinished;
+    std::vector<ramp_s> listAborted;
+    std::vector<ramp_s> listTicks;
+    timespec now, deadline;
+
+    pthread_mutex_lock(&mMutex);
+    while (!mQuit)
+    {
+        if (mRamps.empty())
+        {
+            pthread_cond_wait(&mCond, &mMutex);
+            continue;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        deadline = now;
+        addNs(deadline, MAX_NS / mTickRate);
+
+        RampMap::iterator iter = mRamps.begin();
+        while (iter != mRamps.end())
+        {
+            ramp_s& ramp = iter->second;
+            if (ramp.canceled)
+            {
+                //keeps the volume that cancelRamp evaluated
+                listAborted.push_back(ramp);
+                mRamps.erase(iter++);
+                continue;
+            }
+            evaluate(ramp, now);
+            if (!isBefore(now, ramp.end))
+            {
+                listFinished.push_back(ramp);
+                mRamps.erase(iter++);
+                continue;
+            }
+            if (!isBefore(now, ramp.nextTick))
+            {
+                ramp.nextTick = now;
+                addNs(ramp.nextTick, MAX_NS / mTickRate);
+                if (ramp.currentVolume != ramp.ackedVolume)
+                {
+                    ramp.ackedVolume = ramp.currentVolume;
+                    listTicks.push_back(ramp);
+                }
+            }
+            if (isBefore(ramp.nextTick, deadline))
+                deadline = ramp.nextTick;
+            if (isBefore(ramp.end, deadline))
+                deadline = ramp.end;
+            ++iter;
+        }
+
+        if (!listFinished.empty() || !listAborted.empty() || !listTicks.empty())
+        {
+            pthread_mutex_unlock(&mMutex);
+            std::vector<ramp_s>::const_iterator rampIter = listTicks.begin();
+            for (; rampIter != listTicks.end(); ++rampIter)
+                tick(*rampIter);
+            for (rampIter = listFinished.begin(); rampIter != listFinished.end(); ++rampIter)
+                finish(*rampIter, E_OK);
+            for (rampIter = listAborted.begin(); rampIter != listAborted.end(); ++rampIter)
+                finish(*rampIter, E_ABORTED);
+            listTicks.clear();
+            listFinished.clear();
+            listAborted.clear();
+            pthread_mutex_lock(&mMutex);
+            //ramps might have been added or removed meanwhile, so evaluate again before waiting
+            continue;
+        }
+
+        pthread_cond_timedwait(&mCond, &mMutex, &deadline);
+    }
+    pthread_mutex_unlock(&mMutex);
+}
+
+}
@@ -48,94 +48,220 @@ pthread_mutex_t CAmRoutingSenderAsync::mMapHandleWorkerMutex = PTHREAD_MUTEX_INI
 pthread_mutex_t CAmRoutingSenderAsync::mSinksMutex= PTHREAD_MUTEX_INITIALIZER;
 pthread_mutex_t CAmRoutingSenderAsync::mSourcesMutex= PTHREAD_MUTEX_INITIALIZER;
 pthread_mutex_t CAmRoutingSenderAsync::mDomainsMutex= PTHREAD_MUTEX_INITIALIZER;
-pthread_mutex_t CAmWorkerThreadPool::mBlockingMutex = PTHREAD_MUTEX_INITIALIZER;
 
 void *CAmWorkerThreadPool::CAmWorkerThread(void* data)
 {
     threadInfo_s *myInfo=(threadInfo_s*)data;
-    while (1)
-    {
-        sem_wait(&myInfo->block);
-        pthread_mutex_lock(&mBlockingMutex);
-        CAmWorker* actWorker=myInfo->worker;
-        pthread_mutex_unlock(&mBlockingMutex);
-        actWorker->setCancelSempaphore(&myInfo->cancel);
-        actWorker->start2work();
-        actWorker->pPool->finishedWork(myInfo->threadID);
-    }
+    myInfo->pool->work(*myInfo);
     return NULL;
 }
 
-CAmWorkerThreadPool::CAmWorkerThreadPool(int numThreads):
-mNumThreads(numThreads)
+CAmWorkerThreadPool::CAmWorkerThreadPool(int numThreads, size_t maxQueue):
+        mMaxThreads(numThreads), //
+        mNumThreads(0), //
+        mIdleThreads(0), //
+        mMaxQueue(maxQueue), //
+        mWorkerIDCount(0), //
+        mQuit(false), //
+        mQueueHighWater(0), //
+        mRejected(0), //
+        mListWorkers(), //
+        mQueue(), //
+        mMutex(), //
+        mWorkCond()
 {
-    int workerID=0;
-    mListWorkers.resize(mNumThreads);
-    for (int i=0;i<mNumThreads;i++)
-    {
-        sem_init(&mListWorkers[i].block,NULL,NULL);
-        sem_init(&mListWorkers[i].cancel,NULL,NULL);
-        mListWorkers[i].busy=false;
-        mListWorkers[i].workerID=++workerID;
-        pthread_create(&mListWorkers[i].threadID,NULL,&CAmWorkerThreadPool::CAmWorkerThread,(void*)&mListWorkers[i]);
-    }
+    assert(mMaxThreads>0);
+    assert(mMaxQueue>0);
+    mListWorkers.resize(mMaxThreads);
+    pthread_mutex_init(&mMutex, NULL);
+    pthread_cond_init(&mWorkCond, NULL);
 }
 
 int16_t CAmWorkerThreadPool::startWork(CAmWorker *worker)
 {
-    pthread_mutex_lock(&mBlockingMutex);
-    std::vector<threadInfo_s>::iterator it=mListWorkers.begin();
-    for(;it!=mListWorkers.end();++it)
+    assert(worker!=NULL);
+    pthread_mutex_lock(&mMutex);
+    //waiting for space would block the mainloop, so the request is refused right away
+    if (mQueue.size() >= mMaxQueue || mQuit)
     {
-        if(!it->busy)
-        {
-            it->worker=worker;
-            it->busy=true;
-            pthread_mutex_unlock(&mBlockingMutex);
-            sem_post(&it->block);
-            return ((int)it->workerID);
-        }
+        mRejected++;
+        pthread_mutex_unlock(&mMutex);
+        return (-1);
     }
-    pthread_mutex_unlock(&mBlockingMutex);
-    return (-1);
+
+    job_s job;
+    job.workerID = nextWorkerID();
+    job.worker = worker;
+    mQueue.push_back(job);
+    if (mQueue.size() > mQueueHighWater)
+        mQueueHighWater = mQueue.size();
+
+    if ((int) mQueue.size() > mIdleThreads && mNumThreads < mMaxThreads)
+        createThread();
+    else
+        pthread_cond_signal(&mWorkCond);
+    pthread_mutex_unlock(&mMutex);
+    return (job.workerID);
 }
 
 bool CAmWorkerThreadPool::cancelWork(int workerID)
 {
+    pthread_mutex_lock(&mMutex);
+    std::deque<job_s>::iterator jobIter = mQueue.begin();
+    for (; jobIter != mQueue.end(); ++jobIter)
+    {
+        if (jobIter->workerID == workerID)
+        {
+            //the worker never started, so it is canceled right here
+            CAmWorker* worker = jobIter->worker;
+            mQueue.erase(jobIter);
+            pthread_mutex_unlock(&mMutex);
+            worker->cancelWork();
+            delete worker;
+            return (true);
+        }
+    }
+
     std::vector<threadInfo_s>::iterator it=mListWorkers.begin();
-    for(;it!=mListWorkers.end();++it)
+    for(;it!=mListWorkers.begin()+mNumThreads;++it)
     {
-        if(it->workerID==workerID && it->busy)
+        if(it->workerID==workerID)
         {
             sem_post(&it->cancel);
+            it->canceled++;
+            pthread_mutex_unlock(&mMutex);
             return (true);
         }
     }
+    pthread_mutex_unlock(&mMutex);
     return (false);
 }
 
-void CAmWorkerThreadPool::finishedWork(pthread_t threadID)
+void CAmWorkerThreadPool::stop()
 {
-    pthread_mutex_lock(&mBlockingMutex);
+    pthread_mutex_lock(&mMutex);
+    if (mQuit)
+    {
+        pthread_mutex_unlock(&mMutex);
+        return;
+    }
+    mQuit = true;
     std::vector<threadInfo_s>::iterator it=mListWorkers.begin();
-    for(;it!=mListWorkers.end();++it)
+    for(;it!=mListWorkers.begin()+mNumThreads;++it)
     {
-        if(it->threadID==threadID)
+        if (it->workerID != 0)
+            sem_post(&it->cancel);
+    }
+    pthread_cond_broadcast(&mWorkCond);
+    pthread_mutex_unlock(&mMutex);
+
+    for (int i=0;i<mNumThreads;i++)
+    {
+        pthread_join(mListWorkers[i].threadID, NULL);
+        sem_destroy(&mListWorkers[i].cancel);
+    }
+
+    std::deque<job_s>::iterator jobIter = mQueue.begin();
+    for (; jobIter != mQueue.end(); ++jobIter)
+        delete jobIter->worker;
+    mQueue.clear();
+}
+
+void CAmWorkerThreadPool::getStatistics(std::vector<workerStatistic_s>& listStatistics, uint32_t& queueHighWater, uint32_t& rejected) const
+{
+    listStatistics.clear();
+    workerStatistic_s statistic;
+    pthread_mutex_lock(&mMutex);
+    std::vector<threadInfo_s>::const_iterator it=mListWorkers.begin();
+    for(;it!=mListWorkers.begin()+mNumThreads;++it)
+    {
+        statistic.thread = it->thread;
+        statistic.jobs = it->jobs;
+        statistic.canceled = it->canceled;
+        statistic.busyNs = it->busyNs;
+        listStatistics.push_back(statistic);
+    }
+    queueHighWater = mQueueHighWater;
+    rejected = mRejected;
+    pthread_mutex_unlock(&mMutex);
+}
+
+/**
+ * the loop of a pool thread, takes the jobs from the queue until the pool is stopped
+ */
+void CAmWorkerThreadPool::work(threadInfo_s& info)
+{
+    timespec start, end;
+    pthread_mutex_lock(&mMutex);
+    while (!mQuit)
+    {
+        if (mQueue.empty())
         {
-            it->busy=false;
-            delete it->worker;
-            break;
+            mIdleThreads++;
+            pthread_cond_wait(&mWorkCond, &mMutex);
+            mIdleThreads--;
+            continue;
         }
+
+        job_s job = mQueue.front();
+        mQueue.pop_front();
+        info.workerID = job.workerID;
+
+        //a cancel that came too late for the last worker must not hit this one
+        while (sem_trywait(&info.cancel) == 0)
+            ;
+        pthread_mutex_unlock(&mMutex);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        job.worker->setCancelSempaphore(&info.cancel);
+        job.worker->start2work();
+        delete job.worker;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        pthread_mutex_lock(&mMutex);
+        info.workerID = 0;
+        info.jobs++;
+        info.busyNs += (uint64_t) (end.tv_sec - start.tv_sec) * MAX_NS + end.tv_nsec - start.tv_nsec;
     }
-    pthread_mutex_unlock(&mBlockingMutex);
+    pthread_mutex_unlock(&mMutex);
 }
 
-CAmWorkerThreadPool::~CAmWorkerThreadPool()
-{
-    for (int i=0;i<mNumThreads;i++)
+/**
+ * starts one more thread, must be called with mMutex locked
+ */
+void CAmWorkerThreadPool::createThread()
+{
+    threadInfo_s& info = mListWorkers[mNumThreads];
+    info.pool = this;
+    info.thread = mNumThreads + 1;
+    info.workerID = 0;
+    info.jobs = 0;
+    info.canceled = 0;
+    info.busyNs = 0;
+    sem_init(&info.cancel, 0, 0);
+    if (pthread_create(&info.threadID, NULL, &CAmWorkerThreadPool::CAmWorkerThread, (void*) &info) != 0)
     {
-        pthread_cancel(mListWorkers[i].threadID);
+        logError("CAmWorkerThreadPool::createThread could not create thread");
+        sem_destroy(&info.cancel);
+        return;
     }
+    mNumThreads++;
+}
+
+/**
+ * hands out positive ids, must be called with mMutex locked
+ */
+int16_t CAmWorkerThreadPool::nextWorkerID()
+{
+    mWorkerIDCount = (mWorkerIDCount == 0x7FFF) ? 1 : mWorkerIDCount + 1;
+    return (mWorkerIDCount);
+}
+
+CAmWorkerThreadPool::~CAmWorkerThreadPool()
+{
+    stop();
+    pthread_cond_destroy(&mWorkCond);
+    pthread_mutex_destroy(&mMutex);
 }
 
 CAmWorker::CAmWorker(CAmWorkerThreadPool *pool):
@@ -181,12 +307,16 @@ bool CAmWorker::timedWait(timespec timer)
 }
 
 CAmRoutingSenderAsync::CAmRoutingSenderAsync() :
-        mReceiveInterface(0), mDomains(createDomainTable()), mSinks(createSinkTable()), mSources(createSourceTable()), mGateways(createGatewayTable()), mMapHandleWorker(), mMapConnectionIDRoute(), mPool(10)
+        mReceiveInterface(0), mDomains(createDomainTable()), mSinks(createSinkTable()), mSources(createSourceTable()), mGateways(createGatewayTable()), mMapHandleWorker(), mMapConnectionIDRoute(), mPool(10), mRampScheduler(this)
 {
+    indexSinks();
+    indexSources();
 }
 
 CAmRoutingSenderAsync::~CAmRoutingSenderAsync()
 {
+    mRampScheduler.stop();
+    mPool.stop();
     delete mShadow;
 }
 
@@ -198,6 +328,7 @@ am_Error_e CAmRoutingSenderAsync::startupInterface(IAmRoutingReceive *routingrec
     CAmSocketHandler* handler;
     routingreceiveinterface->getSocketHandler(handler);
     mShadow = new IAmRoutingReceiverShadow(routingreceiveinterface, handler);
+    mRampScheduler.start(mShadow);
     return E_OK;
 }
 
@@ -207,7 +338,7 @@ void CAmRoutingSenderAsync::setRoutingReady(const uint16_t handle)
 
     if ((mPool.startWork(worker)) == -1)
     {
-        logError("AsyncRoutingSender::asyncConnect not enough threads!");
+        logError("AsyncRoutingSender::asyncConnect work queue is full!");
         delete worker;
     }
 
@@ -244,16 +375,25 @@ am_Error_e CAmRoutingSenderAsync::asyncAbort(const am_Handle_s handle)
 
     //first check if we know the handle
     pthread_mutex_lock(&mMapHandleWorkerMutex);
-    std::map<uint16_t, int16_t>::iterator iter = mMapHandleWorker.begin();
-    if (mMapHandleWorker.find(handle.handle) == mMapHandleWorker.end())
+    std::map<uint16_t, int16_t>::iterator iter = mMapHandleWorker.find(handle.handle);
+    if (iter == mMapHandleWorker.end())
     {
         pthread_mutex_unlock(&mMapHandleWorkerMutex);
         return (E_NON_EXISTENT);
     }
+    int16_t workerID = iter->second;
     pthread_mutex_unlock(&mMapHandleWorkerMutex);
 
+    //volume changes are not running on a worker but on the ramp scheduler
+    if (handle.handleType == H_SETSINKVOLUME || handle.handleType == H_SETSOURCEVOLUME)
+    {
+        if (mRampScheduler.cancelRamp(handle.handle))
+            return (E_OK);
+        return (E_UNKNOWN);
+    }
+
     //ok, cancel the action:
-    if (mPool.cancelWork(iter->second))
+    if (mPool.cancelWork(workerID))
         return (E_OK);
     return (E_UNKNOWN);
 }
@@ -273,29 +413,11 @@ am_Error_e CAmRoutingSenderAsync::asyncConnect(const am_Handle_s handle, const a
     int16_t work = -1;
 
     //find the sink
-    std::vector<am_Sink_s>::iterator sinkIter = mSinks.begin();
-    for (; sinkIter != mSinks.end(); ++sinkIter)
-    {
-        if (sinkIter->sinkID == sinkID)
-        {
-            sink = *sinkIter;
-            break;
-        }
-    }
-    if (sinkIter == mSinks.end())
+    if (!getSinkSafe(sinkID, sink))
         return (E_NON_EXISTENT); //not found!
 
     //find the source
-    std::vector<am_Source_s>::iterator sourceIter = mSources.begin();
-    for (; sourceIter != mSources.end(); ++sourceIter)
-    {
-        if (sourceIter->sourceID == sourceID)
-        {
-            source = *sourceIter;
-            break;
-        }
-    }
-    if (sourceIter == mSources.end())
+    if (!getSourceSafe(sourceID, source))
         return (E_NON_EXISTENT); //not found!
 
     //check the format
@@ -308,7 +430,7 @@ am_Error_e CAmRoutingSenderAsync::asyncConnect(const am_Handle_s handle, const a
     asycConnectWorker *worker = new asycConnectWorker(this, &mPool, mShadow, handle, connectionID, sourceID, sinkID, connectionFormat);
     if ((work = mPool.startWork(worker)) == -1)
     {
-        logError("AsyncRoutingSender::asyncConnect not enough threads!");
+        logError("AsyncRoutingSender::asyncConnect work queue is full!");
         delete worker;
         return (E_NOT_POSSIBLE);
     }
@@ -343,7 +465,7 @@ am_Error_e CAmRoutingSenderAsync::asyncDisconnect(const am_Handle_s handle, cons
     asycDisConnectWorker *worker = new asycDisConnectWorker(this, &mPool, mShadow, handle, connectionID);
     if ((work = mPool.startWork(worker)) == -1)
     {
-        logError("AsyncRoutingSender::asyncDisconnect not enough threads!");
+        logError("AsyncRoutingSender::asyncDisconnect work queue is full!");
         delete worker;
         return (E_NOT_POSSIBLE);
     }
@@ -365,36 +487,18 @@ am_Error_e CAmRoutingSenderAsync::asyncSetSinkVolume(const am_Handle_s handle, c
 
     //check if we can take the job
     am_Sink_s sink;
-    int16_t work = -1;
 
     //find the sink
-    pthread_mutex_lock(&mSinksMutex);
-    std::vector<am_Sink_s>::iterator sinkIter = mSinks.begin();
-    for (; sinkIter != mSinks.end(); ++sinkIter)
-    {
-        if (sinkIter->sinkID == sinkID)
-        {
-            sink = *sinkIter;
-            break;
-        }
-    }
-    pthread_mutex_unlock(&mSinksMutex);
-    if (sinkIter == mSinks.end())
+    if (!getSinkSafe(sinkID, sink))
         return (E_NON_EXISTENT); //not found!
 
-    asyncSetSinkVolumeWorker *worker = new asyncSetSinkVolumeWorker(this, &mPool, mShadow, sinkIter->volume, handle, sinkID, volume, ramp, time);
-    if ((work = mPool.startWork(worker)) == -1)
-    {
-        logError("AsyncRoutingSender::asyncSetSinkVolume not enough threads!");
-        delete worker;
-        return (E_NOT_POSSIBLE);
-    }
-
-    //save the handle related to the workerID
+    //save the handle before the ramp starts, a direct ramp might finish right away
     pthread_mutex_lock(&mMapHandleWorkerMutex);
-    mMapHandleWorker.insert(std::make_pair(handle.handle, work));
+    mMapHandleWorker.insert(std::make_pair(handle.handle, 0));
     pthread_mutex_unlock(&mMapHandleWorkerMutex);
 
+    mRampScheduler.startSinkRamp(handle, sinkID, sink.volume, volume, ramp, time);
+
     return (E_OK);
 }
 
@@ -407,36 +511,18 @@ am_Error_e CAmRoutingSenderAsync::asyncSetSourceVolume(const am_Handle_s handle,
 
     //check if we can take the job
     am_Source_s source;
-    int16_t work = -1;
 
     //find the sink
-    pthread_mutex_lock(&mSourcesMutex);
-    std::vector<am_Source_s>::iterator sourceIter = mSources.begin();
-    for (; sourceIter != mSources.end(); ++sourceIter)
-    {
-        if (sourceIter->sourceID == sourceID)
-        {
-            source = *sourceIter;
-            break;
-        }
-    }
-    pthread_mutex_unlock(&mSourcesMutex);
-    if (sourceIter == mSources.end())
+    if (!getSourceSafe(sourceID, source))
         return (E_NON_EXISTENT); //not found!
 
-    asyncSetSourceVolumeWorker *worker = new asyncSetSourceVolumeWorker(this, &mPool, mShadow, sourceIter->volume, handle, sourceID, volume, ramp, time);
-    if ((work = mPool.startWork(worker)) == -1)
-    {
-        logError("AsyncRoutingSender::asyncSetSourceVolume not enough threads!");
-        delete worker;
-        return (E_NOT_POSSIBLE);
-    }
-
-    //save the handle related to the workerID
+    //save the handle before the ramp starts, a direct ramp might finish right away
     pthread_mutex_lock(&mMapHandleWorkerMutex);
-    mMapHandleWorker.insert(std::make_pair(handle.handle, work));
+    mMapHandleWorker.insert(std::make_pair(handle.handle, 0));
     pthread_mutex_unlock(&mMapHandleWorkerMutex);
 
+    mRampScheduler.startSourceRamp(handle, sourceID, source.volume, volume, ramp, time);
+
     return (E_OK);
 }
 
@@ -452,24 +538,13 @@ am_Error_e CAmRoutingSenderAsync::asyncSetSourceState(const am_Handle_s handle,
     int16_t work = -1;
 
     //find the source
-    pthread_mutex_lock(&mSourcesMutex);
-    std::vector<am_Source_s>::iterator sourceIter = mSources.begin();
-    for (; sourceIter != mSources.end(); ++sourceIter)
-    {
-        if (sourceIter->sourceID == sourceID)
-        {
-            source = *sourceIter;
-            break;
-        }
-    }
-    pthread_mutex_unlock(&mSourcesMutex);
-    if (sourceIter == mSources.end())
+    if (!getSourceSafe(sourceID, source))
         return (E_NON_EXISTENT); //not found!
 
     asyncSetSourceStateWorker *worker = new asyncSetSourceStateWorker(this, &mPool, mShadow, handle, sourceID, state);
     if ((work = mPool.startWork(worker)) == -1)
     {
-        logError("AsyncRoutingSender::asyncSetSourceState not enough threads!");
+        logError("AsyncRoutingSender::asyncSetSourceState work queue is full!");
         delete worker;
         return (E_NOT_POSSIBLE);
     }
@@ -494,24 +569,13 @@ am_Error_e CAmRoutingSenderAsync::asyncSetSinkSoundProperty(const am_Handle_s ha
     int16_t work = -1;
 
     //find the sink
-    pthread_mutex_lock(&mSinksMutex);
-    std::vector<am_Sink_s>::iterator sinkIter = mSinks.begin();
-    for (; sinkIter != mSinks.end(); ++sinkIter)
-    {
-        if (sinkIter->sinkID == sinkID)
-        {
-            sink = *sinkIter;
-            break;
-        }
-    }
-    pthread_mutex_unlock(&mSinksMutex);
-    if (sinkIter == mSinks.end())
+    if (!getSinkSafe(sinkID, sink))
         return (E_NON_EXISTENT); //not found!
 
     asyncSetSinkSoundPropertyWorker *worker = new asyncSetSinkSoundPropertyWorker(this, &mPool, mShadow, handle, soundProperty, sinkID);
     if ((work = mPool.startWork(worker)) == -1)
     {
-        logError("AsyncRoutingSender::asyncSetSinkSoundProperty not enough threads!");
+        logError("AsyncRoutingSender::asyncSetSinkSoundProperty work queue is full!");
         delete worker;
         return (E_NOT_POSSIBLE);
     }
@@ -562,7 +626,7 @@ am_Error_e CAmRoutingSenderAsync::setDomainState(const am_domainID_t domainID, c
     asyncDomainStateChangeWorker *worker = new asyncDomainStateChangeWorker(this, &mPool, mShadow, domainID, domainState);
     if ((work = mPool.startWork(worker)) == -1)
     {
-        logError("AsyncRoutingSender::setDomainState not enough threads!");
+        logError("AsyncRoutingSender::setDomainState work queue is full!");
         delete worker;
         return (E_NOT_POSSIBLE);
     }
@@ -583,24 +647,13 @@ am_Error_e CAmRoutingSenderAsync::asyncSetSourceSoundProperty(const am_Handle_s
     int16_t work = -1;
 
     //find the source
-    pthread_mutex_lock(&mSourcesMutex);
-    std::vector<am_Source_s>::iterator sourceIter = mSources.begin();
-    for (; sourceIter != mSources.end(); ++sourceIter)
-    {
-        if (sourceIter->sourceID == sourceID)
-        {
-            source = *sourceIter;
-            break;
-        }
-    }
-    pthread_mutex_unlock(&mSourcesMutex);
-    if (sourceIter == mSources.end())
+    if (!getSourceSafe(sourceID, source))
         return (E_NON_EXISTENT); //not found!
 
     asyncSetSourceSoundPropertyWorker *worker = new asyncSetSourceSoundPropertyWorker(this, &mPool, mShadow, handle, soundProperty, sourceID);
     if ((work = mPool.startWork(worker)) == -1)
     {
-        logError("AsyncRoutingSender::asyncSetSourceState not enough threads!");
+        logError("AsyncRoutingSender::asyncSetSourceState work queue is full!");
         delete worker;
         return (E_NOT_POSSIBLE);
     }
@@ -735,64 +788,43 @@ void CAmRoutingSenderAsync::removeConnectionSafe(am_connectionID_t connectionID)
 void CAmRoutingSenderAsync::updateSinkVolumeSafe(am_sinkID_t sinkID, am_volume_t volume)
 {
     pthread_mutex_lock(&mSinksMutex);
-    std::vector<am_Sink_s>::iterator sinkIter = mSinks.begin();
-    for (; sinkIter != mSinks.end(); ++sinkIter)
-    {
-        if (sinkIter->sinkID == sinkID)
-        {
-            sinkIter->volume = volume;
-            break;
-        }
-    }
+    am_Sink_s* sink = findSink(sinkID);
+    if (sink)
+        sink->volume = volume;
     pthread_mutex_unlock(&mSinksMutex);
 }
 
 void am::CAmRoutingSenderAsync::updateSourceVolumeSafe(am_sourceID_t sourceID, am_volume_t volume)
 {
     pthread_mutex_lock(&mSourcesMutex);
-    std::vector<am_Source_s>::iterator sourceIter = mSources.begin();
-    for (; sourceIter != mSources.end(); ++sourceIter)
-    {
-        if (sourceIter->sourceID == sourceID)
-        {
-            sourceIter->volume = volume;
-            break;
-        }
-    }
+    am_Source_s* source = findSource(sourceID);
+    if (source)
+        source->volume = volume;
     pthread_mutex_unlock(&mSourcesMutex);
 }
 
 void am::CAmRoutingSenderAsync::updateSourceStateSafe(am_sourceID_t sourceID, am_SourceState_e state)
 {
     pthread_mutex_lock(&mSourcesMutex);
-    std::vector<am_Source_s>::iterator sourceIter = mSources.begin();
-    for (; sourceIter != mSources.end(); ++sourceIter)
-    {
-        if (sourceIter->sourceID == sourceID)
-        {
-            sourceIter->sourceState = state;
-            break;
-        }
-    }
+    am_Source_s* source = findSource(sourceID);
+    if (source)
+        source->sourceState = state;
     pthread_mutex_unlock(&mSourcesMutex);
 }
 
 void am::CAmRoutingSenderAsync::updateSinkSoundPropertySafe(am_sinkID_t sinkID, am_SoundProperty_s soundProperty)
 {
     pthread_mutex_lock(&mSinksMutex);
-    std::vector<am_Sink_s>::iterator sinkIter = mSinks.begin();
-    for (; sinkIter != mSinks.end(); ++sinkIter)
+    am_Sink_s* sink = findSink(sinkID);
+    if (sink)
     {
-        if (sinkIter->sinkID == sinkID)
+        std::vector<am_SoundProperty_s>::iterator spIterator = sink->listSoundProperties.begin();
+        for (; spIterator != sink->listSoundProperties.end(); ++spIterator)
         {
-            std::vector<am_SoundProperty_s>::iterator spIterator = sinkIter->listSoundProperties.begin();
-            for (; spIterator != sinkIter->listSoundProperties.end(); ++spIterator)
+            if (spIterator->type == soundProperty.type)
             {
-                if (spIterator->type == soundProperty.type)
-                {
-                    spIterator->value = soundProperty.value;
-                    break;
-                }
+                spIterator->value = soundProperty.value;
+                break;
             }
         }
     }
@@ -802,19 +834,16 @@ void am::CAmRoutingSenderAsync::updateSinkSoundPropertySafe(am_sinkID_t sinkID,
 void am::CAmRoutingSenderAsync::updateSourceSoundPropertySafe(am_sourceID_t sourceID, am_SoundProperty_s soundProperty)
 {
     pthread_mutex_lock(&mSourcesMutex);
-    std::vector<am_Source_s>::iterator sourceIter = mSources.begin();
-    for (; sourceIter != mSources.end(); ++sourceIter)
+    am_Source_s* source = findSource(sourceID);
+    if (source)
     {
-        if (sourceIter->sourceID == sourceID)
+        std::vector<am_SoundProperty_s>::iterator spIterator = source->listSoundProperties.begin();
+        for (; spIterator != source->listSoundProperties.end(); ++spIterator)
         {
-            std::vector<am_SoundProperty_s>::iterator spIterator = sourceIter->listSoundProperties.begin();
-            for (; spIterator != sourceIter->listSoundProperties.end(); ++spIterator)
+            if (spIterator->type == soundProperty.type)
             {
-                if (spIterator->type == soundProperty.type)
-                {
-                    spIterator->value = soundProperty.value;
-                    break;
-                }
+                spIterator->value = soundProperty.value;
+                break;
             }
         }
     }
@@ -847,6 +876,7 @@ void am::CAmRoutingSenderAsync::updateSourceListSafe(std::vector<am_Source_s> li
 {
     pthread_mutex_lock(&mSourcesMutex);
     mSources = listSource;
+    indexSources();
     pthread_mutex_unlock(&mSourcesMutex);
 }
 
@@ -854,9 +884,60 @@ void am::CAmRoutingSenderAsync::updateSinkListSafe(std::vector<am_Sink_s> listSi
 {
     pthread_mutex_lock(&mSinksMutex);
     mSinks = listSinks;
+    indexSinks();
     pthread_mutex_unlock(&mSinksMutex);
 }
 
+bool CAmRoutingSenderAsync::getSinkSafe(am_sinkID_t sinkID, am_Sink_s& sink)
+{
+    pthread_mutex_lock(&mSinksMutex);
+    am_Sink_s* found = findSink(sinkID);
+    if (found)
+        sink = *found;
+    pthread_mutex_unlock(&mSinksMutex);
+    return (found != NULL);
+}
+
+bool CAmRoutingSenderAsync::getSourceSafe(am_sourceID_t sourceID, am_Source_s& source)
+{
+    pthread_mutex_lock(&mSourcesMutex);
+    am_Source_s* found = findSource(sourceID);
+    if (found)
+        source = *found;
+    pthread_mutex_unlock(&mSourcesMutex);
+    return (found != NULL);
+}
+
+am_Sink_s* CAmRoutingSenderAsync::findSink(am_sinkID_t sinkID)
+{
+    std::map<am_sinkID_t, size_t>::const_iterator iter = mMapSinkIndex.find(sinkID);
+    if (iter == mMapSinkIndex.end())
+        return (NULL);
+    return (&mSinks[iter->second]);
+}
+
+am_Source_s* CAmRoutingSenderAsync::findSource(am_sourceID_t sourceID)
+{
+    std::map<am_sourceID_t, size_t>::const_iterator iter = mMapSourceIndex.find(sourceID);
+    if (iter == mMapSourceIndex.end())
+        return (NULL);
+    return (&mSources[iter->second]);
+}
+
+void CAmRoutingSenderAsync::indexSinks()
+{
+    mMapSinkIndex.clear();
+    for (size_t i = 0; i < mSinks.size(); i++)
+        mMapSinkIndex[mSinks[i].sinkID] = i;
+}
+
+void CAmRoutingSenderAsync::indexSources()
+{
+    mMapSourceIndex.clear();
+    for (size_t i = 0; i < mSources.size(); i++)
+        mMapSourceIndex[mSources[i].sourceID] = i;
+}
+
 void CAmRoutingSenderAsync::getInterfaceVersion(std::string & version) const
 {
     version = RoutingSendVersion;
@@ -972,104 +1053,6 @@ void asycDisConnectWorker::cancelWork()
     mShadow->ackDisconnect(mHandle, mConnectionID, E_ABORTED);
 }
 
-asyncSetSinkVolumeWorker::asyncSetSinkVolumeWorker(CAmRoutingSenderAsync *asyncSender, CAmWorkerThreadPool *pool, IAmRoutingReceiverShadow *shadow, const am_volume_t currentVolume, const am_Handle_s handle, const am_sinkID_t sinkID, const am_volume_t volume, const am_RampType_e ramp, const am_time_t time) :
-        CAmWorker(pool), //
-        mAsyncSender(asyncSender), //
-        mShadow(shadow), //
-        mCurrentVolume(currentVolume), //
-        mHandle(handle), //
-        mSinkID(sinkID), //
-        mVolume(volume), //
-        mRamp(ramp), //
-        mTime(time)
-{
-}
-
-void asyncSetSinkVolumeWorker::start2work()
-{
-    //todo: this implementation does not respect time and ramp....
-    logInfo("Start setting sink volume");
-    timespec t;
-    t.tv_nsec = 10000000;
-    t.tv_sec = 0;
-
-    while (mCurrentVolume != mVolume)
-    {
-        if (mCurrentVolume < mVolume)
-            mCurrentVolume++;
-        else
-            mCurrentVolume--;
-        mShadow->ackSinkVolumeTick(mHandle, mSinkID, mCurrentVolume);
-        if (timedWait(t))
-            return;
-    }
-
-    //enter new connectionID into the list
-    mAsyncSender->updateSinkVolumeSafe(mSinkID, mCurrentVolume);
-
-    //send the ack
-    mShadow->ackSetSinkVolumeChange(mHandle, mCurrentVolume, E_OK);
-
-    //destroy the handle
-    mAsyncSender->removeHandleSafe(mHandle.handle);
-}
-
-void asyncSetSinkVolumeWorker::cancelWork()
-{
-    mAsyncSender->updateSinkVolumeSafe(mSinkID, mCurrentVolume);
-    mAsyncSender->removeHandleSafe(mHandle.handle);
-    mShadow->ackSetSinkVolumeChange(mHandle, mCurrentVolume, E_ABORTED);
-}
-
-asyncSetSourceVolumeWorker::asyncSetSourceVolumeWorker(CAmRoutingSenderAsync *asyncSender, CAmWorkerThreadPool *pool, IAmRoutingReceiverShadow *shadow, const am_volume_t currentVolume, const am_Handle_s handle, const am_sourceID_t SourceID, const am_volume_t volume, const am_RampType_e ramp, const am_time_t time) :
-        CAmWorker(pool), //
-        mAsyncSender(asyncSender), //
-        mShadow(shadow), //
-        mCurrentVolume(currentVolume), //
-        mHandle(handle), //
-        mSourceID(SourceID), //
-        mVolume(volume), //
-        mRamp(ramp), //
-        mTime(time)
-{
-}
-
-void asyncSetSourceVolumeWorker::start2work()
-{
-    //todo: this implementation does not respect time and ramp....
-    logInfo("Start setting source volume");
-    timespec t;
-    t.tv_nsec = 10000000;
-    t.tv_sec = 0;
-
-    while (mCurrentVolume != mVolume)
-    {
-        if (mCurrentVolume < mVolume)
-            mCurrentVolume++;
-        else
-            mCurrentVolume--;
-        mShadow->ackSourceVolumeTick(mHandle, mSourceID, mCurrentVolume);
-        if (timedWait(t))
-            return;
-    }
-
-    //enter new connectionID into the list
-    mAsyncSender->updateSourceVolumeSafe(mSourceID, mCurrentVolume);
-
-    //send the ack
-    mShadow->ackSetSourceVolumeChange(mHandle, mCurrentVolume, E_OK);
-
-    //destroy the handle
-    mAsyncSender->removeHandleSafe(mHandle.handle);
-}
-
-void asyncSetSourceVolumeWorker::cancelWork()
-{
-    mAsyncSender->updateSourceVolumeSafe(mSourceID, mCurrentVolume);
-    mAsyncSender->removeHandleSafe(mHandle.handle);
-    mShadow->ackSetSourceVolumeChange(mHandle, mCurrentVolume, E_ABORTED);
-}
-
 asyncSetSourceStateWorker::asyncSetSourceStateWorker(CAmRoutingSenderAsync *asyncSender, CAmWorkerThreadPool *pool, IAmRoutingReceiverShadow *shadow, const am_Handle_s handle, const am_sourceID_t sourceID, const am_SourceState_e state) :
         CAmWorker(pool), //
         mAsyncSender(asyncSender), //
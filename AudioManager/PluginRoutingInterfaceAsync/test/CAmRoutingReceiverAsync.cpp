@@ -234,8 +234,8 @@ TEST_F(CAmRoutingReceiverAsync,setSourceVolume)
 
     am_sourceID_t sourceID = 3;
     am_volume_t volume = 3;
-    am_RampType_e ramp = RAMP_GENIVI_DIRECT;
-    am_time_t myTime = 25;
+    am_RampType_e ramp = RAMP_GENIVI_LINEAR;
+    am_time_t myTime = 100;
 
     EXPECT_CALL(pReceiveInterface,ackSourceVolumeTick(_,sourceID,_)).Times(AtLeast(1));
     EXPECT_CALL(pReceiveInterface,ackSetSourceVolumeChange(_,volume,E_OK)).Times(1);
@@ -253,8 +253,8 @@ TEST_F(CAmRoutingReceiverAsync,setSinkVolume)
 
     am_sinkID_t sinkID = 1;
     am_volume_t volume = 9;
-    am_RampType_e ramp = RAMP_GENIVI_DIRECT;
-    am_time_t myTime = 25;
+    am_RampType_e ramp = RAMP_GENIVI_EXP;
+    am_time_t myTime = 200;
 
     EXPECT_CALL(pReceiveInterface,ackSinkVolumeTick(_,sinkID,_)).Times(AtLeast(2));
     EXPECT_CALL(pReceiveInterface,ackSetSinkVolumeChange(_,volume,E_OK)).Times(1);
@@ -263,6 +263,25 @@ TEST_F(CAmRoutingReceiverAsync,setSinkVolume)
     pSocketHandler.start_listenting();
 }
 
+TEST_F(CAmRoutingReceiverAsync,setSinkVolumeDirect)
+{
+
+    am_Handle_s handle;
+    handle.handle = 1;
+    handle.handleType = H_SETSINKVOLUME;
+
+    am_sinkID_t sinkID = 3;
+    am_volume_t volume = 12;
+    am_RampType_e ramp = RAMP_GENIVI_DIRECT;
+    am_time_t myTime = 500;
+
+    EXPECT_CALL(pReceiveInterface,ackSinkVolumeTick(_,sinkID,_)).Times(0);
+    EXPECT_CALL(pReceiveInterface,ackSetSinkVolumeChange(_,volume,E_OK)).Times(1);
+
+    ASSERT_EQ(E_OK, pRouter->asyncSetSinkVolume(handle,sinkID,volume,ramp,myTime));
+    pSocketHandler.start_listenting();
+}
+
 TEST_F(CAmRoutingReceiverAsync,setSinkVolumeAbort)
 {
 
@@ -272,14 +291,14 @@ TEST_F(CAmRoutingReceiverAsync,setSinkVolumeAbort)
 
     am_sinkID_t sinkID = 2;
     am_volume_t volume = 25;
-    am_RampType_e ramp = RAMP_GENIVI_DIRECT;
-    am_time_t myTime = 25;
+    am_RampType_e ramp = RAMP_GENIVI_LINEAR;
+    am_time_t myTime = 1000;
 
-    EXPECT_CALL(pReceiveInterface, ackSinkVolumeTick(_,sinkID,_));
+    EXPECT_CALL(pReceiveInterface, ackSinkVolumeTick(_,sinkID,_)).Times(AtLeast(1));
     EXPECT_CALL(pReceiveInterface,ackSetSinkVolumeChange(_,AllOf(Ne(volume),Ne(0)),E_ABORTED)).Times(1);
 
     ASSERT_EQ(E_OK, pRouter->asyncSetSinkVolume(handle,sinkID,volume,ramp,myTime));
-    sleep(0.5);
+    usleep(200000);
     ASSERT_EQ(E_OK, pRouter->asyncAbort(handle));
     pSocketHandler.start_listenting();
 }
@@ -476,7 +495,7 @@ TEST_F(CAmRoutingReceiverAsync,connect)
     pSocketHandler.start_listenting();
 }
 
-TEST_F(CAmRoutingReceiverAsync,connectNoMoreThreads)
+TEST_F(CAmRoutingReceiverAsync,connectMoreThanThreads)
 {
 
     am_Handle_s handle;
@@ -488,15 +507,42 @@ TEST_F(CAmRoutingReceiverAsync,connectNoMoreThreads)
     am_sinkID_t sinkID = 1;
     am_ConnectionFormat_e format = CF_GENIVI_ANALOG;
 
+    EXPECT_CALL(pReceiveInterface,ackConnect(_,_,E_OK)).Times(11);
+    for (int i = 0; i < 11; i++)
+    {
+        handle.handle++;
+        connectionID++;
+        ASSERT_EQ(E_OK, pRouter->asyncConnect(handle,connectionID,sourceID,sinkID,format));
+    }
+
+    //the last connect waits in the queue until one of the ten threads is done
+    for (int i = 0; i < 3; i++)
+        pSocketHandler.start_listenting();
+}
+
+TEST_F(CAmRoutingReceiverAsync,connectAbortQueued)
+{
+
+    am_Handle_s handle;
+    handle.handle = 20;
+    handle.handleType = H_CONNECT;
+
+    am_connectionID_t connectionID = 20;
+    am_sourceID_t sourceID = 2;
+    am_sinkID_t sinkID = 1;
+    am_ConnectionFormat_e format = CF_GENIVI_ANALOG;
+
     EXPECT_CALL(pReceiveInterface,ackConnect(_,_,E_OK)).Times(10);
-    for (int i = 0; i < 10; i++)
+    EXPECT_CALL(pReceiveInterface,ackConnect(_,_,E_ABORTED)).Times(1);
+    for (int i = 0; i < 11; i++)
     {
         handle.handle++;
         connectionID++;
         ASSERT_EQ(E_OK, pRouter->asyncConnect(handle,connectionID,sourceID,sinkID,format));
     }
-    ASSERT_EQ(E_NOT_POSSIBLE, pRouter->asyncConnect(handle,connectionID,sourceID,sinkID,format));
-    pSocketHandler.start_listenting();
+    ASSERT_EQ(E_OK, pRouter->asyncAbort(handle));
+    for (int i = 0; i < 2; i++)
+        pSocketHandler.start_listenting();
 }
 
 int main(int argc, char **argv)
@@ -23,6 +23,7 @@
 #include <dbus/dbus.h>
 #include <map>
 #include "CAmDbusMessageHandler.h"
+#include "shared/CAmDbusDispatchTable.h"
 
 namespace am {
 
@@ -90,7 +91,7 @@ private:
     CAmDbusWrapper* mDBusWrapper;
     CAmRoutingSenderDbus* mpRoutingSenderDbus;
 
-    typedef std::map<std::string, CallBackMethod> functionMap_t;
+    typedef CAmDbusDispatchTable<CallBackMethod> functionMap_t;
     functionMap_t mFunctionMap;
     CAmRoutingDbusMessageHandler mDBUSMessageHandler;
     int16_t mNumberDomains;
@@ -627,14 +627,11 @@ DBusHandlerResult IAmRoutingReceiverShadowDbus::receiveCallbackDelegate(DBusConn
         sendIntrospection(conn, msg);
         return (DBUS_HANDLER_RESULT_HANDLED);
     }
-    functionMap_t::iterator iter = mFunctionMap.begin();
-    std::string k(dbus_message_get_member(msg));
-    log(&routingDbus, DLT_LOG_INFO, k.c_str());
-    iter = mFunctionMap.find(k);
-    if (iter != mFunctionMap.end())
+    const char* member(dbus_message_get_member(msg));
+    log(&routingDbus, DLT_LOG_INFO, member ? member : "");
+    CallBackMethod cb;
+    if (mFunctionMap.find(member, cb))
     {
-        std::string p(iter->first);
-        CallBackMethod cb = iter->second;
         (this->*cb)(conn, msg);
         return (DBUS_HANDLER_RESULT_HANDLED);
     }
@@ -699,42 +696,43 @@ void IAmRoutingReceiverShadowDbus::gotRundown(int16_t numberDomains, uint16_t ha
 IAmRoutingReceiverShadowDbus::functionMap_t IAmRoutingReceiverShadowDbus::createMap()
 {
     functionMap_t m;
-    m["ackConnect"] = &IAmRoutingReceiverShadowDbus::ackConnect;
-    m["ackDisconnect"] = &IAmRoutingReceiverShadowDbus::ackDisconnect;
-    m["ackSetSinkVolume"] = &IAmRoutingReceiverShadowDbus::ackSetSinkVolume;
-    m["ackSetSourceVolume"] = &IAmRoutingReceiverShadowDbus::ackSetSourceVolume;
-    m["ackSetSourceState"] = &IAmRoutingReceiverShadowDbus::ackSetSourceState;
-    m["ackSinkVolumeTick"] = &IAmRoutingReceiverShadowDbus::ackSinkVolumeTick;
-    m["ackSourceVolumeTick"] = &IAmRoutingReceiverShadowDbus::ackSourceVolumeTick;
-    m["ackSetSinkSoundProperty"] = &IAmRoutingReceiverShadowDbus::ackSetSinkSoundProperty;
-    m["ackSetSourceSoundProperty"] = &IAmRoutingReceiverShadowDbus::ackSetSourceSoundProperty;
-    m["ackSetSinkSoundProperties"] = &IAmRoutingReceiverShadowDbus::ackSetSinkSoundProperties;
-    m["ackSetSourceSoundProperties"] = &IAmRoutingReceiverShadowDbus::ackSetSourceSoundProperties;
-    m["ackCrossFading"] = &IAmRoutingReceiverShadowDbus::ackCrossFading;
-    m["registerDomain"] = &IAmRoutingReceiverShadowDbus::registerDomain;
-    m["registerSource"] = &IAmRoutingReceiverShadowDbus::registerSource;
-    m["registerSink"] = &IAmRoutingReceiverShadowDbus::registerSink;
-    m["registerGateway"] = &IAmRoutingReceiverShadowDbus::registerGateway;
-    m["peekDomain"] = &IAmRoutingReceiverShadowDbus::peekDomain;
-    m["deregisterDomain"] = &IAmRoutingReceiverShadowDbus::deregisterDomain;
-    m["deregisterGateway"] = &IAmRoutingReceiverShadowDbus::deregisterGateway;
-    m["peekSink"] = &IAmRoutingReceiverShadowDbus::peekSink;
-    m["deregisterSink"] = &IAmRoutingReceiverShadowDbus::deregisterSink;
-    m["peekSource"] = &IAmRoutingReceiverShadowDbus::peekSource;
-    m["deregisterSource"] = &IAmRoutingReceiverShadowDbus::deregisterSource;
-    m["registerCrossfader"] = &IAmRoutingReceiverShadowDbus::registerCrossfader;
-    m["deregisterCrossfader"] = &IAmRoutingReceiverShadowDbus::deregisterCrossfader;
-    m["peekSourceClassID"] = &IAmRoutingReceiverShadowDbus::peekSourceClassID;
-    m["peekSinkClassID"] = &IAmRoutingReceiverShadowDbus::peekSinkClassID;
-    m["hookInterruptStatusChange"] = &IAmRoutingReceiverShadowDbus::hookInterruptStatusChange;
-    m["hookDomainRegistrationComplete"] = &IAmRoutingReceiverShadowDbus::hookDomainRegistrationComplete;
-    m["hookSinkAvailablityStatusChange"] = &IAmRoutingReceiverShadowDbus::hookSinkAvailablityStatusChange;
-    m["hookSourceAvailablityStatusChange"] = &IAmRoutingReceiverShadowDbus::hookSourceAvailablityStatusChange;
-    m["hookDomainStateChange"] = &IAmRoutingReceiverShadowDbus::hookDomainStateChange;
-    m["hookTimingInformationChanged"] = &IAmRoutingReceiverShadowDbus::hookTimingInformationChanged;
-    m["sendChangedData"] = &IAmRoutingReceiverShadowDbus::sendChangedData;
-    m["confirmRoutingReady"] =  &IAmRoutingReceiverShadowDbus::confirmRoutingReady;
-    m["confirmRoutingRundown"] =  &IAmRoutingReceiverShadowDbus::confirmRoutingRundown;
+    m.add("ackConnect", &IAmRoutingReceiverShadowDbus::ackConnect);
+    m.add("ackDisconnect", &IAmRoutingReceiverShadowDbus::ackDisconnect);
+    m.add("ackSetSinkVolume", &IAmRoutingReceiverShadowDbus::ackSetSinkVolume);
+    m.add("ackSetSourceVolume", &IAmRoutingReceiverShadowDbus::ackSetSourceVolume);
+    m.add("ackSetSourceState", &IAmRoutingReceiverShadowDbus::ackSetSourceState);
+    m.add("ackSinkVolumeTick", &IAmRoutingReceiverShadowDbus::ackSinkVolumeTick);
+    m.add("ackSourceVolumeTick", &IAmRoutingReceiverShadowDbus::ackSourceVolumeTick);
+    m.add("ackSetSinkSoundProperty", &IAmRoutingReceiverShadowDbus::ackSetSinkSoundProperty);
+    m.add("ackSetSourceSoundProperty", &IAmRoutingReceiverShadowDbus::ackSetSourceSoundProperty);
+    m.add("ackSetSinkSoundProperties", &IAmRoutingReceiverShadowDbus::ackSetSinkSoundProperties);
+    m.add("ackSetSourceSoundProperties", &IAmRoutingReceiverShadowDbus::ackSetSourceSoundProperties);
+    m.add("ackCrossFading", &IAmRoutingReceiverShadowDbus::ackCrossFading);
+    m.add("registerDomain", &IAmRoutingReceiverShadowDbus::registerDomain);
+    m.add("registerSource", &IAmRoutingReceiverShadowDbus::registerSource);
+    m.add("registerSink", &IAmRoutingReceiverShadowDbus::registerSink);
+    m.add("registerGateway", &IAmRoutingReceiverShadowDbus::registerGateway);
+    m.add("peekDomain", &IAmRoutingReceiverShadowDbus::peekDomain);
+    m.add("deregisterDomain", &IAmRoutingReceiverShadowDbus::deregisterDomain);
+    m.add("deregisterGateway", &IAmRoutingReceiverShadowDbus::deregisterGateway);
+    m.add("peekSink", &IAmRoutingReceiverShadowDbus::peekSink);
+    m.add("deregisterSink", &IAmRoutingReceiverShadowDbus::deregisterSink);
+    m.add("peekSource", &IAmRoutingReceiverShadowDbus::peekSource);
+    m.add("deregisterSource", &IAmRoutingReceiverShadowDbus::deregisterSource);
+    m.add("registerCrossfader", &IAmRoutingReceiverShadowDbus::registerCrossfader);
+    m.add("deregisterCrossfader", &IAmRoutingReceiverShadowDbus::deregisterCrossfader);
+    m.add("peekSourceClassID", &IAmRoutingReceiverShadowDbus::peekSourceClassID);
+    m.add("peekSinkClassID", &IAmRoutingReceiverShadowDbus::peekSinkClassID);
+    m.add("hookInterruptStatusChange", &IAmRoutingReceiverShadowDbus::hookInterruptStatusChange);
+    m.add("hookDomainRegistrationComplete", &IAmRoutingReceiverShadowDbus::hookDomainRegistrationComplete);
+    m.add("hookSinkAvailablityStatusChange", &IAmRoutingReceiverShadowDbus::hookSinkAvailablityStatusChange);
+    m.add("hookSourceAvailablityStatusChange", &IAmRoutingReceiverShadowDbus::hookSourceAvailablityStatusChange);
+    m.add("hookDomainStateChange", &IAmRoutingReceiverShadowDbus::hookDomainStateChange);
+    m.add("hookTimingInformationChanged", &IAmRoutingReceiverShadowDbus::hookTimingInformationChanged);
+    m.add("sendChangedData", &IAmRoutingReceiverShadowDbus::sendChangedData);
+    m.add("confirmRoutingReady", &IAmRoutingReceiverShadowDbus::confirmRoutingReady);
+    m.add("confirmRoutingRundown", &IAmRoutingReceiverShadowDbus::confirmRoutingRundown);
+    m.build();
     return (m);
 }
 }
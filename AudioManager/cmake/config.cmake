@@ -16,6 +16,7 @@
 
 #cmakedefine DEFAULT_TELNETPORT @DEFAULT_TELNETPORT@
 #cmakedefine MAX_TELNETCONNECTIONS @MAX_TELNETCONNECTIONS@
+#cmakedefine MAX_LOGLEVEL @MAX_LOGLEVEL@
 
 #cmakedefine DBUS_SERVICE_PREFIX "@DBUS_SERVICE_PREFIX@"
 #cmakedefine DBUS_SERVICE_OBJECT_PATH "@DBUS_SERVICE_OBJECT_PATH@"
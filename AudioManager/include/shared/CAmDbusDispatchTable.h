@@ -0,0 +1,164 @@
+/**
+ *  Copyright (C) 2012, BMW AG
+ *
+ *  \author Christian Mueller, christian.ei.mueller@bmw.de BMW 2011,2012
+ *
+ *  \copyright
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction,
+ *  including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ *  THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  \file CAmDbusDispatchTable.h
+ *  For further information see http://www.genivi.org/.
+ */
+
+#ifndef CAMDBUSDISPATCHTABLE_H_
+#define CAMDBUSDISPATCHTABLE_H_
+
+#include <vector>
+#include <cassert>
+#include <cstring>
+#include <stdint.h>
+
+/**
+ * highest seed that is tried for one table size before the table is doubled
+ */
+#define DISPATCH_TABLE_MAX_SEED 64
+
+namespace am
+{
+
+/**
+ * Maps the DBus member names of an interface to the methods that handle them.
+ * The names are added once with add(), then build() searches a table size and a hash seed so that every name gets a
+ * slot of its own. A lookup hashes the member name that DBus delivers, reads exactly one slot and confirms it with a
+ * single string compare, no std::string needs to be created for it.
+ * The member names must be string literals or outlive the table, only the pointers are stored.
+ * \tparam TMethod the type that is stored for each name, usually a pointer to member function
+ */
+template<class TMethod> class CAmDbusDispatchTable
+{
+public:
+    CAmDbusDispatchTable() :
+            mListEntries(), //
+            mListSlots(), //
+            mMask(0), //
+            mSeed(0)
+    {
+    }
+
+    /**
+     * adds a member name, the table needs to be built again afterwards
+     * @param member the name of the DBus member
+     * @param method the method for the member
+     */
+    void add(const char* member, TMethod method)
+    {
+        assert(member!=NULL);
+        typename std::vector<entry_s>::const_iterator iter(mListEntries.begin());
+        for (; iter != mListEntries.end(); ++iter)
+            assert(strcmp(iter->member, member) != 0);
+        entry_s entry;
+        entry.member = member;
+        entry.method = method;
+        mListEntries.push_back(entry);
+        mListSlots.clear();
+    }
+
+    /**
+     * searches a collision free table for the added names
+     */
+    void build()
+    {
+        uint32_t size(4);
+        while (size < mListEntries.size() * 2)
+            size <<= 1;
+
+        for (;; size <<= 1)
+        {
+            for (uint32_t seed = 0; seed < DISPATCH_TABLE_MAX_SEED; seed++)
+            {
+                if (place(size, seed))
+                    return;
+            }
+        }
+    }
+
+    /**
+     * looks up a member name
+     * @param member the member name of the DBus message, may be NULL
+     * @param method is set to the method of the member if it was found
+     * @return true if the member was found
+     */
+    bool find(const char* member, TMethod& method) const
+    {
+        if (member == NULL || mListSlots.empty())
+            return (false);
+        const entry_s& slot = mListSlots[hash(member, mSeed) & mMask];
+        if (slot.member == NULL || strcmp(slot.member, member) != 0)
+            return (false);
+        method = slot.method;
+        return (true);
+    }
+
+    size_t size() const
+    {
+        return (mListEntries.size());
+    }
+
+private:
+    struct entry_s
+    {
+        const char* member; //!< the member name, NULL for empty slots
+        TMethod method; //!< the method of the member
+    };
+
+    /**
+     * FNV-1a, mixed with the seed
+     */
+    static uint32_t hash(const char* member, const uint32_t seed)
+    {
+        uint32_t value(2166136261u ^ (seed * 16777619u));
+        for (; *member != '\0'; ++member)
+        {
+            value ^= static_cast<unsigned char>(*member);
+            value *= 16777619u;
+        }
+        return (value ^ (value >> 15));
+    }
+
+    bool place(const uint32_t size, const uint32_t seed)
+    {
+        entry_s empty;
+        empty.member = NULL;
+        empty.method = TMethod();
+        mListSlots.assign(size, empty);
+        typename std::vector<entry_s>::const_iterator iter(mListEntries.begin());
+        for (; iter != mListEntries.end(); ++iter)
+        {
+            entry_s& slot = mListSlots[hash(iter->member, seed) & (size - 1)];
+            if (slot.member != NULL)
+            {
+                mListSlots.clear();
+                return (false);
+            }
+            slot = *iter;
+        }
+        mMask = size - 1;
+        mSeed = seed;
+        return (true);
+    }
+
+    std::vector<entry_s> mListEntries; //!< the added names in the order of add()
+    std::vector<entry_s> mListSlots; //!< the slots of the built table
+    uint32_t mMask; //!< table size - 1
+    uint32_t mSeed; //!< the seed that places all names without collision
+};
+
+}
+
+#endif /* CAMDBUSDISPATCHTABLE_H_ */
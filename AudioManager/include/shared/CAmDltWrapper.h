@@ -23,6 +23,14 @@
 #include <string>
 #include <pthread.h>
 
+/**
+ * the highest loglevel that is compiled in, log calls with a higher level are removed by the compiler.
+ * Can be changed via passing -DMAX_LOGLEVEL=X to cmake, 3 for example keeps DLT_LOG_WARN and everything more severe.
+ */
+#ifndef MAX_LOGLEVEL
+#define MAX_LOGLEVEL 6
+#endif
+
 #ifdef WITH_DLT
 #include <dlt/dlt.h>
 namespace am
@@ -84,6 +92,7 @@ namespace am
  * Wraps around the dlt. This class is instantiated as a singleton and offers a default
  * context (maincontext) that is registered to log to.
  * Logging under the default context can simply be done with the logInfo/logError templates with up to 10 values at a time.
+ * The values are only appended if the loglevel is compiled in (MAX_LOGLEVEL) and enabled at runtime.
  * For logging with a different context, you can use the log template. First register a context with registerContext.
  */
 class CAmDltWrapper
@@ -94,7 +103,7 @@ public:
     void registerContext(DltContext& handle, const char *contextid, const char * description);
     void unregisterContext(DltContext& handle);
 
-    void init(DltLogLevelType loglevel, DltContext* context = NULL);
+    bool init(DltLogLevelType loglevel, DltContext* context = NULL);
     void deinit();
     void send();
     void append(const int8_t value);
@@ -134,14 +143,33 @@ inline CAmDltWrapper* getWrapper()
     return (CAmDltWrapper::instance());
 }
 
+/**
+ * starts a log message if the loglevel is compiled in and enabled.
+ * The first check is against the constant MAX_LOGLEVEL, so the compiler removes the whole log call for levels that are
+ * not compiled in. Only if the message is started the arguments are appended.
+ * @param loglevel the loglevel of the message
+ * @param context the context, NULL for the default context
+ * @return the wrapper to append to, NULL if the message is filtered
+ */
+inline CAmDltWrapper* startLog(const DltLogLevelType loglevel, DltContext* const context = NULL)
+{
+    if (loglevel > MAX_LOGLEVEL)
+        return (NULL);
+    CAmDltWrapper* inst(getWrapper());
+    if (!inst->init(loglevel, context))
+        return (NULL);
+    return (inst);
+}
+
 /**
  * logs a given value with infolevel with the default context
  * @param value
  */
 template<typename T> void logInfo(T value)
 {
-    CAmDltWrapper* inst(getWrapper());
-    inst->init(DLT_LOG_INFO);
+    CAmDltWrapper* inst(startLog(DLT_LOG_INFO));
+    if (!inst)
+        return;
     inst->append(value);
     inst->send();
 }
@@ -153,9 +181,9 @@ template<typename T> void logInfo(T value)
  */
 template<typename T, typename T1> void logInfo(T value, T1 value1)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_INFO);
+    CAmDltWrapper* inst(startLog(DLT_LOG_INFO));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->send();
@@ -170,9 +198,9 @@ template<typename T, typename T1> void logInfo(T value, T1 value1)
  */
 template<typename T, typename T1, typename T2> void logInfo(T value, T1 value1, T2 value2)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_INFO);
+    CAmDltWrapper* inst(startLog(DLT_LOG_INFO));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -189,9 +217,9 @@ template<typename T, typename T1, typename T2> void logInfo(T value, T1 value1,
  */
 template<typename T, typename T1, typename T2, typename T3> void logInfo(T value, T1 value1, T2 value2, T3 value3)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_INFO);
+    CAmDltWrapper* inst(startLog(DLT_LOG_INFO));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -210,9 +238,9 @@ template<typename T, typename T1, typename T2, typename T3> void logInfo(T value
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4> void logInfo(T value, T1 value1, T2 value2, T3 value3, T4 value4)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_INFO);
+    CAmDltWrapper* inst(startLog(DLT_LOG_INFO));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -233,9 +261,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4> void lo
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5> void logInfo(T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_INFO);
+    CAmDltWrapper* inst(startLog(DLT_LOG_INFO));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -258,9 +286,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4, typenam
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6> void logInfo(T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5, T6 value6)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_INFO);
+    CAmDltWrapper* inst(startLog(DLT_LOG_INFO));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -285,9 +313,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4, typenam
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7> void logInfo(T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5, T6 value6, T7 value7)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_INFO);
+    CAmDltWrapper* inst(startLog(DLT_LOG_INFO));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -314,9 +342,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4, typenam
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8> void logInfo(T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5, T6 value6, T7 value7, T8 value8)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_INFO);
+    CAmDltWrapper* inst(startLog(DLT_LOG_INFO));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -345,9 +373,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4, typenam
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9> void logInfo(T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5, T6 value6, T7 value7, T8 value8, T9 value9)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_INFO);
+    CAmDltWrapper* inst(startLog(DLT_LOG_INFO));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -378,9 +406,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4, typenam
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9, typename T10> void logInfo(T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5, T6 value6, T7 value7, T8 value8, T9 value9, T10 value10)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_INFO);
+    CAmDltWrapper* inst(startLog(DLT_LOG_INFO));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -402,9 +430,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4, typenam
  */
 template<typename T> void logError(T value)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_ERROR);
+    CAmDltWrapper* inst(startLog(DLT_LOG_ERROR));
+    if (!inst)
+        return;
     inst->append(value);
     inst->send();
 
@@ -417,9 +445,9 @@ template<typename T> void logError(T value)
  */
 template<typename T, typename T1> void logError(T value, T1 value1)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_ERROR);
+    CAmDltWrapper* inst(startLog(DLT_LOG_ERROR));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->send();
@@ -434,9 +462,9 @@ template<typename T, typename T1> void logError(T value, T1 value1)
  */
 template<typename T, typename T1, typename T2> void logError(T value, T1 value1, T2 value2)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_ERROR);
+    CAmDltWrapper* inst(startLog(DLT_LOG_ERROR));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -453,9 +481,9 @@ template<typename T, typename T1, typename T2> void logError(T value, T1 value1,
  */
 template<typename T, typename T1, typename T2, typename T3> void logError(T value, T1 value1, T2 value2, T3 value3)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_ERROR);
+    CAmDltWrapper* inst(startLog(DLT_LOG_ERROR));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -474,9 +502,9 @@ template<typename T, typename T1, typename T2, typename T3> void logError(T valu
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4> void logError(T value, T1 value1, T2 value2, T3 value3, T4 value4)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_ERROR);
+    CAmDltWrapper* inst(startLog(DLT_LOG_ERROR));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -497,9 +525,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4> void lo
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5> void logError(T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_ERROR);
+    CAmDltWrapper* inst(startLog(DLT_LOG_ERROR));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -522,9 +550,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4, typenam
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6> void logError(T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5, T6 value6)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_ERROR);
+    CAmDltWrapper* inst(startLog(DLT_LOG_ERROR));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -549,9 +577,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4, typenam
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7> void logError(T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5, T6 value6, T7 value7)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_ERROR);
+    CAmDltWrapper* inst(startLog(DLT_LOG_ERROR));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -578,9 +606,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4, typenam
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8> void logError(T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5, T6 value6, T7 value7, T8 value8)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_ERROR);
+    CAmDltWrapper* inst(startLog(DLT_LOG_ERROR));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -609,9 +637,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4, typenam
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9> void logError(T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5, T6 value6, T7 value7, T8 value8, T9 value9)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_ERROR);
+    CAmDltWrapper* inst(startLog(DLT_LOG_ERROR));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -642,9 +670,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4, typenam
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9, typename T10> void logError(T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5, T6 value6, T7 value7, T8 value8, T9 value9, T10 value10)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(DLT_LOG_ERROR);
+    CAmDltWrapper* inst(startLog(DLT_LOG_ERROR));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -668,9 +696,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4, typenam
  */
 template<typename T> void log(DltContext* const context, DltLogLevelType loglevel, T value)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(loglevel, context);
+    CAmDltWrapper* inst(startLog(loglevel, context));
+    if (!inst)
+        return;
     inst->append(value);
     inst->send();
 
@@ -685,9 +713,9 @@ template<typename T> void log(DltContext* const context, DltLogLevelType logleve
  */
 template<typename T, typename T1> void log(DltContext* const context, DltLogLevelType loglevel, T value, T1 value1)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(loglevel, context);
+    CAmDltWrapper* inst(startLog(loglevel, context));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->send();
@@ -704,9 +732,9 @@ template<typename T, typename T1> void log(DltContext* const context, DltLogLeve
  */
 template<typename T, typename T1, typename T2> void log(DltContext* const context, DltLogLevelType loglevel, T value, T1 value1, T2 value2)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(loglevel, context);
+    CAmDltWrapper* inst(startLog(loglevel, context));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -725,9 +753,9 @@ template<typename T, typename T1, typename T2> void log(DltContext* const contex
  */
 template<typename T, typename T1, typename T2, typename T3> void log(DltContext* const context, DltLogLevelType loglevel, T value, T1 value1, T2 value2, T3 value3)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(loglevel, context);
+    CAmDltWrapper* inst(startLog(loglevel, context));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -748,9 +776,9 @@ template<typename T, typename T1, typename T2, typename T3> void log(DltContext*
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4> void log(DltContext* const context, DltLogLevelType loglevel, T value, T1 value1, T2 value2, T3 value3, T4 value4)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(loglevel, context);
+    CAmDltWrapper* inst(startLog(loglevel, context));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -773,9 +801,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4> void lo
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5> void log(DltContext* const context, DltLogLevelType loglevel, T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(loglevel, context);
+    CAmDltWrapper* inst(startLog(loglevel, context));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -800,9 +828,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4, typenam
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6> void log(DltContext* const context, DltLogLevelType loglevel, T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5, T6 value6)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(loglevel, context);
+    CAmDltWrapper* inst(startLog(loglevel, context));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -829,9 +857,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4, typenam
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7> void log(DltContext* const context, DltLogLevelType loglevel, T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5, T6 value6, T7 value7)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(loglevel, context);
+    CAmDltWrapper* inst(startLog(loglevel, context));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -860,9 +888,9 @@ template<typename T, typename T1, typename T2, typename T3, typename T4, typenam
  */
 template<typename T, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8> void log(DltContext* const context, DltLogLevelType loglevel, T value, T1 value1, T2 value2, T3 value3, T4 value4, T5 value5, T6 value6, T7 value7, T8 value8)
 {
-    CAmDltWrapper* inst(getWrapper());
-
-    inst->init(loglevel, context);
+    CAmDltWrapper* inst(startLog(loglevel, context));
+    if (!inst)
+        return;
     inst->append(value);
     inst->append(value1);
     inst->append(value2);
@@ -20,18 +20,28 @@
 #define CAMSERIALIZER_H_
 
 #include <pthread.h>
-#include <deque>
+#include <vector>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
 #include <memory>
+#include <new>
 #include <stdexcept>
+#include <stdint.h>
 #include <unistd.h>
+#include <sys/eventfd.h>
 #include "CAmDltWrapper.h"
 #include "CAmSocketHandler.h"
 
 /**
- * todo: performance improvement we could implement a memory pool that is more efficient here and avoids
- * allocation and deallocation times.
+ * size of the blocks the delegates are allocated from, bigger delegates come from the heap
  */
+#define SERIALIZER_POOL_BLOCK_SIZE 256
+
+/**
+ * number of blocks the delegate pool grows by
+ */
+#define SERIALIZER_POOL_CHUNK_BLOCKS 32
 
 namespace am
 {
@@ -41,8 +51,10 @@ namespace am
  * overloaded template function call will serialize all calls and call them within the
  * main thread context.\n
  * More details can be found here: \ref util
- * \warning asynchronous calls may be used in the mainthread context, but if you want to use synchronous calls make sure that you use one
- * instance of this class per thread otherwise you could be lost in never returning calls.\n
+ * The calls are pushed lock-free on a queue and an eventfd wakes up the mainloop, which takes the whole queue at once.
+ * The delegates are allocated from a pool of the serializer. A synchronous call waits on a condition variable until the
+ * mainloop has executed it, so several threads can share one instance.
+ * \warning asynchronous calls may be used in the mainthread context, synchronous calls from the mainthread never return.\n
  * Examples of the usage can be found in IAmCommandReceiverShadow of the ControlPlugin or IAmRoutingReceiverShadow of the
  * PluginRoutingInterfaceAsync.
  *
@@ -52,833 +64,598 @@ class CAmSerializer
 private:
 
     /**
-     * Prototype for a delegate
+     * pool of fixed size blocks for the delegates. The producers allocate from any thread, so the free list is
+     * protected by a mutex, which is uncontended most of the time.
      */
-    class CAmDelegate
+    class CAmDelegatePool
     {
-    public:
-        virtual ~CAmDelegate()
-        {};
-        virtual bool call(int* pipe)=0;
-
-    };
+    private:
+        struct poolBlock_s //!< header in front of each allocated block
+        {
+            poolBlock_s* next; //!< the next free block, only used while the block is free
+            CAmDelegatePool* pool; //!< the pool the block belongs to, NULL if it was allocated from the heap
+        };
 
-    typedef CAmDelegate* CAmDelegagePtr; //!< pointer to a delegate
+        pthread_mutex_t mMutex; //!< protects the free list
+        poolBlock_s* mFreeBlocks; //!< list of free blocks
+        std::vector<void*> mListChunks; //!< the memory of the blocks
 
-    /**
-     * delegate template for no argument
-     */
-    template<class TClass> class CAmNoArgDelegate: public CAmDelegate
-    {
-    private:
-        TClass* mInstance;
-        void (TClass::*mFunction)();
+        void grow()
+        {
+            const size_t blockSize = sizeof(poolBlock_s) + SERIALIZER_POOL_BLOCK_SIZE;
+            char* chunk = static_cast<char*>(::operator new(blockSize * SERIALIZER_POOL_CHUNK_BLOCKS));
+            mListChunks.push_back(chunk);
+            for (size_t i = 0; i < SERIALIZER_POOL_CHUNK_BLOCKS; i++)
+            {
+                poolBlock_s* block = reinterpret_cast<poolBlock_s*>(chunk + i * blockSize);
+                block->next = mFreeBlocks;
+                mFreeBlocks = block;
+            }
+        }
 
     public:
-        CAmNoArgDelegate(TClass* instance, void (TClass::*function)()) :
-                mInstance(instance), //
-                mFunction(function)
-        {};
+        CAmDelegatePool() :
+                mFreeBlocks(NULL), //
+                mListChunks()
+        {
+            pthread_mutex_init(&mMutex, NULL);
+        }
 
-        bool call(int* pipe)
+        ~CAmDelegatePool()
         {
-            (void) pipe;
-            (*mInstance.*mFunction)();
-            return (true);
-        };
+            std::vector<void*>::iterator it(mListChunks.begin());
+            for (; it != mListChunks.end(); ++it)
+                ::operator delete(*it);
+            pthread_mutex_destroy(&mMutex);
+        }
+
+        void* allocate(size_t size)
+        {
+            poolBlock_s* block;
+            if (size > SERIALIZER_POOL_BLOCK_SIZE)
+            {
+                block = static_cast<poolBlock_s*>(::operator new(sizeof(poolBlock_s) + size));
+                block->pool = NULL;
+                return (block + 1);
+            }
+
+            pthread_mutex_lock(&mMutex);
+            if (mFreeBlocks == NULL)
+                grow();
+            block = mFreeBlocks;
+            mFreeBlocks = block->next;
+            pthread_mutex_unlock(&mMutex);
+
+            block->pool = this;
+            return (block + 1);
+        }
+
+        static void release(void* memory)
+        {
+            if (memory == NULL)
+                return;
+            poolBlock_s* block = static_cast<poolBlock_s*>(memory) - 1;
+            CAmDelegatePool* pool = block->pool;
+            if (pool == NULL)
+            {
+                ::operator delete(block);
+                return;
+            }
+
+            pthread_mutex_lock(&pool->mMutex);
+            block->next = pool->mFreeBlocks;
+            pool->mFreeBlocks = block;
+            pthread_mutex_unlock(&pool->mMutex);
+        }
     };
 
     /**
-     * delegate template for one argument
+     * Prototype for a delegate
      */
-    template<class TClass, typename Targ> class CAmOneArgDelegate: public CAmDelegate
+    class CAmDelegate
     {
-    private:
-        TClass* mInstance;
-        void (TClass::*mFunction)(Targ);
-        Targ mArgument;
-
     public:
-        CAmOneArgDelegate(TClass* instance, void (TClass::*function)(Targ), Targ argument) :
-                mInstance(instance), //
-                mFunction(function), //
-                mArgument(argument)
+        CAmDelegate* mNext; //!< the next delegate on the queue
+
+        CAmDelegate() :
+                mNext(NULL)
+        {};
+        virtual ~CAmDelegate()
         {};
 
-        bool call(int* pipe)
-        {
-            (void) pipe;
-            (*mInstance.*mFunction)(mArgument);
-            return (true);
-        };
-    };
+        /**
+         * executes the call
+         * @return true if the delegate can be deleted, false if the caller of a synchronous call is waiting for it
+         */
+        virtual bool call()=0;
 
-    /**
-     * delegate template for two arguments
-     */
-    template<class TClass, typename Targ, typename Targ1> class CAmTwoArgDelegate: public CAmDelegate
-    {
-    private:
-        TClass* mInstance;
-        void (TClass::*mFunction)(Targ argument, Targ1 argument1);
-        Targ mArgument;
-        Targ1 mArgument1;
+        static void* operator new(size_t size, CAmDelegatePool& pool)
+        {
+            return (pool.allocate(size));
+        }
 
-    public:
-        CAmTwoArgDelegate(TClass* instance, void (TClass::*function)(Targ argument, Targ1 argument1), Targ argument, Targ1 argument1) :
-                mInstance(instance), //
-                mFunction(function), //
-                mArgument(argument), //
-                mArgument1(argument1)
-        { };
+        static void operator delete(void* memory, CAmDelegatePool& pool)
+        {
+            (void) pool;
+            CAmDelegatePool::release(memory);
+        }
 
-        bool call(int* pipe)
+        static void operator delete(void* memory)
         {
-            (void) pipe;
-            (*mInstance.*mFunction)(mArgument, mArgument1);
-            return (true);
-        };
+            CAmDelegatePool::release(memory);
+        }
     };
 
     /**
-     * delegate template for two arguments
+     * Prototype for a delegate of a synchronous call
      */
-    template<class TClass, typename Targ, typename Targ1> class CAmTwoArgDelegateFirstRef: public CAmDelegate
+    class CAmSyncDelegate: public CAmDelegate
     {
-    private:
-        TClass* mInstance;
-        void (TClass::*mFunction)(Targ& argument, Targ1 argument1);
-        Targ mArgument;
-        Targ1 mArgument1;
-
     public:
-        CAmTwoArgDelegateFirstRef(TClass* instance, void (TClass::*function)(Targ& argument, Targ1 argument1), Targ& argument, Targ1 argument1) :
-                mInstance(instance), //
-                mFunction(function), //
-                mArgument(argument), //
-                mArgument1(argument1)
-        { };
+        bool mFinished; //!< set by the mainloop when the call was executed, protected by mReturnMutex
 
-        bool call(int* pipe)
-        {
-            (void) pipe;
-            (*mInstance.*mFunction)(mArgument, mArgument1);
-            return (true);
-        };
+        CAmSyncDelegate() :
+                mFinished(false)
+        {};
     };
 
+    typedef CAmDelegate* CAmDelegagePtr; //!< pointer to a delegate
 
-    template<class TClass, typename Targ, typename Targ1> class CAmTwoArgDelegateSecondRef: public CAmDelegate
+    /**
+     * describes how an argument of the type T is stored in a delegate and how it gets there.
+     * Arguments that asyncCall got by value are copies of its own, they are swapped into the delegate instead of being
+     * copied again, which makes handing over containers like std::vector<am_SoundProperty_s> cheap.
+     */
+    template<class T> struct CAmArgument
     {
-    private:
-        TClass* mInstance;
-        void (TClass::*mFunction)(Targ argument, Targ1& argument1);
-        Targ mArgument;
-        Targ1 mArgument1;
+        typedef T type; //!< the type of the stored argument
+        typedef T& param; //!< the type the argument is handed over with
 
-    public:
-        CAmTwoArgDelegateSecondRef(TClass* instance, void (TClass::*function)(Targ argument, Targ1& argument1), Targ argument, Targ1& argument1) :
-                mInstance(instance), //
-                mFunction(function), //
-                mArgument(argument), //
-                mArgument1(argument1)
-        {};
-
-        bool call(int* pipe)
+        static void take(type& storage, param argument)
         {
-            (void) pipe;
-            (*mInstance.*mFunction)(mArgument, mArgument1);
-            return (true);
-        };
+            std::swap(storage, argument);
+        }
     };
 
     /**
-     * delegate template for two arguments
+     * const arguments are copied
      */
-    template<class TClass, typename Targ, typename Targ1> class CAmTwoArgDelegateAllRef: public CAmDelegate
+    template<class T> struct CAmArgument<const T>
     {
-    private:
-        TClass* mInstance;
-        void (TClass::*mFunction)(Targ& argument, Targ1& argument1);
-        Targ mArgument;
-        Targ1 mArgument1;
+        typedef typename CAmArgument<T>::type type;
+        typedef const T& param;
 
-    public:
-        CAmTwoArgDelegateAllRef(TClass* instance, void (TClass::*function)(Targ& argument, Targ1& argument1), Targ& argument, Targ1& argument1) :
-                mInstance(instance), //
-                mFunction(function), //
-                mArgument(argument), //
-                mArgument1(argument1)
-        { };
-
-        bool call(int* pipe)
+        static void take(type& storage, param argument)
         {
-            (void) pipe;
-            (*mInstance.*mFunction)(mArgument, mArgument1);
-            return (true);
-        };
+            storage = argument;
+        }
     };
 
-
     /**
-     * delegate template for three arguments
+     * arguments given by reference belong to the caller, so they are copied. The delegate keeps its own copy, the called
+     * function gets a reference to it.
      */
-    template<class TClass, typename Targ, typename Targ1, typename Targ2> class CAmThreeArgDelegate: public CAmDelegate
+    template<class T> struct CAmArgument<T&>
     {
-    private:
-        TClass* mInstance;
-        void (TClass::*mFunction)(Targ argument, Targ1 argument1, Targ2 argument2);
-        Targ mArgument;
-        Targ1 mArgument1;
-        Targ2 mArgument2;
-
-    public:
-        CAmThreeArgDelegate(TClass* instance, void (TClass::*function)(Targ argument, Targ1 argument1, Targ2 argument2), Targ argument, Targ1 argument1, Targ2 argument2) :
-                mInstance(instance), //
-                mFunction(function), //
-                mArgument(argument), //
-                mArgument1(argument1), //
-                mArgument2(argument2)
-        {
-        }
-        ;
+        typedef typename CAmArgument<T>::type type;
+        typedef const T& param;
 
-        bool call(int* pipe)
+        static void take(type& storage, param argument)
         {
-            (void) pipe;
-            (*mInstance.*mFunction)(mArgument, mArgument1, mArgument2);
-            return (true);
+            storage = argument;
         }
-        ;
     };
 
     /**
-      * delegate template for three arguments
-      */
-     template<class TClass, typename Targ, typename Targ1, typename Targ2> class CAmThreeArgDelegateFirstRef: public CAmDelegate
-     {
-     private:
-         TClass* mInstance;
-         void (TClass::*mFunction)(Targ& argument, Targ1 argument1, Targ2 argument2);
-         Targ mArgument;
-         Targ1 mArgument1;
-         Targ2 mArgument2;
-
-     public:
-         CAmThreeArgDelegateFirstRef(TClass* instance, void (TClass::*function)(Targ& argument, Targ1 argument1, Targ2 argument2), Targ& argument, Targ1 argument1, Targ2 argument2) :
-                 mInstance(instance), //
-                 mFunction(function), //
-                 mArgument(argument), //
-                 mArgument1(argument1), //
-                 mArgument2(argument2)
-         {};
-
-         bool call(int* pipe)
-         {
-             (void) pipe;
-             (*mInstance.*mFunction)(mArgument, mArgument1, mArgument2);
-             return (true);
-         };
-     };
-
-     /**
-       * delegate template for three arguments
-       */
-      template<class TClass, typename Targ, typename Targ1, typename Targ2> class CAmThreeArgDelegateSecondRef: public CAmDelegate
-      {
-      private:
-          TClass* mInstance;
-          void (TClass::*mFunction)(Targ argument, Targ1& argument1, Targ2 argument2);
-          Targ mArgument;
-          Targ1 mArgument1;
-          Targ2 mArgument2;
-
-      public:
-          CAmThreeArgDelegateSecondRef(TClass* instance, void (TClass::*function)(Targ argument, Targ1& argument1, Targ2 argument2), Targ argument, Targ1& argument1, Targ2 argument2) :
-                  mInstance(instance), //
-                  mFunction(function), //
-                  mArgument(argument), //
-                  mArgument1(argument1), //
-                  mArgument2(argument2)
-          {};
-
-          bool call(int* pipe)
-          {
-              (void) pipe;
-              (*mInstance.*mFunction)(mArgument, mArgument1, mArgument2);
-              return (true);
-          };
-      };
-
-      /**
-        * delegate template for three arguments
-        */
-       template<class TClass, typename Targ, typename Targ1, typename Targ2> class CAmThreeArgDelegateThirdRef: public CAmDelegate
-       {
-       private:
-           TClass* mInstance;
-           void (TClass::*mFunction)(Targ argument, Targ1 argument1, Targ2& argument2);
-           Targ mArgument;
-           Targ1 mArgument1;
-           Targ2 mArgument2;
-
-       public:
-           CAmThreeArgDelegateThirdRef(TClass* instance, void (TClass::*function)(Targ argument, Targ1 argument1, Targ2& argument2), Targ argument, Targ1 argument1, Targ2& argument2) :
-                   mInstance(instance), //
-                   mFunction(function), //
-                   mArgument(argument), //
-                   mArgument1(argument1), //
-                   mArgument2(argument2)
-           {};
-
-           bool call(int* pipe)
-           {
-               (void) pipe;
-               (*mInstance.*mFunction)(mArgument, mArgument1, mArgument2);
-               return (true);
-           };
-       };
-
-       /**
-         * delegate template for three arguments
-         */
-        template<class TClass, typename Targ, typename Targ1, typename Targ2> class CAmThreeArgDelegateFirstSecondRef: public CAmDelegate
-        {
-        private:
-            TClass* mInstance;
-            void (TClass::*mFunction)(Targ& argument, Targ1& argument1, Targ2 argument2);
-            Targ mArgument;
-            Targ1 mArgument1;
-            Targ2 mArgument2;
-
-        public:
-            CAmThreeArgDelegateFirstSecondRef(TClass* instance, void (TClass::*function)(Targ& argument, Targ1& argument1, Targ2 argument2), Targ& argument, Targ1& argument1, Targ2 argument2) :
-                    mInstance(instance), //
-                    mFunction(function), //
-                    mArgument(argument), //
-                    mArgument1(argument1), //
-                    mArgument2(argument2)
-            {};
-
-            bool call(int* pipe)
-            {
-                (void) pipe;
-                (*mInstance.*mFunction)(mArgument, mArgument1, mArgument2);
-                return (true);
-            };
-        };
-
-        /**
-          * delegate template for three arguments
-          */
-         template<class TClass, typename Targ, typename Targ1, typename Targ2> class CAmThreeArgDelegateFirstThirdRef: public CAmDelegate
-         {
-         private:
-             TClass* mInstance;
-             void (TClass::*mFunction)(Targ& argument, Targ1 argument1, Targ2& argument2);
-             Targ mArgument;
-             Targ1 mArgument1;
-             Targ2 mArgument2;
-
-         public:
-             CAmThreeArgDelegateFirstThirdRef(TClass* instance, void (TClass::*function)(Targ& argument, Targ1 argument1, Targ2& argument2), Targ& argument, Targ1 argument1, Targ2& argument2) :
-                     mInstance(instance), //
-                     mFunction(function), //
-                     mArgument(argument), //
-                     mArgument1(argument1), //
-                     mArgument2(argument2)
-             {};
-
-             bool call(int* pipe)
-             {
-                 (void) pipe;
-                 (*mInstance.*mFunction)(mArgument, mArgument1, mArgument2);
-                 return (true);
-             };
-         };
-
-         /**
-           * delegate template for three arguments
-           */
-          template<class TClass, typename Targ, typename Targ1, typename Targ2> class CAmThreeArgDelegateSecondThirdRef: public CAmDelegate
-          {
-          private:
-              TClass* mInstance;
-              void (TClass::*mFunction)(Targ argument, Targ1& argument1, Targ2& argument2);
-              Targ mArgument;
-              Targ1 mArgument1;
-              Targ2 mArgument2;
-
-          public:
-              CAmThreeArgDelegateSecondThirdRef(TClass* instance, void (TClass::*function)(Targ argument, Targ1& argument1, Targ2& argument2), Targ argument, Targ1& argument1, Targ2& argument2) :
-                      mInstance(instance), //
-                      mFunction(function), //
-                      mArgument(argument), //
-                      mArgument1(argument1), //
-                      mArgument2(argument2)
-              {};
-
-              bool call(int* pipe)
-              {
-                  (void) pipe;
-                  (*mInstance.*mFunction)(mArgument, mArgument1, mArgument2);
-                  return (true);
-              };
-          };
-
-          /**
-            * delegate template for three arguments
-            */
-           template<class TClass, typename Targ, typename Targ1, typename Targ2> class CAmThreeArgDelegateAllRef: public CAmDelegate
-           {
-           private:
-               TClass* mInstance;
-               void (TClass::*mFunction)(Targ& argument, Targ1& argument1, Targ2& argument2);
-               Targ mArgument;
-               Targ1 mArgument1;
-               Targ2 mArgument2;
-
-           public:
-               CAmThreeArgDelegateAllRef(TClass* instance, void (TClass::*function)(Targ& argument, Targ1& argument1, Targ2& argument2), Targ& argument, Targ1& argument1, Targ2& argument2) :
-                       mInstance(instance), //
-                       mFunction(function), //
-                       mArgument(argument), //
-                       mArgument1(argument1), //
-                       mArgument2(argument2)
-               {};
-
-               bool call(int* pipe)
-               {
-                   (void) pipe;
-                   (*mInstance.*mFunction)(mArgument, mArgument1, mArgument2);
-                   return (true);
-               };
-           };
-
-    /**
-     * delegate template for four arguments
+     * arguments of a call without arguments
      */
-    template<class TClass, typename Targ, typename Targ1, typename Targ2, typename Targ3> class CAmFourArgDelegate: public CAmDelegate
+    struct CAmArguments0
     {
-    private:
-        TClass* mInstance;
-        void (TClass::*mFunction)(Targ argument, Targ1 argument1, Targ2 argument2, Targ3 argument3);
-        Targ mArgument;
-        Targ1 mArgument1;
-        Targ2 mArgument2;
-        Targ3 mArgument3;
+        void take()
+        {}
 
-    public:
-        CAmFourArgDelegate(TClass* instance, void (TClass::*function)(Targ argument, Targ1 argument1, Targ2 argument2, Targ3 argument3), Targ argument, Targ1 argument1, Targ2 argument2, Targ3 argument3) :
-                mInstance(instance), //
-                mFunction(function), //
-                mArgument(argument), //
-                mArgument1(argument1), //
-                mArgument2(argument2), //
-                mArgument3(argument3)
+        void giveBack()
+        {}
+
+        template<class TClass, class TFunction> void call(TClass* instance, TFunction function)
         {
+            (*instance.*function)();
         }
-        ;
 
-        bool call(int* pipe)
+        template<class TretVal, class TClass, class TFunction> TretVal callReturn(TClass* instance, TFunction function)
         {
-            (void) pipe;
-            (*mInstance.*mFunction)(mArgument, mArgument1, mArgument2, mArgument3);
-            return (true);
+            return ((*instance.*function)());
         }
-        ;
     };
 
     /**
-     * Template for synchronous calls with no argument
+     * argument of a call with one argument
      */
-    template<class TClass, typename TretVal> class CAmSyncNoArgDelegate: public CAmDelegate
+    template<class T0> struct CAmArguments1
     {
-    private:
-        TClass* mInstance;
-        TretVal (TClass::*mFunction)();
-        TretVal mRetval;
+        typename CAmArgument<T0>::type mArgument;
 
-    public:
-        friend class CAmSerializer;
-        CAmSyncNoArgDelegate(TClass* instance, TretVal (TClass::*function)()) :
-                mInstance(instance), //
-                mFunction(function), //
-                mRetval()
+        CAmArguments1() :
+                mArgument()
+        {}
+
+        void take(typename CAmArgument<T0>::param argument)
         {
+            CAmArgument<T0>::take(mArgument, argument);
         }
-        ;
 
-        bool call(int* pipe)
+        void giveBack(typename CAmArgument<T0>::type& argument)
         {
-            mRetval = (*mInstance.*mFunction)();
-            write(pipe[1], this, sizeof(this));
-            return (false);
+            std::swap(argument, mArgument);
         }
-        ;
 
-        TretVal returnResults()
+        template<class TClass, class TFunction> void call(TClass* instance, TFunction function)
         {
-            return (mRetval);
+            (*instance.*function)(mArgument);
+        }
+
+        template<class TretVal, class TClass, class TFunction> TretVal callReturn(TClass* instance, TFunction function)
+        {
+            return ((*instance.*function)(mArgument));
         }
     };
 
     /**
-     * template for synchronous calls with one argument
+     * arguments of a call with 2 arguments
      */
-    template<class TClass, typename TretVal, typename TargCall, typename Targ> class CAmSyncOneArgDelegate: public CAmDelegate
+    template<class T0, class T1> struct CAmArguments2
     {
-    private:
-        TClass* mInstance;
-        TretVal (TClass::*mFunction)(TargCall argument);
-        Targ mArgument;
-        TretVal mRetval;
+        typename CAmArgument<T0>::type mArgument;
+        typename CAmArgument<T1>::type mArgument1;
 
-    public:
-        friend class CAmSerializer;
-        CAmSyncOneArgDelegate(TClass* instance, TretVal (TClass::*function)(TargCall argument), Targ argument) :
-                mInstance(instance), //
-                mFunction(function), //
-                mArgument(argument), //
-                mRetval()
+        CAmArguments2() :
+                mArgument(), //
+                mArgument1()
+        {}
+
+        void take(typename CAmArgument<T0>::param argument, typename CAmArgument<T1>::param argument1)
         {
+            CAmArgument<T0>::take(mArgument, argument);
+            CAmArgument<T1>::take(mArgument1, argument1);
         }
-        ;
 
-        bool call(int* pipe)
+        void giveBack(typename CAmArgument<T0>::type& argument, typename CAmArgument<T1>::type& argument1)
         {
-            mRetval = (*mInstance.*mFunction)(mArgument);
-            write(pipe[1], this, sizeof(this));
-            return (false);
+            std::swap(argument, mArgument);
+            std::swap(argument1, mArgument1);
+        }
+
+        template<class TClass, class TFunction> void call(TClass* instance, TFunction function)
+        {
+            (*instance.*function)(mArgument, mArgument1);
         }
-        ;
 
-        TretVal returnResults(Targ& argument)
+        template<class TretVal, class TClass, class TFunction> TretVal callReturn(TClass* instance, TFunction function)
         {
-            argument = mArgument;
-            return (mRetval);
+            return ((*instance.*function)(mArgument, mArgument1));
         }
     };
 
     /**
-     * template for synchronous calls with one argument on a const function
+     * arguments of a call with 3 arguments
      */
-    template<class TClass, typename TretVal, typename TargCall, typename Targ> class CAmSyncOneArgConstDelegate: public CAmDelegate
+    template<class T0, class T1, class T2> struct CAmArguments3
     {
-    private:
-        TClass* mInstance;
-        TretVal (TClass::*mFunction)(TargCall argument) const;
-        Targ mArgument;
-        TretVal mRetval;
+        typename CAmArgument<T0>::type mArgument;
+        typename CAmArgument<T1>::type mArgument1;
+        typename CAmArgument<T2>::type mArgument2;
 
-    public:
-        friend class CAmSerializer;
-        CAmSyncOneArgConstDelegate(TClass* instance, TretVal (TClass::*function)(TargCall argument) const, Targ argument) :
-                mInstance(instance), //
-                mFunction(function), //
-                mArgument(argument), //
-                mRetval()
+        CAmArguments3() :
+                mArgument(), //
+                mArgument1(), //
+                mArgument2()
+        {}
+
+        void take(typename CAmArgument<T0>::param argument, typename CAmArgument<T1>::param argument1, typename CAmArgument<T2>::param argument2)
         {
+            CAmArgument<T0>::take(mArgument, argument);
+            CAmArgument<T1>::take(mArgument1, argument1);
+            CAmArgument<T2>::take(mArgument2, argument2);
         }
-        ;
 
-        bool call(int* pipe)
+        void giveBack(typename CAmArgument<T0>::type& argument, typename CAmArgument<T1>::type& argument1, typename CAmArgument<T2>::type& argument2)
         {
-            mRetval = (*mInstance.*mFunction)(mArgument);
-            write(pipe[1], this, sizeof(this));
-            return (false);
+            std::swap(argument, mArgument);
+            std::swap(argument1, mArgument1);
+            std::swap(argument2, mArgument2);
         }
-        ;
 
-        TretVal returnResults(Targ& argument)
+        template<class TClass, class TFunction> void call(TClass* instance, TFunction function)
         {
-            argument = mArgument;
-            return (mRetval);
+            (*instance.*function)(mArgument, mArgument1, mArgument2);
+        }
+
+        template<class TretVal, class TClass, class TFunction> TretVal callReturn(TClass* instance, TFunction function)
+        {
+            return ((*instance.*function)(mArgument, mArgument1, mArgument2));
         }
     };
 
     /**
-     * template for synchronous calls with two arguments
+     * arguments of a call with 4 arguments
      */
-    template<class TClass, typename TretVal, typename TargCall, typename TargCall1, typename Targ, typename Targ1> class CAmSyncTwoArgDelegate: public CAmDelegate
+    template<class T0, class T1, class T2, class T3> struct CAmArguments4
     {
-    private:
-        TClass* mInstance;
-        TretVal (TClass::*mFunction)(TargCall, TargCall1);
-        Targ mArgument;
-        Targ1 mArgument1;
-        TretVal mRetval;
+        typename CAmArgument<T0>::type mArgument;
+        typename CAmArgument<T1>::type mArgument1;
+        typename CAmArgument<T2>::type mArgument2;
+        typename CAmArgument<T3>::type mArgument3;
+
+        CAmArguments4() :
+                mArgument(), //
+                mArgument1(), //
+                mArgument2(), //
+                mArgument3()
+        {}
+
+        void take(typename CAmArgument<T0>::param argument, typename CAmArgument<T1>::param argument1, typename CAmArgument<T2>::param argument2, typename CAmArgument<T3>::param argument3)
+        {
+            CAmArgument<T0>::take(mArgument, argument);
+            CAmArgument<T1>::take(mArgument1, argument1);
+            CAmArgument<T2>::take(mArgument2, argument2);
+            CAmArgument<T3>::take(mArgument3, argument3);
+        }
 
-    public:
-        friend class CAmSerializer;
-        CAmSyncTwoArgDelegate(TClass* instance, TretVal (TClass::*function)(TargCall, TargCall1), Targ& argument, Targ1& argument1) :
-                mInstance(instance), //
-                mFunction(function), //
-                mArgument(argument), //
-                mArgument1(argument1), //
-                mRetval()
+        void giveBack(typename CAmArgument<T0>::type& argument, typename CAmArgument<T1>::type& argument1, typename CAmArgument<T2>::type& argument2, typename CAmArgument<T3>::type& argument3)
         {
+            std::swap(argument, mArgument);
+            std::swap(argument1, mArgument1);
+            std::swap(argument2, mArgument2);
+            std::swap(argument3, mArgument3);
         }
-        ;
 
-        bool call(int* pipe)
+        template<class TClass, class TFunction> void call(TClass* instance, TFunction function)
         {
-            mRetval = (*mInstance.*mFunction)(mArgument, mArgument1);
-            write(pipe[1], this, sizeof(this));
-            return (false);
+            (*instance.*function)(mArgument, mArgument1, mArgument2, mArgument3);
         }
-        ;
 
-        TretVal returnResults(Targ& argument, Targ1& argument1)
+        template<class TretVal, class TClass, class TFunction> TretVal callReturn(TClass* instance, TFunction function)
         {
-            argument = mArgument;
-            argument1 = mArgument1;
-            return (mRetval);
+            return ((*instance.*function)(mArgument, mArgument1, mArgument2, mArgument3));
         }
     };
 
     /**
-     * template for synchronous calls with two arguments on a const function
+     * arguments of a call with 5 arguments
      */
-    template<class TClass, typename TretVal, typename TargCall, typename TargCall1, typename Targ, typename Targ1> class CAmSyncTwoArgConstDelegate: public CAmDelegate
+    template<class T0, class T1, class T2, class T3, class T4> struct CAmArguments5
     {
-    private:
-        TClass* mInstance;
-        TretVal (TClass::*mFunction)(TargCall, TargCall1) const;
-        Targ mArgument;
-        Targ1 mArgument1;
-        TretVal mRetval;
+        typename CAmArgument<T0>::type mArgument;
+        typename CAmArgument<T1>::type mArgument1;
+        typename CAmArgument<T2>::type mArgument2;
+        typename CAmArgument<T3>::type mArgument3;
+        typename CAmArgument<T4>::type mArgument4;
+
+        CAmArguments5() :
+                mArgument(), //
+                mArgument1(), //
+                mArgument2(), //
+                mArgument3(), //
+                mArgument4()
+        {}
+
+        void take(typename CAmArgument<T0>::param argument, typename CAmArgument<T1>::param argument1, typename CAmArgument<T2>::param argument2, typename CAmArgument<T3>::param argument3, typename CAmArgument<T4>::param argument4)
+        {
+            CAmArgument<T0>::take(mArgument, argument);
+            CAmArgument<T1>::take(mArgument1, argument1);
+            CAmArgument<T2>::take(mArgument2, argument2);
+            CAmArgument<T3>::take(mArgument3, argument3);
+            CAmArgument<T4>::take(mArgument4, argument4);
+        }
 
-    public:
-        friend class CAmSerializer;
-        CAmSyncTwoArgConstDelegate(TClass* instance, TretVal (TClass::*function)(TargCall, TargCall1) const, Targ& argument, Targ1& argument1) :
-                mInstance(instance), //
-                mFunction(function), //
-                mArgument(argument), //
-                mArgument1(argument1), //
-                mRetval()
+        void giveBack(typename CAmArgument<T0>::type& argument, typename CAmArgument<T1>::type& argument1, typename CAmArgument<T2>::type& argument2, typename CAmArgument<T3>::type& argument3, typename CAmArgument<T4>::type& argument4)
         {
+            std::swap(argument, mArgument);
+            std::swap(argument1, mArgument1);
+            std::swap(argument2, mArgument2);
+            std::swap(argument3, mArgument3);
+            std::swap(argument4, mArgument4);
         }
-        ;
 
-        bool call(int* pipe)
+        template<class TClass, class TFunction> void call(TClass* instance, TFunction function)
         {
-            mRetval = (*mInstance.*mFunction)(mArgument, mArgument1);
-            write(pipe[1], this, sizeof(this));
-            return (false);
+            (*instance.*function)(mArgument, mArgument1, mArgument2, mArgument3, mArgument4);
         }
-        ;
 
-        TretVal returnResults(Targ& argument, Targ1& argument1)
+        template<class TretVal, class TClass, class TFunction> TretVal callReturn(TClass* instance, TFunction function)
         {
-            argument = mArgument;
-            argument1 = mArgument1;
-            return (mRetval);
+            return ((*instance.*function)(mArgument, mArgument1, mArgument2, mArgument3, mArgument4));
         }
     };
 
     /**
-     * template for synchronous calls with three arguments
+     * arguments of a call with 6 arguments
      */
-    template<class TClass, typename TretVal, typename TargCall, typename TargCall1, typename TargCall2, typename Targ, typename Targ1, typename Targ2> class CAmSyncThreeArgDelegate: public CAmDelegate
+    template<class T0, class T1, class T2, class T3, class T4, class T5> struct CAmArguments6
     {
-    private:
-        TClass* mInstance;
-        TretVal (TClass::*mFunction)(TargCall argument, TargCall1 argument1, TargCall2 argument2);
-        Targ mArgument;
-        Targ1 mArgument1;
-        Targ2 mArgument2;
-        TretVal mRetval;
+        typename CAmArgument<T0>::type mArgument;
+        typename CAmArgument<T1>::type mArgument1;
+        typename CAmArgument<T2>::type mArgument2;
+        typename CAmArgument<T3>::type mArgument3;
+        typename CAmArgument<T4>::type mArgument4;
+        typename CAmArgument<T5>::type mArgument5;
+
+        CAmArguments6() :
+                mArgument(), //
+                mArgument1(), //
+                mArgument2(), //
+                mArgument3(), //
+                mArgument4(), //
+                mArgument5()
+        {}
+
+        void take(typename CAmArgument<T0>::param argument, typename CAmArgument<T1>::param argument1, typename CAmArgument<T2>::param argument2, typename CAmArgument<T3>::param argument3, typename CAmArgument<T4>::param argument4, typename CAmArgument<T5>::param argument5)
+        {
+            CAmArgument<T0>::take(mArgument, argument);
+            CAmArgument<T1>::take(mArgument1, argument1);
+            CAmArgument<T2>::take(mArgument2, argument2);
+            CAmArgument<T3>::take(mArgument3, argument3);
+            CAmArgument<T4>::take(mArgument4, argument4);
+            CAmArgument<T5>::take(mArgument5, argument5);
+        }
 
-    public:
-        CAmSyncThreeArgDelegate(TClass* instance, TretVal (TClass::*function)(TargCall argument, TargCall1 argument1, TargCall2 argument2), Targ argument, Targ1 argument1, Targ2 argument2) :
-                mInstance(instance), //
-                mFunction(function), //
-                mArgument(argument), //
-                mArgument1(argument1), //
-                mArgument2(argument2), //
-                mRetval()
+        void giveBack(typename CAmArgument<T0>::type& argument, typename CAmArgument<T1>::type& argument1, typename CAmArgument<T2>::type& argument2, typename CAmArgument<T3>::type& argument3, typename CAmArgument<T4>::type& argument4, typename CAmArgument<T5>::type& argument5)
         {
+            std::swap(argument, mArgument);
+            std::swap(argument1, mArgument1);
+            std::swap(argument2, mArgument2);
+            std::swap(argument3, mArgument3);
+            std::swap(argument4, mArgument4);
+            std::swap(argument5, mArgument5);
         }
-        ;
 
-        bool call(int* pipe)
+        template<class TClass, class TFunction> void call(TClass* instance, TFunction function)
         {
-            mRetval = (*mInstance.*mFunction)(mArgument, mArgument1, mArgument2);
-            write(pipe[1], this, sizeof(this));
-            return (false);
+            (*instance.*function)(mArgument, mArgument1, mArgument2, mArgument3, mArgument4, mArgument5);
         }
-        ;
 
-        TretVal returnResults(Targ& argument, Targ1& argument1, Targ2& argument2)
+        template<class TretVal, class TClass, class TFunction> TretVal callReturn(TClass* instance, TFunction function)
         {
-            argument = mArgument;
-            argument1 = mArgument1;
-            argument2 = mArgument2;
-            return (mRetval);
+            return ((*instance.*function)(mArgument, mArgument1, mArgument2, mArgument3, mArgument4, mArgument5));
         }
     };
 
     /**
-     * template for synchronous calls with four arguments
+     * delegate for asynchronous calls
+     * @tparam TClass the class to be called
+     * @tparam TFunction the type of the memberfunction pointer
+     * @tparam TArguments one of the CAmArguments templates with the parameter types of asyncCall
      */
-    template<class TClass, typename TretVal, typename TargCAll, typename TargCall1, typename TargCall2, typename TargCall3, typename Targ, typename Targ1, typename Targ2, typename Targ3> class CAmSyncFourArgDelegate: public CAmDelegate
+    template<class TClass, class TFunction, class TArguments> class CAmAsyncCallDelegate: public CAmDelegate
     {
     private:
         TClass* mInstance;
-        TretVal (TClass::*mFunction)(TargCAll argument, TargCall1 argument1, TargCall2 argument2, TargCall3 argument3);
-        Targ mArgument;
-        Targ1 mArgument1;
-        Targ2 mArgument2;
-        Targ3 mArgument3;
-        TretVal mRetval;
+        TFunction mFunction;
+
     public:
-        CAmSyncFourArgDelegate(TClass* instance, TretVal (TClass::*function)(TargCAll argument, TargCall1 argument1, TargCall2 argument2, TargCall3 argument3), Targ argument, Targ1 argument1, Targ2 argument2, Targ3 argument3) :
+        TArguments mArguments; //!< the arguments, filled after construction
+
+        CAmAsyncCallDelegate(TClass* instance, TFunction function) :
                 mInstance(instance), //
                 mFunction(function), //
-                mArgument(argument), //
-                mArgument1(argument1), //
-                mArgument2(argument2), //
-                mArgument3(argument3), //
-                mRetval()
-        {
-        }
-        ;
-
-        bool call(int* pipe)
-        {
-            mRetval = (*mInstance.*mFunction)(mArgument, mArgument1, mArgument2, mArgument3);
-            write(pipe[1], this, sizeof(this));
-            return (false);
-        }
-        ;
+                mArguments()
+        {};
 
-        TretVal returnResults(Targ& argument, Targ1& argument1, Targ2& argument2, Targ3& argument3)
+        bool call()
         {
-            argument = mArgument;
-            argument1 = mArgument1;
-            argument2 = mArgument2;
-            argument3 = mArgument3;
-            return (mRetval);
-        }
+            mArguments.call(mInstance, mFunction);
+            return (true);
+        };
     };
 
     /**
-     * delegate template for five arguments
+     * delegate for synchronous calls. The arguments of the caller are swapped in before the call and swapped back
+     * together with the results afterwards, the caller waits in between.
+     * @tparam TClass the class to be called
+     * @tparam TFunction the type of the memberfunction pointer
+     * @tparam TretVal the type of the return value
+     * @tparam TArguments one of the CAmArguments templates with the argument types of syncCall
      */
-    template<class TClass, typename TretVal, typename TargCAll, typename TargCall1, typename TargCall2, typename TargCall3, typename TargCall4, typename Targ, typename Targ1, typename Targ2, typename Targ3, typename Targ4> class CAmSyncFiveArgDelegate: public CAmDelegate
+    template<class TClass, class TFunction, class TretVal, class TArguments> class CAmSyncCallDelegate: public CAmSyncDelegate
     {
     private:
         TClass* mInstance;
-        TretVal (TClass::*mFunction)(TargCAll argument, TargCall1 argument1, TargCall2 argument2, TargCall3 argument3, TargCall4);
-        Targ mArgument;
-        Targ1 mArgument1;
-        Targ2 mArgument2;
-        Targ3 mArgument3;
-        Targ4 mArgument4;
-        TretVal mRetval;
+        TFunction mFunction;
+
     public:
+        TArguments mArguments; //!< the arguments, filled after construction and given back after the call
+        TretVal mRetval; //!< the return value of the call
 
-        CAmSyncFiveArgDelegate(TClass* instance, TretVal (TClass::*function)(TargCAll argument, TargCall1 argument1, TargCall2 argument2, TargCall3 argument3, TargCall4 argument4), Targ argument, Targ1 argument1, Targ2 argument2, Targ3 argument3, Targ4 argument4) :
+        CAmSyncCallDelegate(TClass* instance, TFunction function) :
                 mInstance(instance), //
                 mFunction(function), //
-                mArgument(argument), //
-                mArgument1(argument1), //
-                mArgument2(argument2), //
-                mArgument3(argument3), //
-                mArgument4(argument4), //
+                mArguments(), //
                 mRetval()
-        {
-        }
-        ;
+        {};
 
-        bool call(int* pipe)
+        bool call()
         {
-            mRetval = (*mInstance.*mFunction)(mArgument, mArgument1, mArgument2, mArgument3, mArgument4);
-            write(pipe[1], this, sizeof(this));
+            mRetval = mArguments.template callReturn<TretVal>(mInstance, mFunction);
             return (false);
-        }
-        ;
-
-        TretVal returnResults(Targ& argument, Targ1& argument1, Targ2& argument2, Targ3& argument3, Targ4& argument4)
-        {
-            argument = mArgument;
-            argument1 = mArgument1;
-            argument2 = mArgument2;
-            argument3 = mArgument3;
-            argument4 = mArgument4;
-            return (mRetval);
-        }
+        };
     };
 
     /**
-     * template for synchronous calls with six arguments
+     * pushes the delegate on the queue and rings the eventfd if the queue was empty
+     * @param p delegate pointer
      */
-    template<class TClass, typename TretVal, typename TargCAll, typename TargCall1, typename TargCall2, typename TargCall3, typename TargCall4, typename TargCall5, typename Targ, typename Targ1, typename Targ2, typename Targ3, typename Targ4, typename Targ5> class CAmSyncSixArgDelegate: public CAmDelegate
+    inline void send(CAmDelegagePtr p)
     {
-    private:
-        TClass* mInstance;
-        TretVal (TClass::*mFunction)(TargCAll argument, TargCall1 argument1, TargCall2 argument2, TargCall3 argument3, TargCall4, TargCall5);
-        Targ mArgument;
-        Targ1 mArgument1;
-        Targ2 mArgument2;
-        Targ3 mArgument3;
-        Targ4 mArgument4;
-        Targ5 mArgument5;
-        TretVal mRetval;
-
-        CAmSyncSixArgDelegate(TClass* instance, TretVal (TClass::*function)(TargCAll, TargCall1, TargCall2, TargCall3, TargCall4, TargCall5), Targ argument, Targ1 argument1, Targ2 argument2, Targ3 argument3, Targ4 argument4, Targ5 argument5) :
-                mInstance(instance), //
-                mFunction(function), //
-                mArgument(argument), //
-                mArgument1(argument1), //
-                mArgument2(argument2), //
-                mArgument3(argument3), //
-                mArgument4(argument4), //
-                mArgument5(argument5), //
-                mRetval()
+        //counted before the push, so the mainloop never executes a call that is not counted yet
+        __sync_fetch_and_add(&mQueueDepth, 1);
+        CAmDelegagePtr head;
+        do
         {
-        }
-        ;
+            head = mQueueHead;
+            p->mNext = head;
+        } while (!__sync_bool_compare_and_swap(&mQueueHead, head, p));
 
-        bool call(int* pipe)
+        //if the queue was not empty, the mainloop was woken up already and has not taken the queue yet
+        if (head == NULL)
         {
-            mRetval = (*mInstance.*mFunction)(mArgument, mArgument1, mArgument2, mArgument3, mArgument4, mArgument5);
-            write(pipe[1], this, sizeof(this));
-            return (false);
-        }
-        ;
-
-        TretVal returnResults(Targ& argument, Targ1& argument1, Targ2& argument2, Targ3& argument3, Targ4& argument4, Targ5& argument5)
-        {
-            argument = mArgument;
-            argument1 = mArgument1;
-            argument2 = mArgument2;
-            argument3 = mArgument3;
-            argument4 = mArgument4;
-            argument5 = mArgument5;
-            return (mRetval);
+            uint64_t event = 1;
+            if (write(mEventFd, &event, sizeof(event)) == -1)
+            {
+                throw std::runtime_error("could not write to eventfd !");
+            }
         }
-    };
+    }
 
     /**
-     * rings the line of the pipe and adds the delegate pointer to the queue
-     * @param p delegate pointer
+     * blocks until the mainloop has executed a synchronous call
+     * @param p the delegate of the call
      */
-    inline void send(CAmDelegagePtr p)
+    inline void waitForReturn(CAmSyncDelegate* p)
     {
-        if (write(mPipe[1], &p, sizeof(p)) == -1)
-        {
-            throw std::runtime_error("could not write to pipe !");
-        }
+        pthread_mutex_lock(&mReturnMutex);
+        while (!p->mFinished)
+            pthread_cond_wait(&mReturnCond, &mReturnMutex);
+        pthread_mutex_unlock(&mReturnMutex);
     }
 
-    int mPipe[2]; //!< the pipe
-    int mReturnPipe[2]; //!< pipe handling returns
-    std::deque<CAmDelegagePtr> mListDelegatePoiters; //!< intermediate queue to store the pipe results
+    CAmSocketHandler* mpSocketHandler; //!< the sockethandler the eventfd is polled by
+    CAmDelegatePool mDelegatePool; //!< memory for the delegates
+    int mEventFd; //!< wakes up the mainloop when calls are queued
+    sh_pollHandle_t mPollHandle; //!< poll handle of the eventfd
+    CAmDelegagePtr volatile mQueueHead; //!< lock-free stack the calls are pushed on, the last call is in front
+    CAmDelegagePtr mDispatchHead; //!< the calls taken from the queue in the order of calling, only used by the mainloop
+    CAmDelegagePtr mDispatchTail; //!< the last call taken from the queue
+    pthread_mutex_t mReturnMutex; //!< protects the finished flags of the synchronous calls
+    pthread_cond_t mReturnCond; //!< signaled when a synchronous call was executed
+    volatile uint32_t mQueueDepth; //!< number of calls that are queued and not yet executed
+    uint32_t mMaxQueueDepth; //!< highest queue depth the mainloop found, only used by the mainloop
+    uint32_t mExecutedCalls; //!< number of executed calls, only used by the mainloop
 
 public:
 
+    /**
+     * returns the counters of the queue. Must be called in the mainthread context.
+     * @param depth number of calls that wait for execution
+     * @param maxDepth highest number of waiting calls the mainloop found when it took the queue
+     * @param calls number of executed calls
+     */
+    void getQueueStatistics(uint32_t& depth, uint32_t& maxDepth, uint32_t& calls) const
+    {
+        depth = mQueueDepth;
+        maxDepth = mMaxQueueDepth;
+        calls = mExecutedCalls;
+    }
+
+    /**
+     * sets the number of executed calls to 0 and the highest depth to the current one. Must be called in the mainthread
+     * context.
+     */
+    void resetQueueStatistics()
+    {
+        mMaxQueueDepth = mQueueDepth;
+        mExecutedCalls = 0;
+    }
+
     /**
      * calls a function with no arguments threadsafe
      * @param instance the instance of the class that shall be called
@@ -899,7 +676,9 @@ public:
     template<class TClass>
     void asyncCall(TClass* instance, void (TClass::*function)())
     {
-        CAmDelegagePtr p(new CAmNoArgDelegate<TClass>(instance, function));
+        typedef CAmAsyncCallDelegate<TClass, void (TClass::*)(), CAmArguments0 > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take();
         send(p);
     }
 
@@ -926,7 +705,9 @@ public:
     template<class TClass1, class Targ>
     void asyncCall(TClass1* instance, void (TClass1::*function)(Targ), Targ argument)
     {
-        CAmDelegagePtr p(new CAmOneArgDelegate<TClass1, Targ>(instance, function, argument));
+        typedef CAmAsyncCallDelegate<TClass1, void (TClass1::*)(Targ), CAmArguments1<Targ> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument);
         send(p);
     }
 
@@ -953,7 +734,9 @@ public:
     template<class TClass1, class Targ>
     void asyncCall(TClass1* instance, void (TClass1::*function)(Targ&), Targ& argument)
     {
-        CAmDelegagePtr p(new CAmOneArgDelegate<TClass1, Targ&>(instance, function, argument));
+        typedef CAmAsyncCallDelegate<TClass1, void (TClass1::*)(Targ&), CAmArguments1<Targ&> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument);
         send(p);
     }
 
@@ -970,8 +753,9 @@ public:
     template<class TClass1, class Targ, class Targ1>
     void asyncCall(TClass1* instance, void (TClass1::*function)(Targ argument, Targ1 argument1), Targ argument, Targ1 argument1)
     {
-        logInfo("took without ref");
-        CAmDelegagePtr p(new CAmTwoArgDelegate<TClass1, Targ, Targ1>(instance, function, argument, argument1));
+        typedef CAmAsyncCallDelegate<TClass1, void (TClass1::*)(Targ, Targ1), CAmArguments2<Targ, Targ1> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1);
         send(p);
     }
 
@@ -988,7 +772,9 @@ public:
     template<class TClass1, class Targ, class Targ1>
     void asyncCall(TClass1* instance, void (TClass1::*function)(Targ& argument, Targ1 argument1), Targ& argument, Targ1 argument1)
     {
-        CAmDelegagePtr p(new CAmTwoArgDelegateFirstRef<TClass1, Targ, Targ1>(instance, function, argument, argument1));
+        typedef CAmAsyncCallDelegate<TClass1, void (TClass1::*)(Targ&, Targ1), CAmArguments2<Targ&, Targ1> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1);
         send(p);
     }
 
@@ -1005,8 +791,9 @@ public:
     template<class TClass1, class Targ, class Targ1>
     void asyncCall(TClass1* instance, void (TClass1::*function)(Targ argument, Targ1& argument1), Targ argument, Targ1& argument1)
     {
-        logInfo("took ref");
-        CAmDelegagePtr p(new CAmTwoArgDelegateSecondRef<TClass1, Targ, Targ1>(instance, function, argument, argument1));
+        typedef CAmAsyncCallDelegate<TClass1, void (TClass1::*)(Targ, Targ1&), CAmArguments2<Targ, Targ1&> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1);
         send(p);
     }
 
@@ -1023,7 +810,9 @@ public:
     template<class TClass1, class Targ, class Targ1>
     void asyncCall(TClass1* instance, void (TClass1::*function)(Targ& argument, Targ1& argument1), Targ& argument, Targ1& argument1)
     {
-        CAmDelegagePtr p(new CAmTwoArgDelegateAllRef<TClass1, Targ, Targ1>(instance, function, argument, argument1));
+        typedef CAmAsyncCallDelegate<TClass1, void (TClass1::*)(Targ&, Targ1&), CAmArguments2<Targ&, Targ1&> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1);
         send(p);
     }
 
@@ -1033,7 +822,9 @@ public:
     template<class TClass1, class Targ, class Targ1, class Targ2>
     void asyncCall(TClass1* instance, void (TClass1::*function)(Targ argument, Targ1 argument1, Targ2 argument2), Targ argument, Targ1 argument1, Targ2 argument2)
     {
-        CAmDelegagePtr p(new CAmThreeArgDelegate<TClass1, Targ, Targ1, Targ2>(instance, function, argument, argument1, argument2));
+        typedef CAmAsyncCallDelegate<TClass1, void (TClass1::*)(Targ, Targ1, Targ2), CAmArguments3<Targ, Targ1, Targ2> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1, argument2);
         send(p);
     }
 
@@ -1043,7 +834,9 @@ public:
     template<class TClass1, class Targ, class Targ1, class Targ2>
     void asyncCall(TClass1* instance, void (TClass1::*function)(Targ& argument, Targ1 argument1, Targ2 argument2), Targ& argument, Targ1 argument1, Targ2 argument2)
     {
-        CAmDelegagePtr p(new CAmThreeArgDelegateFirstRef<TClass1, Targ, Targ1, Targ2>(instance, function, argument, argument1, argument2));
+        typedef CAmAsyncCallDelegate<TClass1, void (TClass1::*)(Targ&, Targ1, Targ2), CAmArguments3<Targ&, Targ1, Targ2> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1, argument2);
         send(p);
     }
 
@@ -1054,7 +847,9 @@ public:
     template<class TClass1, class Targ, class Targ1, class Targ2>
     void asyncCall(TClass1* instance, void (TClass1::*function)(Targ argument, Targ1& argument1, Targ2 argument2), Targ argument, Targ1& argument1, Targ2 argument2)
     {
-        CAmDelegagePtr p(new CAmThreeArgDelegateSecondRef<TClass1, Targ, Targ1, Targ2>(instance, function, argument, argument1, argument2));
+        typedef CAmAsyncCallDelegate<TClass1, void (TClass1::*)(Targ, Targ1&, Targ2), CAmArguments3<Targ, Targ1&, Targ2> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1, argument2);
         send(p);
     }
 
@@ -1064,7 +859,9 @@ public:
     template<class TClass1, class Targ, class Targ1, class Targ2>
     void asyncCall(TClass1* instance, void (TClass1::*function)(Targ argument, Targ1 argument1, Targ2& argument2), Targ argument, Targ1 argument1, Targ2& argument2)
     {
-        CAmDelegagePtr p(new CAmThreeArgDelegateThirdRef<TClass1, Targ, Targ1, Targ2>(instance, function, argument, argument1, argument2));
+        typedef CAmAsyncCallDelegate<TClass1, void (TClass1::*)(Targ, Targ1, Targ2&), CAmArguments3<Targ, Targ1, Targ2&> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1, argument2);
         send(p);
     }
 
@@ -1074,7 +871,9 @@ public:
     template<class TClass1, class Targ, class Targ1, class Targ2>
     void asyncCall(TClass1* instance, void (TClass1::*function)(Targ argument, Targ1& argument1, Targ2& argument2), Targ argument, Targ1& argument1, Targ2& argument2)
     {
-        CAmDelegagePtr p(new CAmThreeArgDelegateSecondThirdRef<TClass1, Targ, Targ1, Targ2>(instance, function, argument, argument1, argument2));
+        typedef CAmAsyncCallDelegate<TClass1, void (TClass1::*)(Targ, Targ1&, Targ2&), CAmArguments3<Targ, Targ1&, Targ2&> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1, argument2);
         send(p);
     }
 
@@ -1084,7 +883,9 @@ public:
     template<class TClass1, class Targ, class Targ1, class Targ2>
     void asyncCall(TClass1* instance, void (TClass1::*function)(Targ& argument, Targ1& argument1, Targ2& argument2), Targ& argument, Targ1& argument1, Targ2& argument2)
     {
-        CAmDelegagePtr p(new CAmThreeArgDelegateAllRef<TClass1, Targ, Targ1, Targ2>(instance, function, argument, argument1, argument2));
+        typedef CAmAsyncCallDelegate<TClass1, void (TClass1::*)(Targ&, Targ1&, Targ2&), CAmArguments3<Targ&, Targ1&, Targ2&> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1, argument2);
         send(p);
     }
 
@@ -1094,7 +895,9 @@ public:
     template<class TClass1, class Targ, class Targ1, class Targ2>
     void asyncCall(TClass1* instance, void (TClass1::*function)(Targ& argument, Targ1& argument1, Targ2 argument2), Targ& argument, Targ1& argument1, Targ2 argument2)
     {
-        CAmDelegagePtr p(new CAmThreeArgDelegateFirstSecondRef<TClass1, Targ, Targ1, Targ2>(instance, function, argument, argument1, argument2));
+        typedef CAmAsyncCallDelegate<TClass1, void (TClass1::*)(Targ&, Targ1&, Targ2), CAmArguments3<Targ&, Targ1&, Targ2> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1, argument2);
         send(p);
     }
 
@@ -1104,7 +907,9 @@ public:
     template<class TClass1, class Targ, class Targ1, class Targ2>
     void asyncCall(TClass1* instance, void (TClass1::*function)(Targ& argument, Targ1 argument1, Targ2& argument2), Targ& argument, Targ1 argument1, Targ2& argument2)
     {
-        CAmDelegagePtr p(new CAmThreeArgDelegateFirstThirdRef<TClass1, Targ, Targ1, Targ2>(instance, function, argument, argument1, argument2));
+        typedef CAmAsyncCallDelegate<TClass1, void (TClass1::*)(Targ&, Targ1, Targ2&), CAmArguments3<Targ&, Targ1, Targ2&> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1, argument2);
         send(p);
     }
 
@@ -1114,7 +919,9 @@ public:
     template<class TClass1, class Targ, class Targ1, class Targ2, class Targ3>
     void asyncCall(TClass1* instance, void (TClass1::*function)(Targ argument, Targ1 argument1, Targ2 argument2, Targ3 argument3), Targ argument, Targ1 argument1, Targ2 argument2, Targ3 argument3)
     {
-        CAmDelegagePtr p(new CAmFourArgDelegate<TClass1, Targ, Targ1, Targ2, Targ3>(instance, function, argument, argument1, argument2, argument3));
+        typedef CAmAsyncCallDelegate<TClass1, void (TClass1::*)(Targ, Targ1, Targ2, Targ3), CAmArguments4<Targ, Targ1, Targ2, Targ3> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1, argument2, argument3);
         send(p);
     }
 
@@ -1143,17 +950,13 @@ public:
     template<class TClass1, class TretVal>
     void syncCall(TClass1* instance, TretVal (TClass1::*function)(), TretVal& retVal)
     {
-        CAmSyncNoArgDelegate<TClass1, TretVal>* p(new CAmSyncNoArgDelegate<TClass1, TretVal>(instance, function));
-        send(static_cast<CAmDelegagePtr>(p));
-        int numReads;
-        CAmDelegagePtr ptr;
-        if ((numReads = read(mReturnPipe[0], &ptr, sizeof(ptr))) == -1)
-        {
-            logError("CAmSerializer::receiverCallback could not read pipe!");
-            throw std::runtime_error("CAmSerializer Could not read pipe!");
-        }
-        //working with friend class here is not the finest of all programming stiles but it works...
-        retVal = p->returnResults();
+        typedef CAmSyncCallDelegate<TClass1, TretVal (TClass1::*)(), TretVal, CAmArguments0 > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take();
+        send(p);
+        waitForReturn(p);
+        retVal = p->mRetval;
+        p->mArguments.giveBack();
         delete p;
     }
 
@@ -1186,17 +989,13 @@ public:
     template<class TClass1, class TretVal, class TargCall, class Targ>
     void syncCall(TClass1* instance, TretVal (TClass1::*function)(TargCall), TretVal& retVal, Targ& argument)
     {
-        CAmSyncOneArgDelegate<TClass1, TretVal, TargCall, Targ>* p(new CAmSyncOneArgDelegate<TClass1, TretVal, TargCall, Targ>(instance, function, argument));
-        send(static_cast<CAmDelegagePtr>(p));
-        int numReads;
-        CAmDelegagePtr ptr;
-        if ((numReads = read(mReturnPipe[0], &ptr, sizeof(ptr))) == -1)
-        {
-            logError("CAmSerializer::receiverCallback could not read pipe!");
-            throw std::runtime_error("CAmSerializer Could not read pipe!");
-        }
-        //working with friend class here is not the finest of all programming stiles but it works...
-        retVal = p->returnResults(argument);
+        typedef CAmSyncCallDelegate<TClass1, TretVal (TClass1::*)(TargCall), TretVal, CAmArguments1<Targ> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument);
+        send(p);
+        waitForReturn(p);
+        retVal = p->mRetval;
+        p->mArguments.giveBack(argument);
         delete p;
     }
 
@@ -1206,17 +1005,13 @@ public:
     template<class TClass1, class TretVal, class TargCall, class Targ>
     void syncCall(TClass1* instance, TretVal (TClass1::*function)(TargCall) const, TretVal& retVal, Targ& argument)
     {
-        CAmSyncOneArgConstDelegate<TClass1, TretVal, TargCall, Targ>* p(new CAmSyncOneArgConstDelegate<TClass1, TretVal, TargCall, Targ>(instance, function, argument));
-        send(static_cast<CAmDelegagePtr>(p));
-        int numReads;
-        CAmDelegagePtr ptr;
-        if ((numReads = read(mReturnPipe[0], &ptr, sizeof(ptr))) == -1)
-        {
-            logError("CAmSerializer::receiverCallback could not read pipe!");
-            throw std::runtime_error("CAmSerializer Could not read pipe!");
-        }
-        //working with friend class here is not the finest of all programming stiles but it works...
-        retVal = p->returnResults(argument);
+        typedef CAmSyncCallDelegate<TClass1, TretVal (TClass1::*)(TargCall) const, TretVal, CAmArguments1<Targ> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument);
+        send(p);
+        waitForReturn(p);
+        retVal = p->mRetval;
+        p->mArguments.giveBack(argument);
         delete p;
     }
 
@@ -1226,16 +1021,13 @@ public:
     template<class TClass1, class TretVal, class TargCall, class Targ1Call, class Targ, class Targ1>
     void syncCall(TClass1* instance, TretVal (TClass1::*function)(TargCall, Targ1Call), TretVal& retVal, Targ& argument, Targ1& argument1)
     {
-        CAmSyncTwoArgDelegate<TClass1, TretVal, TargCall, Targ1Call, Targ, Targ1>* p(new CAmSyncTwoArgDelegate<TClass1, TretVal, TargCall, Targ1Call, Targ, Targ1>(instance, function, argument, argument1));
-        send(dynamic_cast<CAmDelegagePtr>(p));
-
-        CAmDelegagePtr ptr;
-        if (read(mReturnPipe[0], &ptr, sizeof(ptr)) == -1)
-        {
-            logError("CAmSerializer::receiverCallback could not read pipe!");
-            throw std::runtime_error("CAmSerializer Could not read pipe!");
-        }
-        retVal = p->returnResults(argument, argument1);
+        typedef CAmSyncCallDelegate<TClass1, TretVal (TClass1::*)(TargCall, Targ1Call), TretVal, CAmArguments2<Targ, Targ1> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1);
+        send(p);
+        waitForReturn(p);
+        retVal = p->mRetval;
+        p->mArguments.giveBack(argument, argument1);
         delete p;
     }
     /**
@@ -1244,16 +1036,13 @@ public:
     template<class TClass1, class TretVal, class TargCall, class Targ1Call, class Targ, class Targ1>
     void syncCall(TClass1* instance, TretVal (TClass1::*function)(TargCall, Targ1Call) const, TretVal& retVal, Targ& argument, Targ1& argument1)
     {
-        CAmSyncTwoArgConstDelegate<TClass1, TretVal, TargCall, Targ1Call, Targ, Targ1>* p(new CAmSyncTwoArgConstDelegate<TClass1, TretVal, TargCall, Targ1Call, Targ, Targ1>(instance, function, argument, argument1));
-        send(dynamic_cast<CAmDelegagePtr>(p));
-
-        CAmDelegagePtr ptr;
-        if (read(mReturnPipe[0], &ptr, sizeof(ptr)) == -1)
-        {
-            logError("CAmSerializer::receiverCallback could not read pipe!");
-            throw std::runtime_error("CAmSerializer Could not read pipe!");
-        }
-        retVal = p->returnResults(argument, argument1);
+        typedef CAmSyncCallDelegate<TClass1, TretVal (TClass1::*)(TargCall, Targ1Call) const, TretVal, CAmArguments2<Targ, Targ1> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1);
+        send(p);
+        waitForReturn(p);
+        retVal = p->mRetval;
+        p->mArguments.giveBack(argument, argument1);
         delete p;
     }
 
@@ -1263,17 +1052,13 @@ public:
     template<class TClass1, class TretVal, class TargCall, class TargCall1, class TargCall2, class Targ, class Targ1, class Targ2>
     void syncCall(TClass1* instance, TretVal (TClass1::*function)(TargCall, TargCall1, TargCall2), TretVal& retVal, Targ& argument, Targ1& argument1, Targ2& argument2)
     {
-        CAmSyncThreeArgDelegate<TClass1, TretVal, TargCall, TargCall1, TargCall2, Targ, Targ1, Targ2>* p(new CAmSyncThreeArgDelegate<TClass1, TretVal, TargCall, TargCall1, TargCall2, Targ, Targ1, Targ2>(instance, function, argument, argument1, argument2));
-        send(static_cast<CAmDelegagePtr>(p));
-        int numReads;
-        CAmDelegagePtr ptr;
-        if ((numReads = read(mReturnPipe[0], &ptr, sizeof(ptr))) == -1)
-        {
-            logError("CAmSerializer::receiverCallback could not read pipe!");
-            throw std::runtime_error("CAmSerializer Could not read pipe!");
-        }
-        //working with friend class here is not the finest of all programming stiles but it worCAmTwoArgDelegateks...
-        retVal = p->returnResults(argument, argument1, argument2);
+        typedef CAmSyncCallDelegate<TClass1, TretVal (TClass1::*)(TargCall, TargCall1, TargCall2), TretVal, CAmArguments3<Targ, Targ1, Targ2> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1, argument2);
+        send(p);
+        waitForReturn(p);
+        retVal = p->mRetval;
+        p->mArguments.giveBack(argument, argument1, argument2);
         delete p;
     }
 
@@ -1283,17 +1068,13 @@ public:
     template<class TClass1, class TretVal, class TargCall, class TargCall1, class TargCall2, class TargCall3, class Targ, class Targ1, class Targ2, class Targ3>
     void syncCall(TClass1* instance, TretVal (TClass1::*function)(TargCall, TargCall1, TargCall2, TargCall3), TretVal& retVal, Targ& argument, Targ1& argument1, Targ2& argument2, Targ3& argument3)
     {
-        CAmSyncFourArgDelegate<TClass1, TretVal, TargCall, TargCall1, TargCall2, TargCall3, Targ, Targ1, Targ2, Targ3>* p(new CAmSyncFourArgDelegate<TClass1, TretVal, TargCall, TargCall1, TargCall2, TargCall3, Targ, Targ1, Targ2, Targ3>(instance, function, argument, argument1, argument2, argument3));
-        send(static_cast<CAmDelegagePtr>(p));
-        int numReads;
-        CAmDelegagePtr ptr;
-        if ((numReads = read(mReturnPipe[0], &ptr, sizeof(ptr))) == -1)
-        {
-            logError("CAmSerializer::receiverCallback could not read pipe!");
-            throw std::runtime_error("CAmSerializer Could not read pipe!");
-        }
-        //working with friend class here is not the finest of all programming stiles but it works...
-        retVal = p->returnResults(argument, argument1, argument2, argument3);
+        typedef CAmSyncCallDelegate<TClass1, TretVal (TClass1::*)(TargCall, TargCall1, TargCall2, TargCall3), TretVal, CAmArguments4<Targ, Targ1, Targ2, Targ3> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1, argument2, argument3);
+        send(p);
+        waitForReturn(p);
+        retVal = p->mRetval;
+        p->mArguments.giveBack(argument, argument1, argument2, argument3);
         delete p;
     }
 
@@ -1303,17 +1084,13 @@ public:
     template<class TClass1, class TretVal, class TargCall, class TargCall1, class TargCall2, class TargCall3, class TargCall4, class Targ, class Targ1, class Targ2, class Targ3, class Targ4>
     void syncCall(TClass1* instance, TretVal (TClass1::*function)(TargCall, TargCall1, TargCall2, TargCall3, TargCall4), TretVal& retVal, Targ& argument, Targ1& argument1, Targ2& argument2, Targ3& argument3, Targ4& argument4)
     {
-        CAmSyncFiveArgDelegate<TClass1, TretVal, TargCall, TargCall1, TargCall2, TargCall3, TargCall4, Targ, Targ1, Targ2, Targ3, Targ4>* p(new CAmSyncFiveArgDelegate<TClass1, TretVal, TargCall, TargCall1, TargCall2, TargCall3, TargCall4, Targ, Targ1, Targ2, Targ3, Targ4>(instance, function, argument, argument1, argument2, argument3, argument4));
-        send(static_cast<CAmDelegagePtr>(p));
-        int numReads;
-        CAmDelegagePtr ptr;
-        if ((numReads = read(mReturnPipe[0], &ptr, sizeof(ptr))) == -1)
-        {
-            logError("CAmSerializer::receiverCallback could not read pipe!");
-            throw std::runtime_error("CAmSerializer Could not read pipe!");
-        }
-        //working with friend class here is not the finest of all programming stiles but it works...
-        retVal = p->returnResults(argument, argument1, argument2, argument3, argument4);
+        typedef CAmSyncCallDelegate<TClass1, TretVal (TClass1::*)(TargCall, TargCall1, TargCall2, TargCall3, TargCall4), TretVal, CAmArguments5<Targ, Targ1, Targ2, Targ3, Targ4> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1, argument2, argument3, argument4);
+        send(p);
+        waitForReturn(p);
+        retVal = p->mRetval;
+        p->mArguments.giveBack(argument, argument1, argument2, argument3, argument4);
         delete p;
     }
 
@@ -1323,35 +1100,50 @@ public:
     template<class TClass1, class TretVal, class TargCall, class TargCall1, class TargCall2, class TargCall3, class TargCall4, class TargCall5, class Targ, class Targ1, class Targ2, class Targ3, class Targ4, class Targ5>
     void syncCall(TClass1* instance, TretVal (TClass1::*function)(TargCall, TargCall1, TargCall2, TargCall3, TargCall4, TargCall5), TretVal& retVal, Targ& argument, Targ1& argument1, Targ2& argument2, Targ3& argument3, Targ4& argument4, Targ5& argument5)
     {
-        CAmSyncSixArgDelegate<TClass1, TretVal, TargCall, TargCall1, TargCall2, TargCall3, TargCall4, TargCall5, Targ, Targ1, Targ2, Targ3, Targ4, Targ5>* p(new CAmSyncSixArgDelegate<TClass1, TretVal, TargCall, TargCall1, TargCall2, TargCall3, TargCall4, TargCall5, Targ, Targ1, Targ2, Targ3, Targ4, Targ5>(instance, function, argument, argument1, argument2, argument3, argument4, argument5));
-        send(static_cast<CAmDelegagePtr>(p));
-        int numReads;
-        CAmDelegagePtr ptr;
-        if ((numReads = read(mReturnPipe[0], &ptr, sizeof(ptr))) == -1)
-        {
-            logError("CAmSerializer::receiverCallback could not read pipe!");
-            throw std::runtime_error("CAmSerializer Could not read pipe!");
-        }
-        //working with friend class here is not the finest of all programming stiles but it works...
-        retVal = p->returnResults(argument, argument1, argument2, argument3, argument4, argument5);
+        typedef CAmSyncCallDelegate<TClass1, TretVal (TClass1::*)(TargCall, TargCall1, TargCall2, TargCall3, TargCall4, TargCall5), TretVal, CAmArguments6<Targ, Targ1, Targ2, Targ3, Targ4, Targ5> > TDelegate;
+        TDelegate* p(new (mDelegatePool) TDelegate(instance, function));
+        p->mArguments.take(argument, argument1, argument2, argument3, argument4, argument5);
+        send(p);
+        waitForReturn(p);
+        retVal = p->mRetval;
+        p->mArguments.giveBack(argument, argument1, argument2, argument3, argument4, argument5);
         delete p;
     }
 
     /**
-     * receiver callback for sockethandling, for more, see CAmSocketHandler
+     * receiver callback for sockethandling, takes all calls from the queue. For more, see CAmSocketHandler
      */
     void receiverCallback(const pollfd pollfd, const sh_pollHandle_t handle, void* userData)
     {
         (void) handle;
         (void) userData;
-        int numReads;
-        CAmDelegagePtr listPointers[3];
-        if ((numReads = read(pollfd.fd, &listPointers, sizeof(listPointers))) == -1)
+        uint64_t events;
+        if (read(pollfd.fd, &events, sizeof(events)) == -1 && errno != EAGAIN)
         {
-            logError("CAmSerializer::receiverCallback could not read pipe!");
-            throw std::runtime_error("CAmSerializer Could not read pipe!");
+            logError("CAmSerializer::receiverCallback could not read eventfd!");
+            throw std::runtime_error("CAmSerializer Could not read eventfd!");
         }
-        mListDelegatePoiters.assign(listPointers, listPointers + (numReads / sizeof(CAmDelegagePtr)));
+
+        //the queue is a stack, so it is reversed to keep the order of the calls
+        CAmDelegagePtr list = __sync_lock_test_and_set(&mQueueHead, static_cast<CAmDelegagePtr>(NULL));
+        CAmDelegagePtr last = list, reversed = NULL;
+        while (list != NULL)
+        {
+            CAmDelegagePtr next = list->mNext;
+            list->mNext = reversed;
+            reversed = list;
+            list = next;
+        }
+
+        if (reversed == NULL)
+            return;
+        if (mQueueDepth > mMaxQueueDepth)
+            mMaxQueueDepth = mQueueDepth;
+        if (mDispatchTail != NULL)
+            mDispatchTail->mNext = reversed;
+        else
+            mDispatchHead = reversed;
+        mDispatchTail = last;
     }
 
     /**
@@ -1361,9 +1153,7 @@ public:
     {
         (void) handle;
         (void) userData;
-        if (mListDelegatePoiters.empty())
-            return (false);
-        return (true);
+        return (mDispatchHead != NULL);
     }
 
     /**
@@ -1373,13 +1163,26 @@ public:
     {
         (void) handle;
         (void) userData;
-        CAmDelegagePtr delegatePoiter = mListDelegatePoiters.front();
-        mListDelegatePoiters.pop_front();
-        if (delegatePoiter->call(mReturnPipe))
+        CAmDelegagePtr delegatePoiter = mDispatchHead;
+        mDispatchHead = delegatePoiter->mNext;
+        if (mDispatchHead == NULL)
+            mDispatchTail = NULL;
+        __sync_fetch_and_sub(&mQueueDepth, 1);
+        mExecutedCalls++;
+
+        if (delegatePoiter->call())
+        {
             delete delegatePoiter;
-        if (mListDelegatePoiters.empty())
-            return (false);
-        return (true);
+        }
+        else
+        {
+            //the caller of the synchronous call takes the results and deletes the delegate
+            pthread_mutex_lock(&mReturnMutex);
+            static_cast<CAmSyncDelegate*>(delegatePoiter)->mFinished = true;
+            pthread_cond_broadcast(&mReturnCond);
+            pthread_mutex_unlock(&mReturnMutex);
+        }
+        return (mDispatchHead != NULL);
     }
 
     TAmShPollFired<CAmSerializer> receiverCallbackT;
@@ -1391,32 +1194,56 @@ public:
      * @param iSocketHandler pointer to the CAmSocketHandler
      */
     CAmSerializer(CAmSocketHandler *iSocketHandler) :
-            mPipe(), //
-            mListDelegatePoiters(), //
+            mpSocketHandler(iSocketHandler), //
+            mDelegatePool(), //
+            mEventFd(-1), //
+            mPollHandle(0), //
+            mQueueHead(NULL), //
+            mDispatchHead(NULL), //
+            mDispatchTail(NULL), //
+            mQueueDepth(0), //
+            mMaxQueueDepth(0), //
+            mExecutedCalls(0), //
             receiverCallbackT(this, &CAmSerializer::receiverCallback), //
             dispatcherCallbackT(this, &CAmSerializer::dispatcherCallback), //
             checkerCallbackT(this, &CAmSerializer::checkerCallback)
     {
-        if (pipe(mPipe) == -1)
+        if ((mEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) == -1)
         {
-            logError("CAmSerializer could not create pipe!");
-            throw std::runtime_error("CAmSerializer Could not open pipe!");
+            logError("CAmSerializer could not create eventfd!");
+            throw std::runtime_error("CAmSerializer Could not open eventfd!");
         }
 
-        if (pipe(mReturnPipe) == -1)
-        {
-            logError("CAmSerializer could not create mReturnPipe!");
-            throw std::runtime_error("CAmSerializer Could not open mReturnPipe!");
-        }
+        pthread_mutex_init(&mReturnMutex, NULL);
+        pthread_cond_init(&mReturnCond, NULL);
 
         short event = 0;
-        sh_pollHandle_t handle;
         event |= POLLIN;
-        iSocketHandler->addFDPoll(mPipe[0], event, NULL, &receiverCallbackT, &checkerCallbackT, &dispatcherCallbackT, NULL, handle);
+        iSocketHandler->addFDPoll(mEventFd, event, NULL, &receiverCallbackT, &checkerCallbackT, &dispatcherCallbackT, NULL, mPollHandle);
     }
 
     ~CAmSerializer()
     {
+        mpSocketHandler->removeFDPoll(mPollHandle);
+        close(mEventFd);
+
+        //calls that were not executed anymore are dropped
+        CAmDelegagePtr list = __sync_lock_test_and_set(&mQueueHead, static_cast<CAmDelegagePtr>(NULL));
+        while (list != NULL)
+        {
+            CAmDelegagePtr next = list->mNext;
+            delete list;
+            list = next;
+        }
+        while (mDispatchHead != NULL)
+        {
+            CAmDelegagePtr next = mDispatchHead->mNext;
+            delete mDispatchHead;
+            mDispatchHead = next;
+        }
+
+        pthread_cond_destroy(&mReturnCond);
+        pthread_mutex_destroy(&mReturnMutex);
     }
 };
 } /* namespace am */
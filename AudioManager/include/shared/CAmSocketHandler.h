@@ -23,8 +23,11 @@
 #include <sys/socket.h>
 #include <stdint.h>
 #include <sys/poll.h>
+#include <sys/epoll.h>
+#include <deque>
 #include <list>
 #include <map>
+#include <vector>
 #include <signal.h>
 
 #include <iostream> //todo: remove me
@@ -33,6 +36,14 @@ namespace am
 
 #define MAX_NS 1000000000L
 
+/**
+ * a removed timer handle is only reused when at least this number of other timer handles was removed after it, so a
+ * stale handle does not hit a new timer right away
+ */
+#ifndef TIMER_HANDLE_REUSE_DISTANCE
+#define TIMER_HANDLE_REUSE_DISTANCE 64
+#endif
+
 static volatile sig_atomic_t gDispatchDone = 1; //this global is used to stop the mainloop
 
 typedef uint16_t sh_timerHandle_t; //!<this is a handle for a timer to be used with the SocketHandler
@@ -145,6 +156,14 @@ public:
         };
     };
 
+    struct sh_pollStatistic_s //!<counters of one poll
+    {
+        sh_pollHandle_t handle; //!<the handle of the poll
+        int fd; //!<the filedescriptor
+        uint32_t wakeups; //!<number of loops the filedescriptor fired in
+        uint64_t dispatchNs; //!<time spent in the fired, check and dispatch callbacks in nanoseconds
+    };
+
     CAmSocketHandler();
     ~CAmSocketHandler();
 
@@ -156,6 +175,8 @@ public:
     am_Error_e restartTimer(const sh_timerHandle_t handle);
     am_Error_e updateTimer(const sh_timerHandle_t handle, const timespec timeouts);
     am_Error_e stopTimer(const sh_timerHandle_t handle);
+    void getStatistics(uint32_t& wakeups, uint64_t& busyNs, std::vector<sh_pollStatistic_s>& listPolls) const;
+    void resetStatistics();
     void start_listenting();
     void stop_listening();
     void exit_mainloop();
@@ -173,8 +194,11 @@ public:
             return (false);
         };
 
+    void timerFdCallback(const pollfd pollfd, const sh_pollHandle_t handle, void* userData);
+
     TAmShPollFired<CAmSocketHandler> receiverCallbackT;
     TAmShPollCheck<CAmSocketHandler> checkerCallbackT;
+    TAmShPollFired<CAmSocketHandler> timerFdCallbackT;
 
 private:
 
@@ -184,12 +208,23 @@ private:
     struct sh_timer_s //!<struct that holds information of timers
     {
         sh_timerHandle_t handle; //!<the handle of the timer
-        timespec countdown; //!<the countdown, this value is decreased every time the timer is up
+        timespec timeout; //!<the time from starting the timer until it is up
         IAmShTimerCallBack* callback; //!<the callbackfunction
         void * userData; //!<saves a void pointer together with the rest.
+        bool isValid; //!<false if the slot is free
+        bool isActive; //!<true while the timer is running
+        uint32_t sequence; //!<identifies the current run of the timer, entries of older runs on the heap are ignored
+    };
+
+    struct sh_timerDeadline_s //!<entry of the heap of running timers
+    {
+        timespec deadline; //!<the CLOCK_MONOTONIC time when the timer is up
+        sh_timerHandle_t handle; //!<the handle of the timer
+        uint32_t sequence; //!<the run of the timer this entry belongs to
     };
 
-    typedef std::reverse_iterator<sh_timer_s> rListTimerIter; //!<typedef for reverseiterator on timer lists
+    typedef std::vector<sh_timer_s> mListTimer_t; //!<the timers, the slot of a timer is its handle - 1
+    typedef std::vector<sh_timerDeadline_s> mListTimerDeadline_t; //!<heap of the running timers, the next one due is at the front
 
     struct sh_poll_s //!<struct that holds information about polls
     {
@@ -198,27 +233,39 @@ private:
         IAmShPollFired *firedCB; //!<pointer to fired callback
         IAmShPollCheck *checkCB; //!< pointer to check callback
         IAmShPollDispatch *dispatchCB; //!<pointer to dispatch callback
-        pollfd pollfdValue; //!<the array for polling the filedescriptors
+        pollfd pollfdValue; //!<the filedescriptor, the requested events and the events that fired
         void *userData; //!<userdata saved together with the callback.
+        bool isValid; //!<false if the slot is free or the poll was removed
+        sh_pollHandle_t nextOnFd; //!<next handle that polls the same filedescriptor, 0 for the last one
+        uint32_t wakeups; //!<number of loops the filedescriptor fired in
+        uint64_t dispatchNs; //!<time spent in the callbacks in nanoseconds
     };
 
-    typedef std::vector<pollfd> mListPollfd_t; //!<vector of filedescriptors
-    typedef std::vector<sh_poll_s> mListPoll_t; //!<list for the callbacks
+    typedef std::vector<sh_poll_s> mListPoll_t; //!<the polls, the slot of a poll is its handle - 1
+    typedef std::vector<sh_pollHandle_t> mListPollHandle_t; //!<list of poll handles
 
     bool fdIsValid(const int fd) const;
+    sh_poll_s* getPoll(const sh_pollHandle_t handle);
+    am_Error_e updateEpoll(const int fd);
+    void dispatchFired(const int numberEvents);
+    void addDispatchTime(const sh_pollHandle_t handle, const timespec& start);
+    sh_timer_s* getTimer(const sh_timerHandle_t handle);
+    void startTimer(sh_timer_s& timer);
+    bool isTimerRunStale(const sh_timerDeadline_s& entry);
+    void removeStaleTimerRuns();
     void timerUp();
-    void timerCorrection();
+    void armTimerFd();
     timespec* insertTime(timespec& buffertime);
 
     /**
-     * compares countdown values
+     * compares deadlines, used to keep the earliest deadline at the front of the heap
      * @param a
      * @param b
-     * @return true if b greater a
+     * @return true if a is due after b
      */
-    inline static bool compareCountdown(const sh_timer_s& a, const sh_timer_s& b)
+    inline static bool compareDeadline(const sh_timerDeadline_s& a, const sh_timerDeadline_s& b)
     {
-        return ((a.countdown.tv_sec == b.countdown.tv_sec) ? (a.countdown.tv_nsec < b.countdown.tv_nsec) : (a.countdown.tv_sec < b.countdown.tv_sec));
+        return ((a.deadline.tv_sec == b.deadline.tv_sec) ? (a.deadline.tv_nsec > b.deadline.tv_nsec) : (a.deadline.tv_sec > b.deadline.tv_sec));
     }
 
     /**
@@ -295,72 +342,6 @@ private:
             return (0);
     }
 
-    /**
-     * functor to return all fired events
-     * @param a
-     * @return
-     */
-    inline static bool eventFired(const pollfd& a)
-    {
-        return (a.revents == 0 ? false : true);
-    }
-
-    /**
-     * functor to help find the items that do not need dispatching
-     * @param a
-     * @return
-     */
-    inline static bool noDispatching(const sh_poll_s& a)
-    {
-        //remove from list of there is no checkCB
-        if (!a.checkCB)
-            return (true);
-        return (!a.checkCB->Call(a.handle, a.userData));
-    }
-
-    /**
-     * checks if dispatching is already finished
-     * @param a
-     * @return
-     */
-    inline static bool dispatchingFinished(const sh_poll_s& a)
-    {
-        //remove from list of there is no dispatchCB
-        if (!a.dispatchCB)
-            return (true);
-        return (!a.dispatchCB->Call(a.handle, a.userData));
-    }
-
-    class CAmShCopyPollfd //!< functor to copy filedescriptors into the poll array
-    {
-    private:
-        mListPollfd_t& mArray;
-    public:
-        CAmShCopyPollfd(mListPollfd_t& dest) :
-                mArray(dest)
-        {
-        }
-        void operator()(const sh_poll_s& row)
-        {
-            pollfd temp = row.pollfdValue;
-            temp.revents = 0;
-            mArray.push_back(temp);
-        }
-    };
-
-    class CAmShCallFire //!< functor to call the firecallbacks
-    {
-    public:
-        CAmShCallFire()
-        {
-        }
-        ;
-        void operator()(sh_poll_s& row)
-        {
-            row.firedCB->Call(row.pollfdValue, row.handle, row.userData);
-        }
-    };
-
     class CAmShCallPrep //!< functor to call the preparation callbacks
     {
     public:
@@ -370,90 +351,29 @@ private:
         ;
         void operator()(sh_poll_s& row)
         {
-            if (row.prepareCB)
+            if (row.isValid && row.prepareCB)
                 row.prepareCB->Call(row.handle, row.userData);
         }
     };
 
-    class CAmShCallTimer //!<functor to call a timer
-    {
-    public:
-        CAmShCallTimer()
-        {
-        }
-        ;
-        void operator()(sh_timer_s& row)
-        {
-            row.callback->Call(row.handle, row.userData);
-        }
-    };
-
-    class CAmShCountdownUp //!<functor that checks if a timer is up
-    {
-    private:
-        timespec mDiffTime;
-    public:
-        CAmShCountdownUp(const timespec& differenceTime) :
-                mDiffTime(differenceTime)
-        {
-        }
-        ;
-        bool operator()(const sh_timer_s& row)
-        {
-            timespec sub = timespecSub(row.countdown, mDiffTime);
-            if (sub.tv_nsec == 0 && sub.tv_sec == 0)
-                return (true);
-            return (false);
-        }
-    };
-
-    class CAmShCountdownZero //!<functor that checks if a timer is zero
-    {
-    public:
-        CAmShCountdownZero()
-        {
-        }
-        ;
-        bool operator()(const sh_timer_s& row)
-        {
-            if (row.countdown.tv_nsec == 0 && row.countdown.tv_sec == 0)
-                return (true);
-            return (false);
-        }
-    };
-
-    class CAmShSubstractTime //!<functor to easy substract from each countdown value
-    {
-    private:
-        timespec param;
-    public:
-        CAmShSubstractTime(timespec param) :
-                param(param)
-        {
-        }
-        inline void operator()(sh_timer_s& t)
-        {
-            t.countdown = timespecSub(t.countdown, param);
-        }
-    };
+    int mEpollFd; //!<the epoll instance all filedescriptors are registered at
+    std::vector<epoll_event> mListEpollEvent; //!<receives the events of epoll_pwait, grows with the number of polls and never is empty
+    mListPoll_t mListPoll; //!<slots that hold all information for the polls
+    mListPollHandle_t mListFdFirstHandle; //!<first handle polling a filedescriptor, indexed by the filedescriptor
+    mListPollHandle_t mListFreePollHandle; //!<handles of free slots that can be reused
+    mListPollHandle_t mListRemovedPollHandle; //!<handles removed during this loop, they are freed with the next loop
+    mListPollHandle_t mListFired; //!<handles that fired in this loop
+    mListTimer_t mListTimer; //!<slots of all timers
+    std::deque<sh_timerHandle_t> mListFreeTimerHandle; //!<handles of free timer slots that can be reused, oldest first
+    mListTimerDeadline_t mListActiveTimer; //!<heap of the running timers, can contain entries of stopped runs
+    size_t mNumberActiveTimer; //!<number of running timers
+    uint32_t mTimerSequence; //!<counts the runs of all timers
+    int mTimerFd; //!<timerfd that wakes up the mainloop for the next timer, -1 if the timeout of epoll_pwait is used
+    sh_pollHandle_t mTimerFdHandle; //!<poll handle of the timerfd
+    timespec mTimerFdDeadline; //!<the deadline the timerfd is armed with, 0 if it is disarmed
+    uint32_t mWakeups; //!<number of times epoll_pwait returned
+    uint64_t mBusyNs; //!<time spent between the wakeups and the next call of epoll_pwait in nanoseconds
 
-    mListPollfd_t mfdPollingArray; //!<the polling array for ppoll
-    mListPoll_t mListPoll; //!<list that holds all information for the ppoll
-    std::list<sh_timer_s> mListTimer; //!<list of all timers
-    std::list<sh_timer_s> mListActiveTimer; //!<list of all currently active timers
-    sh_timerHandle_t mLastInsertedHandle; //!<keeps track of the last inserted timer handle
-    sh_pollHandle_t mLastInsertedPollHandle; //!<keeps track of the last inserted poll handle
-    bool mRecreatePollfds; //!<when this is true, the poll list needs to be recreated
-    timespec mStartTime; //!<here the actual time is saved for timecorrection
-
-//    void debugPrintTimerList ()
-//    {
-//        std::list<sh_timer_s>::iterator it(mListActiveTimer.begin());
-//        for(;it!=mListActiveTimer.end();++it)
-//        {
-//            std::cout<< "Handle " << it->handle << "sec " << it->countdown.tv_sec << "nsec " << it->countdown.tv_nsec<<std::endl;
-//        }
-//    }
 }
 ;
 